@@ -35,5 +35,12 @@
 #define GPIO_HAL_CONF_ARCH_SW_TOGGLE     1
 #define GPIO_HAL_CONF_PORT_PIN_NUMBERING 0
 /*---------------------------------------------------------------------------*/
+#ifndef SHA_256_CONF
+#define SHA_256_CONF                     sha_256_accel_driver
+#endif
+#ifndef CRC16_CONF_METHOD
+#define CRC16_CONF_METHOD                CRC16_METHOD_SLICE_BY_8
+#endif
+/*---------------------------------------------------------------------------*/
 #endif /* NATIVE_DEF_H_ */
 /*---------------------------------------------------------------------------*/
@@ -31,6 +31,7 @@
 #include "dev/moteid.h"
 #include "lib/simEnvChange.h"
 #include "lib/random.h"
+#include "lib/prng.h"
 #include "lib/csprng.h"
 #include "lib/sha-256.h"
 #include <string.h>
@@ -49,6 +50,8 @@ doInterfaceActionsBeforeTick(void)
 
     simMoteIDChanged = 0;
     random_init(simRandomSeed);
+    /* the streams of the subsystems get all bits of the seed */
+    prng_set_seed((uint32_t)simRandomSeed);
 
     sha_256_hkdf(NULL, 0,
                  (const uint8_t *)&simRandomSeed, sizeof(simRandomSeed),
@@ -102,4 +102,9 @@ typedef unsigned int uip_stats_t;
 #define PLATFORM_CONF_MAIN_ACCEPTS_ARGS  1
 #define PLATFORM_CONF_SUPPORTS_STACK_CHECK 0
 
+/* The disk used by the FatFs port, see fs/fat/disk-file.h */
+#ifndef DISK_CACHE_CONF_DRIVER
+#define DISK_CACHE_CONF_DRIVER disk_file_driver
+#endif
+
 #endif /* CONTIKI_CONF_H_ */
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/**
+ * \addtogroup native-fat
+ * @{
+ *
+ * \file
+ * Implementation of the disk driver backed by a disk image file.
+ */
+#include "disk-file.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+static int fd = -1;
+/*----------------------------------------------------------------------------*/
+static disk_status_t
+disk_file_status(uint8_t dev)
+{
+  if(dev != 0 || fd < 0) {
+    return 0;
+  }
+  return DISK_STATUS_INIT | DISK_STATUS_DISK | DISK_STATUS_WRITABLE;
+}
+/*----------------------------------------------------------------------------*/
+static disk_status_t
+disk_file_initialize(uint8_t dev)
+{
+  struct stat st;
+  off_t size;
+
+  if(dev != 0) {
+    return 0;
+  }
+
+  if(fd < 0) {
+    fd = open(DISK_FILE_NAME, O_RDWR | O_CREAT, 0600);
+    if(fd < 0) {
+      return DISK_STATUS_ERROR;
+    }
+  }
+
+  size = (off_t)DISK_FILE_SECTOR_COUNT * DISK_FILE_SECTOR_SIZE;
+  if(fstat(fd, &st) < 0 || (st.st_size < size && ftruncate(fd, size) < 0)) {
+    close(fd);
+    fd = -1;
+    return DISK_STATUS_ERROR;
+  }
+
+  return disk_file_status(dev);
+}
+/*----------------------------------------------------------------------------*/
+static disk_result_t
+check_range(uint8_t dev, uint32_t sector, uint32_t count)
+{
+  if(dev != 0 || fd < 0) {
+    return DISK_RESULT_NO_INIT;
+  }
+  if(count == 0 || sector >= DISK_FILE_SECTOR_COUNT ||
+     count > DISK_FILE_SECTOR_COUNT - sector) {
+    return DISK_RESULT_INVALID_ARG;
+  }
+  return DISK_RESULT_OK;
+}
+/*----------------------------------------------------------------------------*/
+static disk_result_t
+disk_file_read(uint8_t dev, void *buff, uint32_t sector, uint32_t count)
+{
+  disk_result_t result;
+  size_t len;
+
+  result = check_range(dev, sector, count);
+  if(result != DISK_RESULT_OK) {
+    return result;
+  }
+
+  len = (size_t)count * DISK_FILE_SECTOR_SIZE;
+  if(pread(fd, buff, len, (off_t)sector * DISK_FILE_SECTOR_SIZE) !=
+     (ssize_t)len) {
+    return DISK_RESULT_IO_ERROR;
+  }
+  return DISK_RESULT_OK;
+}
+/*----------------------------------------------------------------------------*/
+static disk_result_t
+disk_file_write(uint8_t dev, const void *buff, uint32_t sector, uint32_t count)
+{
+  disk_result_t result;
+  size_t len;
+
+  result = check_range(dev, sector, count);
+  if(result != DISK_RESULT_OK) {
+    return result;
+  }
+
+  len = (size_t)count * DISK_FILE_SECTOR_SIZE;
+  if(pwrite(fd, buff, len, (off_t)sector * DISK_FILE_SECTOR_SIZE) !=
+     (ssize_t)len) {
+    return DISK_RESULT_IO_ERROR;
+  }
+  return DISK_RESULT_OK;
+}
+/*----------------------------------------------------------------------------*/
+static disk_result_t
+disk_file_ioctl(uint8_t dev, uint8_t cmd, void *buff)
+{
+  if(dev != 0 || fd < 0) {
+    return DISK_RESULT_NO_INIT;
+  }
+
+  switch(cmd) {
+  case DISK_IOCTL_CTRL_SYNC:
+    /* Data written with pwrite() survives a crash of the process. */
+    return DISK_RESULT_OK;
+  case DISK_IOCTL_GET_SECTOR_COUNT:
+    *(uint32_t *)buff = DISK_FILE_SECTOR_COUNT;
+    return DISK_RESULT_OK;
+  case DISK_IOCTL_GET_SECTOR_SIZE:
+    *(uint16_t *)buff = DISK_FILE_SECTOR_SIZE;
+    return DISK_RESULT_OK;
+  case DISK_IOCTL_GET_BLOCK_SIZE:
+    /* The erase block size is unknown. */
+    *(uint32_t *)buff = 1;
+    return DISK_RESULT_OK;
+  default:
+    return DISK_RESULT_INVALID_ARG;
+  }
+}
+/*----------------------------------------------------------------------------*/
+const struct disk_driver disk_file_driver = {
+  .status = disk_file_status,
+  .initialize = disk_file_initialize,
+  .read = disk_file_read,
+  .write = disk_file_write,
+  .ioctl = disk_file_ioctl
+};
+/*----------------------------------------------------------------------------*/
+
+/** @} */
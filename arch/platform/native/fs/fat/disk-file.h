@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/**
+ * \addtogroup native-fat
+ * @{
+ *
+ * \file
+ * Header file for the disk driver backed by a disk image file.
+ */
+#ifndef DISK_FILE_H_
+#define DISK_FILE_H_
+
+#include "contiki.h"
+#include "dev/storage/disk/disk.h"
+
+/** The name of the disk image file, created if it does not exist. */
+#ifdef DISK_FILE_CONF_NAME
+#define DISK_FILE_NAME DISK_FILE_CONF_NAME
+#else
+#define DISK_FILE_NAME "fat.img"
+#endif
+
+/** The number of sectors of the disk. */
+#ifdef DISK_FILE_CONF_SECTOR_COUNT
+#define DISK_FILE_SECTOR_COUNT DISK_FILE_CONF_SECTOR_COUNT
+#else
+#define DISK_FILE_SECTOR_COUNT 8192
+#endif
+
+/** The size of a sector in bytes. */
+#define DISK_FILE_SECTOR_SIZE 512
+
+/**
+ * Disk driver storing the sectors of drive 0 in a disk image file of
+ * the host. The image is extended to the full disk size when the
+ * driver is initialized.
+ */
+extern const struct disk_driver disk_file_driver;
+
+#endif /* DISK_FILE_H_ */
+
+/** @} */
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+/**
+ * \addtogroup native-fat
+ * @{
+ *
+ * \file
+ * Implementation of the default port of FatFs on the native platform.
+ */
+#include "diskio.h"
+#include "disk-file.h"
+
+#include <time.h>
+
+/*----------------------------------------------------------------------------*/
+static DRESULT
+convert_result(disk_result_t result)
+{
+  switch(result) {
+  default:
+  case DISK_RESULT_NO_INIT:
+  case DISK_RESULT_IO_ERROR: return RES_ERROR;
+  case DISK_RESULT_OK: return RES_OK;
+  case DISK_RESULT_WR_PROTECTED: return RES_WRPRT;
+  case DISK_RESULT_INVALID_ARG: return RES_PARERR;
+  }
+}
+/*----------------------------------------------------------------------------*/
+DSTATUS __attribute__((__weak__))
+disk_status(BYTE pdrv)
+{
+  return ~disk_file_driver.status(pdrv);
+}
+/*----------------------------------------------------------------------------*/
+DSTATUS __attribute__((__weak__))
+disk_initialize(BYTE pdrv)
+{
+  return ~disk_file_driver.initialize(pdrv);
+}
+/*----------------------------------------------------------------------------*/
+DRESULT __attribute__((__weak__))
+disk_read(BYTE pdrv, BYTE *buff, DWORD sector, UINT count)
+{
+  return convert_result(disk_file_driver.read(pdrv, buff, sector, count));
+}
+/*----------------------------------------------------------------------------*/
+DRESULT __attribute__((__weak__))
+disk_write(BYTE pdrv, const BYTE *buff, DWORD sector, UINT count)
+{
+  return convert_result(disk_file_driver.write(pdrv, buff, sector, count));
+}
+/*----------------------------------------------------------------------------*/
+DRESULT __attribute__((__weak__))
+disk_ioctl(BYTE pdrv, BYTE cmd, void *buff)
+{
+  return convert_result(disk_file_driver.ioctl(pdrv, cmd, buff));
+}
+/*----------------------------------------------------------------------------*/
+DWORD __attribute__((__weak__))
+get_fattime(void)
+{
+  time_t now;
+  struct tm *tm;
+
+  now = time(NULL);
+  tm = localtime(&now);
+  if(tm == NULL || tm->tm_year < 80) {
+    return 0;
+  }
+  return (DWORD)(tm->tm_year - 80) << 25 | (DWORD)(tm->tm_mon + 1) << 21 |
+    (DWORD)tm->tm_mday << 16 | (DWORD)tm->tm_hour << 11 |
+    (DWORD)tm->tm_min << 5 | (DWORD)tm->tm_sec / 2;
+}
+/*----------------------------------------------------------------------------*/
+
+/** @} */
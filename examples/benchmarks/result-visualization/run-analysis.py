@@ -2,9 +2,12 @@
 
 import os
 import sys
-import time
 import matplotlib.pyplot as pl
 
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                "..", "..", "..", "tools", "log-analysis"))
+import contikilog
+
 ###########################################
 
 # If set to true, all nodes are plotted, even those with no valid data
@@ -148,53 +151,26 @@ def extract_ipaddr_pair(fields):
     fields = s.split(" -> ")
     return extract_ipaddr(fields[0]), extract_ipaddr(fields[1])
 
-def addr_to_id(addr):
-    return int(addr.split(":")[-1], 16)
-
 ###########################################
 # Parse a log file
 
-def analyze_results(filename, is_testbed):
+LOG_MODULES = {"TSCH", "TSCH Queue", "RPL", "App", "Link Stats", "Energest"}
+
+def analyze_results(filename):
     nodes = {}
 
-    in_initialization = True
-
-    start_ts_unix = None
-
-    with open(filename, "r") as f:
-        for line in f:
-            line = line.strip()
-            if is_testbed:
-                fields1 = line.split(";")
-                fields2 = fields1[2].split()
-                fields = fields1[:2] + fields2
-            else:
-                fields = line.split()
-
-            try:
-                # in milliseconds
-                if is_testbed:
-                    ts_unix = float(fields[0])
-                    if start_ts_unix is None:
-                        start_ts_unix = ts_unix
-                    ts_unix -= start_ts_unix
-                    ts = int(float(ts_unix) * 1000)
-                    node = int(fields[1][3:])
-                else:
-                    ts = int(fields[0]) // 1000 # convert to ms
-                    node = int(fields[1]) 
-            except:
-                # failed to extract timestamp
-                continue
+    with contikilog.open_log(filename) as f:
+        for record in contikilog.read_records(f, modules=LOG_MODULES):
+            node = record.node
+            line = record.message
+            fields = line.split()
 
             if node not in nodes:
                 nodes[node] = NodeStats(node)
 
             if "association done" in line:
-                # has_assoc.add(node)
-                #nodes[node].seqnums = set()
                 if nodes[node].tsch_join_time_sec is None:
-                    nodes[node].tsch_join_time_sec = ts / 1000
+                    nodes[node].tsch_join_time_sec = record.time
                 nodes[node].is_tsch_joined = True
                 continue
 
@@ -203,55 +179,52 @@ def analyze_results(filename, is_testbed):
                 nodes[node].energest_joined = False
                 continue
 
-            # 536000 2 [INFO: TSCH Queue] update time source: (NULL LL addr) -> 0001.0001.0001.0001
+            # update time source: (NULL LL addr) -> 0001.0001.0001.0001
             if "update time source" in line:
                 nodes[node].tsch_time_source = extract_macaddr(line.split(" -> ")[1])
                 continue
 
-            # 2497128 2 [INFO: RPL       ] rpl_set_preferred_parent fe80::201:1:1:1 used to be NULL
+            # rpl_set_preferred_parent fe80::201:1:1:1 used to be NULL
             if "rpl_set_preferred_parent" in line:
                 nodes[node].rpl_parent_changes += 1
-                nodes[node].rpl_parent = extract_ipaddr(fields[6])
+                nodes[node].rpl_parent = extract_ipaddr(fields[1])
                 if nodes[node].rpl_join_time_sec is None:
-                    nodes[node].rpl_join_time_sec = ts / 1000
+                    nodes[node].rpl_join_time_sec = record.time
                 continue
 
-            # 377018480 76 [INFO: RPL       ] parent switch: (NULL IP addr) -> fe80::244:44:44:44
-            if " parent switch: " in line:
+            # parent switch: (NULL IP addr) -> fe80::244:44:44:44
+            if line.startswith("parent switch: "):
                 nodes[node].rpl_parent_changes += 1
-                nodes[node].rpl_parent = extract_ipaddr_pair(fields[7:])[1]
+                nodes[node].rpl_parent = extract_ipaddr_pair(fields[2:])[1]
                 if nodes[node].rpl_join_time_sec is None:
-                    nodes[node].rpl_join_time_sec = ts / 1000
+                    nodes[node].rpl_join_time_sec = record.time
                 continue
 
-            # 120904000 4 [INFO: App       ] app generate packet seqnum=1
+            # app generate packet seqnum=1 node_id=4
             if "app generate packet" in line:
-                seqnum = int(fields[8].split("=")[1])
-                if is_testbed:
-                    node_id = int(fields[9].split("=")[1])
+                seqnum = int(fields[3].split("=")[1])
+                if len(fields) > 4:
+                    node_id = int(fields[4].split("=")[1])
                     node_id_to_device_id[node_id] = node
                 nodes[node].max_seqnum_sent = max(nodes[node].max_seqnum_sent, seqnum)
                 continue
 
-            # 123047424 1 [INFO: App       ] app receive packet seqnum=1 from=fd00::208:8:8:8
+            # app receive packet seqnum=1 from=fd00::208:8:8:8
             if "app receive packet" in line:
-                seqnum = int(fields[8].split("=")[1])
-                fromaddr = fields[9].split("=")[1]
-                from_node = addr_to_id(fromaddr)
-                if is_testbed:
-                    from_node = node_id_to_device_id.get(from_node, 0)
+                seqnum = int(fields[3].split("=")[1])
+                from_node = contikilog.node_id(fields[4].split("=")[1])
+                from_node = node_id_to_device_id.get(from_node, from_node)
                 if from_node not in nodes:
                     nodes[from_node] = NodeStats(from_node)
                 nodes[from_node].seqnums_received_on_root.add(seqnum)
                 continue
 
-            # 600142000 28 [INFO: Link Stats] num packets: tx=0 ack=0 rx=0 queue_drops=0 to=0014.0014.0014.0014
-            if "num packets" in line:
-                tx = int(fields[7].split("=")[1])
-                ack = int(fields[8].split("=")[1])
-                rx = int(fields[9].split("=")[1])
-                queue_drops = int(fields[10].split("=")[1])
-                to_addr = fields[11].split("=")[1]
+            # num packets: tx=0 ack=0 rx=0 queue_drops=0 to=0014.0014.0014.0014
+            if line.startswith("num packets"):
+                tx = int(fields[2].split("=")[1])
+                ack = int(fields[3].split("=")[1])
+                queue_drops = int(fields[5].split("=")[1])
+                to_addr = fields[6].split("=")[1]
                 # only account for the (current) time source node
                 if nodes[node].tsch_time_source == to_addr:
                     nodes[node].parent_packets_tx += tx
@@ -259,39 +232,42 @@ def analyze_results(filename, is_testbed):
                     nodes[node].parent_packets_queue_dropped += queue_drops
                 continue
 
-            # 960073000 8 [INFO: Energest  ] Total time  :   60000000
-            # 960073000 8 [INFO: Energest  ] CPU         :   60000000/  60000000 (69 permil)
-            # 960073000 8 [INFO: Energest  ] LPM         :          0/  60000000 (0 permil)
-            # 960073000 8 [INFO: Energest  ] Deep LPM    :          0/  60000000 (0 permil)
-            # 960073000 8 [INFO: Energest  ] Radio Tx    :      49216/  60000000 (0 permil)
-            # 960073000 8 [INFO: Energest  ] Radio Rx    :    2470552/  60000000 (41 permil)
-            # 960073000 8 [INFO: Energest  ] Radio total :    2519768/  60000000 (41 permil)
-            if "INFO: Energest" in line:
-                if "Period" in line:
-                    nodes[node].energest_period_seconds = int(fields[9][1:])
-                elif "Total time" in line:
-                    total = int(fields[8])
-                    nodes[node].energest_total += total
-                    nodes[node].energest_ticks_per_second = total / nodes[node].energest_period_seconds
-                    if nodes[node].energest_joined:
-                        nodes[node].energest_total_joined += total
-                else:
-                    ticks = int(fields[8][:-1])
-                    if "CPU" in line:
-                        nodes[node].energest_cpu_on += ticks
-                    elif "Deep LPM" in line:
-                        nodes[node].energest_cpu_sleep += ticks
-                    elif "LPM" in line:
-                        nodes[node].energest_cpu_deep_sleep += ticks
-                    elif "Radio Tx" in line:
-                        nodes[node].energest_radio_tx += ticks
-                    elif "Radio Rx" in line:
-                        nodes[node].energest_radio_rx += ticks
-                        if nodes[node].energest_joined:
-                            nodes[node].energest_radio_rx_joined += ticks
-                        # update the state
-                        nodes[node].energest_joined = nodes[node].is_tsch_joined
+            # --- Period summary #2 (60 seconds)
+            # Total time  :   60000000
+            # CPU         :   60000000/  60000000 (69 permil)
+            # LPM         :          0/  60000000 (0 permil)
+            # Deep LPM    :          0/  60000000 (0 permil)
+            # Radio Tx    :      49216/  60000000 (0 permil)
+            # Radio Rx    :    2470552/  60000000 (41 permil)
+            # Radio total :    2519768/  60000000 (41 permil)
+            if record.module == "Energest":
+                m = contikilog.Energest.SUMMARY.match(line)
+                if m:
+                    nodes[node].energest_period_seconds = int(m.group(2))
                     continue
+                m = contikilog.Energest.VALUE.match(line)
+                if m is None:
+                    continue
+                name, ticks = m.group(1), int(m.group(2))
+                if name == "Total time":
+                    nodes[node].energest_total += ticks
+                    nodes[node].energest_ticks_per_second = ticks / nodes[node].energest_period_seconds
+                    if nodes[node].energest_joined:
+                        nodes[node].energest_total_joined += ticks
+                elif name == "CPU":
+                    nodes[node].energest_cpu_on += ticks
+                elif name == "LPM":
+                    nodes[node].energest_cpu_sleep += ticks
+                elif name == "Deep LPM":
+                    nodes[node].energest_cpu_deep_sleep += ticks
+                elif name == "Radio Tx":
+                    nodes[node].energest_radio_tx += ticks
+                elif name == "Radio Rx":
+                    nodes[node].energest_radio_rx += ticks
+                    if nodes[node].energest_joined:
+                        nodes[node].energest_radio_rx_joined += ticks
+                    # update the state
+                    nodes[node].energest_joined = nodes[node].is_tsch_joined
 
     r = []
     # link layer PAR
@@ -368,10 +344,7 @@ def main():
         print('The input file "{}" does not exist'.format(input_file))
         exit(-1)
 
-    with open(input_file, "r") as f:
-        is_testbed = "Starting COOJA logger" not in f.read()
-
-    results, ll_par, ll_queue_dropped, e2e_pdr = analyze_results(input_file, is_testbed)
+    results, ll_par, ll_queue_dropped, e2e_pdr = analyze_results(input_file)
 
     print("Link-layer PAR={:.2f} ({} packets queue dropped) End-to-end PDR={:.2f}".format(
         ll_par, ll_queue_dropped, e2e_pdr))
@@ -2,20 +2,14 @@
 
 import re
 import os
-import fileinput
-import math
-import yaml
-import pandas as pd
-from pandas import *
-from pylab import *
-from datetime import *
-from collections import OrderedDict
-from IPython import embed
-import matplotlib as mpl
-
-pd.set_option('display.max_rows', 48)
-pd.set_option('display.width', None)
-pd.set_option('display.max_columns', None)
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                "..", "..", "..", "tools", "log-analysis"))
+import contikilog
+
+# Width of the per-time bins, in seconds
+BIN_SECONDS = 120
 
 networkFormationTime = None
 parents = {}
@@ -75,51 +69,9 @@ def parseRPL(log):
         return {'event': 'DAGinit' }
     return None
 
-def parseEnergest(log):
-    res = re.compile('Radio Tx\s*:\s*(\d*)/\s*(\d+)').match(log)
-    if res:
-        tx = float(res.group(1))
-        total = float(res.group(2))
-        return {'channel-utilization': 100.*tx/total }
-    res = re.compile('Radio total\s*:\s*(\d*)/\s*(\d+)').match(log)
-    if res:
-        radio = float(res.group(1))
-        total = float(res.group(2))
-        return {'duty-cycle': 100.*radio/total }
-    return None
-
-def parseApp(log):
-    res = re.compile('Sending (.+?) (\d+) to 6G-(\d+)').match(log)
-    if res:
-        type = res.group(1)
-        id = int(res.group(2))
-        dest = int(res.group(3))
-        return {'event': 'send', 'type': type, 'id': id, 'node': dest }
-    res = re.compile('Received (.+?) (\d+) from 6G-(\d+)').match(log)
-    if res:
-        type = res.group(1)
-        id = int(res.group(2))
-        src = int(res.group(3))
-        return {'event': 'recv', 'type': type, 'id': id, 'src': src }
-    return None
-
-def parseLine(line):
-    res = re.compile('\s*([.\d]+)\\tID:(\d+)\\t\[(.*?):(.*?)\](.*)$').match(line)
-    if res:
-        time = float(res.group(1))
-        nodeid = int(res.group(2))
-        level = res.group(3).strip()
-        module = res.group(4).strip()
-        log = res.group(5).strip()
-        return time, nodeid, level, module, log
-    return None, None, None, None, None
-
 def doParse(file):
     global networkFormationTime
 
-    time = None
-    lastPrintedTime = 0
-
     arrays = {
         "packets": [],
         "energest": [],
@@ -130,51 +82,24 @@ def doParse(file):
         "topology": [],
     }
 
-#    print("\nProcessing %s" %(file))
-    # Filter out non-printable chars from log file
-    os.system("cat %s | tr -dc '[:print:]\n\t' | sponge %s" %(file, file))
-    for line in open(file, 'r').readlines():
-        # match time, id, module, log; The common format for all log lines
-        time, nodeid, level, module, log = parseLine(line)
-
-        if time == None:
-            # malformed line
-            continue
-
-        if time - lastPrintedTime >= 60:
-#            print("%u, "%(time / 60),end='', flush=True)
-            lastPrintedTime = time
-
-        entry = {
-            "timestamp": timedelta(seconds=time),
-            "node": nodeid,
-        }
-
-        try:
-            if module == "App":
-                ret = parseApp(log)
-                if(ret != None):
-                    entry.update(ret)
-                    if(ret['event'] == 'send' and ret['type'] == 'request'):
-                        # populate series of sent requests
-                        entry['pdr'] = 0.
-                        arrays["packets"].append(entry)
-                        if networkFormationTime == None:
-                            networkFormationTime = time
-                    elif(ret['event'] == 'recv' and ret['type'] == 'response'):
-                        # update sent request series with latency and PDR
-                        txElement = [x for x in arrays["packets"] if x['event']=='send' and x['id']==ret['id']][0]
-                        txElement['latency'] = time - txElement['timestamp'].seconds
-                        txElement['pdr'] = 100.
-
-            if module == "Energest":
-                ret = parseEnergest(log)
-                if(ret != None):
-                    entry.update(ret)
-                    arrays["energest"].append(entry)
-
-            if module == "RPL":
-                ret = parseRPL(log)
+    packets = contikilog.Packets()
+    energest = contikilog.Energest()
+    with contikilog.open_log(file) as f:
+        for record in contikilog.read_records(f, modules={"App", "Energest", "RPL"}):
+            if record.module == "App":
+                packets.feed(record)
+                continue
+            if record.module == "Energest":
+                energest.feed(record)
+                continue
+
+            entry = {
+                "timestamp": record.time,
+                "node": record.node,
+            }
+
+            try:
+                ret = parseRPL(record.message)
                 if(ret != None):
                     entry.update(ret)
                     if(ret['event'] == 'rank'):
@@ -195,39 +120,68 @@ def doParse(file):
                             nodeEntry["hops"] = calculateHops(n)
                             nodeEntry["children"] = calculateChildren(n)
                             arrays["topology"].append(nodeEntry)
-        except: # typical exception: failed str conversion to int, due to lossy logs
-            print("Exception: %s" %(str(sys.exc_info()[0])))
+            except: # typical exception: failed str conversion to int, due to lossy logs
+                print("Exception: %s" %(str(sys.exc_info()[0])))
+                continue
+
+    columns, rows = packets.tables()["packets"]
+    for row in sorted(rows, key=lambda row: row[columns.index("sent")]):
+        packet = dict(zip(columns, row))
+        arrays["packets"].append({
+            "timestamp": packet["sent"],
+            "node": packet["dst"],
+            "pdr": 100. if packet["received"] is not None else 0.,
+            "latency": packet["latency"],
+        })
+    if arrays["packets"]:
+        networkFormationTime = arrays["packets"][0]["timestamp"]
+    # Remove last few packets -- might be in-flight when test stopped
+    arrays["packets"] = arrays["packets"][0:-10]
+
+    columns, rows = energest.tables()["energest"]
+    for row in rows:
+        period = dict(zip(columns, row))
+        if not period["total"]:
             continue
+        arrays["energest"].append({
+            "timestamp": period["time"],
+            "node": period["node"],
+            "channel-utilization": 100. * period["radio_tx"] / period["total"],
+            "duty-cycle": period["duty_cycle"],
+        })
 
-#    print("")
+    return {key: array for key, array in arrays.items() if len(array) > 0}
 
-    # Remove last few packets -- might be in-flight when test stopped
-    arrays["packets"] = arrays["packets"][0:-10]
+def mean(values):
+    values = [x for x in values if x is not None]
+    return sum(values) / len(values) if values else None
 
-    dfs = {}
-    for key in arrays.keys():
-        if(len(arrays[key]) > 0):
-            df = DataFrame(arrays[key])
-            dfs[key] = df.set_index("timestamp")
+def aggregate(values, agg):
+    return mean(values) if agg == "mean" else len(values)
 
-    return dfs
+def formatValue(x):
+    return "null" if x is None else "%.4f"%(x)
 
 def outputStats(dfs, key, metric, agg, name, metricLabel = None):
     if not key in dfs:
         return
 
-    df = dfs[key]
-    perNode = getattr(df.groupby("node")[metric], agg)()
-    perTime = getattr(df.groupby([pd.Grouper(freq="2Min")])[metric], agg)()
+    entries = dfs[key]
+    perNode = {}
+    perTime = {}
+    for entry in entries:
+        perNode.setdefault(entry["node"], []).append(entry[metric])
+        perTime.setdefault(int(entry["timestamp"] // BIN_SECONDS), []).append(entry[metric])
+    bins = range(min(perTime), max(perTime) + 1)
 
     print("  %s:" %(metricLabel if metricLabel != None else metric))
     print("    name: %s" %(name))
     print("    per-node:")
-    print("      x: [%s]" %(", ".join(["%u"%x for x in sort(df.node.unique())])))
-    print("      y: [%s]" %(', '.join(["%.4f"%(x) for x in perNode])))
+    print("      x: [%s]" %(", ".join(["%u"%x for x in sorted(perNode)])))
+    print("      y: [%s]" %(', '.join([formatValue(aggregate(perNode[x], agg)) for x in sorted(perNode)])))
     print("    per-time:")
-    print("      x: [%s]" %(", ".join(["%u"%x for x in range(0, 2*len(df.groupby([pd.Grouper(freq="2Min")]).mean().index), 2)])))
-    print("      y: [%s]" %(', '.join(["%.4f"%(x) for x in perTime]).replace("nan", "null")))
+    print("      x: [%s]" %(", ".join(["%u"%x for x in range(0, 2*len(bins), 2)])))
+    print("      y: [%s]" %(', '.join([formatValue(aggregate(perTime.get(x, []), agg)) for x in bins])))
 
 def main():
     if len(sys.argv) < 2:
@@ -239,16 +193,21 @@ def main():
     dfs = doParse(file)
 
     if len(dfs) == 0:
+        print("No records found in %s" %(file), file=sys.stderr)
         return
 
+    def column(key, metric):
+        return [entry[metric] for entry in dfs.get(key, [])]
+
+    pdr = column("packets", "pdr")
     print("global-stats:")
-    print("  pdr: %.4f" %(dfs["packets"]["pdr"].mean()))
-    print("  loss-rate: %.e" %(1-(dfs["packets"]["pdr"].mean()/100)))
-    print("  packets-sent: %u" %(dfs["packets"]["pdr"].count()))
-    print("  packets-received: %u" %(dfs["packets"]["pdr"].sum()/100))
-    print("  latency: %.4f" %(dfs["packets"]["latency"].mean()))
-    print("  duty-cycle: %.2f" %(dfs["energest"]["duty-cycle"].mean()))
-    print("  channel-utilization: %.2f" %(dfs["energest"]["channel-utilization"].mean()))
+    print("  pdr: %.4f" %(mean(pdr)))
+    print("  loss-rate: %.e" %(1-(mean(pdr)/100)))
+    print("  packets-sent: %u" %(len(pdr)))
+    print("  packets-received: %u" %(sum(pdr)/100))
+    print("  latency: %.4f" %(mean(column("packets", "latency"))))
+    print("  duty-cycle: %.2f" %(mean(column("energest", "duty-cycle"))))
+    print("  channel-utilization: %.2f" %(mean(column("energest", "channel-utilization"))))
     print("  network-formation-time: %.2f" %(networkFormationTime))
     print("stats:")
 
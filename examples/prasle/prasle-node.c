@@ -42,7 +42,7 @@
 #include "sys/log.h"
 #include "sys/node-id.h"
 #include "dev/moteid.h"
-#include "random.h"
+#include "lib/prng.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdbool.h>
@@ -364,7 +364,9 @@ PROCESS_THREAD(prasle_process, ev, data)
   nullnet_set_input_callback(input_callback);
 
   /* Small random delay to avoid synchronized starts */
-  etimer_set(&round_timer, (random_rand() % CLOCK_SECOND) + CLOCK_SECOND);
+  etimer_set(&round_timer,
+             prng_range(prng_stream(PRNG_STREAM_APP),
+                        CLOCK_SECOND, 2 * CLOCK_SECOND - 1));
   PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&round_timer));
 
   start_time = clock_time();
@@ -60,6 +60,25 @@ extern const struct slip_radio_sensors SLIP_RADIO_CONF_SENSORS;
 uint8_t packet_ids[16];
 int packet_pos;
 
+/*
+ * The number of packets that the host may have in flight. The serial
+ * line input buffer holds only a few packets, so this is kept small.
+ */
+#ifdef SLIP_RADIO_CONF_CREDITS
+#define SLIP_RADIO_CREDITS SLIP_RADIO_CONF_CREDITS
+#else
+#define SLIP_RADIO_CREDITS 4
+#endif
+
+#if SLIP_RADIO_CREDITS > 16
+#error SLIP_RADIO_CREDITS must not exceed the number of packet ids.
+#endif
+
+/* The number of packets given to the MAC layer and not yet reported. */
+static uint8_t in_flight;
+/* The number of "!S" packets received from the host, modulo 256. */
+static uint8_t received;
+
 static int slip_radio_cmd_handler(const uint8_t *data, int len);
 
 int cmd_handler_cc2420(const uint8_t *data, int len);
@@ -109,6 +128,15 @@ parse_frame(void)
   return 0;
 }
 /*---------------------------------------------------------------------------*/
+static int
+add_credits(uint8_t *buf, int pos)
+{
+  buf[pos++] = in_flight < SLIP_RADIO_CREDITS ?
+    SLIP_RADIO_CREDITS - in_flight : 0;
+  buf[pos++] = received;
+  return pos;
+}
+/*---------------------------------------------------------------------------*/
 static void
 packet_sent(void *ptr, int status, int transmissions)
 {
@@ -126,6 +154,10 @@ packet_sent(void *ptr, int status, int transmissions)
   buf[pos++] = sid;
   buf[pos++] = status; /* one byte ? */
   buf[pos++] = transmissions;
+  if(in_flight > 0) {
+    in_flight--;
+  }
+  pos = add_credits(buf, pos);
   cmd_send(buf, pos);
 }
 /*---------------------------------------------------------------------------*/
@@ -139,6 +171,7 @@ slip_radio_cmd_handler(const uint8_t *data, int len)
     if(data[1] == 'S') {
       int pos;
       packet_ids[packet_pos] = data[2];
+      received++;
 
       packetbuf_clear();
       pos = packetutils_deserialize_atts(&data[3], len - 3);
@@ -159,6 +192,7 @@ slip_radio_cmd_handler(const uint8_t *data, int len)
 
       /* parse frame before sending to get addresses, etc. */
       parse_frame();
+      in_flight++;
       NETSTACK_MAC.send(packet_sent, &packet_ids[packet_pos]);
 
       packet_pos++;
@@ -199,6 +233,12 @@ slip_radio_cmd_handler(const uint8_t *data, int len)
       uip_len = 10;
       cmd_send(uip_buf, uip_len);
       return 1;
+    } else if(data[1] == 'F') {
+      uint8_t buf[4];
+      buf[0] = '!';
+      buf[1] = 'F';
+      cmd_send(buf, add_credits(buf, 2));
+      return 1;
     } else if(data[1] == 'V') {
       /* ask the radio about the specific parameter and send it back... */
       int type = ((uint16_t)data[2] << 8) | data[3];
@@ -240,6 +280,8 @@ init(void)
   process_start(&slip_process, NULL);
   slip_set_input_callback(slip_input_callback);
   packet_pos = 0;
+  in_flight = 0;
+  received = 0;
 }
 /*---------------------------------------------------------------------------*/
 PROCESS(slip_radio_process, "Slip radio process");
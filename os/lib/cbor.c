@@ -456,5 +456,304 @@ cbor_read_map(cbor_reader_state_t *state)
   return read_array_or_map(state);
 }
 /*---------------------------------------------------------------------------*/
+/* Decodes the head of the item at cbor, without checking its major type,
+   and returns a pointer past it or NULL if the head is invalid. */
+static const uint8_t *
+read_head(const uint8_t *cbor, const uint8_t *end,
+          uint64_t *value, bool *indefinite)
+{
+  uint_fast8_t additional_information = *cbor++ & ~0xE0;
+  size_t bytes_to_read;
+
+  *indefinite = false;
+  if(additional_information < CBOR_SIZE_1) {
+    *value = additional_information;
+    return cbor;
+  }
+  switch(additional_information) {
+  case CBOR_SIZE_1:
+    bytes_to_read = 1;
+    break;
+  case CBOR_SIZE_2:
+    bytes_to_read = 2;
+    break;
+  case CBOR_SIZE_4:
+    bytes_to_read = 4;
+    break;
+  case CBOR_SIZE_8:
+    bytes_to_read = 8;
+    break;
+  case CBOR_SIZE_INDEFINITE:
+    *indefinite = true;
+    *value = 0;
+    return cbor;
+  default:
+    return NULL;
+  }
+  if(bytes_to_read > (size_t)(end - cbor)) {
+    return NULL;
+  }
+  *value = 0;
+  while(bytes_to_read--) {
+    *value = (*value << 8) | *cbor++;
+  }
+  return cbor;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns a pointer past the given number of consecutive items at cbor,
+   or NULL if they are malformed, truncated, or too deeply nested. */
+static const uint8_t *
+skip(const uint8_t *cbor, const uint8_t *end, size_t items)
+{
+  /* items that remain to be skipped in each enclosing array or map, where
+     SIZE_MAX stands for an indefinite number of items */
+  size_t remaining[CBOR_MAX_NESTING];
+  size_t depth = 0;
+  uint_fast8_t initial_byte;
+  uint64_t value;
+  bool indefinite;
+
+  while(items || depth) {
+    if(!items) {
+      items = remaining[--depth];
+      continue;
+    }
+    if(cbor == end) {
+      return NULL;
+    }
+    initial_byte = *cbor;
+    if(initial_byte == CBOR_BREAK) {
+      if(items != SIZE_MAX) {
+        return NULL;
+      }
+      cbor++;
+      items = depth ? remaining[--depth] : 0;
+      continue;
+    }
+    if(items != SIZE_MAX) {
+      items--;
+    }
+    if(initial_byte < CBOR_MAJOR_TYPE_BYTE_STRING
+       && (initial_byte & ~0xE0) < CBOR_SIZE_1) {
+      /* small integers make up most of a typical payload */
+      cbor++;
+      continue;
+    }
+    cbor = read_head(cbor, end, &value, &indefinite);
+    if(!cbor) {
+      return NULL;
+    }
+
+    switch(initial_byte & 0xE0) {
+    case CBOR_MAJOR_TYPE_UNSIGNED:
+    case CBOR_MAJOR_TYPE_SIGNED:
+    case CBOR_MAJOR_TYPE_SIMPLE:
+      if(indefinite) {
+        return NULL;
+      }
+      break;
+    case CBOR_MAJOR_TYPE_TAG:
+      if(indefinite) {
+        return NULL;
+      }
+      /* the tagged item follows */
+      if(items != SIZE_MAX) {
+        items++;
+      }
+      break;
+    case CBOR_MAJOR_TYPE_BYTE_STRING:
+    case CBOR_MAJOR_TYPE_TEXT_STRING:
+      if(!indefinite) {
+        if(value > (uint64_t)(end - cbor)) {
+          return NULL;
+        }
+        cbor += value;
+        break;
+      }
+      /* the chunks are skipped like the elements of an array */
+      /* fall through */
+    case CBOR_MAJOR_TYPE_ARRAY:
+    case CBOR_MAJOR_TYPE_MAP:
+      if(!indefinite) {
+        /* each item takes at least one byte */
+        if(value > (uint64_t)(end - cbor)) {
+          return NULL;
+        }
+        if((initial_byte & 0xE0) == CBOR_MAJOR_TYPE_MAP) {
+          value *= 2;
+        }
+        if(!value) {
+          break;
+        }
+      }
+      /* no need to come back to a level that has no items left */
+      if(items) {
+        if(depth == CBOR_MAX_NESTING) {
+          return NULL;
+        }
+        remaining[depth++] = items;
+      }
+      items = indefinite ? SIZE_MAX : (size_t)value;
+      break;
+    }
+  }
+  return cbor;
+}
+/*---------------------------------------------------------------------------*/
+bool
+cbor_skip(cbor_reader_state_t *state)
+{
+  const uint8_t *next;
+
+  if(!state->cbor_size) {
+    return false;
+  }
+  next = skip(state->cbor, state->cbor + state->cbor_size, 1);
+  if(!next) {
+    return false;
+  }
+  state->cbor_size -= next - state->cbor;
+  state->cbor = next;
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+const uint8_t *
+cbor_read_item(cbor_reader_state_t *state, size_t *item_size)
+{
+  const uint8_t *beginning = state->cbor;
+
+  if(!cbor_skip(state)) {
+    return NULL;
+  }
+  *item_size = state->cbor - beginning;
+  return beginning;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+read_key(cbor_reader_state_t *state,
+         const cbor_path_element_t *element, bool *match)
+{
+  cbor_reader_state_t key_reader = *state;
+  const char *text;
+  size_t text_size;
+  int64_t key;
+
+  if(!cbor_skip(state)) {
+    return false;
+  }
+
+  switch(cbor_peek_next(&key_reader)) {
+  case CBOR_MAJOR_TYPE_TEXT_STRING:
+    text = element->text ? cbor_read_text(&key_reader, &text_size) : NULL;
+    *match = text
+             && (text_size == element->text_size)
+             && !memcmp(text, element->text, text_size);
+    break;
+  case CBOR_MAJOR_TYPE_UNSIGNED:
+  case CBOR_MAJOR_TYPE_SIGNED:
+    *match = !element->text
+             && (cbor_read_signed(&key_reader, &key) != CBOR_SIZE_NONE)
+             && (key == element->key);
+    break;
+  default:
+    *match = false;
+    break;
+  }
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+at_end(cbor_reader_state_t *state, bool indefinite,
+       uint64_t index, uint64_t length)
+{
+  if(indefinite) {
+    return !state->cbor_size || (*state->cbor == CBOR_BREAK);
+  }
+  return index >= length;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+find_element(cbor_reader_state_t *state, const cbor_path_element_t *element)
+{
+  const uint8_t *next;
+  uint64_t length;
+  uint64_t index;
+  cbor_major_type_t major_type;
+  bool indefinite;
+  bool match;
+
+  if(!state->cbor_size) {
+    return false;
+  }
+  next = read_head(state->cbor, state->cbor + state->cbor_size,
+                   &length, &indefinite);
+  if(!next) {
+    return false;
+  }
+  major_type = *state->cbor & 0xE0;
+  state->cbor_size -= next - state->cbor;
+  state->cbor = next;
+
+  switch(major_type) {
+  case CBOR_MAJOR_TYPE_ARRAY:
+    if(element->text || (element->key < 0)) {
+      return false;
+    }
+    if(!indefinite) {
+      /* the preceding elements are skipped in one go */
+      if((uint64_t)element->key >= length) {
+        return false;
+      }
+      next = skip(state->cbor, state->cbor + state->cbor_size,
+                  (size_t)element->key);
+      if(!next) {
+        return false;
+      }
+      state->cbor_size -= next - state->cbor;
+      state->cbor = next;
+      return true;
+    }
+    for(index = 0; !at_end(state, indefinite, index, length); index++) {
+      if(index == (uint64_t)element->key) {
+        return true;
+      }
+      if(!cbor_skip(state)) {
+        return false;
+      }
+    }
+    return false;
+  case CBOR_MAJOR_TYPE_MAP:
+    for(index = 0; !at_end(state, indefinite, index, length); index++) {
+      if(!read_key(state, element, &match)) {
+        return false;
+      }
+      if(match) {
+        return true;
+      }
+      if(!cbor_skip(state)) {
+        return false;
+      }
+    }
+    return false;
+  default:
+    return false;
+  }
+}
+/*---------------------------------------------------------------------------*/
+bool
+cbor_find(cbor_reader_state_t *state,
+          const cbor_path_element_t *path, size_t path_length)
+{
+  cbor_reader_state_t reader = *state;
+
+  while(path_length--) {
+    if(!find_element(&reader, path++)) {
+      return false;
+    }
+  }
+  *state = reader;
+  return true;
+}
+/*---------------------------------------------------------------------------*/
 
 /** @} */
@@ -80,6 +80,7 @@ typedef enum cbor_major_type_t {
   CBOR_MAJOR_TYPE_TEXT_STRING = 0x60,
   CBOR_MAJOR_TYPE_ARRAY = 0x80,
   CBOR_MAJOR_TYPE_MAP = 0xA0,
+  CBOR_MAJOR_TYPE_TAG = 0xC0,
   CBOR_MAJOR_TYPE_SIMPLE = 0xE0,
 } cbor_major_type_t;
 
@@ -103,8 +104,14 @@ typedef enum cbor_size_t {
   CBOR_SIZE_2 = 0x19,  /**< 2 bytes */
   CBOR_SIZE_4 = 0x1A,  /**< 4 bytes */
   CBOR_SIZE_8 = 0x1B,  /**< 8 bytes */
+  CBOR_SIZE_INDEFINITE = 0x1F, /**< indefinite length */
 } cbor_size_t;
 
+/**
+ * The "break" stop code that terminates indefinite-length items.
+ */
+#define CBOR_BREAK (0xFF)
+
 /**
  * Structure of a nesting record.
  */
@@ -132,6 +139,26 @@ typedef struct cbor_reader_state_t {
   size_t cbor_size;
 } cbor_reader_state_t;
 
+/**
+ * Structure of an element of a path to a nested data item.
+ *
+ * Within an array, \c key is the index of the element. Within a map, the
+ * element is the value of the entry whose key is the text string \c text,
+ * or the integer \c key if \c text is \c NULL.
+ */
+typedef struct cbor_path_element_t {
+  const char *text;
+  size_t text_size;
+  int64_t key;
+} cbor_path_element_t;
+
+/** Path element that selects an array element by its index. */
+#define CBOR_PATH_INDEX(index) { NULL, 0, (index) }
+/** Path element that selects a map entry by its integer key. */
+#define CBOR_PATH_KEY(key) { NULL, 0, (key) }
+/** Path element that selects a map entry by a text string literal key. */
+#define CBOR_PATH_TEXT(text) { (text), sizeof(text) - 1, 0 }
+
 /**
  * Prepares for writing CBOR output.
  *
@@ -363,6 +390,50 @@ size_t cbor_read_array(cbor_reader_state_t *state);
  */
 size_t cbor_read_map(cbor_reader_state_t *state);
 
+/**
+ * Skips the next data item, including all data items nested in it.
+ *
+ * Indefinite-length strings, arrays, and maps, tags, and floating-point
+ * values are skipped as well, although the other reading functions do not
+ * support them. Nothing is copied; the reader just moves past the item.
+ *
+ * \param state State of the CBOR reader.
+ *
+ * \return      \c true on success, or \c false if the item is malformed,
+ *              truncated, or nested deeper than \c CBOR_MAX_NESTING levels.
+ */
+bool cbor_skip(cbor_reader_state_t *state);
+
+/**
+ * Reads the encoding of the next data item as a whole.
+ *
+ * \param state     State of the CBOR reader.
+ * \param item_size Size of the encoded item in bytes.
+ *
+ * \return          First byte of the encoded item within the CBOR input,
+ *                  or \c NULL on error.
+ */
+const uint8_t *cbor_read_item(cbor_reader_state_t *state, size_t *item_size);
+
+/**
+ * Moves to a data item nested in the next data item.
+ *
+ * The arrays and maps along the path may have definite or indefinite
+ * lengths. Map keys and array elements that precede the ones on the path
+ * are skipped with cbor_skip(), so that only the headers of the enclosing
+ * items are decoded.
+ *
+ * \param state       State of the CBOR reader.
+ * \param path        Path from the next data item to the nested data item.
+ * \param path_length Number of elements in \p path.
+ *
+ * \return            \c true if the reader was moved to the nested data
+ *                    item, or \c false if it does not exist or on error, in
+ *                    which case the reader is left unchanged.
+ */
+bool cbor_find(cbor_reader_state_t *state,
+               const cbor_path_element_t *path, size_t path_length);
+
 /** @} */
 /** @} */
 
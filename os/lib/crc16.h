@@ -55,6 +55,40 @@
 #ifndef CRC16_H_
 #define CRC16_H_
 
+#include "contiki.h"
+
+/** Compute the CRC one bit at a time, without tables (the default) */
+#define CRC16_METHOD_BITWISE    0
+/** Compute the CRC one byte at a time with a 512-byte table */
+#define CRC16_METHOD_TABLE      1
+/** Compute the CRC four bytes at a time with 2 KB of tables */
+#define CRC16_METHOD_SLICE_BY_4 4
+/** Compute the CRC eight bytes at a time with 4 KB of tables */
+#define CRC16_METHOD_SLICE_BY_8 8
+
+/**
+ * The software implementation of crc16_add() and crc16_data(), which
+ * trades code size for throughput. All methods produce the same CRC.
+ */
+#ifdef CRC16_CONF_METHOD
+#define CRC16_METHOD CRC16_CONF_METHOD
+#else
+#define CRC16_METHOD CRC16_METHOD_BITWISE
+#endif
+
+/**
+ * A platform can set CRC16_CONF_ACCEL to the name of a function with
+ * the prototype of crc16_data() that uses a CRC peripheral, which
+ * crc16_data() then calls. The peripheral must compute the same
+ * CRC-16/CCITT with reflected input and output and without a final
+ * XOR, continuing from the accumulated CRC.
+ */
+#ifdef CRC16_CONF_ACCEL
+#define CRC16_ACCEL CRC16_CONF_ACCEL
+unsigned short CRC16_ACCEL(const unsigned char *data, int datalen,
+                           unsigned short acc);
+#endif
+
 /**
  * \brief      Update an accumulated CRC16 checksum with one byte.
  * \param b    The byte to be added to the checksum
@@ -65,7 +99,7 @@
  *             with one byte. It can be used as a running checksum, or
  *             to checksum an entire data block.
  *
- *             \note The algorithm used in this implementation is
+ *             \note With CRC16_METHOD_BITWISE, the algorithm is
  *             tailored for a running checksum and does not perform as
  *             well as a table-driven algorithm when checksumming an
  *             entire data block.
@@ -82,10 +116,9 @@ unsigned short crc16_add(unsigned char b, unsigned short crc);
  *
  *             This function calculates the CRC16 checksum of a data area.
  *
- *             \note The algorithm used in this implementation is
- *             tailored for a running checksum and does not perform as
- *             well as a table-driven algorithm when checksumming an
- *             entire data block.
+ *             \note Set CRC16_CONF_METHOD to a table-driven method, or
+ *             CRC16_CONF_ACCEL to a CRC peripheral, for checksumming
+ *             large data areas quickly.
  */
 unsigned short crc16_data(const unsigned char *data, int datalen,
 			  unsigned short acc);
@@ -65,46 +65,38 @@ dbl_circ_list_head(const_dbl_circ_list_t dblcl)
 void *
 dbl_circ_list_tail(const_dbl_circ_list_t dblcl)
 {
-  struct dblcl *this;
-
   if(*dblcl == NULL) {
     return NULL;
   }
 
-  for(this = *dblcl; this->next != *dblcl; this = this->next);
-
-  return this;
+  /* The list is circular, so the tail precedes the head. */
+  return ((struct dblcl *)*dblcl)->previous;
 }
 /*---------------------------------------------------------------------------*/
 void
 dbl_circ_list_remove(dbl_circ_list_t dblcl, const void *element)
 {
-  struct dblcl *this;
-
-  if(*dblcl == NULL || element == NULL) {
+  struct dblcl *this = (struct dblcl *)element;
+
+  /*
+   * Every element on a circular list has a successor, and elements
+   * that are removed get their pointers cleared, so an element that
+   * is not on the list is recognized without searching the list.
+   */
+  if(*dblcl == NULL || this == NULL || this->next == NULL) {
     return;
   }
 
-  this = *dblcl;
+  this->previous->next = this->next;
+  this->next->previous = this->previous;
 
-  do {
-    if(this == element) {
-      this->previous->next = this->next;
-      this->next->previous = this->previous;
-
-      /* We need to update the head of the list if we removed the head */
-      if(*dblcl == element) {
-        *dblcl = this->next == this ? NULL : this->next;
-      }
-
-      this->next = NULL;
-      this->previous = NULL;
-
-      return;
-    }
+  /* We need to update the head of the list if we removed the head */
+  if(*dblcl == element) {
+    *dblcl = this->next == this ? NULL : this->next;
+  }
 
-    this = this->next;
-  } while(this != *dblcl);
+  this->next = NULL;
+  this->previous = NULL;
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -45,6 +45,13 @@
  * These fields will be used by the library to maintain the list. Application
  * code must not modify these fields directly.
  *
+ * An element that is not on a list must have a \e next field set to NULL,
+ * which is the case for zero-initialized elements and for elements that
+ * have been removed from a list. This lets all operations except
+ * dbl_circ_list_length() run in constant time, since the list does not have
+ * to be searched for an element that is to be removed or moved. An element
+ * must not be on more than one list at a time.
+ *
  * Functions that modify the list (add / remove) will, in the general case,
  * update the list's head and item order. If you call one of these functions
  * as part of a list traversal, it is advised to stop / restart traversing
@@ -78,7 +85,7 @@
  */
 #define DBL_CIRC_LIST(name) \
   static void *name##_dbl_circ_list = NULL; \
-  static dbl_list_t name = (dbl_circ_list_t)&name##_dbl_circ_list
+  static dbl_circ_list_t name = (dbl_circ_list_t)&name##_dbl_circ_list
 /*---------------------------------------------------------------------------*/
 /**
  * The doubly-linked circular list datatype
@@ -86,6 +86,50 @@
 #define HEAPMEM_REALLOC 1
 #endif /* HEAPMEM_CONF_REALLOC */
 
+/*
+ * The HEAPMEM_CONF_SEGREGATED_FIT parameter selects the segregated-fit
+ * allocation mode (non-zero value), in which free chunks are kept in
+ * one list per size class instead of in a single list. Small
+ * allocations are then served in constant time, and free chunks are
+ * coalesced when they are deallocated rather than before each
+ * allocation.
+ */
+#ifdef HEAPMEM_CONF_SEGREGATED_FIT
+#define HEAPMEM_SEGREGATED_FIT HEAPMEM_CONF_SEGREGATED_FIT
+#else
+#define HEAPMEM_SEGREGATED_FIT 0
+#endif /* HEAPMEM_CONF_SEGREGATED_FIT */
+
+#if HEAPMEM_SEGREGATED_FIT
+/*
+ * The HEAPMEM_CONF_SMALL_CLASSES parameter sets the number of exact
+ * size classes, each holding chunks of a single size: one alignment
+ * unit, two alignment units, and so on. Larger chunks are kept in
+ * HEAPMEM_CONF_LARGE_CLASSES classes whose size ranges double in
+ * size, the last one holding all chunks that do not fit elsewhere.
+ */
+#ifdef HEAPMEM_CONF_SMALL_CLASSES
+#define SMALL_CLASSES HEAPMEM_CONF_SMALL_CLASSES
+#else
+#define SMALL_CLASSES 8
+#endif /* HEAPMEM_CONF_SMALL_CLASSES */
+
+#ifdef HEAPMEM_CONF_LARGE_CLASSES
+#define LARGE_CLASSES HEAPMEM_CONF_LARGE_CLASSES
+#else
+#define LARGE_CLASSES 8
+#endif /* HEAPMEM_CONF_LARGE_CLASSES */
+
+#if SMALL_CLASSES < 1 || LARGE_CLASSES < 1 || SMALL_CLASSES + LARGE_CLASSES > 32
+#error HeapMem must have 2 to 32 size classes, with at least one small and one large.
+#endif
+
+#define FREE_LISTS (SMALL_CLASSES + LARGE_CLASSES)
+#define SMALL_SIZE_MAX (SMALL_CLASSES * HEAPMEM_ALIGNMENT)
+#else
+#define FREE_LISTS 1
+#endif /* HEAPMEM_SEGREGATED_FIT */
+
 #if __STDC_VERSION__ >= 201112L
 #include <stdalign.h>
 #define HEAPMEM_DEFAULT_ALIGNMENT alignof(max_align_t)
@@ -139,6 +183,8 @@ struct heapmem_zone {
   const char *name;
   size_t zone_size;
   size_t allocated;
+  size_t max_allocated;
+  unsigned failures;
 };
 
 #ifdef HEAPMEM_CONF_MAX_ZONES
@@ -159,26 +205,46 @@ static struct heapmem_zone zones[HEAPMEM_MAX_ZONES] = {
  * We use a double-linked list of chunks, with a slight space overhead
  * compared to a single-linked list, but with the advantage of having
  * much faster list removals.
+ *
+ * The structure is aligned to HEAPMEM_ALIGNMENT, which pads its size
+ * to a multiple of the alignment where the fields do not add up to
+ * one, e.g., with the debug fields on 32-bit platforms.
  */
-typedef struct chunk {
+typedef struct CC_ALIGN(HEAPMEM_ALIGNMENT) chunk {
   struct chunk *prev;
   struct chunk *next;
   size_t size;
   uint8_t flags;
   heapmem_zone_t zone;
 #if HEAPMEM_DEBUG
-  const char *file;
+  /* The line is placed right after the zone, where it fills the
+     padding on 64-bit platforms. */
   unsigned line;
+  const char *file;
+  clock_time_t time;
 #endif
 } chunk_t;
 
+/* The data of a chunk starts right after its header, and the chunk
+   sizes are multiples of the alignment, so the header size must be
+   one as well for the data and the following chunks to be aligned. */
+static_assert(sizeof(chunk_t) % HEAPMEM_ALIGNMENT == 0,
+              "The chunk header size must be a multiple of HEAPMEM_ALIGNMENT");
+
 /* All allocated space is located within a heap, which is
    statically allocated with a configurable size. */
 static char heap_base[HEAPMEM_ARENA_SIZE] CC_ALIGN(HEAPMEM_ALIGNMENT);
 static size_t heap_usage;
 static size_t max_heap_usage;
 
-static chunk_t *free_list;
+/* The free lists, indexed by size class. Without the segregated-fit
+   mode, there is a single list that holds all free chunks. */
+static chunk_t *free_lists[FREE_LISTS];
+
+#if HEAPMEM_SEGREGATED_FIT
+/* A bitmap of the size classes whose free lists are not empty. */
+static uint32_t nonempty_lists;
+#endif
 
 #define IN_HEAP(ptr) ((ptr) != NULL && \
                      (char *)(ptr) >= (char *)heap_base) && \
@@ -202,24 +268,44 @@ extend_space(size_t size)
   return old_usage;
 }
 
-/* free_chunk: Mark a chunk as being free, and put it on the free list. */
+/* size_class: Get the index of the free list that holds chunks of
+   the specified size. */
+static unsigned
+size_class(size_t size)
+{
+#if HEAPMEM_SEGREGATED_FIT
+  if(size <= SMALL_SIZE_MAX) {
+    return (size - 1) / HEAPMEM_ALIGNMENT;
+  }
+
+  unsigned class = SMALL_CLASSES;
+  for(size_t limit = 2 * SMALL_SIZE_MAX;
+      size > limit && class < FREE_LISTS - 1;
+      limit *= 2) {
+    class++;
+  }
+  return class;
+#else
+  return 0;
+#endif /* HEAPMEM_SEGREGATED_FIT */
+}
+
+/* insert_chunk_in_free_list: Put a free chunk first in the free list
+   of its size class. */
 static void
-free_chunk(chunk_t * const chunk)
+insert_chunk_in_free_list(chunk_t * const chunk)
 {
-  chunk->flags &= ~CHUNK_FLAG_ALLOCATED;
+  unsigned class = size_class(chunk->size);
 
-  if(IS_LAST_CHUNK(chunk)) {
-    /* Release the chunk back into the wilderness. */
-    heap_usage -= sizeof(chunk_t) + chunk->size;
-  } else {
-    /* Put the chunk on the free list. */
-    chunk->prev = NULL;
-    chunk->next = free_list;
-    if(free_list != NULL) {
-      free_list->prev = chunk;
-    }
-    free_list = chunk;
+  chunk->prev = NULL;
+  chunk->next = free_lists[class];
+  if(free_lists[class] != NULL) {
+    free_lists[class]->prev = chunk;
   }
+  free_lists[class] = chunk;
+#if HEAPMEM_SEGREGATED_FIT
+  nonempty_lists |= (uint32_t)1 << class;
+#endif
 }
 
 /* remove_chunk_from_free_list: Mark a chunk as being allocated, and
@@ -227,10 +313,16 @@ free_chunk(chunk_t * const chunk)
 static void
 remove_chunk_from_free_list(chunk_t * const chunk)
 {
-  if(chunk == free_list) {
-    free_list = chunk->next;
-    if(free_list != NULL) {
-      free_list->prev = NULL;
+  unsigned class = size_class(chunk->size);
+
+  if(chunk == free_lists[class]) {
+    free_lists[class] = chunk->next;
+    if(free_lists[class] != NULL) {
+      free_lists[class]->prev = NULL;
+#if HEAPMEM_SEGREGATED_FIT
+    } else {
+      nonempty_lists &= ~((uint32_t)1 << class);
+#endif
     }
   } else {
     chunk->prev->next = chunk->next;
@@ -241,6 +333,33 @@ remove_chunk_from_free_list(chunk_t * const chunk)
   }
 }
 
+/* free_chunk: Mark a chunk as being free, and put it on the free list. */
+static void
+free_chunk(chunk_t * const chunk)
+{
+  chunk->flags &= ~CHUNK_FLAG_ALLOCATED;
+
+#if HEAPMEM_SEGREGATED_FIT
+  /* Merge the chunk with a bounded number of free chunks that follow
+     it, so that the free lists do not fill up with fragments. Any
+     remaining fragments are merged by defrag_heap() when needed. */
+  int i = CHUNK_SEARCH_MAX;
+  for(chunk_t *next = NEXT_CHUNK(chunk);
+      (char *)next < &heap_base[heap_usage] && CHUNK_FREE(next) && i-- > 0;
+      next = NEXT_CHUNK(next)) {
+    remove_chunk_from_free_list(next);
+    chunk->size += sizeof(chunk_t) + next->size;
+  }
+#endif /* HEAPMEM_SEGREGATED_FIT */
+
+  if(IS_LAST_CHUNK(chunk)) {
+    /* Release the chunk back into the wilderness. */
+    heap_usage -= sizeof(chunk_t) + chunk->size;
+  } else {
+    insert_chunk_in_free_list(chunk);
+  }
+}
+
 /*
  * split_chunk: When allocating a chunk, we may have found one that is
  * larger than needed, so this function is called to keep the rest of
@@ -276,6 +395,97 @@ coalesce_chunks(chunk_t *chunk)
   }
 }
 
+#if HEAPMEM_SEGREGATED_FIT
+/* defrag_heap: Coalesce all adjacent free chunks in the heap, and
+   release the last chunk into the wilderness if it is free. */
+static void
+defrag_heap(void)
+{
+  chunk_t *last = NULL;
+
+  for(chunk_t *chunk = (chunk_t *)heap_base;
+      (char *)chunk < &heap_base[heap_usage];
+      chunk = NEXT_CHUNK(chunk)) {
+    if(CHUNK_FREE(chunk) && !IS_LAST_CHUNK(chunk) &&
+       CHUNK_FREE(NEXT_CHUNK(chunk))) {
+      /* The size class of the chunk changes when it grows. */
+      remove_chunk_from_free_list(chunk);
+      coalesce_chunks(chunk);
+      insert_chunk_in_free_list(chunk);
+    }
+    last = chunk;
+  }
+
+  if(last != NULL && CHUNK_FREE(last)) {
+    remove_chunk_from_free_list(last);
+    heap_usage -= sizeof(chunk_t) + last->size;
+  }
+}
+
+/* lowest_set_bit: Get the index of the lowest set bit in a non-zero
+   word. */
+static unsigned
+lowest_set_bit(uint32_t word)
+{
+#ifdef __GNUC__
+  return __builtin_ctzl(word);
+#else
+  unsigned bit = 0;
+  while((word & 1) == 0) {
+    word >>= 1;
+    bit++;
+  }
+  return bit;
+#endif
+}
+
+/*
+ * get_free_chunk: Take a chunk that can hold the requested size from
+ * the free lists. A small request is served from the head of the
+ * list of its size class, where all chunks have the same size. A
+ * large request searches a bounded number of chunks in its class for
+ * the best fit. If that fails, the first chunk of the smallest
+ * non-empty larger class is used, since any chunk in it is large
+ * enough.
+ */
+static chunk_t *
+get_free_chunk(const size_t size)
+{
+  unsigned class = size_class(size);
+  chunk_t *best = NULL;
+
+  if(size <= SMALL_SIZE_MAX) {
+    best = free_lists[class];
+  } else {
+    int i = CHUNK_SEARCH_MAX;
+    for(chunk_t *chunk = free_lists[class]; chunk != NULL; chunk = chunk->next) {
+      if(i-- == 0) {
+        break;
+      }
+      if(size <= chunk->size && (best == NULL || chunk->size < best->size)) {
+        best = chunk;
+        if(best->size == size) {
+          break;
+        }
+      }
+    }
+  }
+
+  if(best == NULL) {
+    uint32_t larger = nonempty_lists & ~(((uint32_t)2 << class) - 1);
+    if(larger != 0) {
+      best = free_lists[lowest_set_bit(larger)];
+    }
+  }
+
+  if(best != NULL) {
+    remove_chunk_from_free_list(best);
+    split_chunk(best, size);
+  }
+
+  return best;
+}
+#else /* HEAPMEM_SEGREGATED_FIT */
 /* defrag_chunks: Scan the free list for chunks that can be coalesced,
    and stop within a bounded time. */
 static void
@@ -283,7 +493,7 @@ defrag_chunks(void)
 {
   /* Limit the time we spend on searching the free list. */
   int i = CHUNK_SEARCH_MAX;
-  for(chunk_t *chunk = free_list; chunk != NULL; chunk = chunk->next) {
+  for(chunk_t *chunk = free_lists[0]; chunk != NULL; chunk = chunk->next) {
     if(i-- == 0) {
       break;
     }
@@ -302,7 +512,7 @@ get_free_chunk(const size_t size)
   chunk_t *best = NULL;
   /* Limit the time we spend on searching the free list. */
   int i = CHUNK_SEARCH_MAX;
-  for(chunk_t *chunk = free_list; chunk != NULL; chunk = chunk->next) {
+  for(chunk_t *chunk = free_lists[0]; chunk != NULL; chunk = chunk->next) {
     if(i-- == 0) {
       break;
     }
@@ -329,6 +539,16 @@ get_free_chunk(const size_t size)
 
   return best;
 }
+#endif /* HEAPMEM_SEGREGATED_FIT */
+
+/* update_max_allocated: Record the highest allocation of a zone. */
+static void
+update_max_allocated(heapmem_zone_t zone)
+{
+  if(zones[zone].allocated > zones[zone].max_allocated) {
+    zones[zone].max_allocated = zones[zone].allocated;
+  }
+}
 
 /*
  * heapmem_zone_register: Register a new zone, which is essentially a
@@ -381,6 +601,11 @@ heapmem_zone_register(const char *name, size_t zone_size)
  *
  * As a last resort, heapmem_alloc() will try to extend the heap
  * space, and thereby create a new chunk available for use.
+ *
+ * In the segregated-fit mode, the free lists are searched as
+ * described for get_free_chunk(). Only if neither the free lists nor
+ * the heap space can satisfy the request, all free chunks are
+ * coalesced and the allocation is attempted once more.
  */
 void *
 #if HEAPMEM_DEBUG
@@ -404,13 +629,21 @@ heapmem_zone_alloc(heapmem_zone_t zone, size_t size)
   if(sizeof(chunk_t) + size >
      zones[zone].zone_size - zones[zone].allocated) {
     LOG_ERR("Cannot allocate %zu bytes because of the zone limit\n", size);
+    zones[zone].failures++;
     return NULL;
   }
 
   chunk_t *chunk = get_free_chunk(size);
+#if HEAPMEM_SEGREGATED_FIT
+  if(chunk == NULL && sizeof(chunk_t) + size > HEAPMEM_ARENA_SIZE - heap_usage) {
+    defrag_heap();
+    chunk = get_free_chunk(size);
+  }
+#endif /* HEAPMEM_SEGREGATED_FIT */
   if(chunk == NULL) {
     chunk = extend_space(sizeof(chunk_t) + size);
     if(chunk == NULL) {
+      zones[zone].failures++;
       return NULL;
     }
     chunk->size = size;
@@ -421,12 +654,16 @@ heapmem_zone_alloc(heapmem_zone_t zone, size_t size)
 #if HEAPMEM_DEBUG
   chunk->file = file;
   chunk->line = line;
+  chunk->time = clock_time();
 #endif
 
   LOG_DBG("%s ptr %p size %zu\n", __func__, GET_PTR(chunk), size);
 
   chunk->zone = zone;
-  zones[zone].allocated += sizeof(chunk_t) + size;
+  /* A free chunk that was too small to split is larger than the
+     request, and it is freed with its full size. */
+  zones[zone].allocated += sizeof(chunk_t) + chunk->size;
+  update_max_allocated(zone);
 
   return GET_PTR(chunk);
 }
@@ -532,16 +769,18 @@ heapmem_realloc(void *ptr, size_t size)
 #if HEAPMEM_DEBUG
   chunk->file = file;
   chunk->line = line;
+  chunk->time = clock_time();
 #endif
 
   size = ALIGN(size);
   int size_adj = size - chunk->size;
+  size_t old_size = chunk->size;
 
   if(size_adj <= 0) {
     /* Request to make the object smaller or to keep its size.
        In the former case, the chunk will be split if possible. */
     split_chunk(chunk, size);
-    zones[chunk->zone].allocated += size_adj;
+    zones[chunk->zone].allocated -= old_size - chunk->size;
     return ptr;
   }
 
@@ -555,6 +794,7 @@ heapmem_realloc(void *ptr, size_t size)
     if(extend_space(size_adj) != NULL) {
       chunk->size = size;
       zones[chunk->zone].allocated += size_adj;
+      update_max_allocated(chunk->zone);
       return ptr;
     }
   } else {
@@ -568,7 +808,8 @@ heapmem_realloc(void *ptr, size_t size)
       /* There was enough free adjacent space to extend the chunk in
 	 its current place. */
       split_chunk(chunk, size);
-      zones[chunk->zone].allocated += size_adj;
+      zones[chunk->zone].allocated += chunk->size - old_size;
+      update_max_allocated(chunk->zone);
       return ptr;
     }
   }
@@ -584,7 +825,17 @@ heapmem_realloc(void *ptr, size_t size)
     return NULL;
   }
 
-  memcpy(newptr, ptr, chunk->size);
+#if HEAPMEM_DEBUG
+  /* Attribute the new chunk to the caller rather than to this
+     function. */
+  GET_CHUNK(newptr)->file = file;
+  GET_CHUNK(newptr)->line = line;
+#endif
+
+  memcpy(newptr, ptr, old_size);
+  /* The chunk may have grown through coalescing, but its zone was
+     only charged for the old size. */
+  zones[chunk->zone].allocated -= sizeof(chunk_t) + old_size;
   free_chunk(chunk);
 
   return newptr;
@@ -618,25 +869,81 @@ heapmem_calloc(size_t nmemb, size_t size)
 void
 heapmem_stats(heapmem_stats_t *stats)
 {
+  /* The number of bytes, headers included, in the current run of
+     adjacent free chunks. */
+  size_t free_run = 0;
+
   memset(stats, 0, sizeof(*stats));
 
+  /* The heap is not modified here. A run of free chunks is counted as
+     the single chunk it becomes when it is coalesced, and a run at the
+     end of the heap as part of the wilderness. */
   for(chunk_t *chunk = (chunk_t *)heap_base;
       (char *)chunk < &heap_base[heap_usage];
       chunk = NEXT_CHUNK(chunk)) {
     if(CHUNK_ALLOCATED(chunk)) {
+      if(free_run > 0) {
+        stats->available += free_run - sizeof(chunk_t);
+        free_run = 0;
+      }
       stats->allocated += chunk->size;
       stats->overhead += sizeof(chunk_t);
     } else {
-      coalesce_chunks(chunk);
-      stats->available += chunk->size;
+      free_run += sizeof(chunk_t) + chunk->size;
     }
   }
-  stats->available += HEAPMEM_ARENA_SIZE - heap_usage;
-  stats->footprint = heap_usage;
+  stats->footprint = heap_usage - free_run;
+  stats->available += HEAPMEM_ARENA_SIZE - stats->footprint;
   stats->max_footprint = max_heap_usage;
   stats->chunks = stats->overhead / sizeof(chunk_t);
 }
 
+/* heapmem_zone_stats: Provides statistics regarding a zone. */
+bool
+heapmem_zone_stats(heapmem_zone_t zone, heapmem_zone_stats_t *stats)
+{
+  if(zone >= HEAPMEM_MAX_ZONES || zones[zone].name == NULL) {
+    return false;
+  }
+
+  stats->name = zones[zone].name;
+  stats->zone_size = zones[zone].zone_size;
+  stats->allocated = zones[zone].allocated;
+  stats->max_allocated = zones[zone].max_allocated;
+  stats->failures = zones[zone].failures;
+  return true;
+}
+
+#if HEAPMEM_DEBUG
+/* heapmem_chunk_next: Finds the allocated chunk following the one in
+   the info object, and fills in the object with its information. */
+bool
+heapmem_chunk_next(heapmem_chunk_info_t *info)
+{
+  chunk_t *chunk;
+
+  if(info->ptr == NULL) {
+    chunk = (chunk_t *)heap_base;
+  } else {
+    chunk = NEXT_CHUNK(GET_CHUNK(info->ptr));
+  }
+
+  for(; (char *)chunk < &heap_base[heap_usage]; chunk = NEXT_CHUNK(chunk)) {
+    if(CHUNK_ALLOCATED(chunk)) {
+      info->ptr = GET_PTR(chunk);
+      info->size = chunk->size;
+      info->zone = chunk->zone;
+      info->file = chunk->file;
+      info->line = chunk->line;
+      info->age = clock_time() - chunk->time;
+      return true;
+    }
+  }
+
+  return false;
+}
+#endif /* HEAPMEM_DEBUG */
+
 /* heapmem_print_stats: Print all the statistics collected through the
    heapmem_stats function. */
 void
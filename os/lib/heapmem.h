@@ -45,6 +45,12 @@
  * adds some memory overhead compared to a single-linked list, it
  * improves the performance of list management.
  *
+ * By setting HEAPMEM_CONF_SEGREGATED_FIT to 1, the free chunks are
+ * instead kept in one list per size class. Small allocations then
+ * take constant time, and fragmentation is reduced under workloads
+ * that mix many object sizes, at the cost of a few more bytes of
+ * static memory for the list heads.
+ *
  * Internally, allocated chunks can be retrieved using the pointer to
  * the allocated memory returned by heapmem_alloc() and
  * heapmem_realloc(), because the chunk structure immediately precedes
@@ -98,6 +104,27 @@ typedef uint8_t heapmem_zone_t;
 #define HEAPMEM_ZONE_INVALID (heapmem_zone_t)-1
 #define HEAPMEM_ZONE_GENERAL 0
 /*****************************************************************************/
+typedef struct heapmem_zone_stats {
+  const char *name;
+  size_t zone_size;
+  size_t allocated;
+  size_t max_allocated;
+  unsigned failures;
+} heapmem_zone_stats_t;
+/*****************************************************************************/
+#if HEAPMEM_DEBUG
+/* Information about an allocated chunk, as obtained through
+   heapmem_chunk_next(). */
+typedef struct heapmem_chunk_info {
+  void *ptr;
+  size_t size;
+  heapmem_zone_t zone;
+  const char *file;
+  unsigned line;
+  clock_time_t age;
+} heapmem_chunk_info_t;
+#endif /* HEAPMEM_DEBUG */
+/*****************************************************************************/
 
 /**
  * \brief      Register a zone with a reserved subdivision of the heap.
@@ -219,6 +246,37 @@ bool heapmem_free(void *ptr);
  */
 void heapmem_stats(heapmem_stats_t *stats);
 
+/**
+ * \brief       Obtain the statistics of a heapmem zone.
+ * \param zone  The ID of the zone.
+ * \param stats A pointer to an object of type heapmem_zone_stats_t,
+ *              which will be filled when calling this function.
+ * \return      true if the zone is registered, false otherwise.
+ *
+ * Besides the current allocation of the zone, the statistics include
+ * the highest allocation reached and the number of allocation
+ * requests that could not be satisfied, either because of the zone
+ * limit or because the heap was exhausted.
+ */
+bool heapmem_zone_stats(heapmem_zone_t zone, heapmem_zone_stats_t *stats);
+
+#if HEAPMEM_DEBUG
+/**
+ * \brief       Iterate over the allocated chunks.
+ * \param info  A pointer to an object of type heapmem_chunk_info_t.
+ *              Its ptr field must be set to NULL to obtain the first
+ *              chunk, and is left unchanged when obtaining the next
+ *              chunk.
+ * \return      true if info was filled with the next allocated chunk,
+ *              false if there are no more chunks.
+ *
+ * The chunk information includes the source file and line of the
+ * call that allocated the chunk, and the time elapsed since then.
+ * The heap must not be modified while iterating over it.
+ */
+bool heapmem_chunk_next(heapmem_chunk_info_t *info);
+#endif /* HEAPMEM_DEBUG */
+
 /**
  * \brief              Print debugging information for the heap memory
  *                     management.
@@ -0,0 +1,486 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         A streaming JSON tokenizer.
+ */
+
+#include "jsonstream.h"
+#include <string.h>
+
+/* what may come next outside of a token */
+enum {
+  EXPECT_VALUE,
+  EXPECT_FIRST_VALUE,
+  EXPECT_NAME,
+  EXPECT_FIRST_NAME,
+  EXPECT_COLON,
+  EXPECT_COMMA,
+  EXPECT_END
+};
+
+/* the token that is being read */
+enum {
+  TOKEN_NONE,
+  TOKEN_STRING,
+  TOKEN_ESCAPE,
+  TOKEN_UNICODE,
+  TOKEN_NUMBER,
+  TOKEN_LITERAL
+};
+
+/*--------------------------------------------------------------------*/
+static int
+fail(struct jsonstream_state *state, int error)
+{
+  state->error = error;
+  return error;
+}
+/*--------------------------------------------------------------------*/
+static int
+report(struct jsonstream_state *state, int type, const char *value,
+       int len, int last)
+{
+  if(state->callback(state, type, value, len, last)) {
+    return fail(state, JSON_ERROR_ABORTED);
+  }
+  return JSON_ERROR_OK;
+}
+/*--------------------------------------------------------------------*/
+static bool
+in_object(struct jsonstream_state *state)
+{
+  return (state->stack[(state->depth - 1) / 8] >> ((state->depth - 1) % 8)) & 1;
+}
+/*--------------------------------------------------------------------*/
+static int
+push(struct jsonstream_state *state, int type)
+{
+  uint8_t mask;
+
+  if(state->depth == JSONSTREAM_MAX_DEPTH) {
+    return fail(state, JSON_ERROR_TOO_DEEP);
+  }
+  mask = 1 << (state->depth % 8);
+  if(type == JSON_TYPE_OBJECT) {
+    state->stack[state->depth / 8] |= mask;
+    state->expect = EXPECT_FIRST_NAME;
+  } else {
+    state->stack[state->depth / 8] &= ~mask;
+    state->expect = EXPECT_FIRST_VALUE;
+  }
+  state->depth++;
+  return report(state, type, NULL, 0, 1);
+}
+/*--------------------------------------------------------------------*/
+static void
+value_done(struct jsonstream_state *state)
+{
+  state->token = TOKEN_NONE;
+  state->expect = state->depth ? EXPECT_COMMA : EXPECT_END;
+}
+/*--------------------------------------------------------------------*/
+static int
+pop(struct jsonstream_state *state, int type)
+{
+  state->depth--;
+  value_done(state);
+  return report(state, type, NULL, 0, 1);
+}
+/*--------------------------------------------------------------------*/
+/* check the number against the JSON grammar before reporting it */
+static int
+end_number(struct jsonstream_state *state)
+{
+  const char *c = state->buf;
+  const char *end = state->buf + state->count;
+
+  if(c < end && *c == '-') {
+    c++;
+  }
+  if(c < end && *c == '0') {
+    c++;
+  } else if(c < end && *c >= '1' && *c <= '9') {
+    while(c < end && *c >= '0' && *c <= '9') {
+      c++;
+    }
+  } else {
+    return fail(state, JSON_ERROR_SYNTAX);
+  }
+  if(c < end && *c == '.') {
+    if(++c == end || *c < '0' || *c > '9') {
+      return fail(state, JSON_ERROR_SYNTAX);
+    }
+    while(c < end && *c >= '0' && *c <= '9') {
+      c++;
+    }
+  }
+  if(c < end && (*c == 'e' || *c == 'E')) {
+    c++;
+    if(c < end && (*c == '+' || *c == '-')) {
+      c++;
+    }
+    if(c == end || *c < '0' || *c > '9') {
+      return fail(state, JSON_ERROR_SYNTAX);
+    }
+    while(c < end && *c >= '0' && *c <= '9') {
+      c++;
+    }
+  }
+  if(c != end) {
+    return fail(state, JSON_ERROR_SYNTAX);
+  }
+  value_done(state);
+  return report(state, JSON_TYPE_NUMBER, state->buf, state->count, 1);
+}
+/*--------------------------------------------------------------------*/
+static int
+string_type(struct jsonstream_state *state)
+{
+  return state->expect == EXPECT_COLON ? JSON_TYPE_PAIR_NAME
+                                       : JSON_TYPE_STRING;
+}
+/*--------------------------------------------------------------------*/
+/* report a decoded code point as UTF-8 */
+static int
+end_unicode(struct jsonstream_state *state)
+{
+  uint32_t code_point = state->code_point;
+  char utf8[4];
+  int len;
+
+  if(state->high_surrogate) {
+    if(code_point < 0xDC00 || code_point > 0xDFFF) {
+      return fail(state, JSON_ERROR_SYNTAX);
+    }
+    code_point = 0x10000 + ((uint32_t)(state->high_surrogate - 0xD800) << 10)
+                 + (code_point - 0xDC00);
+    state->high_surrogate = 0;
+  } else if(code_point >= 0xD800 && code_point <= 0xDBFF) {
+    /* the low surrogate must follow as another escape sequence */
+    state->high_surrogate = code_point;
+    state->token = TOKEN_STRING;
+    return JSON_ERROR_OK;
+  } else if(code_point >= 0xDC00 && code_point <= 0xDFFF) {
+    return fail(state, JSON_ERROR_SYNTAX);
+  }
+
+  if(code_point < 0x80) {
+    utf8[0] = code_point;
+    len = 1;
+  } else if(code_point < 0x800) {
+    utf8[0] = 0xC0 | (code_point >> 6);
+    utf8[1] = 0x80 | (code_point & 0x3F);
+    len = 2;
+  } else if(code_point < 0x10000) {
+    utf8[0] = 0xE0 | (code_point >> 12);
+    utf8[1] = 0x80 | ((code_point >> 6) & 0x3F);
+    utf8[2] = 0x80 | (code_point & 0x3F);
+    len = 3;
+  } else {
+    utf8[0] = 0xF0 | (code_point >> 18);
+    utf8[1] = 0x80 | ((code_point >> 12) & 0x3F);
+    utf8[2] = 0x80 | ((code_point >> 6) & 0x3F);
+    utf8[3] = 0x80 | (code_point & 0x3F);
+    len = 4;
+  }
+  state->token = TOKEN_STRING;
+  return report(state, string_type(state), utf8, len, 0);
+}
+/*--------------------------------------------------------------------*/
+static int
+escape(struct jsonstream_state *state, char c)
+{
+  char decoded;
+
+  if(state->high_surrogate && c != 'u') {
+    return fail(state, JSON_ERROR_SYNTAX);
+  }
+  switch(c) {
+  case '"':  decoded = '"';  break;
+  case '\\': decoded = '\\'; break;
+  case '/':  decoded = '/';  break;
+  case 'b':  decoded = '\b'; break;
+  case 'f':  decoded = '\f'; break;
+  case 'n':  decoded = '\n'; break;
+  case 'r':  decoded = '\r'; break;
+  case 't':  decoded = '\t'; break;
+  case 'u':
+    state->token = TOKEN_UNICODE;
+    state->code_point = 0;
+    state->count = 0;
+    return JSON_ERROR_OK;
+  default:
+    return fail(state, JSON_ERROR_SYNTAX);
+  }
+  state->token = TOKEN_STRING;
+  return report(state, string_type(state), &decoded, 1, 0);
+}
+/*--------------------------------------------------------------------*/
+static int
+hex_digit(struct jsonstream_state *state, char c)
+{
+  if(c >= '0' && c <= '9') {
+    c -= '0';
+  } else if(c >= 'a' && c <= 'f') {
+    c -= 'a' - 10;
+  } else if(c >= 'A' && c <= 'F') {
+    c -= 'A' - 10;
+  } else {
+    return fail(state, JSON_ERROR_SYNTAX);
+  }
+  state->code_point = (state->code_point << 4) | c;
+  if(++state->count == 4) {
+    return end_unicode(state);
+  }
+  return JSON_ERROR_OK;
+}
+/*--------------------------------------------------------------------*/
+static int
+literal(struct jsonstream_state *state, char c)
+{
+  int type;
+
+  if(c != state->literal[state->count]) {
+    return fail(state, JSON_ERROR_SYNTAX);
+  }
+  if(state->literal[++state->count] != '\0') {
+    return JSON_ERROR_OK;
+  }
+  type = state->literal[0];
+  value_done(state);
+  return report(state, type, state->literal, state->count, 1);
+}
+/*--------------------------------------------------------------------*/
+/* start a value, or end an empty array */
+static int
+value(struct jsonstream_state *state, char c)
+{
+  switch(c) {
+  case '{':
+  case '[':
+    return push(state, c);
+  case ']':
+    if(state->expect != EXPECT_FIRST_VALUE) {
+      return fail(state, JSON_ERROR_UNEXPECTED_END_OF_ARRAY);
+    }
+    return pop(state, c);
+  case '"':
+    state->token = TOKEN_STRING;
+    return JSON_ERROR_OK;
+  case 't':
+    state->literal = "true";
+    break;
+  case 'f':
+    state->literal = "false";
+    break;
+  case 'n':
+    state->literal = "null";
+    break;
+  default:
+    if(c == '-' || (c >= '0' && c <= '9')) {
+      state->token = TOKEN_NUMBER;
+      state->buf[0] = c;
+      state->count = 1;
+      return JSON_ERROR_OK;
+    }
+    return fail(state, JSON_ERROR_SYNTAX);
+  }
+  state->token = TOKEN_LITERAL;
+  state->count = 1;
+  return JSON_ERROR_OK;
+}
+/*--------------------------------------------------------------------*/
+static int
+structure(struct jsonstream_state *state, char c)
+{
+  switch(state->expect) {
+  case EXPECT_VALUE:
+  case EXPECT_FIRST_VALUE:
+    return value(state, c);
+  case EXPECT_NAME:
+  case EXPECT_FIRST_NAME:
+    if(c == '"') {
+      /* a name keeps EXPECT_COLON while it is read, which selects its type */
+      state->token = TOKEN_STRING;
+      state->expect = EXPECT_COLON;
+      return JSON_ERROR_OK;
+    }
+    if(c == '}' && state->expect == EXPECT_FIRST_NAME) {
+      return pop(state, c);
+    }
+    return fail(state, JSON_ERROR_SYNTAX);
+  case EXPECT_COLON:
+    if(c != ':') {
+      return fail(state, JSON_ERROR_SYNTAX);
+    }
+    state->expect = EXPECT_VALUE;
+    return JSON_ERROR_OK;
+  case EXPECT_COMMA:
+    if(c == ',') {
+      state->expect = in_object(state) ? EXPECT_NAME : EXPECT_VALUE;
+      return JSON_ERROR_OK;
+    }
+    if(c == '}') {
+      if(!in_object(state)) {
+        return fail(state, JSON_ERROR_UNEXPECTED_END_OF_OBJECT);
+      }
+      return pop(state, c);
+    }
+    if(c == ']') {
+      if(in_object(state)) {
+        return fail(state, JSON_ERROR_UNEXPECTED_END_OF_ARRAY);
+      }
+      return pop(state, c);
+    }
+    return fail(state, JSON_ERROR_SYNTAX);
+  default:
+    return fail(state, JSON_ERROR_SYNTAX);
+  }
+}
+/*--------------------------------------------------------------------*/
+void
+jsonstream_setup(struct jsonstream_state *state,
+                 jsonstream_callback_t callback, void *ptr)
+{
+  memset(state, 0, sizeof(*state));
+  state->callback = callback;
+  state->ptr = ptr;
+  state->expect = EXPECT_VALUE;
+  state->token = TOKEN_NONE;
+}
+/*--------------------------------------------------------------------*/
+int
+jsonstream_feed(struct jsonstream_state *state, const char *data, int len)
+{
+  const char *end = data + len;
+  const char *start;
+  char c;
+
+  while(data < end && state->error == JSON_ERROR_OK) {
+    switch(state->token) {
+    case TOKEN_NONE:
+      c = *data++;
+      if(c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+        structure(state, c);
+      }
+      break;
+    case TOKEN_STRING:
+      /* report unescaped runs directly from the chunk */
+      start = data;
+      while(data < end && *data != '"' && *data != '\\'
+            && (unsigned char)*data >= 0x20) {
+        data++;
+      }
+      if(start != data && state->high_surrogate) {
+        fail(state, JSON_ERROR_SYNTAX);
+        break;
+      }
+      if(data == end) {
+        if(start != data) {
+          report(state, string_type(state), start, data - start, 0);
+        }
+        break;
+      }
+      c = *data++;
+      if(c == '"') {
+        if(state->high_surrogate) {
+          fail(state, JSON_ERROR_SYNTAX);
+          break;
+        }
+        if(state->expect == EXPECT_COLON) {
+          state->token = TOKEN_NONE;
+          report(state, JSON_TYPE_PAIR_NAME, start, data - start - 1, 1);
+        } else {
+          value_done(state);
+          report(state, JSON_TYPE_STRING, start, data - start - 1, 1);
+        }
+      } else if(c == '\\') {
+        state->token = TOKEN_ESCAPE;
+        if(start != data - 1) {
+          report(state, string_type(state), start, data - start - 1, 0);
+        }
+      } else {
+        /* control characters must be escaped */
+        fail(state, JSON_ERROR_SYNTAX);
+      }
+      break;
+    case TOKEN_ESCAPE:
+      escape(state, *data++);
+      break;
+    case TOKEN_UNICODE:
+      hex_digit(state, *data++);
+      break;
+    case TOKEN_NUMBER:
+      while(data < end && (((c = *data) >= '0' && c <= '9') || c == '.'
+                           || c == 'e' || c == 'E' || c == '+' || c == '-')) {
+        if(state->count == JSONSTREAM_NUMBER_SIZE) {
+          fail(state, JSON_ERROR_TOO_LONG);
+          break;
+        }
+        state->buf[state->count++] = c;
+        data++;
+      }
+      if(data < end && state->error == JSON_ERROR_OK) {
+        /* the character that ends the number is read again */
+        end_number(state);
+      }
+      break;
+    case TOKEN_LITERAL:
+      literal(state, *data++);
+      break;
+    }
+  }
+  return state->error;
+}
+/*--------------------------------------------------------------------*/
+int
+jsonstream_finish(struct jsonstream_state *state)
+{
+  if(state->error != JSON_ERROR_OK) {
+    return state->error;
+  }
+  if(state->token == TOKEN_NUMBER && state->depth == 0) {
+    if(end_number(state) != JSON_ERROR_OK) {
+      return state->error;
+    }
+  }
+  if(state->token != TOKEN_NONE || state->expect != EXPECT_END) {
+    return fail(state, JSON_ERROR_SYNTAX);
+  }
+  return JSON_ERROR_OK;
+}
+/*--------------------------------------------------------------------*/
+int
+jsonstream_get_depth(struct jsonstream_state *state)
+{
+  return state->depth;
+}
+/*--------------------------------------------------------------------*/
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         A streaming JSON tokenizer.
+ *
+ *         The tokenizer is fed a document in chunks of any size, for
+ *         example as TCP segments arrive, and reports each token to a
+ *         callback as soon as it is complete. Strings are reported in
+ *         fragments that point into the chunk, so neither the document
+ *         nor its strings need to be buffered. The RAM used is that of
+ *         the state structure, whatever the size of the document.
+ */
+
+#ifndef JSONSTREAM_H_
+#define JSONSTREAM_H_
+
+#include "contiki.h"
+#include "json.h"
+
+#ifdef JSONSTREAM_CONF_MAX_DEPTH
+#define JSONSTREAM_MAX_DEPTH JSONSTREAM_CONF_MAX_DEPTH
+#else
+#define JSONSTREAM_MAX_DEPTH 32
+#endif /* JSONSTREAM_CONF_MAX_DEPTH */
+
+#if JSONSTREAM_MAX_DEPTH > 255
+#error JSONSTREAM_MAX_DEPTH must be at most 255.
+#endif
+
+/* the longest number that can be reported, in characters */
+#ifdef JSONSTREAM_CONF_NUMBER_SIZE
+#define JSONSTREAM_NUMBER_SIZE JSONSTREAM_CONF_NUMBER_SIZE
+#else
+#define JSONSTREAM_NUMBER_SIZE 24
+#endif /* JSONSTREAM_CONF_NUMBER_SIZE */
+
+struct jsonstream_state;
+
+/**
+ * \brief       A callback that receives the tokens of a document.
+ * \param state The tokenizer state.
+ * \param type  The type of the token: JSON_TYPE_OBJECT,
+ *              JSON_TYPE_ARRAY, '}', ']', JSON_TYPE_PAIR_NAME,
+ *              JSON_TYPE_STRING, JSON_TYPE_NUMBER, JSON_TYPE_TRUE,
+ *              JSON_TYPE_FALSE, or JSON_TYPE_NULL.
+ * \param value The characters of the token, with escape sequences
+ *              decoded. The pointer is only valid during the call.
+ * \param len   The number of characters in value.
+ * \param last  Zero if more fragments of a name or a string follow.
+ * \return      Zero to continue, or non-zero to stop tokenizing with
+ *              JSON_ERROR_ABORTED.
+ *
+ *              Names and strings may be reported in several fragments,
+ *              whose concatenation is the decoded string. All other
+ *              tokens are reported once, with last set.
+ */
+typedef int (* jsonstream_callback_t)(struct jsonstream_state *state,
+                                      int type, const char *value,
+                                      int len, int last);
+
+struct jsonstream_state {
+  jsonstream_callback_t callback;
+  void *ptr;
+  /* one bit per level, set for objects */
+  uint8_t stack[(JSONSTREAM_MAX_DEPTH + 7) / 8];
+  uint8_t depth;
+  uint8_t expect;
+  uint8_t token;
+  uint8_t count;
+  char error;
+  const char *literal;
+  uint16_t code_point;
+  uint16_t high_surrogate;
+  char buf[JSONSTREAM_NUMBER_SIZE];
+};
+
+/**
+ * \brief          Initialize a tokenizer state.
+ * \param state    A pointer to a tokenizer state.
+ * \param callback The callback that receives the tokens.
+ * \param ptr      A pointer that is kept in the state for the callback.
+ */
+void jsonstream_setup(struct jsonstream_state *state,
+                      jsonstream_callback_t callback, void *ptr);
+
+/**
+ * \brief       Tokenize the next chunk of a document.
+ * \param state A pointer to a tokenizer state.
+ * \param data  The chunk.
+ * \param len   The length of the chunk.
+ * \return      JSON_ERROR_OK, or the error that stopped the tokenizer.
+ *
+ *              Once an error has occurred, the state must be set up
+ *              again before tokenizing another document.
+ */
+int jsonstream_feed(struct jsonstream_state *state, const char *data,
+                    int len);
+
+/**
+ * \brief       Finish tokenizing a document.
+ * \param state A pointer to a tokenizer state.
+ * \return      JSON_ERROR_OK if the chunks formed a complete document,
+ *              or an error otherwise.
+ *
+ *              A number at the top level is reported here, since
+ *              only the end of the document terminates it.
+ */
+int jsonstream_finish(struct jsonstream_state *state);
+
+/* get the current depth of nested objects and arrays */
+int jsonstream_get_depth(struct jsonstream_state *state);
+
+#endif /* JSONSTREAM_H_ */
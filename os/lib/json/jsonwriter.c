@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         A JSON encoder that writes directly to a buffer.
+ */
+
+#include "jsonwriter.h"
+#include <string.h>
+
+/*--------------------------------------------------------------------*/
+static bool
+flush_buffer(struct jsonwriter *writer)
+{
+  if(writer->error != JSON_ERROR_OK) {
+    return false;
+  }
+  if(writer->flush == NULL) {
+    writer->error = JSON_ERROR_TOO_LONG;
+    return false;
+  }
+  if(writer->flush(writer, writer->buf, writer->pos)) {
+    writer->error = JSON_ERROR_ABORTED;
+    return false;
+  }
+  writer->flushed += writer->pos;
+  writer->pos = 0;
+  return true;
+}
+/*--------------------------------------------------------------------*/
+static void
+write_data(struct jsonwriter *writer, const char *data, int len)
+{
+  int n;
+
+  while(len > 0) {
+    if(writer->pos == writer->size && !flush_buffer(writer)) {
+      return;
+    }
+    n = writer->size - writer->pos;
+    if(n > len) {
+      n = len;
+    }
+    memcpy(writer->buf + writer->pos, data, n);
+    writer->pos += n;
+    data += n;
+    len -= n;
+  }
+}
+/*--------------------------------------------------------------------*/
+static void
+put(struct jsonwriter *writer, char c)
+{
+  if(writer->pos == writer->size && !flush_buffer(writer)) {
+    return;
+  }
+  writer->buf[writer->pos++] = c;
+}
+/*--------------------------------------------------------------------*/
+static bool
+get_bit(const uint8_t *bits, int level)
+{
+  return (bits[level / 8] >> (level % 8)) & 1;
+}
+/*--------------------------------------------------------------------*/
+static void
+set_bit(uint8_t *bits, int level, bool value)
+{
+  if(value) {
+    bits[level / 8] |= 1 << (level % 8);
+  } else {
+    bits[level / 8] &= ~(1 << (level % 8));
+  }
+}
+/*--------------------------------------------------------------------*/
+/* separate a value from the previous one */
+static void
+separate(struct jsonwriter *writer)
+{
+  int level = writer->depth - 1;
+
+  if(writer->after_name) {
+    writer->after_name = 0;
+    return;
+  }
+  if(writer->depth == 0) {
+    return;
+  }
+  if(get_bit(writer->values, level)) {
+    put(writer, ',');
+  } else {
+    set_bit(writer->values, level, true);
+  }
+}
+/*--------------------------------------------------------------------*/
+static void
+write_string(struct jsonwriter *writer, const char *text)
+{
+  static const char hex[] = "0123456789abcdef";
+  const char *start;
+  char escape[6];
+  unsigned char c;
+
+  put(writer, '"');
+  while(*text != '\0') {
+    /* copy runs that need no escaping in one go */
+    start = text;
+    while((c = *text) >= 0x20 && c != '"' && c != '\\') {
+      text++;
+    }
+    write_data(writer, start, text - start);
+    if(c == '\0') {
+      break;
+    }
+    escape[0] = '\\';
+    switch(c) {
+    case '"':  escape[1] = '"';  break;
+    case '\\': escape[1] = '\\'; break;
+    case '\b': escape[1] = 'b';  break;
+    case '\f': escape[1] = 'f';  break;
+    case '\n': escape[1] = 'n';  break;
+    case '\r': escape[1] = 'r';  break;
+    case '\t': escape[1] = 't';  break;
+    default:
+      escape[1] = 'u';
+      escape[2] = '0';
+      escape[3] = '0';
+      escape[4] = hex[c >> 4];
+      escape[5] = hex[c & 0xF];
+      write_data(writer, escape, 6);
+      text++;
+      continue;
+    }
+    write_data(writer, escape, 2);
+    text++;
+  }
+  put(writer, '"');
+}
+/*--------------------------------------------------------------------*/
+static void
+write_number(struct jsonwriter *writer, unsigned long value, bool negative)
+{
+  char digits[sizeof(unsigned long) * 3 + 1];
+  int i = sizeof(digits);
+
+  do {
+    digits[--i] = '0' + value % 10;
+    value /= 10;
+  } while(value);
+  if(negative) {
+    digits[--i] = '-';
+  }
+  write_data(writer, digits + i, sizeof(digits) - i);
+}
+/*--------------------------------------------------------------------*/
+static void
+open_level(struct jsonwriter *writer, bool object)
+{
+  separate(writer);
+  if(writer->depth == JSONWRITER_MAX_DEPTH) {
+    writer->error = JSON_ERROR_TOO_DEEP;
+    return;
+  }
+  set_bit(writer->objects, writer->depth, object);
+  set_bit(writer->values, writer->depth, false);
+  writer->depth++;
+  put(writer, object ? '{' : '[');
+}
+/*--------------------------------------------------------------------*/
+static void
+close_level(struct jsonwriter *writer, bool object)
+{
+  if(writer->depth == 0 || writer->after_name
+     || get_bit(writer->objects, writer->depth - 1) != object) {
+    writer->error = object ? JSON_ERROR_UNEXPECTED_END_OF_OBJECT
+                           : JSON_ERROR_UNEXPECTED_END_OF_ARRAY;
+    return;
+  }
+  writer->depth--;
+  put(writer, object ? '}' : ']');
+}
+/*--------------------------------------------------------------------*/
+void
+jsonwriter_setup(struct jsonwriter *writer, char *buf, int size,
+                 jsonwriter_flush_t flush, void *ptr)
+{
+  memset(writer, 0, sizeof(*writer));
+  writer->buf = buf;
+  writer->size = size;
+  writer->flush = flush;
+  writer->ptr = ptr;
+}
+/*--------------------------------------------------------------------*/
+void
+jsonwriter_object_start(struct jsonwriter *writer)
+{
+  open_level(writer, true);
+}
+/*--------------------------------------------------------------------*/
+void
+jsonwriter_object_end(struct jsonwriter *writer)
+{
+  close_level(writer, true);
+}
+/*--------------------------------------------------------------------*/
+void
+jsonwriter_array_start(struct jsonwriter *writer)
+{
+  open_level(writer, false);
+}
+/*--------------------------------------------------------------------*/
+void
+jsonwriter_array_end(struct jsonwriter *writer)
+{
+  close_level(writer, false);
+}
+/*--------------------------------------------------------------------*/
+void
+jsonwriter_name(struct jsonwriter *writer, const char *name)
+{
+  if(writer->depth == 0 || writer->after_name
+     || !get_bit(writer->objects, writer->depth - 1)) {
+    writer->error = JSON_ERROR_SYNTAX;
+    return;
+  }
+  separate(writer);
+  write_string(writer, name);
+  put(writer, ':');
+  writer->after_name = 1;
+}
+/*--------------------------------------------------------------------*/
+void
+jsonwriter_string(struct jsonwriter *writer, const char *text)
+{
+  separate(writer);
+  write_string(writer, text);
+}
+/*--------------------------------------------------------------------*/
+void
+jsonwriter_int(struct jsonwriter *writer, long value)
+{
+  separate(writer);
+  if(value < 0) {
+    write_number(writer, 0UL - (unsigned long)value, true);
+  } else {
+    write_number(writer, value, false);
+  }
+}
+/*--------------------------------------------------------------------*/
+void
+jsonwriter_uint(struct jsonwriter *writer, unsigned long value)
+{
+  separate(writer);
+  write_number(writer, value, false);
+}
+/*--------------------------------------------------------------------*/
+void
+jsonwriter_bool(struct jsonwriter *writer, int value)
+{
+  separate(writer);
+  if(value) {
+    write_data(writer, "true", 4);
+  } else {
+    write_data(writer, "false", 5);
+  }
+}
+/*--------------------------------------------------------------------*/
+void
+jsonwriter_null(struct jsonwriter *writer)
+{
+  separate(writer);
+  write_data(writer, "null", 4);
+}
+/*--------------------------------------------------------------------*/
+long
+jsonwriter_end(struct jsonwriter *writer)
+{
+  if(writer->depth != 0 || writer->after_name) {
+    writer->error = JSON_ERROR_SYNTAX;
+  }
+  if(writer->error != JSON_ERROR_OK) {
+    return -1;
+  }
+  if(writer->flush != NULL) {
+    if(writer->pos > 0 && !flush_buffer(writer)) {
+      return -1;
+    }
+  } else if(writer->pos < writer->size) {
+    writer->buf[writer->pos] = '\0';
+  }
+  return writer->flushed + writer->pos;
+}
+/*--------------------------------------------------------------------*/
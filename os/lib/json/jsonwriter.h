@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         A JSON encoder that writes directly to a buffer.
+ *
+ *         Values are written in document order, and commas, colons and
+ *         escape sequences are inserted as needed. When the buffer is
+ *         full, it is passed to a flush callback, for example one that
+ *         sends it over a socket, and reused. Documents larger than the
+ *         buffer can thereby be written without further RAM.
+ */
+
+#ifndef JSONWRITER_H_
+#define JSONWRITER_H_
+
+#include "contiki.h"
+#include "json.h"
+
+#ifdef JSONWRITER_CONF_MAX_DEPTH
+#define JSONWRITER_MAX_DEPTH JSONWRITER_CONF_MAX_DEPTH
+#else
+#define JSONWRITER_MAX_DEPTH 32
+#endif /* JSONWRITER_CONF_MAX_DEPTH */
+
+#if JSONWRITER_MAX_DEPTH > 255
+#error JSONWRITER_MAX_DEPTH must be at most 255.
+#endif
+
+struct jsonwriter;
+
+/**
+ * \brief        A callback that receives the contents of a full buffer.
+ * \param writer The writer.
+ * \param data   The contents of the buffer.
+ * \param len    The number of characters in data.
+ * \return       Zero on success, or non-zero to stop writing with
+ *               JSON_ERROR_ABORTED.
+ */
+typedef int (* jsonwriter_flush_t)(struct jsonwriter *writer,
+                                   const char *data, int len);
+
+struct jsonwriter {
+  char *buf;
+  int size;
+  int pos;
+  /* the number of characters passed to the flush callback */
+  long flushed;
+  jsonwriter_flush_t flush;
+  void *ptr;
+  /* one bit per level, set for objects */
+  uint8_t objects[(JSONWRITER_MAX_DEPTH + 7) / 8];
+  /* one bit per level, set once a value has been written in it */
+  uint8_t values[(JSONWRITER_MAX_DEPTH + 7) / 8];
+  uint8_t depth;
+  uint8_t after_name;
+  char error;
+};
+
+/**
+ * \brief        Initialize a writer.
+ * \param writer A pointer to the writer.
+ * \param buf    The buffer to write to.
+ * \param size   The size of the buffer.
+ * \param flush  The callback that receives the buffer when it is full,
+ *               or NULL if the document must fit in the buffer.
+ * \param ptr    A pointer that is kept in the writer for the callback.
+ */
+void jsonwriter_setup(struct jsonwriter *writer, char *buf, int size,
+                      jsonwriter_flush_t flush, void *ptr);
+
+/* start and end objects and arrays */
+void jsonwriter_object_start(struct jsonwriter *writer);
+void jsonwriter_object_end(struct jsonwriter *writer);
+void jsonwriter_array_start(struct jsonwriter *writer);
+void jsonwriter_array_end(struct jsonwriter *writer);
+
+/* write the name of the next value in an object */
+void jsonwriter_name(struct jsonwriter *writer, const char *name);
+
+/* write values, escaping strings as needed */
+void jsonwriter_string(struct jsonwriter *writer, const char *text);
+void jsonwriter_int(struct jsonwriter *writer, long value);
+void jsonwriter_uint(struct jsonwriter *writer, unsigned long value);
+void jsonwriter_bool(struct jsonwriter *writer, int value);
+void jsonwriter_null(struct jsonwriter *writer);
+
+/**
+ * \brief        Finish writing a document.
+ * \param writer A pointer to the writer.
+ * \return       The length of the document, or -1 if the buffer was too
+ *               small, the callback failed, or the document is not
+ *               complete.
+ *
+ *               If a flush callback is set, it receives the rest of the
+ *               document. Otherwise the document is in the buffer, which
+ *               is null-terminated if there is room.
+ */
+long jsonwriter_end(struct jsonwriter *writer);
+
+#endif /* JSONWRITER_H_ */
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Binary snapshots of the heapmem allocator and the memb pools.
+ */
+
+#include "contiki.h"
+#include "lib/heapmem.h"
+#include "lib/memb.h"
+#include "lib/mem-snapshot.h"
+
+#include <string.h>
+
+/* Snapshots are only compiled when there is something to record. */
+#if defined(HEAPMEM_CONF_ARENA_SIZE) || MEMB_STATS
+
+struct writer {
+  mem_snapshot_output_t output;
+  void *ptr;
+  size_t total;
+  uint8_t record[MEM_SNAPSHOT_PART_MAX];
+  uint8_t length;
+};
+/*---------------------------------------------------------------------------*/
+static void
+begin_record(struct writer *w, uint8_t type)
+{
+  w->record[0] = type;
+  w->length = 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+put_bytes(struct writer *w, const void *data, size_t len)
+{
+  if(len > MEM_SNAPSHOT_PAYLOAD_MAX - w->length) {
+    len = MEM_SNAPSHOT_PAYLOAD_MAX - w->length;
+  }
+  memcpy(&w->record[2 + w->length], data, len);
+  w->length += len;
+}
+/*---------------------------------------------------------------------------*/
+static void
+put_uint(struct writer *w, uint32_t value, unsigned bytes)
+{
+  uint8_t buf[4];
+
+  for(unsigned i = 0; i < bytes; i++) {
+    buf[i] = value >> (8 * i);
+  }
+  put_bytes(w, buf, bytes);
+}
+/*---------------------------------------------------------------------------*/
+static void
+put_string(struct writer *w, const char *str)
+{
+  if(str != NULL) {
+    put_bytes(w, str, strlen(str));
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+end_record(struct writer *w)
+{
+  w->record[1] = w->length;
+  w->output(w->record, 2 + w->length, w->ptr);
+  w->total += 2 + w->length;
+}
+/*---------------------------------------------------------------------------*/
+#if HEAPMEM_DEBUG
+/* Source file names are stored without their directory, which keeps
+   the records short while still identifying the allocation site. */
+static const char *
+base_name(const char *path)
+{
+  const char *name = strrchr(path, '/');
+
+  return name != NULL ? name + 1 : path;
+}
+#endif /* HEAPMEM_DEBUG */
+/*---------------------------------------------------------------------------*/
+size_t
+mem_snapshot(mem_snapshot_output_t output, void *ptr)
+{
+  static const uint8_t magic[] = { 'M', 'E', 'M', 'S', MEM_SNAPSHOT_VERSION };
+  struct writer w = { .output = output, .ptr = ptr };
+  uint8_t header[6];
+  clock_time_t now = clock_time();
+
+  output(magic, sizeof(magic), ptr);
+  for(unsigned i = 0; i < 4; i++) {
+    header[i] = (uint32_t)now >> (8 * i);
+  }
+  header[4] = CLOCK_SECOND & 0xff;
+  header[5] = CLOCK_SECOND >> 8;
+  output(header, sizeof(header), ptr);
+  w.total = sizeof(magic) + sizeof(header);
+
+#ifdef HEAPMEM_CONF_ARENA_SIZE
+  heapmem_stats_t stats;
+  heapmem_stats(&stats);
+  begin_record(&w, MEM_SNAPSHOT_HEAP);
+  put_uint(&w, stats.allocated, 4);
+  put_uint(&w, stats.overhead, 4);
+  put_uint(&w, stats.available, 4);
+  put_uint(&w, stats.footprint, 4);
+  put_uint(&w, stats.max_footprint, 4);
+  put_uint(&w, stats.chunks, 4);
+  end_record(&w);
+
+  heapmem_zone_stats_t zone_stats;
+  for(heapmem_zone_t zone = HEAPMEM_ZONE_GENERAL;
+      heapmem_zone_stats(zone, &zone_stats);
+      zone++) {
+    begin_record(&w, MEM_SNAPSHOT_ZONE);
+    put_uint(&w, zone, 1);
+    put_uint(&w, zone_stats.zone_size, 4);
+    put_uint(&w, zone_stats.allocated, 4);
+    put_uint(&w, zone_stats.max_allocated, 4);
+    put_uint(&w, zone_stats.failures, 4);
+    put_string(&w, zone_stats.name);
+    end_record(&w);
+  }
+
+#if HEAPMEM_DEBUG
+  heapmem_chunk_info_t info = { .ptr = NULL };
+  while(heapmem_chunk_next(&info)) {
+    begin_record(&w, MEM_SNAPSHOT_CHUNK);
+    put_uint(&w, info.zone, 1);
+    put_uint(&w, info.size, 4);
+    put_uint(&w, info.line, 4);
+    put_uint(&w, info.age, 4);
+    put_string(&w, base_name(info.file));
+    end_record(&w);
+  }
+#endif /* HEAPMEM_DEBUG */
+#endif /* HEAPMEM_CONF_ARENA_SIZE */
+
+#if MEMB_STATS
+  for(struct memb *m = memb_stats_head(); m != NULL; m = m->next) {
+    begin_record(&w, MEM_SNAPSHOT_MEMB);
+    put_uint(&w, m->size, 2);
+    put_uint(&w, m->num, 2);
+    put_uint(&w, m->num - m->free, 2);
+    put_uint(&w, m->max_used, 2);
+    put_uint(&w, m->failures, 2);
+    put_string(&w, m->name);
+    end_record(&w);
+  }
+#endif /* MEMB_STATS */
+
+  begin_record(&w, MEM_SNAPSHOT_END);
+  end_record(&w);
+
+  return w.total;
+}
+/*---------------------------------------------------------------------------*/
+#endif /* defined(HEAPMEM_CONF_ARENA_SIZE) || MEMB_STATS */
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup mem
+ * @{
+ */
+
+/**
+ * \defgroup mem-snapshot Binary snapshots of the memory allocators
+ *
+ * A memory snapshot describes the state of the heapmem allocator and
+ * of the memb pools at a point in time, in a compact binary format
+ * that can be transferred to a host and compared with other
+ * snapshots, for instance with tools/mem-snapshot/mem-snapshot.py.
+ *
+ * The snapshot begins with a header consisting of the four bytes
+ * "MEMS", a version byte, the current clock time as a 32-bit value,
+ * and CLOCK_SECOND as a 16-bit value. A sequence of records follows,
+ * each with a type byte, a length byte, and a payload of that many
+ * bytes. The snapshot ends with a record of the type
+ * MEM_SNAPSHOT_END. All integers are stored in little-endian byte
+ * order, and strings are stored without a terminating null byte at
+ * the end of a record.
+ *
+ * Heap records are included if heapmem is enabled, chunk records if
+ * HEAPMEM_DEBUG is set, and memb records if MEMB_CONF_STATS is set.
+ * If neither heapmem nor the memb statistics are enabled, the module
+ * is not compiled.
+ *
+ * @{
+ */
+
+/**
+ * \file
+ *         Header file for memory allocator snapshots.
+ */
+
+#ifndef MEM_SNAPSHOT_H
+#define MEM_SNAPSHOT_H
+
+#include "contiki.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MEM_SNAPSHOT_VERSION 1
+
+/* The largest record payload. Names that do not fit are truncated. */
+#define MEM_SNAPSHOT_PAYLOAD_MAX 64
+
+/* The largest part of a snapshot passed to the output function. */
+#define MEM_SNAPSHOT_PART_MAX (2 + MEM_SNAPSHOT_PAYLOAD_MAX)
+
+/* The record types of a snapshot. */
+#define MEM_SNAPSHOT_END     0
+/* Heap totals: allocated, overhead, available, footprint,
+   max_footprint and chunks, all 32-bit. */
+#define MEM_SNAPSHOT_HEAP    1
+/* Zone: 8-bit ID, 32-bit zone size, allocated, max_allocated and
+   failures, followed by the zone name. */
+#define MEM_SNAPSHOT_ZONE    2
+/* Allocated chunk: 8-bit zone ID, 32-bit size, line and age in clock
+   ticks, followed by the name of the source file. */
+#define MEM_SNAPSHOT_CHUNK   3
+/* Memb pool: 16-bit block size, number of blocks, blocks in use,
+   maximum blocks in use and failures, followed by the pool name. */
+#define MEM_SNAPSHOT_MEMB    4
+
+/**
+ * A function that receives consecutive parts of a snapshot.
+ */
+typedef void (*mem_snapshot_output_t)(const uint8_t *data, size_t len,
+                                      void *ptr);
+
+/**
+ * \brief        Write a snapshot of the memory allocators.
+ * \param output The function that receives the snapshot.
+ * \param ptr    A pointer that is passed to the output function.
+ * \return       The total size of the snapshot in bytes.
+ */
+size_t mem_snapshot(mem_snapshot_output_t output, void *ptr);
+
+#endif /* MEM_SNAPSHOT_H */
+
+/** @} */
+/** @} */
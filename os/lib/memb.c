@@ -47,54 +47,130 @@
 #include "contiki.h"
 #include "lib/memb.h"
 
+#if MEMB_STATS
+static struct memb *memb_list;
+#endif
+/*---------------------------------------------------------------------------*/
+/* Get the index of the least significant zero bit of a bitmap word
+   that is not full. */
+static unsigned
+first_zero_bit(uint32_t word)
+{
+#ifdef __GNUC__
+  return __builtin_ctzl((unsigned long)~word);
+#else
+  unsigned bit;
+
+  for(bit = 0; word & 1; bit++) {
+    word >>= 1;
+  }
+  return bit;
+#endif
+}
+/*---------------------------------------------------------------------------*/
+#if MEMB_STATS
+static void
+add_to_list(struct memb *m)
+{
+  if(!m->listed) {
+    m->listed = true;
+    m->next = memb_list;
+    memb_list = m;
+  }
+}
+#endif /* MEMB_STATS */
 /*---------------------------------------------------------------------------*/
 void
 memb_init(struct memb *m)
 {
-  memset(m->used, 0, m->num);
+  memset(m->used, 0, MEMB_BITMAP_WORDS(m->num) * sizeof(m->used[0]));
   memset(m->mem, 0, m->size * m->num);
+  m->free = m->num;
+  m->hint = 0;
+#if MEMB_STATS
+  m->max_used = 0;
+  m->failures = 0;
+  add_to_list(m);
+#endif
 }
 /*---------------------------------------------------------------------------*/
 void *
 memb_alloc(struct memb *m)
 {
-  int i;
+  unsigned short i;
+  unsigned short index;
+
+#if MEMB_STATS
+  add_to_list(m);
+#endif
+
+  if(m->free == 0) {
+#if MEMB_STATS
+    m->failures++;
+#endif
+    return NULL;
+  }
 
-  for(i = 0; i < m->num; ++i) {
-    if(m->used[i] == false) {
-      /* If this block was unused, we set the used flag on
-	 and return a pointer to the memory block. */
-      m->used[i] = true;
-      return (void *)((char *)m->mem + (i * m->size));
+  /* All words before the hint are full, so the search only has to
+     skip words filled since then. The block with the lowest index
+     is allocated, as with a linear scan of the blocks. */
+  for(i = m->hint; i < MEMB_BITMAP_WORDS(m->num); i++) {
+    if(m->used[i] != UINT32_MAX) {
+      index = i * 32 + first_zero_bit(m->used[i]);
+      if(index >= m->num) {
+        /* The unused bits of the last word are not blocks. */
+        break;
+      }
+      m->used[i] |= (uint32_t)1 << (index % 32);
+      m->free--;
+      m->hint = i;
+#if MEMB_STATS
+      if(m->num - m->free > m->max_used) {
+        m->max_used = m->num - m->free;
+      }
+#endif
+      return (void *)((char *)m->mem + (index * m->size));
     }
   }
 
   /* No free block was found, so we return NULL to indicate failure to
      allocate block. */
+#if MEMB_STATS
+  m->failures++;
+#endif
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
 int
 memb_free(struct memb *m, void *ptr)
 {
-  int i;
-  char *ptr2;
+  size_t offset;
+  unsigned short index;
+  uint32_t mask;
 
-  /* Walk through the list of blocks and try to find the block to
-     which the pointer "ptr" points to. */
-  ptr2 = (char *)m->mem;
-  for(i = 0; i < m->num; ++i) {
-    if(ptr2 == (char *)ptr) {
-      /* We've found the block to which "ptr" points, so we check the allocation
-         status to detect the double-free error and free the block. */
-      if (m->used[i] == false)
-        return -1;
-      m->used[i] = false;
-      return 0;
-    }
-    ptr2 += m->size;
+  /* The index of the block is computed from its address, which must
+     be the beginning of a block. */
+  if(!memb_inmemb(m, ptr)) {
+    return -1;
+  }
+  offset = (char *)ptr - (char *)m->mem;
+  if(offset % m->size != 0) {
+    return -1;
+  }
+  index = offset / m->size;
+
+  /* Check the allocation status to detect the double-free error and
+     free the block. */
+  mask = (uint32_t)1 << (index % 32);
+  if(!(m->used[index / 32] & mask)) {
+    return -1;
+  }
+  m->used[index / 32] &= ~mask;
+  m->free++;
+  if(index / 32 < m->hint) {
+    m->hint = index / 32;
   }
-  return -1;
+  return 0;
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -107,15 +183,14 @@ memb_inmemb(struct memb *m, void *ptr)
 size_t
 memb_numfree(struct memb *m)
 {
-  int i;
-  size_t num_free = 0;
-
-  for(i = 0; i < m->num; ++i) {
-    if(m->used[i] == false) {
-      ++num_free;
-    }
-  }
-
-  return num_free;
+  return m->free;
+}
+/*---------------------------------------------------------------------------*/
+#if MEMB_STATS
+struct memb *
+memb_stats_head(void)
+{
+  return memb_list;
 }
+#endif /* MEMB_STATS */
 /** @} */
@@ -48,6 +48,16 @@
  * memory by the memb_alloc() function, and are deallocated with the
  * memb_free() function.
  *
+ * The allocation state of the blocks is kept in a bitmap, so that
+ * memb_alloc() skips 32 allocated blocks at a time and memb_free()
+ * finds a block from its address in constant time.
+ *
+ * If MEMB_CONF_STATS is set, each set of blocks also records the
+ * highest number of blocks that have been in use at the same time,
+ * and the number of allocations that failed. The sets are added to a
+ * list that can be traversed with memb_stats_head() when they are
+ * initialized or first allocated from.
+ *
  * @{
  */
 
@@ -64,16 +74,24 @@
 #define MEMB_H_
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include "sys/cc.h"
 
+#ifdef MEMB_CONF_STATS
+#define MEMB_STATS MEMB_CONF_STATS
+#else
+#define MEMB_STATS 0
+#endif
+
 /**
  * Declare a memory block.
  *
  * This macro is used to statically declare a block of memory that can
  * be used by the block allocation functions. The macro statically
  * declares a C array with a size that matches the specified number of
- * blocks and their individual sizes.
+ * blocks and their individual sizes, and a bitmap that records which
+ * blocks are in use.
  *
  * Example:
  \code
@@ -89,17 +107,41 @@ MEMB(connections, struct connection, 16);
  *
  */
 #define MEMB(name, structure, num) \
-        static bool CC_CONCAT(name,_memb_used)[num]; \
+        static uint32_t CC_CONCAT(name,_memb_used)[MEMB_BITMAP_WORDS(num)]; \
         static structure CC_CONCAT(name,_memb_mem)[num]; \
         static struct memb name = {sizeof(structure), num, \
                                           CC_CONCAT(name,_memb_used), \
-                                          (void *)CC_CONCAT(name,_memb_mem)}
+                                          (void *)CC_CONCAT(name,_memb_mem), \
+                                          num, 0 MEMB_STATS_INIT(name)}
+
+#if MEMB_STATS
+#define MEMB_STATS_INIT(name) , #name, 0, 0, false, NULL
+#else
+#define MEMB_STATS_INIT(name)
+#endif
+
+/** The number of 32-bit words in the bitmap of a set of \c num blocks. */
+#define MEMB_BITMAP_WORDS(num) (((num) + 31) / 32)
 
 struct memb {
   unsigned short size;
   unsigned short num;
-  bool *used;
+  /* A bitmap in which a set bit marks a block that is in use. */
+  uint32_t *used;
   void *mem;
+  /* The number of free blocks. */
+  unsigned short free;
+  /* The index of the first bitmap word that may have a free block. */
+  unsigned short hint;
+#if MEMB_STATS
+  const char *name;
+  /* The highest number of blocks in use at the same time. */
+  unsigned short max_used;
+  /* The number of allocations that failed. */
+  unsigned short failures;
+  bool listed;
+  struct memb *next;
+#endif
 };
 
 /**
@@ -150,6 +192,17 @@ int memb_inmemb(struct memb *m, void *ptr);
  */
 size_t memb_numfree(struct memb *m);
 
+#if MEMB_STATS
+/**
+ * Get the first set of memory blocks in the list of sets that have
+ * been initialized or allocated from.
+ *
+ * \return The first set of memory blocks, or NULL if there are none.
+ * The next set is obtained through the \c next field.
+ */
+struct memb *memb_stats_head(void);
+#endif /* MEMB_STATS */
+
 /** @} */
 /** @} */
 
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup prng
+ * @{
+ */
+
+/**
+ * \file
+ *         Seedable pseudo-random number streams.
+ */
+
+#include "lib/prng.h"
+#include "lib/random.h"
+
+#include <stdbool.h>
+
+static prng_t streams[PRNG_STREAM_COUNT];
+static bool seeded;
+
+/*---------------------------------------------------------------------------*/
+static uint64_t
+splitmix64(uint64_t *x)
+{
+  uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+rotl(uint32_t x, int k)
+{
+  return (x << k) | (x >> (32 - k));
+}
+/*---------------------------------------------------------------------------*/
+void
+prng_seed(prng_t *prng, uint64_t seed, uint32_t stream)
+{
+  uint64_t x = stream;
+  uint64_t z;
+
+  /* the stream number selects a distant starting point of SplitMix64 */
+  x = seed ^ splitmix64(&x);
+  z = splitmix64(&x);
+  prng->s[0] = (uint32_t)z;
+  prng->s[1] = (uint32_t)(z >> 32);
+  z = splitmix64(&x);
+  prng->s[2] = (uint32_t)z;
+  prng->s[3] = (uint32_t)(z >> 32);
+
+  /* the all-zero state is the only one that xoshiro cannot leave */
+  if((prng->s[0] | prng->s[1] | prng->s[2] | prng->s[3]) == 0) {
+    prng->s[0] = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+prng_rand32(prng_t *prng)
+{
+  uint32_t *s = prng->s;
+  uint32_t result = rotl(s[1] * 5, 7) * 9;
+  uint32_t t = s[1] << 9;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl(s[3], 11);
+
+  return result;
+}
+/*---------------------------------------------------------------------------*/
+uint64_t
+prng_rand64(prng_t *prng)
+{
+  uint64_t high = prng_rand32(prng);
+
+  return (high << 32) | prng_rand32(prng);
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+prng_uniform(prng_t *prng, uint32_t bound)
+{
+  uint64_t m = (uint64_t)prng_rand32(prng) * bound;
+  uint32_t threshold;
+
+  /* reject the low parts that would make some results more likely */
+  if((uint32_t)m < bound) {
+    threshold = -bound % bound;
+    while((uint32_t)m < threshold) {
+      m = (uint64_t)prng_rand32(prng) * bound;
+    }
+  }
+  return m >> 32;
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+prng_range(prng_t *prng, uint32_t min, uint32_t max)
+{
+  if(max - min == UINT32_MAX) {
+    return prng_rand32(prng);
+  }
+  return min + prng_uniform(prng, max - min + 1);
+}
+/*---------------------------------------------------------------------------*/
+void
+prng_set_seed(uint64_t seed)
+{
+  for(int i = 0; i < PRNG_STREAM_COUNT; i++) {
+    prng_seed(&streams[i], seed, i);
+  }
+  seeded = true;
+}
+/*---------------------------------------------------------------------------*/
+prng_t *
+prng_stream(prng_stream_t stream)
+{
+  uint64_t seed = 0;
+
+  if(!seeded) {
+    for(int i = 0; i < 4; i++) {
+      seed = (seed << 16) | random_rand();
+    }
+    prng_set_seed(seed);
+  }
+  return &streams[stream];
+}
+/*---------------------------------------------------------------------------*/
+
+/** @} */
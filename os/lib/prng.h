@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup lib
+ * @{
+ */
+
+/**
+ * \defgroup prng Seedable pseudo-random number streams
+ *
+ * The prng module generates pseudo-random numbers with xoshiro128**,
+ * which has 128 bits of state, passes the common statistical test
+ * suites, and needs only 32-bit operations. Unlike random_rand(), each
+ * generator has its own state, so that each subsystem can draw from an
+ * independent stream. A simulation then stays reproducible in one
+ * subsystem when another subsystem draws more or fewer numbers.
+ *
+ * The module keeps one stream per subsystem, which prng_stream()
+ * returns. All streams are derived from a single seed that is set with
+ * prng_set_seed(). If no seed is set before a stream is first used,
+ * the seed is taken from random_rand(), which is backed by a hardware
+ * RNG on many platforms.
+ *
+ * The generators are not suited for cryptography; use csprng for that.
+ *
+ * @{
+ */
+
+/**
+ * \file
+ *         Header file for the seedable pseudo-random number streams.
+ */
+
+#ifndef PRNG_H_
+#define PRNG_H_
+
+#include "contiki.h"
+
+#include <stdint.h>
+
+/** The state of a generator. */
+typedef struct prng {
+  uint32_t s[4];
+} prng_t;
+
+/** The streams of the subsystems. */
+typedef enum prng_stream {
+  PRNG_STREAM_MAC,
+  PRNG_STREAM_ROUTING,
+  PRNG_STREAM_TRICKLE,
+  PRNG_STREAM_APP,
+  PRNG_STREAM_COUNT
+} prng_stream_t;
+
+/**
+ * \brief        Seed a generator.
+ * \param prng   The generator.
+ * \param seed   The seed.
+ * \param stream A number that selects one of 2^32 independent streams
+ *               for the same seed.
+ *
+ *               The state is derived from the seed and the stream
+ *               number with SplitMix64, so similar seeds give
+ *               unrelated sequences.
+ */
+void prng_seed(prng_t *prng, uint64_t seed, uint32_t stream);
+
+/**
+ * \brief      Get the next 32-bit number of a generator.
+ * \param prng The generator.
+ * \return     A number between 0 and UINT32_MAX.
+ */
+uint32_t prng_rand32(prng_t *prng);
+
+/**
+ * \brief      Get the next 64-bit number of a generator.
+ * \param prng The generator.
+ * \return     A number between 0 and UINT64_MAX.
+ */
+uint64_t prng_rand64(prng_t *prng);
+
+/**
+ * \brief       Get a number below a bound, without modulo bias.
+ * \param prng  The generator.
+ * \param bound The bound.
+ * \return      A number between 0 and bound - 1, or 0 if bound is 0.
+ *
+ *              Unlike prng_rand32() % bound, every result is equally
+ *              likely. Lemire's method takes one multiplication and
+ *              almost never a division.
+ */
+uint32_t prng_uniform(prng_t *prng, uint32_t bound);
+
+/**
+ * \brief       Get a number in a range, without modulo bias.
+ * \param prng  The generator.
+ * \param min   The smallest number.
+ * \param max   The largest number, which must not be smaller than min.
+ * \return      A number between min and max, inclusive.
+ */
+uint32_t prng_range(prng_t *prng, uint32_t min, uint32_t max);
+
+/**
+ * \brief      Reseed the streams of all subsystems.
+ * \param seed The seed, such as the random seed of a simulated node.
+ */
+void prng_set_seed(uint64_t seed);
+
+/**
+ * \brief        Get the generator of a subsystem.
+ * \param stream The subsystem.
+ * \return       The generator of the subsystem.
+ */
+prng_t *prng_stream(prng_stream_t stream);
+
+#endif /* PRNG_H_ */
+
+/** @} */
+/** @} */
@@ -32,21 +32,30 @@
 
 
 #include "lib/random.h"
-#include <stdlib.h>
+#include "lib/prng.h"
 
+#include <stdbool.h>
+
+/* random_rand() has its own generator, so that drawing from it does not
+   disturb the streams of the subsystems */
+static prng_t prng;
+static bool initialized;
 /*---------------------------------------------------------------------------*/
 void
 random_init(unsigned short seed)
 {
-  srand(seed);
+  prng_seed(&prng, seed, PRNG_STREAM_COUNT);
+  initialized = true;
+  prng_set_seed(seed);
 }
 /*---------------------------------------------------------------------------*/
 unsigned short
 random_rand(void)
 {
-/* In gcc int rand() uses RAND_MAX and long random() uses RANDOM_MAX=0x7FFFFFFF */
-/* RAND_MAX varies depending on the architecture */
-
-  return (unsigned short)rand();
+  if(!initialized) {
+    prng_seed(&prng, 0, PRNG_STREAM_COUNT);
+    initialized = true;
+  }
+  return prng_rand32(&prng) >> 16;
 }
 /*---------------------------------------------------------------------------*/
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup crypto
+ * @{
+ * \file
+ *         Block compression functions of SHA-256 that use the SHA
+ *         instructions of x86 processors (SHA-NI).
+ *
+ *         The x86 functions are compiled for the SHA extensions
+ *         regardless of the compiler flags, and are only returned if
+ *         the processor reports support for them at run time.
+ */
+
+#include "lib/sha-256-accel.h"
+#include <stdbool.h>
+
+#if !SHA_256_ACCEL
+/* Use the portable implementation. */
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SHA_256_ACCEL_X86 1
+#endif
+
+#if SHA_256_ACCEL_X86
+#include <cpuid.h>
+#include <immintrin.h>
+
+#define SHA_NI_TARGET __attribute__((target("sha,sse4.1")))
+#define SHA_NI_INLINE static inline __attribute__((always_inline)) SHA_NI_TARGET
+
+/* The state and message schedule of one message being hashed. */
+struct sha_ni_lane {
+  __m128i abef;
+  __m128i cdgh;
+  __m128i w0;
+  __m128i w1;
+  __m128i w2;
+  __m128i w3;
+};
+
+/*
+ * Four rounds of group g. The message schedule for later groups is
+ * computed from the words of the current (cur) and previous (prev)
+ * groups into the words of the next group (next) while the rounds
+ * are executed.
+ */
+#define SHA_NI_ROUNDS(l, g, cur, prev, next) do { \
+    __m128i msg = _mm_add_epi32((l).cur, \
+      _mm_loadu_si128((const __m128i *)&sha_256_k[4 * (g)])); \
+    (l).cdgh = _mm_sha256rnds2_epu32((l).cdgh, (l).abef, msg); \
+    if((g) >= 3 && (g) <= 14) { \
+      (l).next = _mm_sha256msg2_epu32( \
+        _mm_add_epi32((l).next, _mm_alignr_epi8((l).cur, (l).prev, 4)), \
+        (l).cur); \
+    } \
+    msg = _mm_shuffle_epi32(msg, 0x0e); \
+    (l).abef = _mm_sha256rnds2_epu32((l).abef, (l).cdgh, msg); \
+    if((g) >= 1 && (g) <= 12) { \
+      (l).prev = _mm_sha256msg1_epu32((l).prev, (l).cur); \
+    } \
+  } while(0)
+
+/* Sixteen rounds starting with group g. */
+#define SHA_NI_ROUNDS16(l, g) \
+  SHA_NI_ROUNDS(l, (g) + 0, w0, w3, w1); \
+  SHA_NI_ROUNDS(l, (g) + 1, w1, w0, w2); \
+  SHA_NI_ROUNDS(l, (g) + 2, w2, w1, w3); \
+  SHA_NI_ROUNDS(l, (g) + 3, w3, w2, w0)
+
+
+/*---------------------------------------------------------------------------*/
+SHA_NI_INLINE void
+sha_ni_load_state(struct sha_ni_lane *l, const uint32_t state[static 8])
+{
+  /* The instructions keep the state as ABEF and CDGH. */
+  __m128i dcba = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[0]),
+                                   0xb1);
+  __m128i efgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[4]),
+                                   0x1b);
+
+  l->abef = _mm_alignr_epi8(dcba, efgh, 8);
+  l->cdgh = _mm_blend_epi16(efgh, dcba, 0xf0);
+}
+/*---------------------------------------------------------------------------*/
+SHA_NI_INLINE void
+sha_ni_store_state(const struct sha_ni_lane *l, uint32_t state[static 8])
+{
+  __m128i feba = _mm_shuffle_epi32(l->abef, 0x1b);
+  __m128i dchg = _mm_shuffle_epi32(l->cdgh, 0xb1);
+
+  _mm_storeu_si128((__m128i *)&state[0], _mm_blend_epi16(feba, dchg, 0xf0));
+  _mm_storeu_si128((__m128i *)&state[4], _mm_alignr_epi8(dchg, feba, 8));
+}
+/*---------------------------------------------------------------------------*/
+SHA_NI_INLINE void
+sha_ni_load_block(struct sha_ni_lane *l, const uint8_t *block)
+{
+  const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL,
+                                      0x0405060700010203ULL);
+
+  l->w0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&block[0]), mask);
+  l->w1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&block[16]), mask);
+  l->w2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&block[32]), mask);
+  l->w3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&block[48]), mask);
+}
+/*---------------------------------------------------------------------------*/
+SHA_NI_TARGET static void
+compress_sha_ni(uint32_t state[static 8], const uint8_t *blocks, size_t count)
+{
+  struct sha_ni_lane l;
+  __m128i abef;
+  __m128i cdgh;
+
+  sha_ni_load_state(&l, state);
+
+  for(; count > 0; count--, blocks += 64) {
+    abef = l.abef;
+    cdgh = l.cdgh;
+    sha_ni_load_block(&l, blocks);
+
+    SHA_NI_ROUNDS16(l, 0);
+    SHA_NI_ROUNDS16(l, 4);
+    SHA_NI_ROUNDS16(l, 8);
+    SHA_NI_ROUNDS16(l, 12);
+
+    l.abef = _mm_add_epi32(l.abef, abef);
+    l.cdgh = _mm_add_epi32(l.cdgh, cdgh);
+  }
+
+  sha_ni_store_state(&l, state);
+}
+/*---------------------------------------------------------------------------*/
+static bool
+cpu_has_sha_ni(void)
+{
+  static int8_t supported = -1;
+  unsigned eax, ebx, ecx, edx;
+
+  if(supported < 0) {
+    supported = 0;
+    /* SSSE3 and SSE4.1 are in ECX of leaf 1, SHA is bit 29 of EBX of
+       leaf 7. */
+    if(__get_cpuid(1, &eax, &ebx, &ecx, &edx) &&
+       (ecx & bit_SSSE3) && (ecx & bit_SSE4_1) &&
+       __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) &&
+       (ebx & (1U << 29))) {
+      supported = 1;
+    }
+  }
+  return supported;
+}
+/*---------------------------------------------------------------------------*/
+sha_256_compress_t
+sha_256_accel_compress(void)
+{
+  return cpu_has_sha_ni() ? compress_sha_ni : NULL;
+}
+/*---------------------------------------------------------------------------*/
+#else /* SHA_256_ACCEL_X86 */
+/*---------------------------------------------------------------------------*/
+sha_256_compress_t
+sha_256_accel_compress(void)
+{
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+#endif /* SHA_256_ACCEL_X86 */
+
+/** @} */
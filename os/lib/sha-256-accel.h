@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup crypto
+ * @{
+ * \file
+ *         Block compression functions of SHA-256 that use the SHA
+ *         instructions of x86 processors (SHA-NI).
+ */
+
+#ifndef SHA_256_ACCEL_H_
+#define SHA_256_ACCEL_H_
+
+#include "contiki.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Set to 0 to always use the portable implementation, e.g., to compare
+ * the performance of the implementations.
+ */
+#ifdef SHA_256_CONF_ACCEL
+#define SHA_256_ACCEL SHA_256_CONF_ACCEL
+#else /* SHA_256_CONF_ACCEL */
+#define SHA_256_ACCEL 1
+#endif /* SHA_256_CONF_ACCEL */
+
+/**
+ * Compresses count consecutive 64-byte blocks into a state.
+ */
+typedef void (* sha_256_compress_t)(uint32_t state[static 8],
+                                    const uint8_t *blocks, size_t count);
+
+/** The round constants of SHA-256. */
+extern const uint32_t sha_256_k[64];
+
+/**
+ * \brief  Gets the accelerated compression function.
+ * \return The function, or NULL if the compiler or the processor does
+ *         not support the SHA instructions.
+ */
+sha_256_compress_t sha_256_accel_compress(void);
+
+#endif /* SHA_256_ACCEL_H_ */
+
+/** @} */
@@ -33,6 +33,7 @@
  */
 
 #include "lib/sha-256.h"
+#include "lib/sha-256-accel.h"
 #include "net/ipv6/uip.h"
 #include "sys/cc.h"
 #include <string.h>
@@ -105,7 +106,7 @@ be32dec_vect(uint32_t *dst, const uint8_t *src, size_t len)
 }
 #endif /* UIP_BYTE_ORDER != UIP_LITTLE_ENDIAN */
 
-static const uint32_t K[64] = {
+const uint32_t sha_256_k[64] = {
   0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
   0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
   0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
@@ -146,7 +147,7 @@ static const uint32_t K[64] = {
       S[(66 - i) % 8], S[(67 - i) % 8], \
       S[(68 - i) % 8], S[(69 - i) % 8], \
       S[(70 - i) % 8], S[(71 - i) % 8], \
-      W[i + ii] + K[i + ii])
+      W[i + ii] + sha_256_k[i + ii])
 
 /* Message schedule computation */
 #define MSCH(W, ii, i) \
@@ -155,6 +156,11 @@ static const uint32_t K[64] = {
                    + s0(W[i + ii + 1]) \
                    + W[i + ii]
 
+static const uint32_t initial_state[SHA_256_DIGEST_LENGTH / sizeof(uint32_t)] = {
+  0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+  0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
 static sha_256_checkpoint_t checkpoint;
 
 /*---------------------------------------------------------------------------*/
@@ -163,7 +169,8 @@ static sha_256_checkpoint_t checkpoint;
  * the 512-bit input block to produce a new state.
  */
 static void
-transform(const uint8_t block[static SHA_256_BLOCK_SIZE])
+transform(uint32_t state[static 8],
+          const uint8_t block[static SHA_256_BLOCK_SIZE])
 {
   uint32_t W[64];
   uint32_t S[8];
@@ -173,7 +180,7 @@ transform(const uint8_t block[static SHA_256_BLOCK_SIZE])
   be32dec_vect(W, block, 64);
 
   /* 2. Initialize working variables. */
-  memcpy(S, checkpoint.state, 32);
+  memcpy(S, state, 32);
 
   /* 3. Mix. */
   for(i = 0; i < 64; i += 16) {
@@ -217,13 +224,29 @@ transform(const uint8_t block[static SHA_256_BLOCK_SIZE])
 
   /* 4. Mix local working variables into global state */
   for(i = 0; i < 8; i++) {
-    checkpoint.state[i] += S[i];
+    state[i] += S[i];
   }
 }
 /*---------------------------------------------------------------------------*/
+static void
+compress_portable(uint32_t state[static 8], const uint8_t *blocks, size_t count)
+{
+  for(; count > 0; count--, blocks += SHA_256_BLOCK_SIZE) {
+    transform(state, blocks);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static sha_256_compress_t
+compress_accel(void)
+{
+  sha_256_compress_t compress = sha_256_accel_compress();
+
+  return compress != NULL ? compress : compress_portable;
+}
+/*---------------------------------------------------------------------------*/
 /* Add padding and terminating bit-count. */
 static void
-sha_256_pad(void)
+sha_256_pad(sha_256_checkpoint_t *cp, sha_256_compress_t compress)
 {
   static const unsigned char PAD[64] = {
     0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -233,48 +256,42 @@ sha_256_pad(void)
   };
 
   /* Pad to 56 mod 64, transforming if we finish a block en route. */
-  if(checkpoint.buf_len < 56) {
+  if(cp->buf_len < 56) {
     /* Pad to 56 mod 64. */
-    memcpy(&checkpoint.buf[checkpoint.buf_len], PAD, 56 - checkpoint.buf_len);
+    memcpy(&cp->buf[cp->buf_len], PAD, 56 - cp->buf_len);
   } else {
     /* Finish the current block and mix. */
-    memcpy(&checkpoint.buf[checkpoint.buf_len], PAD,
-           SHA_256_BLOCK_SIZE - checkpoint.buf_len);
-    transform(checkpoint.buf);
+    memcpy(&cp->buf[cp->buf_len], PAD,
+           SHA_256_BLOCK_SIZE - cp->buf_len);
+    compress(cp->state, cp->buf, 1);
 
     /* The start of the final block is all zeroes. */
-    memset(&checkpoint.buf[0], 0, 56);
+    memset(&cp->buf[0], 0, 56);
   }
 
   /* Add the terminating bit-count. */
-  be64enc(&checkpoint.buf[56], checkpoint.bit_count);
+  be64enc(&cp->buf[56], cp->bit_count);
 
   /* Mix in the final block. */
-  transform(checkpoint.buf);
+  compress(cp->state, cp->buf, 1);
 }
 /*---------------------------------------------------------------------------*/
 /* SHA-256 initialization. Begins a SHA-256 operation. */
 static void
-init(void)
+start(sha_256_checkpoint_t *cp)
 {
   /* Zero bits processed so far */
-  checkpoint.bit_count = 0;
-  checkpoint.buf_len = 0;
+  cp->bit_count = 0;
+  cp->buf_len = 0;
 
   /* Magic initialization constants */
-  checkpoint.state[0] = 0x6A09E667;
-  checkpoint.state[1] = 0xBB67AE85;
-  checkpoint.state[2] = 0x3C6EF372;
-  checkpoint.state[3] = 0xA54FF53A;
-  checkpoint.state[4] = 0x510E527F;
-  checkpoint.state[5] = 0x9B05688C;
-  checkpoint.state[6] = 0x1F83D9AB;
-  checkpoint.state[7] = 0x5BE0CD19;
+  memcpy(cp->state, initial_state, sizeof(cp->state));
 }
 /*---------------------------------------------------------------------------*/
 /* Add bytes into the hash */
 static void
-update(const uint8_t *data, size_t len)
+update_with(sha_256_checkpoint_t *cp, sha_256_compress_t compress,
+            const uint8_t *data, size_t len)
 {
   uint64_t bitlen;
 
@@ -282,34 +299,32 @@ update(const uint8_t *data, size_t len)
   bitlen = len << 3;
 
   /* Update number of bits */
-  checkpoint.bit_count += bitlen;
+  cp->bit_count += bitlen;
 
   /* Handle the case where we don't need to perform any transforms */
-  if(len < SHA_256_BLOCK_SIZE - checkpoint.buf_len) {
-    memcpy(&checkpoint.buf[checkpoint.buf_len], data, len);
-    checkpoint.buf_len += len;
+  if(len < SHA_256_BLOCK_SIZE - cp->buf_len) {
+    memcpy(&cp->buf[cp->buf_len], data, len);
+    cp->buf_len += len;
     return;
   }
 
   /* Finish the current block */
-  memcpy(&checkpoint.buf[checkpoint.buf_len],
+  memcpy(&cp->buf[cp->buf_len],
          data,
-         SHA_256_BLOCK_SIZE - checkpoint.buf_len);
-  transform(checkpoint.buf);
-  data += SHA_256_BLOCK_SIZE - checkpoint.buf_len;
-  len -= SHA_256_BLOCK_SIZE - checkpoint.buf_len;
-  checkpoint.buf_len = 0;
+         SHA_256_BLOCK_SIZE - cp->buf_len);
+  compress(cp->state, cp->buf, 1);
+  data += SHA_256_BLOCK_SIZE - cp->buf_len;
+  len -= SHA_256_BLOCK_SIZE - cp->buf_len;
+  cp->buf_len = 0;
 
   /* Perform complete blocks */
-  while(len >= 64) {
-    transform(data);
-    data += SHA_256_BLOCK_SIZE;
-    len -= SHA_256_BLOCK_SIZE;
-  }
+  compress(cp->state, data, len / SHA_256_BLOCK_SIZE);
+  data += len - len % SHA_256_BLOCK_SIZE;
+  len %= SHA_256_BLOCK_SIZE;
 
   /* Copy left over data into buffer */
-  memcpy(checkpoint.buf, data, len);
-  checkpoint.buf_len += len;
+  memcpy(cp->buf, data, len);
+  cp->buf_len += len;
 }
 /*---------------------------------------------------------------------------*/
 /*
@@ -317,17 +332,48 @@ update(const uint8_t *data, size_t len)
  * and clears the context state.
  */
 static void
-finalize(uint8_t digest[static SHA_256_DIGEST_LENGTH])
+finalize_with(sha_256_checkpoint_t *cp, sha_256_compress_t compress,
+              uint8_t digest[static SHA_256_DIGEST_LENGTH])
 {
   /* Add padding */
-  sha_256_pad();
+  sha_256_pad(cp, compress);
 
   /* Write the hash */
-  be32enc_vect(digest, checkpoint.state, SHA_256_DIGEST_LENGTH);
+  be32enc_vect(digest, cp->state, SHA_256_DIGEST_LENGTH);
 
   /* Clear the context state */
-  memset(&checkpoint.buf, 0, sizeof(checkpoint.buf));
-  memset(&checkpoint.state, 0, sizeof(checkpoint.state));
+  memset(&cp->buf, 0, sizeof(cp->buf));
+  memset(&cp->state, 0, sizeof(cp->state));
+}
+/*---------------------------------------------------------------------------*/
+static void
+init(void)
+{
+  start(&checkpoint);
+}
+/*---------------------------------------------------------------------------*/
+static void
+update(const uint8_t *data, size_t len)
+{
+  update_with(&checkpoint, compress_portable, data, len);
+}
+/*---------------------------------------------------------------------------*/
+static void
+finalize(uint8_t digest[static SHA_256_DIGEST_LENGTH])
+{
+  finalize_with(&checkpoint, compress_portable, digest);
+}
+/*---------------------------------------------------------------------------*/
+static void
+update_accel(const uint8_t *data, size_t len)
+{
+  update_with(&checkpoint, compress_accel(), data, len);
+}
+/*---------------------------------------------------------------------------*/
+static void
+finalize_accel(uint8_t digest[static SHA_256_DIGEST_LENGTH])
+{
+  finalize_with(&checkpoint, compress_accel(), digest);
 }
 /*---------------------------------------------------------------------------*/
 static void
@@ -460,5 +506,14 @@ const struct sha_256_driver sha_256_driver = {
   sha_256_hash,
 };
 /*---------------------------------------------------------------------------*/
+const struct sha_256_driver sha_256_accel_driver = {
+  init,
+  update_accel,
+  finalize_accel,
+  create_checkpoint,
+  restore_checkpoint,
+  sha_256_hash,
+};
+/*---------------------------------------------------------------------------*/
 
 /** @} */
@@ -108,6 +108,18 @@ struct sha_256_driver {
 
 extern const struct sha_256_driver SHA_256;
 
+/**
+ * Portable software driver.
+ */
+extern const struct sha_256_driver sha_256_driver;
+
+/**
+ * Software driver that uses the SHA instructions of x86 processors
+ * (SHA-NI) when they are available, and falls back to the portable
+ * implementation otherwise.
+ */
+extern const struct sha_256_driver sha_256_accel_driver;
+
 /**
  * \brief Generic implementation of sha_256_driver#hash.
  */
@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup slip-codec
+ * @{
+ */
+
+/**
+ * \file
+ *         SLIP framing of whole buffers.
+ */
+
+#include "lib/slip-codec.h"
+
+#include <string.h>
+
+#if SLIP_CODEC_SIMD && defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#define USE_SSE2 1
+#else
+#define USE_SSE2 0
+#endif
+
+/* The decoder states. */
+#define STATE_ESCAPED 0x01
+#define STATE_RESET   0x02
+
+/*
+ * Word-at-a-time search: HAS_ZERO() is nonzero if any byte of the
+ * word is zero, so HAS_BYTE() is nonzero if any byte equals b.
+ */
+typedef uintptr_t word_t;
+#define ONES               ((word_t)-1 / 0xff)
+#define HAS_ZERO(w)        (((w) - ONES) & ~(w) & (ONES * 0x80))
+#define HAS_BYTE(w, b)     HAS_ZERO((w) ^ (ONES * (b)))
+
+/*---------------------------------------------------------------------------*/
+/* Find the first byte that is one of the four special bytes. */
+static size_t
+scan(const uint8_t *p, size_t len, const uint8_t special[4])
+{
+  size_t i = 0;
+  word_t w;
+
+#if USE_SSE2
+  const __m128i s0 = _mm_set1_epi8((char)special[0]);
+  const __m128i s1 = _mm_set1_epi8((char)special[1]);
+  const __m128i s2 = _mm_set1_epi8((char)special[2]);
+  const __m128i s3 = _mm_set1_epi8((char)special[3]);
+
+  for(; i + 16 <= len; i += 16) {
+    __m128i x = _mm_loadu_si128((const __m128i *)(p + i));
+    __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, s0),
+                                          _mm_cmpeq_epi8(x, s1)),
+                             _mm_or_si128(_mm_cmpeq_epi8(x, s2),
+                                          _mm_cmpeq_epi8(x, s3)));
+    int mask = _mm_movemask_epi8(m);
+
+    if(mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+#endif /* USE_SSE2 */
+
+  for(; i + sizeof(w) <= len; i += sizeof(w)) {
+    memcpy(&w, p + i, sizeof(w));
+    if(HAS_BYTE(w, special[0]) | HAS_BYTE(w, special[1]) |
+       HAS_BYTE(w, special[2]) | HAS_BYTE(w, special[3])) {
+      break;
+    }
+  }
+
+  for(; i < len; i++) {
+    if(p[i] == special[0] || p[i] == special[1] ||
+       p[i] == special[2] || p[i] == special[3]) {
+      break;
+    }
+  }
+  return i;
+}
+/*---------------------------------------------------------------------------*/
+size_t
+slip_codec_encode(uint8_t *dst, const void *src, size_t len, uint8_t flags)
+{
+  const uint8_t *p = src;
+  const uint8_t *end = p + len;
+  uint8_t *d = dst;
+  uint8_t special[4] = { SLIP_CODEC_END, SLIP_CODEC_ESC,
+                         SLIP_CODEC_END, SLIP_CODEC_ESC };
+  size_t n;
+
+  if(flags & SLIP_CODEC_XONXOFF) {
+    special[2] = SLIP_CODEC_XON;
+    special[3] = SLIP_CODEC_XOFF;
+  }
+
+  while(p < end) {
+    n = scan(p, end - p, special);
+    memcpy(d, p, n);
+    d += n;
+    p += n;
+    if(p == end) {
+      break;
+    }
+    *d++ = SLIP_CODEC_ESC;
+    switch(*p++) {
+    case SLIP_CODEC_END:
+      *d++ = SLIP_CODEC_ESC_END;
+      break;
+    case SLIP_CODEC_ESC:
+      *d++ = SLIP_CODEC_ESC_ESC;
+      break;
+    case SLIP_CODEC_XON:
+      *d++ = SLIP_CODEC_ESC_XON;
+      break;
+    default:
+      *d++ = SLIP_CODEC_ESC_XOFF;
+      break;
+    }
+  }
+  *d++ = SLIP_CODEC_END;
+
+  return d - dst;
+}
+/*---------------------------------------------------------------------------*/
+void
+slip_decoder_init(slip_decoder_t *d, uint8_t *buf, size_t size, uint8_t flags)
+{
+  memset(d, 0, sizeof(*d));
+  d->buf = buf;
+  d->size = size;
+  d->flags = flags;
+  d->special[0] = d->special[2] = SLIP_CODEC_END;
+  d->special[1] = d->special[3] = SLIP_CODEC_ESC;
+  if(flags & SLIP_CODEC_LINES) {
+    d->special[2] = d->special[3] = '\n';
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+slip_decoder_input(slip_decoder_t *d, const void *data, size_t len)
+{
+  d->input = data;
+  d->input_end = d->input + len;
+}
+/*---------------------------------------------------------------------------*/
+void
+slip_decoder_reset(slip_decoder_t *d)
+{
+  d->len = 0;
+  d->state &= ~STATE_RESET;
+}
+/*---------------------------------------------------------------------------*/
+int
+slip_decoder_next(slip_decoder_t *d)
+{
+  const uint8_t *p = d->input;
+  const uint8_t *end = d->input_end;
+  size_t n;
+  uint8_t c;
+
+  if(d->state & STATE_RESET) {
+    slip_decoder_reset(d);
+  }
+
+  while(p < end) {
+    if(d->state & STATE_ESCAPED) {
+      d->state &= ~STATE_ESCAPED;
+      switch(c = *p++) {
+      case SLIP_CODEC_ESC_END:
+        c = SLIP_CODEC_END;
+        break;
+      case SLIP_CODEC_ESC_ESC:
+        c = SLIP_CODEC_ESC;
+        break;
+      case SLIP_CODEC_ESC_XON:
+        c = SLIP_CODEC_XON;
+        break;
+      case SLIP_CODEC_ESC_XOFF:
+        c = SLIP_CODEC_XOFF;
+        break;
+      }
+      if(d->len == d->size) {
+        /* decode the escape sequence again after the reset */
+        d->state |= STATE_ESCAPED;
+        p--;
+        goto overflow;
+      }
+      d->buf[d->len++] = c;
+      continue;
+    }
+
+    /* copy the run of bytes that need no decoding */
+    n = scan(p, end - p, d->special);
+    if(n > d->size - d->len) {
+      n = d->size - d->len;
+      memcpy(d->buf + d->len, p, n);
+      d->len += n;
+      p += n;
+      goto overflow;
+    }
+    memcpy(d->buf + d->len, p, n);
+    d->len += n;
+    p += n;
+    if(p == end) {
+      break;
+    }
+
+    c = *p++;
+    if(c == SLIP_CODEC_END) {
+      if(d->len > 0) {
+        d->state |= STATE_RESET;
+        d->frames++;
+        d->input = p;
+        return SLIP_DECODER_FRAME;
+      }
+    } else if(c == SLIP_CODEC_ESC) {
+      d->state |= STATE_ESCAPED;
+    } else {
+      /* a newline */
+      if(d->len == d->size) {
+        p--;
+        goto overflow;
+      }
+      d->buf[d->len++] = c;
+      d->input = p;
+      return SLIP_DECODER_LINE;
+    }
+  }
+
+  d->input = p;
+  return SLIP_DECODER_NONE;
+
+overflow:
+  d->state |= STATE_RESET;
+  d->overflows++;
+  d->input = p;
+  return SLIP_DECODER_OVERFLOW;
+}
+/*---------------------------------------------------------------------------*/
+
+/** @} */
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup lib
+ * @{
+ */
+
+/**
+ * \defgroup slip-codec SLIP framing of whole buffers
+ *
+ * The slip-codec module encodes and decodes SLIP (RFC 1055) frames a
+ * buffer at a time, for hosts that talk to a serial radio at high
+ * baud rates. Instead of examining one byte per call, the codec scans
+ * for the bytes that need escaping a machine word at a time (or 16
+ * bytes at a time with SSE2) and copies the runs between them with
+ * memcpy().
+ *
+ * The decoder keeps its state between calls, so input may be fed in
+ * chunks of any size, as returned by read(), even if a chunk ends in
+ * the middle of an escape sequence. After slip_decoder_input() has been
+ * called, slip_decoder_next() is called repeatedly to obtain the
+ * frames in the input, until it returns SLIP_DECODER_NONE.
+ *
+ * The module depends only on the C library, so that it can also be
+ * built into the host tools in tools/serial-io.
+ *
+ * @{
+ */
+
+/**
+ * \file
+ *         Header file for the SLIP codec.
+ */
+
+#ifndef SLIP_CODEC_H_
+#define SLIP_CODEC_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SLIP_CODEC_END      0300
+#define SLIP_CODEC_ESC      0333
+#define SLIP_CODEC_ESC_END  0334
+#define SLIP_CODEC_ESC_ESC  0335
+#define SLIP_CODEC_ESC_XON  0336
+#define SLIP_CODEC_ESC_XOFF 0337
+#define SLIP_CODEC_XON      17
+#define SLIP_CODEC_XOFF     19
+
+/**
+ * Scan 16 bytes at a time with SSE2 when the compiler targets it.
+ * Otherwise, or if this is set to 0, the scan proceeds a machine word
+ * at a time.
+ */
+#ifdef SLIP_CODEC_CONF_SIMD
+#define SLIP_CODEC_SIMD SLIP_CODEC_CONF_SIMD
+#else
+#define SLIP_CODEC_SIMD 1
+#endif
+
+/** Escape the XON and XOFF characters, for links with software flow
+    control. */
+#define SLIP_CODEC_XONXOFF  0x01
+/** Make the decoder report each newline, for links on which debug
+    output is mixed with frames. */
+#define SLIP_CODEC_LINES    0x02
+
+/** The largest size of an encoded frame with a payload of len bytes. */
+#define SLIP_CODEC_ENCODED_SIZE_MAX(len) (2 * (len) + 1)
+
+/** The input has been consumed. */
+#define SLIP_DECODER_NONE     0
+/** A frame has been received. */
+#define SLIP_DECODER_FRAME    1
+/** A newline has been received, with SLIP_CODEC_LINES. */
+#define SLIP_DECODER_LINE     2
+/** The frame buffer filled up, and its contents are dropped. */
+#define SLIP_DECODER_OVERFLOW 3
+
+/**
+ * The state of a decoder. The data received so far is available in
+ * buf, and its length in len.
+ */
+typedef struct slip_decoder {
+  uint8_t *buf;
+  size_t size;
+  size_t len;
+  const uint8_t *input;
+  const uint8_t *input_end;
+  unsigned long frames;
+  unsigned long overflows;
+  uint8_t flags;
+  uint8_t state;
+  uint8_t special[4];
+} slip_decoder_t;
+
+/**
+ * \brief       Encode a frame.
+ * \param dst   The buffer to write the frame to, which must hold at
+ *              least SLIP_CODEC_ENCODED_SIZE_MAX(len) bytes.
+ * \param src   The payload of the frame.
+ * \param len   The length of the payload.
+ * \param flags SLIP_CODEC_XONXOFF, or 0.
+ * \return      The length of the encoded frame, including the
+ *              terminating END byte.
+ */
+size_t slip_codec_encode(uint8_t *dst, const void *src, size_t len,
+                         uint8_t flags);
+
+/**
+ * \brief       Initialize a decoder.
+ * \param d     A pointer to the decoder.
+ * \param buf   The buffer in which frames are assembled.
+ * \param size  The size of the buffer.
+ * \param flags SLIP_CODEC_XONXOFF, SLIP_CODEC_LINES, or 0.
+ *
+ *              The XON and XOFF escape sequences are always decoded;
+ *              the SLIP_CODEC_XONXOFF flag is accepted for symmetry
+ *              with the encoder.
+ */
+void slip_decoder_init(slip_decoder_t *d, uint8_t *buf, size_t size,
+                       uint8_t flags);
+
+/**
+ * \brief      Give the decoder a chunk of input.
+ * \param d    A pointer to the decoder.
+ * \param data The input, which must remain valid until
+ *             slip_decoder_next() returns SLIP_DECODER_NONE.
+ * \param len  The length of the input.
+ */
+void slip_decoder_input(slip_decoder_t *d, const void *data, size_t len);
+
+/**
+ * \brief      Decode the input up to the next event.
+ * \param d    A pointer to the decoder.
+ * \return     SLIP_DECODER_FRAME if a frame of d->len bytes is in
+ *             d->buf, SLIP_DECODER_LINE if the last byte in d->buf is
+ *             a newline, SLIP_DECODER_OVERFLOW if d->buf is full and
+ *             its contents are about to be dropped, or
+ *             SLIP_DECODER_NONE if the input has been consumed.
+ *
+ *             The buffer is emptied when the function is called again
+ *             after a frame or an overflow. After a newline, the data
+ *             is kept unless slip_decoder_reset() is called.
+ *             Empty frames are not reported.
+ */
+int slip_decoder_next(slip_decoder_t *d);
+
+/**
+ * \brief      Drop the data that has been received since the last frame.
+ * \param d    A pointer to the decoder.
+ */
+void slip_decoder_reset(slip_decoder_t *d);
+
+#endif /* SLIP_CODEC_H_ */
+
+/** @} */
+/** @} */
@@ -45,7 +45,7 @@
 #include "lib/trickle-timer.h"
 #include "sys/ctimer.h"
 #include "sys/cc.h"
-#include "lib/random.h"
+#include "lib/prng.h"
 /*---------------------------------------------------------------------------*/
 #define DEBUG 0
 
@@ -56,15 +56,9 @@
 #define PRINTF(...)
 #endif
 /*---------------------------------------------------------------------------*/
-/**
- * \brief Wide randoms for platforms using a 4-byte wide clock
- * (see ::TRICKLE_TIMER_WIDE_RAND)
- */
-#if TRICKLE_TIMER_WIDE_RAND
-#define tt_rand() wide_rand()
-#else
-#define tt_rand() random_rand()
-#endif
+/* Returns a random number in [0, bound) */
+#define tt_rand(bound) \
+  prng_uniform(prng_stream(PRNG_STREAM_TRICKLE), (uint32_t)(bound))
 /*---------------------------------------------------------------------------*/
 /* Declarations of variables of local interest */
 /*---------------------------------------------------------------------------*/
@@ -76,15 +70,6 @@ static void double_interval(void *ptr);
 /*---------------------------------------------------------------------------*/
 /* Local utilities and functions to be used as ctimer callbacks */
 /*---------------------------------------------------------------------------*/
-#if TRICKLE_TIMER_WIDE_RAND
-/* Returns a 4-byte wide, unsigned random number */
-static uint32_t
-wide_rand(void)
-{
-  return (uint32_t)random_rand() << 16 | random_rand();
-}
-#endif
-/*---------------------------------------------------------------------------*/
 /*
  * Returns the maximum sane Imax value for a given Imin
  *
@@ -162,7 +147,7 @@ get_t(clock_time_t i_cur)
   PRINTF("trickle_timer get t: [%lu, %lu)\n", (unsigned long)i_cur,
          (unsigned long)(i_cur << 1));
 
-  return i_cur + (tt_rand() % i_cur);
+  return i_cur + tt_rand(i_cur);
 }
 /*---------------------------------------------------------------------------*/
 static void
@@ -396,7 +381,7 @@ trickle_timer_set(struct trickle_timer *tt, trickle_timer_cb_t proto_cb,
 
   /* Random I in [Imin , Imax] */
   tt->i_cur = tt->i_min +
-    (tt_rand() % (TRICKLE_TIMER_INTERVAL_MAX(tt) - tt->i_min + 1));
+    tt_rand(TRICKLE_TIMER_INTERVAL_MAX(tt) - tt->i_min + 1);
 
   PRINTF("trickle_timer set: I=%lu in [%lu , %lu]\n", (unsigned long)tt->i_cur,
          (unsigned long)tt->i_min,
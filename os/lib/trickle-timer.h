@@ -152,6 +152,9 @@
  *
  * For platforms with a 2-byte wide clock_time_t, this can be defined as 0
  * to reduce code footprint and increase speed.
+ *
+ * \note The random numbers now come from the 32-bit trickle stream of the
+ * prng module whatever this setting, so it no longer has an effect.
  */
 #ifdef TRICKLE_TIMER_CONF_WIDE_RAND
 #define TRICKLE_TIMER_WIDE_RAND TRICKLE_TIMER_CONF_WIDE_RAND
@@ -155,6 +155,11 @@ coap_receive(const coap_endpoint_t *src,
   coap_status_code = coap_parse_message(message, payload, payload_length);
   coap_set_src_endpoint(message, src);
 
+  NET_STATS_INC(coap_net_stats, COAP_NET_STATS_RX);
+  if(coap_status_code != NO_ERROR) {
+    NET_STATS_INC(coap_net_stats, COAP_NET_STATS_RX_ERR);
+  }
+
   if(coap_status_code == NO_ERROR) {
 
     /*TODO duplicates suppression, if required by application */
@@ -170,6 +175,7 @@ coap_receive(const coap_endpoint_t *src,
 
     /* handle requests */
     if(message->code >= COAP_GET && message->code <= COAP_DELETE) {
+      NET_STATS_INC(coap_net_stats, COAP_NET_STATS_REQUESTS);
 
       /* use transaction buffer for response to confirmable request */
       if((transaction = coap_new_transaction(message->mid, src))) {
@@ -393,6 +399,7 @@ coap_engine_init(void)
 
   list_init(coap_handlers);
   list_init(coap_resource_services);
+  NET_STATS_REGISTER(coap_net_stats);
 
 #if COAP_WELL_KNOWN_RESOURCE_ENABLED
   coap_activate_resource(&res_well_known_core, ".well-known/core");
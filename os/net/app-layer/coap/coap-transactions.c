@@ -58,6 +58,22 @@
 MEMB(transactions_memb, coap_transaction_t, COAP_MAX_OPEN_TRANSACTIONS);
 LIST(transactions_list);
 
+#if NET_STATS
+static const char *const coap_net_stats_names[] = {
+  "rx", "rx_err", "requests", "tx", "retransmit", "timeout", "open"
+};
+
+static void
+coap_net_stats_update(struct net_stats *stats)
+{
+  stats->values[COAP_NET_STATS_OPEN] = list_length(transactions_list);
+}
+
+NET_STATS_GROUP(coap_net_stats, "coap", coap_net_stats_names,
+                NET_STATS_GAUGE(COAP_NET_STATS_OPEN),
+                coap_net_stats_update);
+#endif /* NET_STATS */
+
 /*---------------------------------------------------------------------------*/
 static void
 coap_retransmit_transaction(coap_timer_t *nt)
@@ -68,6 +84,7 @@ coap_retransmit_transaction(coap_timer_t *nt)
     return;
   }
   ++(t->retrans_counter);
+  NET_STATS_INC(coap_net_stats, COAP_NET_STATS_RETRANSMIT);
   LOG_DBG("Retransmitting %u (%u)\n", t->mid, t->retrans_counter);
   coap_send_transaction(t);
 }
@@ -103,6 +120,7 @@ coap_send_transaction(coap_transaction_t *t)
      ((COAP_HEADER_TYPE_MASK & t->message[0]) >> COAP_HEADER_TYPE_POSITION)) {
     if(t->retrans_counter <= COAP_MAX_RETRANSMIT) {
       /* not timed out yet */
+      NET_STATS_INC(coap_net_stats, COAP_NET_STATS_TX);
       coap_sendto(&t->endpoint, t->message, t->message_len);
       LOG_DBG("Keeping transaction %u\n", t->mid);
 
@@ -125,6 +143,7 @@ coap_send_transaction(coap_transaction_t *t)
     } else {
       /* timed out */
       LOG_DBG("Timeout\n");
+      NET_STATS_INC(coap_net_stats, COAP_NET_STATS_TIMEOUT);
       coap_resource_response_handler_t callback = t->callback;
       void *callback_data = t->callback_data;
 
@@ -138,6 +157,7 @@ coap_send_transaction(coap_transaction_t *t)
       }
     }
   } else {
+    NET_STATS_INC(coap_net_stats, COAP_NET_STATS_TX);
     coap_sendto(&t->endpoint, t->message, t->message_len);
     coap_clear_transaction(t);
   }
@@ -47,6 +47,7 @@
 #include "coap.h"
 #include "coap-engine.h"
 #include "coap-timer.h"
+#include "net/net-stats.h"
 
 /*
  * Modulo mask (thus +1) for a random number to get the tick number for the random
@@ -79,5 +80,20 @@ void coap_send_transaction(coap_transaction_t *t);
 void coap_clear_transaction(coap_transaction_t *t);
 coap_transaction_t *coap_get_transaction_by_mid(uint16_t mid);
 
+#if NET_STATS
+/* The counters of the "coap" statistics group */
+enum {
+  COAP_NET_STATS_RX,         /* Messages received */
+  COAP_NET_STATS_RX_ERR,     /* Messages that could not be parsed */
+  COAP_NET_STATS_REQUESTS,   /* Requests received */
+  COAP_NET_STATS_TX,         /* Transaction messages sent */
+  COAP_NET_STATS_RETRANSMIT, /* Retransmissions of confirmable messages */
+  COAP_NET_STATS_TIMEOUT,    /* Confirmable messages never acknowledged */
+  COAP_NET_STATS_OPEN,       /* Open transactions (gauge) */
+};
+
+extern struct net_stats coap_net_stats;
+#endif /* NET_STATS */
+
 #endif /* COAP_TRANSACTIONS_H_ */
 /** @} */
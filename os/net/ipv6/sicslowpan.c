@@ -75,6 +75,7 @@
 #include "net/queuebuf.h"
 
 #include "net/routing/routing.h"
+#include "net/net-stats.h"
 
 /* Log configuration */
 #include "sys/log.h"
@@ -449,6 +450,44 @@ copy_frags2uip(int context)
 #endif /* SICSLOWPAN_CONF_FRAG */
 
 /* -------------------------------------------------------------------------- */
+#if NET_STATS
+/* The counters of the "sicslowpan" statistics group */
+enum {
+  SICSLOWPAN_NET_STATS_OUT,       /* IPv6 packets to send */
+  SICSLOWPAN_NET_STATS_TX,        /* IPv6 packets compressed and sent */
+  SICSLOWPAN_NET_STATS_TX_FRAMES, /* Frames passed to the MAC layer */
+  SICSLOWPAN_NET_STATS_RX_FRAMES, /* Frames received from the MAC layer */
+  SICSLOWPAN_NET_STATS_RX_FRAGS,  /* Fragments received */
+  SICSLOWPAN_NET_STATS_FRAG_ERR,  /* Fragments without a reassembly context */
+  SICSLOWPAN_NET_STATS_RX,        /* IPv6 packets passed to the IPv6 layer */
+  SICSLOWPAN_NET_STATS_REASS,     /* Packets being reassembled (gauge) */
+};
+
+static const char *const sicslowpan_net_stats_names[] = {
+  "out", "tx", "tx_frames", "rx_frames", "rx_frags", "frag_err", "rx",
+  "reass"
+};
+
+static void
+sicslowpan_net_stats_update(struct net_stats *stats)
+{
+  uint32_t reassembling = 0;
+
+#if SICSLOWPAN_CONF_FRAG
+  for(int i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
+    if(frag_info[i].len > 0) {
+      reassembling++;
+    }
+  }
+#endif /* SICSLOWPAN_CONF_FRAG */
+  stats->values[SICSLOWPAN_NET_STATS_REASS] = reassembling;
+}
+
+NET_STATS_GROUP(sicslowpan_net_stats, "sicslowpan",
+                sicslowpan_net_stats_names,
+                NET_STATS_GAUGE(SICSLOWPAN_NET_STATS_REASS),
+                sicslowpan_net_stats_update);
+#endif /* NET_STATS */
 
 /*-------------------------------------------------------------------------*/
 /* Basic netstack sniffer */
@@ -1560,6 +1599,7 @@ send_packet(void)
 {
   /* Provide a callback function to receive the result of
      a packet transmission. */
+  NET_STATS_INC(sicslowpan_net_stats, SICSLOWPAN_NET_STATS_TX_FRAMES);
   NETSTACK_MAC.send(&packet_sent, NULL);
 
   /* If we are sending multiple packets in a row, we need to let the
@@ -1623,6 +1663,8 @@ output(const linkaddr_t *localdest)
 {
   int frag_needed;
 
+  NET_STATS_INC(sicslowpan_net_stats, SICSLOWPAN_NET_STATS_OUT);
+
   /* init */
   uncomp_hdr_len = UIP_IPH_LEN;
   packetbuf_hdr_len = 0;
@@ -1830,6 +1872,7 @@ output(const linkaddr_t *localdest)
     packetbuf_set_datalen(uip_len - uncomp_hdr_len + packetbuf_hdr_len);
     send_packet();
   }
+  NET_STATS_INC(sicslowpan_net_stats, SICSLOWPAN_NET_STATS_TX);
   return 1;
 }
 
@@ -1866,6 +1909,7 @@ input(void)
 
   /* Update link statistics */
   link_stats_input_callback(packetbuf_addr(PACKETBUF_ADDR_SENDER));
+  NET_STATS_INC(sicslowpan_net_stats, SICSLOWPAN_NET_STATS_RX_FRAMES);
 
   /* init */
   uncomp_hdr_len = 0;
@@ -1911,9 +1955,11 @@ input(void)
              frag_tag, frag_size);
 
       /* Add the fragment to the fragmentation context */
+      NET_STATS_INC(sicslowpan_net_stats, SICSLOWPAN_NET_STATS_RX_FRAGS);
       frag_context = add_fragment(frag_tag, frag_size, frag_offset);
 
       if(frag_context == -1) {
+        NET_STATS_INC(sicslowpan_net_stats, SICSLOWPAN_NET_STATS_FRAG_ERR);
         LOG_ERR("input: failed to allocate new reassembly context\n");
         return;
       }
@@ -1933,9 +1979,11 @@ input(void)
 
       /* Add the fragment to the fragmentation context (this will also
          copy the payload) */
+      NET_STATS_INC(sicslowpan_net_stats, SICSLOWPAN_NET_STATS_RX_FRAGS);
       frag_context = add_fragment(frag_tag, frag_size, frag_offset);
 
       if(frag_context == -1) {
+        NET_STATS_INC(sicslowpan_net_stats, SICSLOWPAN_NET_STATS_FRAG_ERR);
         LOG_ERR("input: reassembly context not found (tag %d)\n", frag_tag);
         return;
       }
@@ -2112,6 +2160,7 @@ input(void)
 #endif /* LLSEC802154_USES_EXPLICIT_KEYS */
 #endif /*  LLSEC802154_USES_AUX_HEADER */
 
+    NET_STATS_INC(sicslowpan_net_stats, SICSLOWPAN_NET_STATS_RX);
     tcpip_input();
 #if SICSLOWPAN_CONF_FRAG
   }
@@ -2125,6 +2174,7 @@ input(void)
 void
 sicslowpan_init(void)
 {
+  NET_STATS_REGISTER(sicslowpan_net_stats);
 
 #if SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_IPHC
 /* Preinitialize any address contexts for better header compression
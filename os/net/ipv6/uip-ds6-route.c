@@ -43,6 +43,7 @@
 #include "net/ipv6/uip.h"
 
 #include "lib/list.h"
+#include "lib/dbl-circ-list.h"
 #include "lib/memb.h"
 #include "net/nbr-table.h"
 
@@ -79,7 +80,7 @@ MEMB(neighborroutememb, struct uip_ds6_route_neighbor_route, UIP_DS6_ROUTE_NB);
 /* Each route is repressented by a uip_ds6_route_t structure and
    memory for each route is allocated from the routememb memory
    block. These routes are maintained on the routelist. */
-LIST(routelist);
+DBL_CIRC_LIST(routelist);
 MEMB(routememb, uip_ds6_route_t, UIP_DS6_ROUTE_NB);
 
 static int num_routes = 0;
@@ -167,7 +168,7 @@ uip_ds6_route_init(void)
 {
 #if (UIP_MAX_ROUTES != 0)
   memb_init(&routememb);
-  list_init(routelist);
+  dbl_circ_list_init(routelist);
   nbr_table_register(nbr_routes,
                      (nbr_table_callback *)rm_routelist_callback);
 #endif /* (UIP_MAX_ROUTES != 0) */
@@ -226,7 +227,7 @@ uip_ds6_route_t *
 uip_ds6_route_head(void)
 {
 #if (UIP_MAX_ROUTES != 0)
-  return list_head(routelist);
+  return dbl_circ_list_head(routelist);
 #else /* (UIP_MAX_ROUTES != 0) */
   return NULL;
 #endif /* (UIP_MAX_ROUTES != 0) */
@@ -237,8 +238,9 @@ uip_ds6_route_next(uip_ds6_route_t *r)
 {
 #if (UIP_MAX_ROUTES != 0)
   if(r != NULL) {
-    uip_ds6_route_t *n = list_item_next(r);
-    return n;
+    /* The route list is circular, so it ends before the head. */
+    uip_ds6_route_t *n = r->next;
+    return n != dbl_circ_list_head(routelist) ? n : NULL;
   }
 #endif /* (UIP_MAX_ROUTES != 0) */
   return NULL;
@@ -313,14 +315,13 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
     LOG_INFO("No route found\n");
   }
 
-  if(found_route != NULL && found_route != list_head(routelist)) {
+  if(found_route != NULL && found_route != dbl_circ_list_head(routelist)) {
     /* If we found a route, we put it at the start of the routeslist
        list. The list is ordered by how recently we looked them up:
        the least recently used route will be at the end of the
        list - for fast lookups (assuming multiple packets to the same node). */
 
-    list_remove(routelist, found_route);
-    list_push(routelist, found_route);
+    dbl_circ_list_add_head(routelist, found_route);
   }
 
   return found_route;
@@ -383,7 +384,7 @@ uip_ds6_route_add(const uip_ipaddr_t *ipaddr, uint8_t length,
 #if UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
       /* Removing the oldest route entry from the route table. The
          least recently used route is the first route on the list. */
-      oldest = list_tail(routelist);
+      oldest = dbl_circ_list_tail(routelist);
 #endif
       if(oldest == NULL) {
         return NULL;
@@ -439,13 +440,14 @@ uip_ds6_route_add(const uip_ipaddr_t *ipaddr, uint8_t length,
 
     /* add new routes first - assuming that there is a reason to add this
        and that there is a packet coming soon. */
-    list_push(routelist, r);
+    dbl_circ_list_add_head(routelist, r);
 
     nbrr = memb_alloc(&neighborroutememb);
     if(nbrr == NULL) {
       /* This should not happen, as we explicitly deallocated one
          route table entry above. */
       LOG_ERR("Add: could not allocate neighbor route list entry\n");
+      dbl_circ_list_remove(routelist, r);
       memb_free(&routememb, r);
       return NULL;
     }
@@ -508,7 +510,7 @@ uip_ds6_route_rm(uip_ds6_route_t *route)
     LOG_INFO_("\n");
 
     /* Remove the route from the route list */
-    list_remove(routelist, route);
+    dbl_circ_list_remove(routelist, route);
 
     /* Find the corresponding neighbor_route and remove it. */
     for(neighbor_route = list_head(route->neighbor_routes->route_list);
@@ -169,7 +169,10 @@ struct uip_ds6_route_neighbor_routes {
 
 /** \brief An entry in the routing table */
 typedef struct uip_ds6_route {
+  /* The route list is doubly linked, so that a route can be moved to
+     the front of the list or removed without searching the list. */
   struct uip_ds6_route *next;
+  struct uip_ds6_route *previous;
   /* Each route entry belongs to a specific neighbor. That neighbor
      holds a list of all routing entries that go through it. The
      routes field point to the uip_ds6_route_neighbor_routes that
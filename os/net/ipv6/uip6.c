@@ -80,6 +80,7 @@
 #include "net/ipv6/uip-ds6.h"
 #include "net/ipv6/multicast/uip-mcast6.h"
 #include "net/routing/routing.h"
+#include "net/net-stats.h"
 
 #if UIP_ND6_SEND_NS
 #include "net/ipv6/uip-ds6-nbr.h"
@@ -94,6 +95,50 @@
 struct uip_stats uip_stat;
 #endif /* UIP_STATISTICS == 1 */
 
+#if NET_STATS && UIP_STATISTICS == 1
+/* The "ipv6" statistics group follows a selection of the uIP
+   statistics, which may be narrower than the 32-bit counters. */
+static const char *const ipv6_net_stats_names[] = {
+  "rx", "tx", "fwd", "drop", "icmp_rx", "icmp_tx", "icmp_drop",
+#if UIP_UDP
+  "udp_rx", "udp_tx", "udp_drop",
+#endif /* UIP_UDP */
+#if UIP_TCP
+  "tcp_rx", "tcp_tx", "tcp_drop",
+#endif /* UIP_TCP */
+};
+
+static uip_stats_t *const ipv6_net_stats_sources[] = {
+  &uip_stat.ip.recv, &uip_stat.ip.sent, &uip_stat.ip.forwarded,
+  &uip_stat.ip.drop, &uip_stat.icmp.recv, &uip_stat.icmp.sent,
+  &uip_stat.icmp.drop,
+#if UIP_UDP
+  &uip_stat.udp.recv, &uip_stat.udp.sent, &uip_stat.udp.drop,
+#endif /* UIP_UDP */
+#if UIP_TCP
+  &uip_stat.tcp.recv, &uip_stat.tcp.sent, &uip_stat.tcp.drop,
+#endif /* UIP_TCP */
+};
+
+static uip_stats_t ipv6_net_stats_seen[sizeof(ipv6_net_stats_sources) /
+                                       sizeof(ipv6_net_stats_sources[0])];
+
+static void
+ipv6_net_stats_update(struct net_stats *stats)
+{
+  for(uint8_t i = 0; i < stats->count; i++) {
+    /* Add the change since the last update, so that the counter does
+       not wrap around with a narrower uip_stats_t. */
+    stats->values[i] += (uip_stats_t)(*ipv6_net_stats_sources[i] -
+                                      ipv6_net_stats_seen[i]);
+    ipv6_net_stats_seen[i] = *ipv6_net_stats_sources[i];
+  }
+}
+
+NET_STATS_GROUP(ipv6_net_stats, "ipv6", ipv6_net_stats_names, 0,
+                ipv6_net_stats_update);
+#endif /* NET_STATS && UIP_STATISTICS == 1 */
+
 /*---------------------------------------------------------------------------*/
 /**
  * \name Layer 2 variables
@@ -391,6 +436,10 @@ uip_init(void)
   uip_icmp6_init();
   uip_nd6_init();
 
+#if NET_STATS && UIP_STATISTICS == 1
+  NET_STATS_REGISTER(ipv6_net_stats);
+#endif /* NET_STATS && UIP_STATISTICS == 1 */
+
 #if UIP_TCP
   for(int c = 0; c < UIP_LISTENPORTS; ++c) {
     uip_listenports[c] = 0;
@@ -97,14 +97,18 @@
 /**
  * Determines if statistics support should be compiled in.
  *
- * The statistics is useful for debugging and to show the user.
+ * The statistics is useful for debugging and to show the user. They
+ * are compiled in by default when the network stack statistics
+ * (NET_STATS_CONF_ENABLED) are, which show them in the "ipv6" group.
  *
  * \hideinitializer
  */
-#ifndef UIP_CONF_STATISTICS
-#define UIP_STATISTICS  0
-#else /* UIP_CONF_STATISTICS */
+#ifdef UIP_CONF_STATISTICS
 #define UIP_STATISTICS (UIP_CONF_STATISTICS)
+#elif defined(NET_STATS_CONF_ENABLED)
+#define UIP_STATISTICS (NET_STATS_CONF_ENABLED)
+#else /* UIP_CONF_STATISTICS */
+#define UIP_STATISTICS  0
 #endif /* UIP_CONF_STATISTICS */
 
 /** @} */
@@ -40,6 +40,7 @@
  */
 
 #include "net/mac/csma/csma.h"
+#include "net/mac/csma/csma-output.h"
 #include "net/mac/csma/csma-security.h"
 #include "net/mac/mac-sequence.h"
 #include "net/packetbuf.h"
@@ -47,11 +48,13 @@
 #include "dev/watchdog.h"
 #include "sys/ctimer.h"
 #include "sys/clock.h"
-#include "lib/random.h"
+#include "lib/prng.h"
 #include "net/netstack.h"
 #include "lib/list.h"
+#include "lib/dbl-circ-list.h"
 #include "lib/memb.h"
 #include "lib/assert.h"
+#include "net/net-stats.h"
 
 /* Log configuration */
 #include "sys/log.h"
@@ -98,6 +101,7 @@ struct qbuf_metadata {
 /* Every neighbor has its own packet queue */
 struct neighbor_queue {
   struct neighbor_queue *next;
+  struct neighbor_queue *previous;
   linkaddr_t addr;
   struct ctimer transmit_timer;
   uint8_t transmissions;
@@ -131,7 +135,27 @@ struct packet_queue {
 MEMB(neighbor_memb, struct neighbor_queue, CSMA_MAX_NEIGHBOR_QUEUES);
 MEMB(packet_memb, struct packet_queue, MAX_QUEUED_PACKETS);
 MEMB(metadata_memb, struct qbuf_metadata, MAX_QUEUED_PACKETS);
-LIST(neighbor_list);
+/* The neighbor list is doubly linked, so that neighbors can be added
+   and removed without searching the list. */
+DBL_CIRC_LIST(neighbor_list);
+
+#if NET_STATS
+static const char *const csma_net_stats_names[] = {
+  "out", "queue_full", "tx_ok", "noack", "collision", "tx_err", "dropped",
+  "rx", "rx_dup", "rx_err", "queued"
+};
+
+static void
+csma_net_stats_update(struct net_stats *stats)
+{
+  stats->values[CSMA_NET_STATS_QUEUED] =
+    packet_memb.num - memb_numfree(&packet_memb);
+}
+
+NET_STATS_GROUP(csma_net_stats, "csma", csma_net_stats_names,
+                NET_STATS_GAUGE(CSMA_NET_STATS_QUEUED),
+                csma_net_stats_update);
+#endif /* NET_STATS */
 
 static void packet_sent(struct neighbor_queue *n,
     struct packet_queue *q,
@@ -142,12 +166,16 @@ static void transmit_from_queue(void *ptr);
 static struct neighbor_queue *
 neighbor_queue_from_addr(const linkaddr_t *addr)
 {
-  struct neighbor_queue *n = list_head(neighbor_list);
-  while(n != NULL) {
-    if(linkaddr_cmp(&n->addr, addr)) {
-      return n;
-    }
-    n = list_item_next(n);
+  struct neighbor_queue *head = dbl_circ_list_head(neighbor_list);
+  struct neighbor_queue *n = head;
+
+  if(n != NULL) {
+    do {
+      if(linkaddr_cmp(&n->addr, addr)) {
+        return n;
+      }
+      n = n->next;
+    } while(n != head);
   }
   return NULL;
 }
@@ -285,7 +313,7 @@ schedule_transmission(struct neighbor_queue *n)
   delay = ((1 << backoff_exponent) - 1) * backoff_period();
   if(delay > 0) {
     /* Pick a time for next transmission */
-    delay = random_rand() % delay;
+    delay = prng_uniform(prng_stream(PRNG_STREAM_MAC), delay);
   }
 
   LOG_DBG("scheduling transmission in %u ticks, NB=%u, BE=%u\n",
@@ -314,7 +342,7 @@ free_packet(struct neighbor_queue *n, struct packet_queue *p, int status)
     } else {
       /* This was the last packet in the queue, we free the neighbor */
       ctimer_stop(&n->transmit_timer);
-      list_remove(neighbor_list, n);
+      dbl_circ_list_remove(neighbor_list, n);
       memb_free(&neighbor_memb, n);
     }
   }
@@ -333,6 +361,10 @@ tx_done(int status, struct packet_queue *q, struct neighbor_queue *n)
   cptr = metadata->cptr;
   ntx = n->transmissions;
 
+  if(status != MAC_TX_OK) {
+    NET_STATS_INC(csma_net_stats, CSMA_NET_STATS_DROPPED);
+  }
+
   LOG_INFO("packet sent to ");
   LOG_INFO_LLADDR(&n->addr);
   LOG_INFO_(", seqno %u, status %u, tx %u, coll %u\n",
@@ -422,17 +454,21 @@ packet_sent(struct neighbor_queue *n,
 
   switch(status) {
   case MAC_TX_OK:
+    NET_STATS_INC(csma_net_stats, CSMA_NET_STATS_TX_OK);
     tx_ok(q, n, num_transmissions);
     break;
   case MAC_TX_NOACK:
+    NET_STATS_INC(csma_net_stats, CSMA_NET_STATS_NOACK);
     noack(q, n, num_transmissions);
     break;
   case MAC_TX_COLLISION:
+    NET_STATS_INC(csma_net_stats, CSMA_NET_STATS_COLLISION);
     collision(q, n, num_transmissions);
     break;
   case MAC_TX_DEFERRED:
     break;
   default:
+    NET_STATS_INC(csma_net_stats, CSMA_NET_STATS_TX_ERR);
     tx_done(status, q, n);
     break;
   }
@@ -461,7 +497,7 @@ csma_output_packet(mac_callback_t sent, void *ptr)
       /* Init packet queue for this neighbor */
       LIST_STRUCT_INIT(n, packet_queue);
       /* Add neighbor to the neighbor list */
-      list_add(neighbor_list, n);
+      dbl_circ_list_add_tail(neighbor_list, n);
     }
   }
 
@@ -484,6 +520,7 @@ csma_output_packet(mac_callback_t sent, void *ptr)
             metadata->sent = sent;
             metadata->cptr = ptr;
             list_add(n->packet_queue, q);
+            NET_STATS_INC(csma_net_stats, CSMA_NET_STATS_OUT);
 
             LOG_INFO("sending to ");
             LOG_INFO_LLADDR(addr);
@@ -505,7 +542,7 @@ csma_output_packet(mac_callback_t sent, void *ptr)
       }
       /* The packet allocation failed. Remove and free neighbor entry if empty. */
       if(list_length(n->packet_queue) == 0) {
-        list_remove(neighbor_list, n);
+        dbl_circ_list_remove(neighbor_list, n);
         memb_free(&neighbor_memb, n);
       }
     } else {
@@ -515,6 +552,7 @@ csma_output_packet(mac_callback_t sent, void *ptr)
   } else {
     LOG_WARN("could not allocate neighbor, dropping packet\n");
   }
+  NET_STATS_INC(csma_net_stats, CSMA_NET_STATS_QUEUE_FULL);
   mac_call_sent_callback(sent, ptr, MAC_TX_QUEUE_FULL, 1);
 }
 /*---------------------------------------------------------------------------*/
@@ -524,4 +562,5 @@ csma_output_init(void)
   memb_init(&packet_memb);
   memb_init(&metadata_memb);
   memb_init(&neighbor_memb);
+  NET_STATS_REGISTER(csma_net_stats);
 }
@@ -44,6 +44,26 @@
 
 #include "contiki.h"
 #include "net/mac/mac.h"
+#include "net/net-stats.h"
+
+#if NET_STATS
+/* The counters of the "csma" statistics group */
+enum {
+  CSMA_NET_STATS_OUT,        /* Packets queued for transmission */
+  CSMA_NET_STATS_QUEUE_FULL, /* Packets dropped because the queue was full */
+  CSMA_NET_STATS_TX_OK,      /* Transmissions that were acknowledged */
+  CSMA_NET_STATS_NOACK,      /* Transmissions that were not acknowledged */
+  CSMA_NET_STATS_COLLISION,  /* Transmissions deferred by a busy channel */
+  CSMA_NET_STATS_TX_ERR,     /* Transmissions that failed otherwise */
+  CSMA_NET_STATS_DROPPED,    /* Packets given up after the last retry */
+  CSMA_NET_STATS_RX,         /* Frames passed to the network layer */
+  CSMA_NET_STATS_RX_DUP,     /* Duplicate frames */
+  CSMA_NET_STATS_RX_ERR,     /* Frames that could not be parsed */
+  CSMA_NET_STATS_QUEUED,     /* Packets in the queue (gauge) */
+};
+
+extern struct net_stats csma_net_stats;
+#endif /* NET_STATS */
 
 void csma_output_packet(mac_callback_t sent, void *ptr);
 void csma_output_init(void);
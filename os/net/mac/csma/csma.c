@@ -82,6 +82,7 @@ input_packet(void)
     /* Ignore ack packets */
     LOG_DBG("ignored ack\n");
   } else if(CSMA_FRAMER.parse() < 0) {
+    NET_STATS_INC(csma_net_stats, CSMA_NET_STATS_RX_ERR);
     LOG_ERR("failed to parse %u\n", packetbuf_datalen());
   } else if(!linkaddr_cmp(packetbuf_addr(PACKETBUF_ADDR_RECEIVER),
                                          &linkaddr_node_addr) &&
@@ -96,6 +97,7 @@ input_packet(void)
     duplicate = mac_sequence_is_duplicate();
     if(duplicate) {
       /* Drop the packet. */
+      NET_STATS_INC(csma_net_stats, CSMA_NET_STATS_RX_DUP);
       LOG_WARN("drop duplicate link layer packet from ");
       LOG_WARN_LLADDR(packetbuf_addr(PACKETBUF_ADDR_SENDER));
       LOG_WARN_(", seqno %u\n", packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO));
@@ -115,6 +117,7 @@ input_packet(void)
       LOG_INFO("received packet from ");
       LOG_INFO_LLADDR(packetbuf_addr(PACKETBUF_ADDR_SENDER));
       LOG_INFO_(", seqno %u, len %u\n", packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO), packetbuf_datalen());
+      NET_STATS_INC(csma_net_stats, CSMA_NET_STATS_RX);
       NETSTACK_NETWORK.input();
     }
   }
@@ -57,6 +57,7 @@
 #include "net/mac/mac-sequence.h"
 #include "lib/random.h"
 #include "net/routing/routing.h"
+#include "net/net-stats.h"
 #include <inttypes.h>
 
 #if TSCH_WITH_SIXTOP
@@ -89,6 +90,40 @@ struct eb_stat {
 NBR_TABLE(struct eb_stat, eb_stats);
 #endif /* TSCH_AUTOSELECT_TIME_SOURCE */
 
+#if NET_STATS
+/* The counters of the "tsch" statistics group. The outcome of a
+   packet is counted when it leaves the queue, after its last
+   transmission. */
+enum {
+  TSCH_NET_STATS_OUT,
+  TSCH_NET_STATS_QUEUE_FULL,
+  TSCH_NET_STATS_TX_OK,
+  TSCH_NET_STATS_NOACK,
+  TSCH_NET_STATS_COLLISION,
+  TSCH_NET_STATS_TX_ERR,
+  TSCH_NET_STATS_RX,
+  TSCH_NET_STATS_RX_DUP,
+  TSCH_NET_STATS_RX_ERR,
+  TSCH_NET_STATS_EB_RX,
+  TSCH_NET_STATS_QUEUED,
+};
+
+static const char *const tsch_net_stats_names[] = {
+  "out", "queue_full", "tx_ok", "noack", "collision", "tx_err",
+  "rx", "rx_dup", "rx_err", "eb_rx", "queued"
+};
+
+static void
+tsch_net_stats_update(struct net_stats *stats)
+{
+  stats->values[TSCH_NET_STATS_QUEUED] = tsch_queue_global_packet_count();
+}
+
+NET_STATS_GROUP(tsch_net_stats, "tsch", tsch_net_stats_names,
+                NET_STATS_GAUGE(TSCH_NET_STATS_QUEUED),
+                tsch_net_stats_update);
+#endif /* NET_STATS */
+
 /* TSCH channel hopping sequence */
 uint8_t tsch_hopping_sequence[TSCH_HOPPING_SEQUENCE_MAX_LEN];
 struct tsch_asn_divisor_t tsch_hopping_sequence_length;
@@ -521,6 +556,7 @@ tsch_rx_process_pending()
       link_stats_input_callback((const linkaddr_t *)frame.src_addr);
 
       /* Process EB without copying the payload to packetbuf */
+      NET_STATS_INC(tsch_net_stats, TSCH_NET_STATS_EB_RX);
       eb_input(current_input);
     }
 
@@ -544,6 +580,22 @@ tsch_tx_process_pending(void)
     LOG_INFO_LLADDR(packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
     LOG_INFO_(", seqno %u, status %d, tx %d\n",
       packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO), p->ret, p->transmissions);
+#if NET_STATS
+    switch(p->ret) {
+    case MAC_TX_OK:
+      NET_STATS_INC(tsch_net_stats, TSCH_NET_STATS_TX_OK);
+      break;
+    case MAC_TX_NOACK:
+      NET_STATS_INC(tsch_net_stats, TSCH_NET_STATS_NOACK);
+      break;
+    case MAC_TX_COLLISION:
+      NET_STATS_INC(tsch_net_stats, TSCH_NET_STATS_COLLISION);
+      break;
+    default:
+      NET_STATS_INC(tsch_net_stats, TSCH_NET_STATS_TX_ERR);
+      break;
+    }
+#endif /* NET_STATS */
     /* Call packet_sent callback */
     mac_call_sent_callback(p->sent, p->ptr, p->ret, p->transmissions);
     /* Free packet queuebuf */
@@ -1083,6 +1135,7 @@ tsch_init(void)
 
   tsch_stats_init();
   tsch_roots_init();
+  NET_STATS_REGISTER(tsch_net_stats);
 }
 /*---------------------------------------------------------------------------*/
 /* Function send for TSCH-MAC, puts the packet in packetbuf in the MAC queue */
@@ -1147,8 +1200,10 @@ send_packet(mac_callback_t sent, void *ptr)
           tsch_queue_nbr_packet_count(n),
           TSCH_QUEUE_NUM_PER_NEIGHBOR, tsch_queue_global_packet_count(),
           QUEUEBUF_NUM);
+      NET_STATS_INC(tsch_net_stats, TSCH_NET_STATS_QUEUE_FULL);
       ret = MAC_TX_QUEUE_FULL;
     } else {
+      NET_STATS_INC(tsch_net_stats, TSCH_NET_STATS_OUT);
       p->header_len = hdr_len;
       LOG_INFO("send packet to ");
       LOG_INFO_LLADDR(addr);
@@ -1172,6 +1227,7 @@ packet_input(void)
   frame_parsed = NETSTACK_FRAMER.parse();
 
   if(frame_parsed < 0) {
+    NET_STATS_INC(tsch_net_stats, TSCH_NET_STATS_RX_ERR);
     LOG_ERR("! failed to parse %u\n", packetbuf_datalen());
   } else {
     int duplicate = 0;
@@ -1182,6 +1238,7 @@ packet_input(void)
       duplicate = mac_sequence_is_duplicate();
       if(duplicate) {
         /* Drop the packet. */
+        NET_STATS_INC(tsch_net_stats, TSCH_NET_STATS_RX_DUP);
         LOG_WARN("! drop dup ll from ");
         LOG_WARN_LLADDR(packetbuf_addr(PACKETBUF_ADDR_SENDER));
         LOG_WARN_(" seqno %u\n", packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO));
@@ -1197,6 +1254,7 @@ packet_input(void)
 #if TSCH_WITH_SIXTOP
       sixtop_input();
 #endif /* TSCH_WITH_SIXTOP */
+      NET_STATS_INC(tsch_net_stats, TSCH_NET_STATS_RX);
       NETSTACK_NETWORK.input();
     }
   }
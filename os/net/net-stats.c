@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup net-stats
+ * @{
+ */
+
+/**
+ * \file
+ *         The registry of network stack statistics.
+ */
+
+#include "contiki.h"
+#include "net/net-stats.h"
+#include "lib/cbor.h"
+#include "lib/list.h"
+
+#include <string.h>
+
+LIST(groups);
+static clock_time_t mark_time;
+static bool marked;
+/*---------------------------------------------------------------------------*/
+void
+net_stats_register(struct net_stats *stats)
+{
+  if(list_contains(groups, stats)) {
+    return;
+  }
+  if(!marked) {
+    mark_time = clock_time();
+    marked = true;
+  }
+  list_add(groups, stats);
+}
+/*---------------------------------------------------------------------------*/
+struct net_stats *
+net_stats_head(void)
+{
+  return list_head(groups);
+}
+/*---------------------------------------------------------------------------*/
+struct net_stats *
+net_stats_find(const char *name)
+{
+  struct net_stats *stats;
+
+  for(stats = list_head(groups); stats != NULL; stats = stats->next) {
+    if(!strcmp(stats->name, name)) {
+      return stats;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+void
+net_stats_update(void)
+{
+  struct net_stats *stats;
+
+  for(stats = list_head(groups); stats != NULL; stats = stats->next) {
+    if(stats->update != NULL) {
+      stats->update(stats);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+net_stats_mark(void)
+{
+  struct net_stats *stats;
+
+  for(stats = list_head(groups); stats != NULL; stats = stats->next) {
+    memcpy(stats->last, stats->values, stats->count * sizeof(uint32_t));
+  }
+  mark_time = clock_time();
+  marked = true;
+}
+/*---------------------------------------------------------------------------*/
+clock_time_t
+net_stats_interval(void)
+{
+  return clock_time() - mark_time;
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+net_stats_delta(const struct net_stats *stats, uint8_t counter)
+{
+  if(stats->gauges & NET_STATS_GAUGE(counter)) {
+    return 0;
+  }
+  /* Unsigned arithmetic gives the right change across a wrap-around. */
+  return stats->values[counter] - stats->last[counter];
+}
+/*---------------------------------------------------------------------------*/
+void
+net_stats_reset(void)
+{
+  struct net_stats *stats;
+  uint8_t i;
+
+  for(stats = list_head(groups); stats != NULL; stats = stats->next) {
+    for(i = 0; i < stats->count; i++) {
+      if(!(stats->gauges & NET_STATS_GAUGE(i))) {
+        stats->values[i] = 0;
+      }
+    }
+  }
+  net_stats_mark();
+}
+/*---------------------------------------------------------------------------*/
+static void
+write_key(cbor_writer_state_t *writer, const char *key)
+{
+  cbor_write_text(writer, key, strlen(key));
+}
+/*---------------------------------------------------------------------------*/
+size_t
+net_stats_to_cbor(const struct net_stats *stats, uint8_t *buf, size_t size)
+{
+  cbor_writer_state_t writer;
+  uint8_t i;
+
+  cbor_init_writer(&writer, buf, size);
+  cbor_open_map(&writer);
+
+  write_key(&writer, "group");
+  write_key(&writer, stats->name);
+  write_key(&writer, "ms");
+  cbor_write_unsigned(&writer,
+                      (uint64_t)net_stats_interval() * 1000 / CLOCK_SECOND);
+
+  write_key(&writer, "values");
+  cbor_open_map(&writer);
+  for(i = 0; i < stats->count; i++) {
+    write_key(&writer, stats->names[i]);
+    cbor_write_unsigned(&writer, stats->values[i]);
+  }
+  cbor_close_map(&writer);
+
+  write_key(&writer, "deltas");
+  cbor_open_map(&writer);
+  for(i = 0; i < stats->count; i++) {
+    if(!(stats->gauges & NET_STATS_GAUGE(i))) {
+      write_key(&writer, stats->names[i]);
+      cbor_write_unsigned(&writer, net_stats_delta(stats, i));
+    }
+  }
+  cbor_close_map(&writer);
+
+  cbor_close_map(&writer);
+  return cbor_end_writer(&writer);
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup net
+ * @{
+ */
+
+/**
+ * \defgroup net-stats Network stack statistics
+ *
+ * The net-stats module keeps a registry of counters for the layers of
+ * the network stack. Each layer declares a group of named counters
+ * with NET_STATS_GROUP(), registers it when it is initialized, and
+ * increments the counters with NET_STATS_INC() and NET_STATS_ADD(). A
+ * counter can also be declared as a gauge, such as a queue length,
+ * which the group sets in its update function before the values are
+ * read.
+ *
+ * A reader, such as the "stats" shell command, calls net_stats_update()
+ * before reading the values, and net_stats_mark() after reading them.
+ * The module remembers the values and the time of the last mark, so
+ * that the reader can show how much each counter has changed since the
+ * previous reading, and at what rate. A group can also be encoded as
+ * CBOR for tools that collect the statistics of many nodes.
+ *
+ * The module is enabled with NET_STATS_CONF_ENABLED. Otherwise, the
+ * macros that update counters expand to nothing.
+ *
+ * @{
+ */
+
+/**
+ * \file
+ *         Header file for the network stack statistics.
+ */
+
+#ifndef NET_STATS_H_
+#define NET_STATS_H_
+
+#include "contiki.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef NET_STATS_CONF_ENABLED
+#define NET_STATS NET_STATS_CONF_ENABLED
+#else /* NET_STATS_CONF_ENABLED */
+#define NET_STATS 0
+#endif /* NET_STATS_CONF_ENABLED */
+
+/* The largest CBOR encoding of a group, see net_stats_to_cbor(). */
+#ifdef NET_STATS_CONF_CBOR_MAX
+#define NET_STATS_CBOR_MAX NET_STATS_CONF_CBOR_MAX
+#else /* NET_STATS_CONF_CBOR_MAX */
+#define NET_STATS_CBOR_MAX 256
+#endif /* NET_STATS_CONF_CBOR_MAX */
+
+/** A group of counters of a layer. */
+struct net_stats {
+  struct net_stats *next;
+  /** The name of the group, such as "csma". */
+  const char *name;
+  /** The names of the counters. */
+  const char *const *names;
+  /** The current values of the counters. */
+  uint32_t *values;
+  /** The values of the counters at the last net_stats_mark(). */
+  uint32_t *last;
+  /** The number of counters, at most 32. */
+  uint8_t count;
+  /** A bitmap in which a set bit marks a counter that is a gauge. */
+  uint32_t gauges;
+  /** A function that sets the gauges and other derived values, or NULL. */
+  void (*update)(struct net_stats *stats);
+};
+
+/** The bit of a counter in the gauges bitmap. */
+#define NET_STATS_GAUGE(counter) ((uint32_t)1 << (counter))
+
+#if NET_STATS
+/**
+ * Declare a group of counters.
+ *
+ * \param var    The name of the group variable.
+ * \param label  The name of the group, as shown to the user.
+ * \param names  An array with the names of the counters.
+ * \param gauges A bitmap of the counters that are gauges, built
+ *               with NET_STATS_GAUGE().
+ * \param update The update function of the group, or NULL.
+ */
+#define NET_STATS_GROUP(var, label, names, gauges, update) \
+  static uint32_t CC_CONCAT(var,_values)[sizeof(names) / sizeof(names[0])]; \
+  static uint32_t CC_CONCAT(var,_last)[sizeof(names) / sizeof(names[0])]; \
+  struct net_stats var = { NULL, label, names, \
+                           CC_CONCAT(var,_values), CC_CONCAT(var,_last), \
+                           sizeof(names) / sizeof(names[0]), \
+                           gauges, update }
+
+/** Add to a counter of a group. */
+#define NET_STATS_ADD(var, counter, n) ((var).values[(counter)] += (n))
+/** Increment a counter of a group. */
+#define NET_STATS_INC(var, counter) NET_STATS_ADD(var, counter, 1)
+/** Set a gauge of a group. */
+#define NET_STATS_SET(var, counter, n) ((var).values[(counter)] = (n))
+/** Register a group, if it is not registered already. */
+#define NET_STATS_REGISTER(var) net_stats_register(&(var))
+#else /* NET_STATS */
+#define NET_STATS_ADD(var, counter, n)
+#define NET_STATS_INC(var, counter)
+#define NET_STATS_SET(var, counter, n)
+#define NET_STATS_REGISTER(var)
+#endif /* NET_STATS */
+
+/**
+ * \brief       Register a group of counters.
+ * \param stats The group, declared with NET_STATS_GROUP().
+ *
+ *              Registering a group again has no effect.
+ */
+void net_stats_register(struct net_stats *stats);
+
+/**
+ * \brief  Get the first registered group.
+ * \return The first group, or NULL if there are none. The next group
+ *         is obtained through the \c next field.
+ */
+struct net_stats *net_stats_head(void);
+
+/**
+ * \brief      Find a registered group by its name.
+ * \param name The name of the group.
+ * \return     The group, or NULL if there is no such group.
+ */
+struct net_stats *net_stats_find(const char *name);
+
+/**
+ * \brief Call the update functions of all groups.
+ */
+void net_stats_update(void);
+
+/**
+ * \brief Remember the current values of all groups and the current
+ *        time, as the base of the changes shown by the next reading.
+ */
+void net_stats_mark(void);
+
+/**
+ * \brief  Get the time since the last net_stats_mark().
+ * \return The time in clock ticks, or since the first group was
+ *         registered if there has been no mark.
+ */
+clock_time_t net_stats_interval(void);
+
+/**
+ * \brief         Get the change of a counter since the last mark.
+ * \param stats   The group.
+ * \param counter The index of the counter.
+ * \return        The change of the counter, or 0 for a gauge.
+ */
+uint32_t net_stats_delta(const struct net_stats *stats, uint8_t counter);
+
+/**
+ * \brief Set all counters except the gauges to zero, and mark.
+ */
+void net_stats_reset(void);
+
+/**
+ * \brief       Encode a group of counters as CBOR.
+ * \param stats The group.
+ * \param buf   The buffer for the encoding.
+ * \param size  The size of the buffer.
+ * \return      The size of the encoding, or 0 if it does not fit.
+ *
+ *              The encoding is a map with the keys "group" for the name
+ *              of the group, "ms" for the milliseconds since the last
+ *              mark, "values" for a map from each counter name to its
+ *              value, and "deltas" for a map from each counter name
+ *              that is not a gauge to its change since the last mark.
+ */
+size_t net_stats_to_cbor(const struct net_stats *stats,
+                         uint8_t *buf, size_t size);
+
+#endif /* NET_STATS_H_ */
+
+/** @} */
+/** @} */
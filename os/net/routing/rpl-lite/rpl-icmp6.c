@@ -48,6 +48,7 @@
 #include "net/ipv6/uip-icmp6.h"
 #include "net/packetbuf.h"
 #include "lib/random.h"
+#include "net/net-stats.h"
 
 #include <inttypes.h>
 #include <limits.h>
@@ -63,6 +64,27 @@
 #define RPL_DIO_MOP_MASK                 0x38
 #define RPL_DIO_PREFERENCE_MASK          0x07
 
+#if NET_STATS
+/* The counters of the "rpl" statistics group */
+enum {
+  RPL_NET_STATS_DIS_RX,
+  RPL_NET_STATS_DIS_TX,
+  RPL_NET_STATS_DIO_RX,
+  RPL_NET_STATS_DIO_TX,
+  RPL_NET_STATS_DAO_RX,
+  RPL_NET_STATS_DAO_TX,
+  RPL_NET_STATS_DAO_ACK_RX,
+  RPL_NET_STATS_DAO_ACK_TX,
+};
+
+static const char *const rpl_net_stats_names[] = {
+  "dis_rx", "dis_tx", "dio_rx", "dio_tx", "dao_rx", "dao_tx",
+  "dao_ack_rx", "dao_ack_tx"
+};
+
+NET_STATS_GROUP(rpl_net_stats, "rpl", rpl_net_stats_names, 0, NULL);
+#endif /* NET_STATS */
+
 /*---------------------------------------------------------------------------*/
 static void dis_input(void);
 static void dio_input(void);
@@ -132,6 +154,8 @@ rpl_icmp6_update_nbr_table(uip_ipaddr_t *from, nbr_table_reason_t reason, void *
 static void
 dis_input(void)
 {
+  NET_STATS_INC(rpl_net_stats, RPL_NET_STATS_DIS_RX);
+
   if(!curr_instance.used) {
     LOG_WARN("dis_input: not in an instance yet, discard\n");
     goto discard;
@@ -166,6 +190,7 @@ rpl_icmp6_dis_output(uip_ipaddr_t *addr)
   LOG_INFO_6ADDR(addr);
   LOG_INFO_("\n");
 
+  NET_STATS_INC(rpl_net_stats, RPL_NET_STATS_DIS_TX);
   uip_icmp6_send(addr, ICMP6_RPL, RPL_CODE_DIS, 2);
 }
 /*---------------------------------------------------------------------------*/
@@ -180,6 +205,8 @@ dio_input(void)
   int len;
   uip_ipaddr_t from;
 
+  NET_STATS_INC(rpl_net_stats, RPL_NET_STATS_DIO_RX);
+
   memset(&dio, 0, sizeof(dio));
 
   /* Set default values in case the DIO configuration option is missing. */
@@ -467,6 +494,7 @@ rpl_icmp6_dio_output(uip_ipaddr_t *uc_addr)
   LOG_INFO_6ADDR(addr);
   LOG_INFO_("\n");
 
+  NET_STATS_INC(rpl_net_stats, RPL_NET_STATS_DIO_TX);
   uip_icmp6_send(addr, ICMP6_RPL, RPL_CODE_DIO, pos);
 }
 /*---------------------------------------------------------------------------*/
@@ -482,6 +510,8 @@ dao_input(void)
   int i;
   uip_ipaddr_t from;
 
+  NET_STATS_INC(rpl_net_stats, RPL_NET_STATS_DAO_RX);
+
   memset(&dao, 0, sizeof(dao));
 
   dao.instance_id = UIP_ICMP_PAYLOAD[0];
@@ -666,6 +696,7 @@ rpl_icmp6_dao_output(uint8_t lifetime)
   LOG_INFO_("\n");
 
   /* Send DAO to root (IPv6 address is DAG ID) */
+  NET_STATS_INC(rpl_net_stats, RPL_NET_STATS_DAO_TX);
   uip_icmp6_send(&curr_instance.dag.dag_id, ICMP6_RPL, RPL_CODE_DAO, pos);
 }
 #if RPL_WITH_DAO_ACK
@@ -678,6 +709,8 @@ dao_ack_input(void)
   uint8_t sequence;
   uint8_t status;
 
+  NET_STATS_INC(rpl_net_stats, RPL_NET_STATS_DAO_ACK_RX);
+
   buffer = UIP_ICMP_PAYLOAD;
 
   instance_id = buffer[0];
@@ -720,6 +753,7 @@ rpl_icmp6_dao_ack_output(uip_ipaddr_t *dest, uint8_t sequence, uint8_t status)
   LOG_INFO_6ADDR(dest);
   LOG_INFO_(" with status %d\n", status);
 
+  NET_STATS_INC(rpl_net_stats, RPL_NET_STATS_DAO_ACK_TX);
   uip_icmp6_send(dest, ICMP6_RPL, RPL_CODE_DAO_ACK, 4);
 }
 #endif /* RPL_WITH_DAO_ACK */
@@ -733,6 +767,7 @@ rpl_icmp6_init()
 #if RPL_WITH_DAO_ACK
   uip_icmp6_register_input_handler(&dao_ack_handler);
 #endif /* RPL_WITH_DAO_ACK */
+  NET_STATS_REGISTER(rpl_net_stats);
 }
 /*---------------------------------------------------------------------------*/
 
@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""Generates fixed-base.inc, the comb tables used by uECC_FIXED_BASE_COMB.
+
+For a curve whose order n has num_n_bits bits, the scalar is split into
+four rows of d = ceil(num_n_bits / 4) bits, and entry j - 1 of the table
+(j = 1..15) holds the affine point sum(2^(i * d) * G for each bit i set in j).
+"""
+
+import sys
+
+CURVES = [
+    ('secp160r1', 20, 161,
+     0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF7FFFFFFF,
+     0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF7FFFFFFC,
+     0x1C97BEFC54BD7A8B65ACF89F81D4D4ADC565FA45,
+     0x0100000000000000000001F4C8F927AED3CA752257,
+     0x4A96B5688EF573284664698968C38BB913CBFC82,
+     0x23A628553168947D59DCC912042351377AC5FB32),
+    ('secp192r1', 24, 192,
+     0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFFFFFFFFFFFF,
+     0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFFFFFFFFFFFC,
+     0x64210519E59C80E70FA7E9AB72243049FEB8DEECC146B9B1,
+     0xFFFFFFFFFFFFFFFFFFFFFFFF99DEF836146BC9B1B4D22831,
+     0x188DA80EB03090F67CBF20EB43A18800F4FF0AFD82FF1012,
+     0x07192B95FFC8DA78631011ED6B24CDD573F977A11E794811),
+    ('secp224r1', 28, 224,
+     0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF000000000000000000000001,
+     0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFFFFFFFFFFFFFFFFFFFE,
+     0xB4050A850C04B3ABF54132565044B0B7D7BFD8BA270B39432355FFB4,
+     0xFFFFFFFFFFFFFFFFFFFFFFFFFFFF16A2E0B8F03E13DD29455C5C2A3D,
+     0xB70E0CBD6BB4BF7F321390B94A03C1D356C21122343280D6115C1D21,
+     0xBD376388B5F723FB4C22DFE6CD4375A05A07476444D5819985007E34),
+    ('secp256r1', 32, 256,
+     0xFFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFF,
+     0xFFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFC,
+     0x5AC635D8AA3A93E7B3EBBD55769886BC651D06B0CC53B0F63BCE3C3E27D2604B,
+     0xFFFFFFFF00000000FFFFFFFFFFFFFFFFBCE6FAADA7179E84F3B9CAC2FC632551,
+     0x6B17D1F2E12C4247F8BCE6E563A440F277037D812DEB33A0F4A13945D898C296,
+     0x4FE342E2FE1A7F9B8EE7EB4A7C0F9E162BCE33576B315ECECBB6406837BF51F5),
+    ('secp256k1', 32, 256,
+     0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2F,
+     0,
+     7,
+     0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141,
+     0x79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798,
+     0x483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8),
+]
+
+TEETH = 4
+
+
+def add(p, a, P, Q):
+    if P is None:
+        return Q
+    if Q is None:
+        return P
+    if P[0] == Q[0]:
+        if (P[1] + Q[1]) % p == 0:
+            return None
+        l = (3 * P[0] * P[0] + a) * pow(2 * P[1], -1, p) % p
+    else:
+        l = (Q[1] - P[1]) * pow(Q[0] - P[0], -1, p) % p
+    x = (l * l - P[0] - Q[0]) % p
+    return (x, (l * (P[0] - x) - P[1]) % p)
+
+
+def mult(p, a, k, P):
+    R = None
+    while k:
+        if k & 1:
+            R = add(p, a, R, P)
+        P = add(p, a, P, P)
+        k >>= 1
+    return R
+
+
+def words(value, num_bytes):
+    data = value.to_bytes(num_bytes, 'little')
+    out = []
+    for i in range(0, num_bytes - num_bytes % 8, 8):
+        out.append('BYTES_TO_WORDS_8(%s)' %
+                   ', '.join('%02X' % b for b in data[i:i + 8]))
+    if num_bytes % 8:
+        out.append('BYTES_TO_WORDS_4(%s)' %
+                   ', '.join('%02X' % b for b in data[-4:]))
+    return out
+
+
+def main():
+    out = ['/* Generated by gen-fixed-base.py. Do not edit. */', '',
+           '#ifndef _UECC_FIXED_BASE_H_', '#define _UECC_FIXED_BASE_H_', '']
+    for name, num_bytes, num_n_bits, p, a, b, n, gx, gy in CURVES:
+        G = (gx, gy)
+        assert (gy * gy - gx * gx * gx - a * gx - b) % p == 0
+        assert mult(p, a, n, G) is None
+        d = (num_n_bits + TEETH - 1) // TEETH
+        rows = [mult(p, a, 1 << (i * d), G) for i in range(TEETH)]
+        out.append('#if uECC_SUPPORTS_%s' % name)
+        out.append('static const uECC_word_t comb_%s[%d * 2 * num_words_%s] = {'
+                   % (name, (1 << TEETH) - 1, name))
+        lines = []
+        for j in range(1, 1 << TEETH):
+            P = None
+            for i in range(TEETH):
+                if j & (1 << i):
+                    P = add(p, a, P, rows[i])
+            lines.extend(words(P[0], num_bytes) + words(P[1], num_bytes))
+        out.append(',\n'.join('    ' + line for line in lines))
+        out.append('};')
+        out.append('#endif /* uECC_SUPPORTS_%s */' % name)
+        out.append('')
+    out.append('#endif /* _UECC_FIXED_BASE_H_ */')
+    sys.stdout.write('\n'.join(out) + '\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -160,6 +160,9 @@ struct uECC_Curve_t {
 #if (uECC_OPTIMIZATION_LEVEL > 0)
     void (*mmod_fast)(uECC_word_t *result, uECC_word_t *product);
 #endif
+#if uECC_FIXED_BASE_COMB
+    const uECC_word_t *comb;
+#endif
 };
 
 #if uECC_VLI_NATIVE_LITTLE_ENDIAN
@@ -920,6 +923,133 @@ static uECC_word_t regularize_k(const uECC_word_t * const k,
     return carry;
 }
 
+#if uECC_FIXED_BASE_COMB
+
+#define uECC_COMB_TEETH 4
+#define uECC_COMB_POINTS ((1 << uECC_COMB_TEETH) - 1)
+
+/* Sets dest = src if mask is all ones, leaves dest unchanged if mask is zero. */
+static void vli_cmov(uECC_word_t *dest,
+                     const uECC_word_t *src,
+                     uECC_word_t mask,
+                     wordcount_t num_words) {
+    wordcount_t i;
+    for (i = 0; i < num_words; ++i) {
+        dest[i] = (dest[i] & ~mask) | (src[i] & mask);
+    }
+}
+
+/* Copies comb entry 'index' (1 - 15) to (X1, Y1), reading all entries so that the memory
+   access pattern does not depend on the index. (X1, Y1) is left unchanged if index is 0. */
+static void comb_select(uECC_word_t * X1,
+                        uECC_word_t * Y1,
+                        uECC_word_t index,
+                        uECC_Curve curve) {
+    const uECC_word_t *entry = curve->comb;
+    wordcount_t num_words = curve->num_words;
+    uECC_word_t j;
+    uECC_word_t mask;
+
+    for (j = 1; j <= uECC_COMB_POINTS; ++j) {
+        mask = (uECC_word_t)0 - (uECC_word_t)(j == index);
+        vli_cmov(X1, entry, mask, num_words);
+        vli_cmov(Y1, entry + num_words, mask, num_words);
+        entry += num_words * 2;
+    }
+}
+
+/* Fixed-base comb multiplication, result = scalar * G, with 0 < scalar < n.
+   Entry j of the comb table is sum(2^(i * d) * G) over the bits i set in j, where
+   d = ceil(num_n_bits / 4). Each of the d columns costs one doubling and one co-Z addition
+   whatever the scalar bits are; the additions of zero columns, and the accumulator while it is
+   still the point at infinity, are discarded with masked copies.
+   Returns 0 if an intermediate sum hit an exceptional case of the addition formula (R = +-T),
+   which only happens for a negligible fraction of the scalars, so that the caller can fall back
+   to the ladder. */
+static uECC_word_t EccPoint_mult_comb(uECC_word_t * result,
+                                      const uECC_word_t * scalar,
+                                      const uECC_word_t * initial_Z,
+                                      uECC_Curve curve) {
+    /* R = accumulator, S = R + T, T = comb entry */
+    uECC_word_t Rx[uECC_MAX_WORDS];
+    uECC_word_t Ry[uECC_MAX_WORDS];
+    uECC_word_t z[uECC_MAX_WORDS];
+    uECC_word_t Sx[uECC_MAX_WORDS];
+    uECC_word_t Sy[uECC_MAX_WORDS];
+    uECC_word_t sz[uECC_MAX_WORDS];
+    uECC_word_t Tx[uECC_MAX_WORDS];
+    uECC_word_t Ty[uECC_MAX_WORDS];
+    uECC_word_t tx[uECC_MAX_WORDS];
+    uECC_word_t ty[uECC_MAX_WORDS];
+    uECC_word_t first_z[uECC_MAX_WORDS];
+    uECC_word_t infinity = (uECC_word_t)-1;
+    uECC_word_t index;
+    uECC_word_t nonzero;
+    wordcount_t num_words = curve->num_words;
+    bitcount_t d = (curve->num_n_bits + uECC_COMB_TEETH - 1) / uECC_COMB_TEETH;
+    bitcount_t i;
+    bitcount_t j;
+
+    if (initial_Z) {
+        uECC_vli_set(first_z, initial_Z, num_words);
+    } else {
+        uECC_vli_clear(first_z, num_words);
+        first_z[0] = 1;
+    }
+
+    /* Keep a valid point in R while it stands for the point at infinity. */
+    uECC_vli_set(Rx, curve->G, num_words);
+    uECC_vli_set(Ry, curve->G + num_words, num_words);
+    uECC_vli_clear(z, num_words);
+    z[0] = 1;
+
+    for (i = d - 1; i >= 0; --i) {
+        index = 0;
+        for (j = uECC_COMB_TEETH - 1; j >= 0; --j) {
+            index = (index << 1) | (uECC_word_t)(!!uECC_vli_testBit(scalar, i + j * d));
+        }
+        nonzero = (uECC_word_t)0 - (uECC_word_t)(index != 0);
+
+        curve->double_jacobian(Rx, Ry, z, curve);
+
+        uECC_vli_set(Tx, curve->comb, num_words);
+        uECC_vli_set(Ty, curve->comb + num_words, num_words);
+        comb_select(Tx, Ty, index, curve);
+
+        uECC_vli_set(tx, Tx, num_words);
+        uECC_vli_set(ty, Ty, num_words);
+        uECC_vli_set(Sx, Rx, num_words);
+        uECC_vli_set(Sy, Ry, num_words);
+        apply_z(tx, ty, z, curve);
+        uECC_vli_modSub(sz, Sx, tx, curve->p, num_words); /* Z = x2 - x1 */
+        /* Note: safe to use tx for 'sub' param, since tx is not used after XYcZ_add. */
+        XYcZ_add(tx, ty, Sx, Sy, tx, curve);
+        uECC_vli_modMult_fast(sz, z, sz, curve);
+
+        /* If R is infinity, the sum is T itself, randomized with the initial Z value. */
+        apply_z(Tx, Ty, first_z, curve);
+        vli_cmov(Sx, Tx, infinity, num_words);
+        vli_cmov(Sy, Ty, infinity, num_words);
+        vli_cmov(sz, first_z, infinity, num_words);
+
+        /* A zero column leaves R unchanged. */
+        vli_cmov(Rx, Sx, nonzero, num_words);
+        vli_cmov(Ry, Sy, nonzero, num_words);
+        vli_cmov(z, sz, nonzero, num_words);
+        infinity &= ~nonzero;
+    }
+
+    /* An exceptional case leaves Z = 0, which results in the point (0, 0). */
+    uECC_vli_modInv(z, z, curve->p, num_words);
+    apply_z(Rx, Ry, z, curve);
+
+    uECC_vli_set(result, Rx, num_words);
+    uECC_vli_set(result + num_words, Ry, num_words);
+    return !infinity && !EccPoint_isZero(result, curve);
+}
+
+#endif /* uECC_FIXED_BASE_COMB */
+
 /* Generates a random integer in the range 0 < random < top.
    Both random and top have num_words words. */
 uECC_VLI_API int uECC_generate_random_int(uECC_word_t *random,
@@ -967,6 +1097,11 @@ static uECC_word_t EccPoint_compute_public_key(uECC_word_t *result,
         }
         initial_Z = p2[carry];
     }
+#if uECC_FIXED_BASE_COMB
+    if (EccPoint_mult_comb(result, private_key, initial_Z, curve)) {
+        return 1;
+    }
+#endif
     EccPoint_mult(result, curve->G, p2[!carry], initial_Z, curve->num_n_bits + 1, curve);
 
     if (EccPoint_isZero(result, curve)) {
@@ -1281,7 +1416,13 @@ static int uECC_sign_with_k_internal(const uint8_t *private_key,
         }
         initial_Z = k2[carry];
     }
+#if uECC_FIXED_BASE_COMB
+    if (!EccPoint_mult_comb(p, k, initial_Z, curve)) {
+        EccPoint_mult(p, curve->G, k2[!carry], initial_Z, num_n_bits + 1, curve);
+    }
+#else
     EccPoint_mult(p, curve->G, k2[!carry], initial_Z, num_n_bits + 1, curve);
+#endif
     if (uECC_vli_isZero(p, num_words)) {
         return 0;
     }
@@ -1489,6 +1630,57 @@ static bitcount_t smax(bitcount_t a, bitcount_t b) {
     return (a > b ? a : b);
 }
 
+#if uECC_VERIFY_WINDOW > 1
+
+#define uECC_VERIFY_POINTS (1 << (uECC_VERIFY_WINDOW - 1))
+
+/* Computes the affine odd multiples point, 3 * point, ..., (2^w - 1) * point.
+   Each multiple is the co-Z sum of the previous one and 2 * point, so the Z value of each
+   multiple is the previous one times a known ratio, and a single inversion converts all of
+   them to affine coordinates. */
+static void EccPoint_odd_multiples(uECC_word_t *table,
+                                   const uECC_word_t *point,
+                                   uECC_Curve curve) {
+    uECC_word_t Dx[uECC_MAX_WORDS];
+    uECC_word_t Dy[uECC_MAX_WORDS];
+    uECC_word_t z[uECC_MAX_WORDS];
+    uECC_word_t sub[uECC_MAX_WORDS];
+    uECC_word_t ratio[uECC_VERIFY_POINTS - 1][uECC_MAX_WORDS];
+    wordcount_t num_words = curve->num_words;
+    uECC_word_t *entry;
+    int i;
+
+    /* D = 2 * point, and entry 1 = point, with the same Z. */
+    uECC_vli_set(table, point, num_words * 2);
+    uECC_vli_set(Dx, point, num_words);
+    uECC_vli_set(Dy, point + num_words, num_words);
+    uECC_vli_clear(z, num_words);
+    z[0] = 1;
+    curve->double_jacobian(Dx, Dy, z, curve);
+    entry = table + num_words * 2;
+    uECC_vli_set(entry, point, num_words * 2);
+    apply_z(entry, entry + num_words, z, curve);
+
+    for (i = 1; i < uECC_VERIFY_POINTS; ++i) {
+        entry = table + i * num_words * 2;
+        if (i > 1) {
+            uECC_vli_set(entry, entry - num_words * 2, num_words * 2);
+        }
+        uECC_vli_modSub(ratio[i - 1], entry, Dx, curve->p, num_words); /* x2 - x1 */
+        XYcZ_add(Dx, Dy, entry, entry + num_words, sub, curve);
+        uECC_vli_modMult_fast(z, z, ratio[i - 1], curve);
+    }
+
+    uECC_vli_modInv(z, z, curve->p, num_words); /* z = 1/Z of the last entry */
+    for (i = uECC_VERIFY_POINTS - 1; i > 0; --i) {
+        entry = table + i * num_words * 2;
+        apply_z(entry, entry + num_words, z, curve);
+        uECC_vli_modMult_fast(z, z, ratio[i - 1], curve);
+    }
+}
+
+#endif /* uECC_VERIFY_WINDOW > 1 */
+
 int uECC_verify(const uint8_t *public_key,
                 const uint8_t *message_hash,
                 unsigned hash_size,
@@ -1496,13 +1688,25 @@ int uECC_verify(const uint8_t *public_key,
                 uECC_Curve curve) {
     uECC_word_t u1[uECC_MAX_WORDS], u2[uECC_MAX_WORDS];
     uECC_word_t z[uECC_MAX_WORDS];
+#if uECC_VERIFY_WINDOW <= 1
     uECC_word_t sum[uECC_MAX_WORDS * 2];
+#endif
     uECC_word_t rx[uECC_MAX_WORDS];
     uECC_word_t ry[uECC_MAX_WORDS];
     uECC_word_t tx[uECC_MAX_WORDS];
     uECC_word_t ty[uECC_MAX_WORDS];
     uECC_word_t tz[uECC_MAX_WORDS];
+#if uECC_VERIFY_WINDOW > 1
+    uECC_word_t table[2][uECC_VERIFY_POINTS * uECC_MAX_WORDS * 2];
+    const uECC_word_t *scalars[2];
+    bitcount_t window_end[2];
+    uECC_word_t window[2];
+    uECC_word_t started;
+    bitcount_t b;
+    int j;
+#else
     const uECC_word_t *points[4];
+#endif
     const uECC_word_t *point;
     bitcount_t num_bits;
     bitcount_t i;
@@ -1548,6 +1752,57 @@ int uECC_verify(const uint8_t *public_key,
     uECC_vli_modMult(u1, u1, z, curve->n, num_n_words); /* u1 = e/s */
     uECC_vli_modMult(u2, r, z, curve->n, num_n_words); /* u2 = r/s */
 
+#if uECC_VERIFY_WINDOW > 1
+    /* Use interleaved sliding windows to calculate u1*G + u2*Q */
+    EccPoint_odd_multiples(table[0], curve->G, curve);
+    EccPoint_odd_multiples(table[1], _public, curve);
+    scalars[0] = u1;
+    scalars[1] = u2;
+    window_end[0] = window_end[1] = -1;
+    num_bits = smax(uECC_vli_numBits(u1, num_n_words),
+                    uECC_vli_numBits(u2, num_n_words));
+    uECC_vli_clear(z, num_words);
+    z[0] = 1;
+    started = 0;
+
+    for (i = num_bits - 1; i >= 0; --i) {
+        if (started) {
+            curve->double_jacobian(rx, ry, z, curve);
+        }
+
+        for (j = 0; j < 2; ++j) {
+            if (window_end[j] < 0 && uECC_vli_testBit(scalars[j], i)) {
+                /* Open a window at bit i, ending at the lowest set bit among the next w bits. */
+                window_end[j] = (i >= uECC_VERIFY_WINDOW - 1 ? i - (uECC_VERIFY_WINDOW - 1) : 0);
+                while (!uECC_vli_testBit(scalars[j], window_end[j])) {
+                    ++window_end[j];
+                }
+                window[j] = 0;
+                for (b = i; b >= window_end[j]; --b) {
+                    window[j] = (window[j] << 1) | (uECC_word_t)(!!uECC_vli_testBit(scalars[j], b));
+                }
+            }
+
+            if (window_end[j] == i) {
+                /* The window value is odd; add the corresponding odd multiple. */
+                point = table[j] + (window[j] >> 1) * num_words * 2;
+                if (!started) {
+                    uECC_vli_set(rx, point, num_words);
+                    uECC_vli_set(ry, point + num_words, num_words);
+                    started = 1;
+                } else {
+                    uECC_vli_set(tx, point, num_words);
+                    uECC_vli_set(ty, point + num_words, num_words);
+                    apply_z(tx, ty, z, curve);
+                    uECC_vli_modSub(tz, rx, tx, curve->p, num_words); /* Z = x2 - x1 */
+                    XYcZ_add(tx, ty, rx, ry, tx, curve);
+                    uECC_vli_modMult_fast(z, z, tz, curve);
+                }
+                window_end[j] = -1;
+            }
+        }
+    }
+#else
     /* Calculate sum = G + Q. */
     uECC_vli_set(sum, _public, num_words);
     uECC_vli_set(sum + num_words, _public + num_words, num_words);
@@ -1589,6 +1844,7 @@ int uECC_verify(const uint8_t *public_key,
             uECC_vli_modMult_fast(z, z, tz, curve);
         }
     }
+#endif /* uECC_VERIFY_WINDOW > 1 */
 
     uECC_vli_modInv(z, z, curve->p, num_words); /* Z = 1/Z */
     apply_z(rx, ry, z, curve);
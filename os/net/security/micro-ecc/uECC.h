@@ -37,6 +37,26 @@ faster somewhat faster, but increases the code size. */
     #define uECC_SQUARE_FUNC 0
 #endif
 
+/* uECC_FIXED_BASE_COMB - If enabled (defined as nonzero), key generation and signing compute
+multiples of the generator with a precomputed 4-teeth comb table instead of the Montgomery
+ladder, which takes about a quarter of the doublings. The table holds 15 points per enabled
+curve (960 bytes of constant data for secp256r1), and is generated by gen-fixed-base.py. The
+table is scanned in full for every lookup, so the operation sequence and memory access pattern
+do not depend on the private key or nonce. */
+#ifndef uECC_FIXED_BASE_COMB
+    #define uECC_FIXED_BASE_COMB 0
+#endif
+
+/* uECC_VERIFY_WINDOW - The window width in bits of the interleaved sliding-window
+multiplication used by uECC_verify() to compute u1 * G + u2 * Q. A width w > 1 keeps
+2^(w - 1) odd multiples of both G and Q on the stack, and reduces the number of point additions
+from about 3/4 to about 2/(w + 1) of the scalar bit length. A width of 1 selects the original
+Shamir's trick with the table {G, Q, G + Q}. Verification only involves public values, so the
+operation sequence may depend on the scalars. */
+#ifndef uECC_VERIFY_WINDOW
+    #define uECC_VERIFY_WINDOW 1
+#endif
+
 /* uECC_VLI_NATIVE_LITTLE_ENDIAN - If enabled (defined as nonzero), this will switch to native
 little-endian format for *all* arrays passed in and out of the public API. This includes public
 and private keys, shared secrets, signatures and message hashes.
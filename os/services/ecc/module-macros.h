@@ -47,4 +47,14 @@
 #define uECC_SUPPORTS_secp256r1 1
 #define uECC_SUPPORTS_secp256k1 0
 
+/* Precomputed comb tables for the generator (960 bytes of flash for P-256) */
+#ifdef ECC_CONF_FIXED_BASE_COMB
+#define uECC_FIXED_BASE_COMB ECC_CONF_FIXED_BASE_COMB
+#endif
+
+/* Window width of the dual multiplication in signature verification */
+#ifdef ECC_CONF_VERIFY_WINDOW
+#define uECC_VERIFY_WINDOW ECC_CONF_VERIFY_WINDOW
+#endif
+
 /** @} */
@@ -52,9 +52,46 @@
 #define NUM_ENTRIES 32
 #endif /* IP64_ADDRMAP_CONF_ENTRIES */
 
+/* The number of hash buckets of each of the two indexes: one for the
+   connection as seen from the IPv6 network, and one for the mapped
+   port. */
+#ifdef IP64_ADDRMAP_CONF_HASH_SIZE
+#define HASH_SIZE IP64_ADDRMAP_CONF_HASH_SIZE
+#else /* IP64_ADDRMAP_CONF_HASH_SIZE */
+#define HASH_SIZE 32
+#endif /* IP64_ADDRMAP_CONF_HASH_SIZE */
+
+#if HASH_SIZE & (HASH_SIZE - 1)
+#error IP64_ADDRMAP_CONF_HASH_SIZE must be a power of two
+#endif
+
+/* The number of one-second slots of the timer wheel that expires the
+   mappings. Mappings that live longer than the wheel goes around are
+   put in its last slot, and are moved on when the slot comes
+   around. */
+#ifdef IP64_ADDRMAP_CONF_WHEEL_SLOTS
+#define WHEEL_SLOTS IP64_ADDRMAP_CONF_WHEEL_SLOTS
+#else /* IP64_ADDRMAP_CONF_WHEEL_SLOTS */
+#define WHEEL_SLOTS 64
+#endif /* IP64_ADDRMAP_CONF_WHEEL_SLOTS */
+
+#if WHEEL_SLOTS < 1 || WHEEL_SLOTS > 256
+#error IP64_ADDRMAP_CONF_WHEEL_SLOTS must be between 1 and 256
+#endif
+
+#define SLOT_TIME CLOCK_SECOND
+
 MEMB(entrymemb, struct ip64_addrmap_entry, NUM_ENTRIES);
 LIST(entrylist);
 
+static struct ip64_addrmap_entry *tuple_table[HASH_SIZE];
+static struct ip64_addrmap_entry *port_table[HASH_SIZE];
+
+static struct ip64_addrmap_entry *wheel[WHEEL_SLOTS];
+static uint8_t wheel_slot;
+/* The start of the time covered by the current slot. */
+static clock_time_t wheel_time;
+
 #define FIRST_MAPPED_PORT 10000
 #define LAST_MAPPED_PORT  20000
 static uint16_t mapped_port = FIRST_MAPPED_PORT;
@@ -71,26 +108,128 @@ ip64_addrmap_init(void)
 {
   memb_init(&entrymemb);
   list_init(entrylist);
+  memset(tuple_table, 0, sizeof(tuple_table));
+  memset(port_table, 0, sizeof(port_table));
+  memset(wheel, 0, sizeof(wheel));
+  wheel_slot = 0;
+  wheel_time = clock_time();
   mapped_port = FIRST_MAPPED_PORT;
 }
 /*---------------------------------------------------------------------------*/
+static unsigned
+tuple_hash(const uip_ip6addr_t *ip6addr, uint16_t ip6port,
+           const uip_ip4addr_t *ip4addr, uint16_t ip4port,
+           uint8_t protocol)
+{
+  uint32_t h;
+  int i;
+
+  h = protocol;
+  for(i = 0; i < 8; i++) {
+    h = h * 33 + ip6addr->u16[i];
+  }
+  h = h * 33 + ip4addr->u16[0];
+  h = h * 33 + ip4addr->u16[1];
+  h = h * 33 + ip6port;
+  h = h * 33 + ip4port;
+  h ^= h >> 16;
+  return h & (HASH_SIZE - 1);
+}
+/*---------------------------------------------------------------------------*/
+static unsigned
+port_hash(uint16_t port)
+{
+  return port & (HASH_SIZE - 1);
+}
+/*---------------------------------------------------------------------------*/
+static clock_time_t
+remaining(struct ip64_addrmap_entry *m)
+{
+  return timer_expired(&m->timer) ? 0 : timer_remaining(&m->timer);
+}
+/*---------------------------------------------------------------------------*/
+/* The number of slots after the current one in which a mapping
+   expires. */
+static uint8_t
+expiry_offset(struct ip64_addrmap_entry *m)
+{
+  clock_time_t offset;
+
+  if(timer_expired(&m->timer)) {
+    return 0;
+  }
+  offset = (clock_time() - wheel_time + remaining(m)) / SLOT_TIME;
+  return offset < WHEEL_SLOTS ? offset : WHEEL_SLOTS - 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+schedule(struct ip64_addrmap_entry *m)
+{
+  m->slot = (wheel_slot + expiry_offset(m)) % WHEEL_SLOTS;
+  m->wheel_next = wheel[m->slot];
+  wheel[m->slot] = m;
+}
+/*---------------------------------------------------------------------------*/
+static void
+unschedule(struct ip64_addrmap_entry *m)
+{
+  struct ip64_addrmap_entry **p;
+
+  for(p = &wheel[m->slot]; *p != m; p = &(*p)->wheel_next);
+  *p = m->wheel_next;
+}
+/*---------------------------------------------------------------------------*/
+/* Removes a mapping that is not in the timer wheel. */
+static void
+free_entry(struct ip64_addrmap_entry *m)
+{
+  struct ip64_addrmap_entry **p;
+
+  for(p = &tuple_table[tuple_hash(&m->ip6addr, m->ip6port, &m->ip4addr,
+                                  m->ip4port, m->protocol)];
+      *p != m; p = &(*p)->tuple_next);
+  *p = m->tuple_next;
+  for(p = &port_table[port_hash(m->mapped_port)]; *p != m;
+      p = &(*p)->port_next);
+  *p = m->port_next;
+  list_remove(entrylist, m);
+  memb_free(&entrymemb, m);
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_entry(struct ip64_addrmap_entry *m)
+{
+  unschedule(m);
+  free_entry(m);
+}
+/*---------------------------------------------------------------------------*/
 static void
 check_age(void)
 {
-  struct ip64_addrmap_entry *m;
+  struct ip64_addrmap_entry *m, *next;
+  int n;
 
-  /* Walk through the list of address mappings, throw away the ones
-     that are too old. */
-  m = list_head(entrylist);
-  while(m != NULL) {
-    if(timer_expired(&m->timer)) {
-      list_remove(entrylist, m);
-      memb_free(&entrymemb, m);
-      m = list_head(entrylist);
-    } else {
-      m = list_item_next(m);
+  /* Turn the wheel to the current time. The mappings in each slot
+     that is passed are thrown away if they are too old, and are
+     otherwise put in the slot in which they expire. */
+  for(n = 0; n < WHEEL_SLOTS && clock_time() - wheel_time >= SLOT_TIME; n++) {
+    m = wheel[wheel_slot];
+    wheel[wheel_slot] = NULL;
+    wheel_slot = (wheel_slot + 1) % WHEEL_SLOTS;
+    wheel_time += SLOT_TIME;
+    for(; m != NULL; m = next) {
+      next = m->wheel_next;
+      if(timer_expired(&m->timer)) {
+        free_entry(m);
+      } else {
+        schedule(m);
+      }
     }
   }
+  if(clock_time() - wheel_time >= SLOT_TIME) {
+    /* All mappings have been seen after a full turn. */
+    wheel_time = clock_time();
+  }
 }
 /*---------------------------------------------------------------------------*/
 static int
@@ -98,31 +237,33 @@ recycle(void)
 {
   /* Find the oldest recyclable mapping and remove it. */
   struct ip64_addrmap_entry *m, *oldest;
+  clock_time_t elapsed;
+  int i;
 
-  /* Walk through the list of address mappings, throw away the ones
-     that are too old. */
-
+  /* Walk through the slots of the wheel in the order in which they
+     expire. The mappings in later slots expire later than any
+     mapping in a slot that has been passed, except for the ones that
+     have been given a longer lifetime, which are moved on. */
   oldest = NULL;
-  for(m = list_head(entrylist);
-      m != NULL;
-      m = list_item_next(m)) {
-    if(m->flags & FLAGS_RECYCLABLE) {
-      if(oldest == NULL) {
+  elapsed = clock_time() - wheel_time;
+  for(i = 0; i < WHEEL_SLOTS; i++) {
+    for(m = wheel[(wheel_slot + i) % WHEEL_SLOTS];
+        m != NULL;
+        m = m->wheel_next) {
+      if((m->flags & FLAGS_RECYCLABLE) &&
+         (oldest == NULL || remaining(m) < remaining(oldest))) {
         oldest = m;
-      } else {
-        if(timer_remaining(&m->timer) <
-           timer_remaining(&oldest->timer)) {
-          oldest = m;
-        }
       }
     }
+    if(oldest != NULL && remaining(oldest) + elapsed <= (i + 1) * SLOT_TIME) {
+      break;
+    }
   }
 
   /* If we found an oldest recyclable entry, remove it and return
      non-zero. */
   if(oldest != NULL) {
-    list_remove(entrylist, oldest);
-    memb_free(&entrymemb, oldest);
+    remove_entry(oldest);
     return 1;
   }
 
@@ -141,7 +282,9 @@ ip64_addrmap_lookup(const uip_ip6addr_t *ip6addr,
   LOG_DBG("lookup ip4port %d ip6port %d\n", uip_htons(ip4port),
 	 uip_htons(ip6port));
   check_age();
-  for(m = list_head(entrylist); m != NULL; m = list_item_next(m)) {
+  for(m = tuple_table[tuple_hash(ip6addr, ip6port, ip4addr, ip4port,
+                                 protocol)];
+      m != NULL; m = m->tuple_next) {
     LOG_DBG("protocol %d %d, ip4port %d %d, ip6port %d %d, ip4 %d ip6 %d\n",
 	   m->protocol, protocol,
 	   m->ip4port, ip4port,
@@ -153,6 +296,10 @@ ip64_addrmap_lookup(const uip_ip6addr_t *ip6addr,
        m->ip6port == ip6port &&
        uip_ip4addr_cmp(&m->ip4addr, ip4addr) &&
        uip_ip6addr_cmp(&m->ip6addr, ip6addr)) {
+      if(timer_expired(&m->timer)) {
+        remove_entry(m);
+        return NULL;
+      }
       m->ip6to4++;
       return m;
     }
@@ -160,18 +307,35 @@ ip64_addrmap_lookup(const uip_ip6addr_t *ip6addr,
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
+static struct ip64_addrmap_entry *
+find_port(uint16_t port)
+{
+  struct ip64_addrmap_entry *m;
+
+  for(m = port_table[port_hash(port)]; m != NULL; m = m->port_next) {
+    if(m->mapped_port == port) {
+      return m;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
 struct ip64_addrmap_entry *
 ip64_addrmap_lookup_port(uint16_t mapped_port, uint8_t protocol)
 {
   struct ip64_addrmap_entry *m;
 
   check_age();
-  for(m = list_head(entrylist); m != NULL; m = list_item_next(m)) {
+  for(m = port_table[port_hash(mapped_port)]; m != NULL; m = m->port_next) {
     LOG_DBG("mapped port %d %d, protocol %d %d\n",
 	   m->mapped_port, mapped_port,
 	   m->protocol, protocol);
     if(m->mapped_port == mapped_port &&
        m->protocol == protocol) {
+      if(timer_expired(&m->timer)) {
+        remove_entry(m);
+        return NULL;
+      }
       m->ip4to6++;
       return m;
     }
@@ -194,6 +358,7 @@ ip64_addrmap_create(const uip_ip6addr_t *ip6addr,
 		    uint8_t protocol)
 {
   struct ip64_addrmap_entry *m;
+  unsigned h;
 
   check_age();
   m = memb_alloc(&entrymemb);
@@ -218,21 +383,20 @@ ip64_addrmap_create(const uip_ip6addr_t *ip6addr,
     /* Pick a new, unused local port. First make sure that the
        mapped_port number does not belong to any active connection. If
        so, we keep increasing the mapped_port until we're free. */
-    {
-      struct ip64_addrmap_entry *n;
-      n = list_head(entrylist);
-      while(n != NULL) {
-	if(n->mapped_port == mapped_port) {
-	  increase_mapped_port();
-	  n = list_head(entrylist);
-	} else {
-	  n = list_item_next(m);
-	}
-      }
+    while(find_port(mapped_port) != NULL) {
+      increase_mapped_port();
     }
     m->mapped_port = mapped_port;
     increase_mapped_port();
 
+    h = tuple_hash(ip6addr, ip6port, ip4addr, ip4port, protocol);
+    m->tuple_next = tuple_table[h];
+    tuple_table[h] = m;
+    h = port_hash(m->mapped_port);
+    m->port_next = port_table[h];
+    port_table[h] = m;
+    schedule(m);
+
     list_add(entrylist, m);
     return m;
   }
@@ -245,6 +409,14 @@ ip64_addrmap_set_lifetime(struct ip64_addrmap_entry *e,
 {
   if(e != NULL) {
     timer_set(&e->timer, time);
+    /* A mapping that now expires before its slot comes around is
+       moved. One that expires later is moved on when its slot comes
+       around, which keeps this cheap for every packet. */
+    if(expiry_offset(e) <
+       (uint8_t)((e->slot + WHEEL_SLOTS - wheel_slot) % WHEEL_SLOTS)) {
+      unschedule(e);
+      schedule(e);
+    }
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -38,6 +38,12 @@
 
 struct ip64_addrmap_entry {
   struct ip64_addrmap_entry *next;
+  /* The next mappings in the hash bucket of the connection, in the
+     hash bucket of the mapped port, and in the slot of the timer
+     wheel. */
+  struct ip64_addrmap_entry *tuple_next;
+  struct ip64_addrmap_entry *port_next;
+  struct ip64_addrmap_entry *wheel_next;
   struct timer timer;
   uip_ip6addr_t ip6addr;
   uip_ip4addr_t ip4addr;
@@ -47,6 +53,7 @@ struct ip64_addrmap_entry {
   uint16_t ip4port;
   uint8_t protocol;
   uint8_t flags;
+  uint8_t slot;
 };
 
 #define FLAGS_NONE       0
@@ -295,6 +295,29 @@ chksum(uint16_t sum, const uint8_t *data, uint16_t len)
   return sum;
 }
 /*---------------------------------------------------------------------------*/
+/* Adds two 16-bit words in one's complement. */
+static uint16_t
+add16(uint16_t a, uint16_t b)
+{
+  a += b;
+  return a < b ? a + 1 : a;
+}
+/*---------------------------------------------------------------------------*/
+/* Updates a transport layer checksum, in network byte order, for the
+   translation of a packet (RFC 1624, equation 3). The old_sum and
+   new_sum are the sums of the fields of the packet and its pseudo
+   header that the translation has changed, before and after. As the
+   rest of the packet is not read, a bad checksum stays bad. */
+static uint16_t
+chksum_update(uint16_t chksum, uint16_t old_sum, uint16_t new_sum)
+{
+  uint16_t sum;
+
+  sum = add16((uint16_t)~uip_ntohs(chksum), (uint16_t)~old_sum);
+  sum = add16(sum, new_sum);
+  return uip_htons((uint16_t)~sum);
+}
+/*---------------------------------------------------------------------------*/
 static uint16_t
 ipv4_checksum(struct ipv4_hdr *hdr)
 {
@@ -305,6 +328,29 @@ ipv4_checksum(struct ipv4_hdr *hdr)
 }
 /*---------------------------------------------------------------------------*/
 static uint16_t
+ipv4_pseudo_sum(const struct ipv4_hdr *v4hdr, uint16_t transport_layer_len,
+                uint8_t proto)
+{
+  /* IP protocol and length fields. This addition cannot carry. */
+  uint16_t sum = transport_layer_len + proto;
+
+  /* Sum IP source and destination addresses. */
+  return chksum(sum, (uint8_t *)&v4hdr->srcipaddr, 2 * sizeof(uip_ip4addr_t));
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+ipv6_pseudo_sum(const struct ipv6_hdr *v6hdr, uint16_t transport_layer_len,
+                uint8_t proto)
+{
+  /* IP protocol and length fields. This addition cannot carry. */
+  uint16_t sum = transport_layer_len + proto;
+
+  /* Sum IP source and destination addresses. */
+  sum = chksum(sum, (uint8_t *)&v6hdr->srcipaddr, sizeof(uip_ip6addr_t));
+  return chksum(sum, (uint8_t *)&v6hdr->destipaddr, sizeof(uip_ip6addr_t));
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
 ipv4_transport_checksum(const uint8_t *packet, uint16_t len, uint8_t proto)
 {
   uint16_t transport_layer_len;
@@ -316,10 +362,7 @@ ipv4_transport_checksum(const uint8_t *packet, uint16_t len, uint8_t proto)
   /* First sum pseudoheader. */
 
   if(proto != IP_PROTO_ICMPV4) {
-    /* IP protocol and length fields. This addition cannot carry. */
-    sum = transport_layer_len + proto;
-    /* Sum IP source and destination addresses. */
-    sum = chksum(sum, (uint8_t *)&v4hdr->srcipaddr, 2 * sizeof(uip_ip4addr_t));
+    sum = ipv4_pseudo_sum(v4hdr, transport_layer_len, proto);
   } else {
     /* ping replies' checksums are calculated over the icmp-part only */
     sum = 0;
@@ -341,12 +384,7 @@ ipv6_transport_checksum(const uint8_t *packet, uint16_t len, uint8_t proto)
   transport_layer_len = len - IPV6_HDRLEN;
 
   /* First sum pseudoheader. */
-
-  /* IP protocol and length fields. This addition cannot carry. */
-  sum = transport_layer_len + proto;
-  /* Sum IP source and destination addresses. */
-  sum = chksum(sum, (uint8_t *)&v6hdr->srcipaddr, sizeof(uip_ip6addr_t));
-  sum = chksum(sum, (uint8_t *)&v6hdr->destipaddr, sizeof(uip_ip6addr_t));
+  sum = ipv6_pseudo_sum(v6hdr, transport_layer_len, proto);
 
   /* Sum transport layer header and data. */
   sum = chksum(sum, &packet[IPV6_HDRLEN], transport_layer_len);
@@ -365,6 +403,8 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
   struct icmpv4_hdr *icmpv4hdr;
   struct icmpv6_hdr *icmpv6hdr;
   uint16_t ipv6len, ipv4len;
+  uint16_t old_sum, new_sum;
+  uint8_t rewritten = 0;
   struct ip64_addrmap_entry *m;
 
   v6hdr = (struct ipv6_hdr *)ipv6packet;
@@ -421,15 +461,6 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
   case IP_PROTO_TCP:
     LOG_DBG("6to4: TCP header\n");
     v4hdr->proto = IP_PROTO_TCP;
-
-    /* Compute and check the TCP checksum - since we're going to
-       recompute it ourselves, we must ensure that it was correct in
-       the first place. */
-    if(ipv6_transport_checksum(ipv6packet, ipv6len,
-                               IP_PROTO_TCP) != 0xffff) {
-      LOG_WARN("Bad TCP checksum, dropping\n");
-    }
-
     break;
 
   case IP_PROTO_UDP:
@@ -443,11 +474,13 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
                       ipv6len - IPV6_HDRLEN - sizeof(struct udp_hdr),
                       (uint8_t *)udphdr + sizeof(struct udp_hdr),
                       BUFSIZE - IPV4_HDRLEN - sizeof(struct udp_hdr));
+      rewritten = 1;
     }
-    /* Compute and check the UDP checksum - since we're going to
-       recompute it ourselves, we must ensure that it was correct in
-       the first place. */
-    if(ipv6_transport_checksum(ipv6packet, ipv6len,
+    /* A rewritten packet, or one without a checksum, gets its
+       checksum recomputed, so we must ensure that it was correct
+       in the first place. */
+    if((rewritten || udphdr->udpchksum == 0) &&
+       ipv6_transport_checksum(ipv6packet, ipv6len,
                                IP_PROTO_UDP) != 0xffff) {
       LOG_WARN("Bad UDP checksum, dropping\n");
     }
@@ -609,25 +642,45 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
 
   /* The checksum is in different places in the different protocol
      headers, so we need to be sure that we update the correct
-     field. */
+     field. Unless the payload has been rewritten, the checksum is
+     updated for the fields that have changed: the pseudo header and
+     the source port, or the ICMP type. */
   switch(v4hdr->proto) {
   case IP_PROTO_TCP:
-    tcphdr->tcpchksum = 0;
-    tcphdr->tcpchksum = ~(ipv4_transport_checksum(resultpacket, ipv4len,
-						  IP_PROTO_TCP));
+    old_sum = chksum(ipv6_pseudo_sum(v6hdr, ipv6len - IPV6_HDRLEN,
+                                     IP_PROTO_TCP),
+                     &ipv6packet[IPV6_HDRLEN], sizeof(uint16_t));
+    new_sum = chksum(ipv4_pseudo_sum(v4hdr, ipv4len - IPV4_HDRLEN,
+                                     IP_PROTO_TCP),
+                     (uint8_t *)&tcphdr->srcport, sizeof(uint16_t));
+    tcphdr->tcpchksum = chksum_update(tcphdr->tcpchksum, old_sum, new_sum);
     break;
   case IP_PROTO_UDP:
-    udphdr->udpchksum = 0;
-    udphdr->udpchksum = ~(ipv4_transport_checksum(resultpacket, ipv4len,
-						  IP_PROTO_UDP));
+    if(rewritten || udphdr->udpchksum == 0) {
+      udphdr->udpchksum = 0;
+      udphdr->udpchksum = ~(ipv4_transport_checksum(resultpacket, ipv4len,
+                                                    IP_PROTO_UDP));
+    } else {
+      old_sum = chksum(ipv6_pseudo_sum(v6hdr, ipv6len - IPV6_HDRLEN,
+                                       IP_PROTO_UDP),
+                       &ipv6packet[IPV6_HDRLEN], sizeof(uint16_t));
+      new_sum = chksum(ipv4_pseudo_sum(v4hdr, ipv4len - IPV4_HDRLEN,
+                                       IP_PROTO_UDP),
+                       (uint8_t *)&udphdr->srcport, sizeof(uint16_t));
+      udphdr->udpchksum = chksum_update(udphdr->udpchksum, old_sum, new_sum);
+    }
     if(udphdr->udpchksum == 0) {
       udphdr->udpchksum = 0xffff;
     }
     break;
   case IP_PROTO_ICMPV4:
-    icmpv4hdr->icmpchksum = 0;
-    icmpv4hdr->icmpchksum = ~(ipv4_transport_checksum(resultpacket, ipv4len,
-						      IP_PROTO_ICMPV4));
+    /* The ICMPv4 checksum does not cover a pseudo header. */
+    old_sum = chksum(ipv6_pseudo_sum(v6hdr, ipv6len - IPV6_HDRLEN,
+                                     IP_PROTO_ICMPV6),
+                     &icmpv6hdr->type, 2);
+    new_sum = chksum(0, &icmpv4hdr->type, 2);
+    icmpv4hdr->icmpchksum = chksum_update(icmpv4hdr->icmpchksum,
+                                          old_sum, new_sum);
     break;
 
   default:
@@ -651,6 +704,8 @@ ip64_4to6(const uint8_t *ipv4packet, const uint16_t ipv4packet_len,
   struct icmpv4_hdr *icmpv4hdr;
   struct icmpv6_hdr *icmpv6hdr;
   uint16_t ipv4len, ipv6len, ipv6_packet_len;
+  uint16_t old_sum, new_sum;
+  uint8_t rewritten = 0;
   struct ip64_addrmap_entry *m;
 
   v6hdr = (struct ipv6_hdr *)resultpacket;
@@ -735,7 +790,7 @@ ip64_4to6(const uint8_t *ipv4packet, const uint16_t ipv4packet_len,
       v6hdr->len[0] = ipv6_packet_len >> 8;
       v6hdr->len[1] = ipv6_packet_len & 0xff;
       ipv6len = ipv6_packet_len + IPV6_HDRLEN;
-
+      rewritten = 1;
     }
     break;
 
@@ -847,28 +902,41 @@ ip64_4to6(const uint8_t *ipv4packet, const uint16_t ipv4packet_len,
      field. */
   switch(v6hdr->nxthdr) {
   case IP_PROTO_TCP:
-    tcphdr->tcpchksum = 0;
-    tcphdr->tcpchksum = ~(ipv6_transport_checksum(resultpacket,
-						  ipv6len,
-						  IP_PROTO_TCP));
+    old_sum = chksum(ipv4_pseudo_sum(v4hdr, ipv4len - IPV4_HDRLEN,
+                                     IP_PROTO_TCP),
+                     &ipv4packet[IPV4_HDRLEN + 2], sizeof(uint16_t));
+    new_sum = chksum(ipv6_pseudo_sum(v6hdr, ipv6_packet_len, IP_PROTO_TCP),
+                     (uint8_t *)&tcphdr->destport, sizeof(uint16_t));
+    tcphdr->tcpchksum = chksum_update(tcphdr->tcpchksum, old_sum, new_sum);
     break;
   case IP_PROTO_UDP:
-    udphdr->udpchksum = 0;
-    /* As the udplen might have changed (DNS) we need to update it also */
-    udphdr->udplen = uip_htons(ipv6_packet_len);
-    udphdr->udpchksum = ~(ipv6_transport_checksum(resultpacket,
-						  ipv6len,
-						  IP_PROTO_UDP));
+    /* A checksum is optional in IPv4, but not in IPv6. */
+    if(rewritten || udphdr->udpchksum == 0) {
+      udphdr->udpchksum = 0;
+      /* As the udplen might have changed (DNS) we need to update it also */
+      udphdr->udplen = uip_htons(ipv6_packet_len);
+      udphdr->udpchksum = ~(ipv6_transport_checksum(resultpacket,
+                                                    ipv6len,
+                                                    IP_PROTO_UDP));
+    } else {
+      old_sum = chksum(ipv4_pseudo_sum(v4hdr, ipv4len - IPV4_HDRLEN,
+                                       IP_PROTO_UDP),
+                       &ipv4packet[IPV4_HDRLEN + 2], sizeof(uint16_t));
+      new_sum = chksum(ipv6_pseudo_sum(v6hdr, ipv6_packet_len, IP_PROTO_UDP),
+                       (uint8_t *)&udphdr->destport, sizeof(uint16_t));
+      udphdr->udpchksum = chksum_update(udphdr->udpchksum, old_sum, new_sum);
+    }
     if(udphdr->udpchksum == 0) {
       udphdr->udpchksum = 0xffff;
     }
     break;
 
   case IP_PROTO_ICMPV6:
-    icmpv6hdr->icmpchksum = 0;
-    icmpv6hdr->icmpchksum = ~(ipv6_transport_checksum(resultpacket,
-                                                ipv6len,
-                                                IP_PROTO_ICMPV6));
+    old_sum = chksum(0, &icmpv4hdr->type, 2);
+    new_sum = chksum(ipv6_pseudo_sum(v6hdr, ipv6_packet_len, IP_PROTO_ICMPV6),
+                     &icmpv6hdr->type, 2);
+    icmpv6hdr->icmpchksum = chksum_update(icmpv6hdr->icmpchksum,
+                                          old_sum, new_sum);
     break;
   default:
     LOG_WARN("4to6: Protocol type %d not supported\n", v4hdr->proto);
@@ -60,6 +60,12 @@
  * resolved. It is up to the receiving process to determine if the
  * correct hostname has been found by calling the resolv_lookup()
  * function with the hostname.
+ *
+ * A query is sent to all configured nameservers at once, and the first
+ * answer is used. Answers are cached for their TTL, and names that do
+ * not exist for the TTL given by the SOA record of the response (RFC
+ * 2308). When the cache is full, the least recently used name is
+ * replaced.
  */
 
 #include "net/ipv6/tcpip.h"
@@ -111,6 +117,22 @@ int strncasecmp(const char *s1, const char *s2, size_t n);
 #define RESOLV_CONF_MAX_DOMAIN_NAME_SIZE 32
 #endif
 
+/** How long, in seconds, to cache a name that does not exist when the
+ *  response has no SOA record. */
+#ifndef RESOLV_CONF_NEGATIVE_TTL
+#define RESOLV_CONF_NEGATIVE_TTL 30
+#endif
+
+/** The longest time, in seconds, to cache a name that does not exist. */
+#ifndef RESOLV_CONF_MAX_NEGATIVE_TTL
+#define RESOLV_CONF_MAX_NEGATIVE_TTL 300
+#endif
+
+/** How long, in seconds, to cache a failure to get an answer. */
+#ifndef RESOLV_CONF_ERROR_TTL
+#define RESOLV_CONF_ERROR_TTL 5
+#endif
+
 #ifdef RESOLV_CONF_AUTO_REMOVE_TRAILING_DOTS
 #define RESOLV_AUTO_REMOVE_TRAILING_DOTS RESOLV_CONF_AUTO_REMOVE_TRAILING_DOTS
 #else
@@ -149,6 +171,7 @@ int strncasecmp(const char *s1, const char *s2, size_t n);
 
 #define DNS_TYPE_A      1
 #define DNS_TYPE_CNAME  5
+#define DNS_TYPE_SOA    6
 #define DNS_TYPE_PTR   12
 #define DNS_TYPE_MX    15
 #define DNS_TYPE_TXT   16
@@ -213,16 +236,20 @@ struct namemap {
 #define STATE_ASKING 3
 #define STATE_DONE   4
   uint8_t state;
-  uint8_t tmr;
   uint16_t id;
   uint8_t retries;
-  uint8_t seqno;
+  /* The time of the last use, for replacing the least recently used name. */
+  uint16_t seqno;
+  /* The retransmission timer of a pending query. */
+  struct etimer timer;
 #if RESOLV_SUPPORTS_RECORD_EXPIRATION
   unsigned long expiration;
 #endif /* RESOLV_SUPPORTS_RECORD_EXPIRATION */
   uip_ipaddr_t ipaddr;
+#define ERR_NO_RESPONSE 0xff
   uint8_t err;
-  uint8_t server;
+  /* The nameservers that have failed to answer, one bit each. */
+  uint8_t servers_failed;
 #if RESOLV_SUPPORTS_MDNS
   bool is_mdns;
   bool is_probe;
@@ -236,10 +263,12 @@ struct namemap {
 #define RESOLV_ENTRIES UIP_CONF_RESOLV_ENTRIES
 #endif /* UIP_CONF_RESOLV_ENTRIES */
 
+/* The number of nameservers that are queried in parallel. */
+#define MAX_SERVERS 8
+
 static struct namemap names[RESOLV_ENTRIES];
-static uint8_t seqno;
+static uint16_t seqno;
 static struct uip_udp_conn *resolv_conn = NULL;
-static struct etimer retry;
 process_event_t resolv_event_found;
 
 PROCESS(resolv_process, "DNS resolver");
@@ -566,149 +595,261 @@ mdns_prep_host_announce_packet(void)
 }
 #endif /* RESOLV_SUPPORTS_MDNS */
 /*---------------------------------------------------------------------------*/
-static char
-try_next_server(struct namemap *namemapptr)
+/** \internal
+ * Keeps an answer, or the absence of one, cached for a number of seconds.
+ */
+static void
+set_expiration(struct namemap *namemapptr, uint32_t ttl)
 {
-  namemapptr->server++;
-  if(uip_nameserver_get(namemapptr->server) != NULL) {
-    LOG_DBG("Using server ");
-    LOG_DBG_6ADDR(uip_nameserver_get(namemapptr->server));
-    LOG_DBG_(", num %u\n", namemapptr->server);
-    namemapptr->retries = 0;
-    return 1;
+#if RESOLV_SUPPORTS_RECORD_EXPIRATION
+  LOG_DBG("Expires in %"PRIu32" seconds\n", ttl);
+  namemapptr->expiration = clock_seconds() + ttl;
+#endif /* RESOLV_SUPPORTS_RECORD_EXPIRATION */
+}
+/*---------------------------------------------------------------------------*/
+/** \internal
+ * Gets a nameserver, or NULL if there are no more nameservers.
+ */
+static const uip_ipaddr_t *
+get_server(uint8_t num)
+{
+  const uip_ipaddr_t *server;
+
+  if(num >= MAX_SERVERS) {
+    return NULL;
+  }
+  server = uip_nameserver_get(num);
+  if(server == NULL || uip_is_addr_unspecified(server)) {
+    return NULL;
   }
-  LOG_DBG("No nameserver, num %u\n", namemapptr->server);
-  namemapptr->server = 0;
-  return 0;
+  return server;
 }
 /*---------------------------------------------------------------------------*/
 /** \internal
- * Runs through the list of names to see if there are any that have
- * not yet been queried and, if so, sends out a query.
+ * Ends a query that did not get an answer.
  */
 static void
-check_entries(void)
+query_failed(struct namemap *namemapptr, uint8_t err)
 {
-  uint8_t i;
+  LOG_DBG("No answer for \"%s\" (%u)\n", namemapptr->name, err);
+  /* STATE_ERROR with DNS_FLAG2_ERR_NAME or no error means "not found". */
+  namemapptr->state = STATE_ERROR;
+  namemapptr->err = err;
+  set_expiration(namemapptr, RESOLV_CONF_ERROR_TTL);
+  etimer_stop(&namemapptr->timer);
+  resolv_found(namemapptr->name, NULL);
+}
+/*---------------------------------------------------------------------------*/
+/** \internal
+ * Sends a query for a name to all nameservers that have not failed,
+ * or to the MDNS group.
+ * \return The number of queries sent.
+ */
+static uint8_t
+send_query(struct namemap *namemapptr)
+{
+  const uip_ipaddr_t *server;
+  uint8_t sent = 0;
+  uint8_t num;
+
+  for(num = 0; num < MAX_SERVERS; num++) {
+    /* The message is built for each server, as sending uses the buffer. */
+    struct dns_hdr *hdr = (struct dns_hdr *)uip_appdata;
+    memset(hdr, 0, sizeof(struct dns_hdr));
+    hdr->id = namemapptr->id;
 
-  for(i = 0; i < RESOLV_ENTRIES; ++i) {
-    struct namemap *namemapptr = &names[i];
-    if(namemapptr->state == STATE_NEW || namemapptr->state == STATE_ASKING) {
-      etimer_set(&retry, CLOCK_SECOND / 4);
-      if(namemapptr->state == STATE_ASKING) {
-        if(namemapptr->tmr == 0 || --namemapptr->tmr == 0) {
 #if RESOLV_SUPPORTS_MDNS
-          if(++namemapptr->retries ==
-             (namemapptr->is_mdns ? RESOLV_CONF_MAX_MDNS_RETRIES :
-              RESOLV_CONF_MAX_RETRIES))
+    if(!namemapptr->is_mdns || namemapptr->is_probe) {
+      hdr->flags1 = DNS_FLAG1_RD;
+    }
+    if(namemapptr->is_mdns) {
+      hdr->id = 0;
+    }
 #else /* RESOLV_SUPPORTS_MDNS */
-          if(++namemapptr->retries == RESOLV_CONF_MAX_RETRIES)
+    hdr->flags1 = DNS_FLAG1_RD;
 #endif /* RESOLV_SUPPORTS_MDNS */
-          {
-            /* Try the next server (if possible) before failing. Otherwise
-               simply mark the entry as failed. */
-            if(try_next_server(namemapptr) == 0) {
-              /* STATE_ERROR basically means "not found". */
-              namemapptr->state = STATE_ERROR;
 
-#if RESOLV_SUPPORTS_RECORD_EXPIRATION
-              /* Keep the "not found" error valid for 30 seconds */
-              namemapptr->expiration = clock_seconds() + 30;
-#endif /* RESOLV_SUPPORTS_RECORD_EXPIRATION */
-
-              resolv_found(namemapptr->name, NULL);
-              continue;
-            }
-          }
-          namemapptr->tmr = namemapptr->retries * namemapptr->retries * 3;
+    hdr->numquestions = UIP_HTONS(1);
+    uint8_t *query = (unsigned char *)uip_appdata + sizeof(*hdr);
+    query = encode_name(query, namemapptr->name);
 
 #if RESOLV_SUPPORTS_MDNS
-          if(namemapptr->is_probe) {
-            /* Probing retries are much more aggressive, 250ms */
-            namemapptr->tmr = 2;
-          }
+    if(namemapptr->is_probe) {
+      *query++ = (uint8_t)((DNS_TYPE_ANY) >> 8);
+      *query++ = (uint8_t)((DNS_TYPE_ANY));
+    } else
 #endif /* RESOLV_SUPPORTS_MDNS */
-        } else {
-          /* Its timer has not run out, so we move on to next entry. */
-          continue;
-        }
-      } else {
-        namemapptr->state = STATE_ASKING;
-        namemapptr->tmr = 1;
-        namemapptr->retries = 0;
-      }
-
-      struct dns_hdr *hdr = (struct dns_hdr *)uip_appdata;
-      memset(hdr, 0, sizeof(struct dns_hdr));
-      hdr->id = random_rand();
-      namemapptr->id = hdr->id;
-
+    {
+      *query++ = (uint8_t)(NATIVE_DNS_TYPE >> 8);
+      *query++ = (uint8_t)NATIVE_DNS_TYPE;
+    }
+    *query++ = (uint8_t)(DNS_CLASS_IN >> 8);
+    *query++ = (uint8_t)DNS_CLASS_IN;
 #if RESOLV_SUPPORTS_MDNS
-      if(!namemapptr->is_mdns || namemapptr->is_probe) {
-        hdr->flags1 = DNS_FLAG1_RD;
-      }
-      if(namemapptr->is_mdns) {
-        hdr->id = 0;
+    if(namemapptr->is_mdns) {
+      if(namemapptr->is_probe) {
+        /* This is our conflict detection request.
+         * In order to be in compliance with the MDNS
+         * spec, we need to add the records we are proposing
+         * to the rrauth section.
+         */
+        uint8_t count = 0;
+
+        query = mdns_write_announce_records(query, &count);
+        hdr->numauthrr = UIP_HTONS(count);
       }
-#else /* RESOLV_SUPPORTS_MDNS */
-      hdr->flags1 = DNS_FLAG1_RD;
+      uip_udp_packet_sendto(resolv_conn, uip_appdata,
+                            (query - (uint8_t *)uip_appdata),
+                            &resolv_mdns_addr, UIP_HTONS(MDNS_PORT));
+
+      LOG_DBG("Sent MDNS %s for \"%s\"\n",
+              namemapptr->is_probe ? "probe" : "request", namemapptr->name);
+      return 1;
+    }
 #endif /* RESOLV_SUPPORTS_MDNS */
 
-      hdr->numquestions = UIP_HTONS(1);
-      uint8_t *query = (unsigned char *)uip_appdata + sizeof(*hdr);
-      query = encode_name(query, namemapptr->name);
+    server = get_server(num);
+    if(server == NULL) {
+      break;
+    }
+    if(namemapptr->servers_failed & (1 << num)) {
+      continue;
+    }
+    uip_udp_packet_sendto(resolv_conn, uip_appdata,
+                          (query - (uint8_t *)uip_appdata),
+                          server, UIP_HTONS(DNS_PORT));
+    LOG_DBG("Sent DNS request for \"%s\" to server %u\n",
+            namemapptr->name, num);
+    sent++;
+  }
+  return sent;
+}
+/*---------------------------------------------------------------------------*/
+/** \internal
+ * Sends the queries of new names, and retransmits the queries whose
+ * timers have expired. Each pending query has its own timer, which
+ * polls the resolver when it expires.
+ */
+static void
+check_entries(void)
+{
+  uint8_t i;
+  uint8_t tmr;
 
+  for(i = 0; i < RESOLV_ENTRIES; ++i) {
+    struct namemap *namemapptr = &names[i];
+    if(namemapptr->state == STATE_NEW) {
+      namemapptr->state = STATE_ASKING;
+      namemapptr->retries = 0;
+      namemapptr->servers_failed = 0;
+      namemapptr->id = random_rand();
+    } else if(namemapptr->state == STATE_ASKING &&
+              etimer_expired(&namemapptr->timer)) {
 #if RESOLV_SUPPORTS_MDNS
-      if(namemapptr->is_probe) {
-        *query++ = (uint8_t)((DNS_TYPE_ANY) >> 8);
-        *query++ = (uint8_t)((DNS_TYPE_ANY));
-      } else
+      if(++namemapptr->retries ==
+         (namemapptr->is_mdns ? RESOLV_CONF_MAX_MDNS_RETRIES :
+          RESOLV_CONF_MAX_RETRIES))
+#else /* RESOLV_SUPPORTS_MDNS */
+      if(++namemapptr->retries == RESOLV_CONF_MAX_RETRIES)
 #endif /* RESOLV_SUPPORTS_MDNS */
       {
-        *query++ = (uint8_t)(NATIVE_DNS_TYPE >> 8);
-        *query++ = (uint8_t)NATIVE_DNS_TYPE;
+        query_failed(namemapptr, ERR_NO_RESPONSE);
+        continue;
       }
-      *query++ = (uint8_t)(DNS_CLASS_IN >> 8);
-      *query++ = (uint8_t)DNS_CLASS_IN;
-#if RESOLV_SUPPORTS_MDNS
-      if(namemapptr->is_mdns) {
-        if(namemapptr->is_probe) {
-          /* This is our conflict detection request.
-           * In order to be in compliance with the MDNS
-           * spec, we need to add the records we are proposing
-           * to the rrauth section.
-           */
-          uint8_t count = 0;
-
-          query = mdns_write_announce_records(query, &count);
-          hdr->numauthrr = UIP_HTONS(count);
-        }
-        uip_udp_packet_sendto(resolv_conn, uip_appdata,
-                              (query - (uint8_t *)uip_appdata),
-                              &resolv_mdns_addr, UIP_HTONS(MDNS_PORT));
+    } else {
+      continue;
+    }
 
-        LOG_DBG("(i=%d) Sent MDNS %s for \"%s\"\n", i,
-                namemapptr->is_probe ? "probe" : "request", namemapptr->name);
-      } else {
-        uip_udp_packet_sendto(resolv_conn, uip_appdata,
-                              (query - (uint8_t *)uip_appdata),
-                              (const uip_ipaddr_t *)
-                              uip_nameserver_get(namemapptr->server),
-                              UIP_HTONS(DNS_PORT));
-
-        LOG_DBG("(i=%d) Sent DNS request for \"%s\"\n", i,
-                namemapptr->name);
-      }
-#else /* RESOLV_SUPPORTS_MDNS */
-      uip_udp_packet_sendto(resolv_conn, uip_appdata,
-                            (query - (uint8_t *)uip_appdata),
-                            uip_nameserver_get(namemapptr->server),
-                            UIP_HTONS(DNS_PORT));
-      LOG_DBG("(i=%d) Sent DNS request for \"%s\"\n", i,
-              namemapptr->name);
+    if(send_query(namemapptr) == 0) {
+      LOG_DBG("No nameserver for \"%s\"\n", namemapptr->name);
+      query_failed(namemapptr, ERR_NO_RESPONSE);
+      continue;
+    }
+
+    /* Back off in quarters of a second: 1, 3, 12, 27, ... */
+    tmr = namemapptr->retries == 0 ? 1 :
+      namemapptr->retries * namemapptr->retries * 3;
+#if RESOLV_SUPPORTS_MDNS
+    if(namemapptr->is_probe) {
+      /* Probing retries are much more aggressive, 250ms */
+      tmr = 2;
+    }
 #endif /* RESOLV_SUPPORTS_MDNS */
+    etimer_set(&namemapptr->timer, tmr * (CLOCK_SECOND / 4));
+  }
+}
+/*---------------------------------------------------------------------------*/
+/** \internal
+ * Gets the time to cache a name that does not exist, from the SOA
+ * record in the authority section of a response (RFC 2308).
+ */
+static uint32_t
+negative_ttl(const unsigned char *rr, uint8_t nanswers, uint8_t nauthrr)
+{
+  const unsigned char *end = (unsigned char *)uip_appdata + uip_datalen();
+  uint32_t ttl = RESOLV_CONF_NEGATIVE_TTL;
+  uint16_t i, type, len;
+  uint32_t rr_ttl, minimum;
+
+  /* Skip the answers, and look for the SOA record among the others. */
+  for(i = 0; i < nanswers + nauthrr; i++) {
+    rr = skip_name((unsigned char *)rr);
+    if(rr + 10 > end) {
+      break;
+    }
+    type = (uint16_t)rr[0] << 8 | rr[1];
+    rr_ttl = (uint32_t)rr[4] << 24 | (uint32_t)rr[5] << 16 |
+      (uint32_t)rr[6] << 8 | rr[7];
+    len = (uint16_t)rr[8] << 8 | rr[9];
+    rr += 10;
+    if(rr + len > end) {
+      break;
+    }
+    if(i >= nanswers && type == DNS_TYPE_SOA && len >= 22) {
+      /* The MINIMUM field ends the record. */
+      minimum = (uint32_t)rr[len - 4] << 24 | (uint32_t)rr[len - 3] << 16 |
+        (uint32_t)rr[len - 2] << 8 | rr[len - 1];
+      ttl = MIN(rr_ttl, minimum);
       break;
     }
+    rr += len;
+  }
+  return MIN(ttl, RESOLV_CONF_MAX_NEGATIVE_TTL);
+}
+/*---------------------------------------------------------------------------*/
+/** \internal
+ * Caches that a name does not exist, or has no address.
+ */
+static void
+name_not_found(struct namemap *namemapptr, uint8_t err, uint32_t ttl)
+{
+  namemapptr->state = STATE_ERROR;
+  namemapptr->err = err;
+  etimer_stop(&namemapptr->timer);
+  set_expiration(namemapptr, ttl);
+  resolv_found(namemapptr->name, NULL);
+}
+/*---------------------------------------------------------------------------*/
+/** \internal
+ * Records that the server that sent the current response failed, and
+ * ends the query if all servers have failed.
+ */
+static void
+server_failed(struct namemap *namemapptr, uint8_t err)
+{
+  const uip_ipaddr_t *server;
+  uint8_t num;
+  bool waiting = false;
+
+  for(num = 0; (server = get_server(num)) != NULL; num++) {
+    if(uip_ipaddr_cmp(server, &UIP_IP_BUF->srcipaddr)) {
+      namemapptr->servers_failed |= 1 << num;
+    } else if(!(namemapptr->servers_failed & (1 << num))) {
+      waiting = true;
+    }
+  }
+  if(!waiting) {
+    query_failed(namemapptr, err);
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -824,6 +965,9 @@ newdata(void)
 
 /** ANSWER HANDLING SECTION **************************************************/
   struct namemap *namemapptr = NULL;
+  const unsigned char *answers = queryptr;
+  const uint8_t nanswers_total = nanswers;
+  uint8_t err;
 
 #if RESOLV_SUPPORTS_MDNS
   if(UIP_UDP_BUF->srcport == UIP_HTONS(MDNS_PORT) && hdr->id == 0) {
@@ -851,19 +995,16 @@ newdata(void)
 
     LOG_DBG("Incoming response for \"%s\"\n", namemapptr->name);
 
-    /* We'll change this to DONE when we find the record. */
-    namemapptr->state = STATE_ERROR;
-    namemapptr->err = hdr->flags2 & DNS_FLAG2_ERR_MASK;
-
-#if RESOLV_SUPPORTS_RECORD_EXPIRATION
-    /* If we remain in the error state, keep it cached for 30 seconds. */
-    namemapptr->expiration = clock_seconds() + 30;
-#endif /* RESOLV_SUPPORTS_RECORD_EXPIRATION */
-
-    /* Check for error. If so, call callback to inform. */
-    if(namemapptr->err != 0) {
-      namemapptr->state = STATE_ERROR;
-      resolv_found(namemapptr->name, NULL);
+    err = hdr->flags2 & DNS_FLAG2_ERR_MASK;
+    if(err != DNS_FLAG2_ERR_NONE && err != DNS_FLAG2_ERR_NAME) {
+      /* The server failed; the other servers may still answer. */
+      server_failed(namemapptr, err);
+      return;
+    }
+    if(err == DNS_FLAG2_ERR_NAME) {
+      name_not_found(namemapptr, err,
+                     negative_ttl(answers, nanswers_total,
+                                  (uint8_t)uip_ntohs(hdr->numauthrr)));
       return;
     }
   }
@@ -968,13 +1109,10 @@ newdata(void)
     LOG_DBG("Answer for \"%s\" is usable\n", namemapptr->name);
 
     namemapptr->state = STATE_DONE;
-#if RESOLV_SUPPORTS_RECORD_EXPIRATION
-    namemapptr->expiration = (uint32_t)uip_ntohs(ans->ttl[0]) << 16 |
-      (uint32_t)uip_ntohs(ans->ttl[1]);
-    LOG_DBG("Expires in %lu seconds\n", namemapptr->expiration);
-
-    namemapptr->expiration += clock_seconds();
-#endif /* RESOLV_SUPPORTS_RECORD_EXPIRATION */
+    namemapptr->err = DNS_FLAG2_ERR_NONE;
+    etimer_stop(&namemapptr->timer);
+    set_expiration(namemapptr, (uint32_t)uip_ntohs(ans->ttl[0]) << 16 |
+                   (uint32_t)uip_ntohs(ans->ttl[1]));
 
     uip_ipaddr_copy(&namemapptr->ipaddr, (uip_ipaddr_t *)ans->ipaddr);
 
@@ -986,8 +1124,7 @@ skip_to_next_answer:
     --nanswers;
   }
 
-  /* Got to this point there's no answer, try next nameserver if available
-     since this one doesn't know the answer */
+  /* Got to this point there's no answer, so the name has no address */
 #if RESOLV_SUPPORTS_MDNS
   if(nanswers == 0 && UIP_UDP_BUF->srcport != UIP_HTONS(MDNS_PORT)
      && hdr->id != 0)
@@ -995,10 +1132,9 @@ skip_to_next_answer:
   if(nanswers == 0)
 #endif
   {
-    if(try_next_server(namemapptr)) {
-      namemapptr->state = STATE_ASKING;
-      process_post(&resolv_process, PROCESS_EVENT_TIMER, NULL);
-    }
+    name_not_found(namemapptr, DNS_FLAG2_ERR_NONE,
+                   negative_ttl(answers, nanswers_total,
+                                (uint8_t)uip_ntohs(hdr->numauthrr)));
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -1188,7 +1324,8 @@ remove_trailing_dots(const char *name)
 void
 resolv_query(const char *name)
 {
-  uint8_t lseqi = 0, lseq = 0, i = 0;
+  uint8_t lclassi = 0, lclass = 0, class, i = 0;
+  uint16_t lseq = 0;
   struct namemap *nameptr = 0;
 
   init();
@@ -1201,26 +1338,44 @@ resolv_query(const char *name)
     if(0 == strcasecmp(nameptr->name, name)) {
       break;
     }
-    if((nameptr->state == STATE_UNUSED)
+    /* Replace unused entries first, then expired ones, then answers,
+       and pending queries last, each in least recently used order. */
+    if(nameptr->state == STATE_UNUSED) {
+      class = 3;
 #if RESOLV_SUPPORTS_RECORD_EXPIRATION
-       || (nameptr->state == STATE_DONE && clock_seconds() > nameptr->expiration)
+    } else if((nameptr->state == STATE_DONE ||
+               nameptr->state == STATE_ERROR) &&
+              clock_seconds() > nameptr->expiration) {
+      class = 2;
 #endif /* RESOLV_SUPPORTS_RECORD_EXPIRATION */
-       ) {
-      lseqi = i;
-      lseq = 255;
-    } else if(seqno - nameptr->seqno > lseq) {
+    } else if(nameptr->state == STATE_DONE || nameptr->state == STATE_ERROR) {
+      class = 1;
+    } else {
+      class = 0;
+    }
+    if(i == 0 || class > lclass ||
+       (class == lclass && (uint16_t)(seqno - nameptr->seqno) > lseq)) {
+      lclass = class;
+      lclassi = i;
       lseq = seqno - nameptr->seqno;
-      lseqi = i;
     }
   }
 
   if(i == RESOLV_ENTRIES) {
-    i = lseqi;
+    i = lclassi;
     nameptr = &names[i];
+  } else if((nameptr->state == STATE_NEW || nameptr->state == STATE_ASKING)
+#if RESOLV_SUPPORTS_MDNS
+            && !nameptr->is_mdns
+#endif /* RESOLV_SUPPORTS_MDNS */
+            ) {
+    LOG_DBG("Query for \"%s\" is already pending\n", name);
+    return;
   }
 
   LOG_DBG("Starting query for \"%s\"\n", name);
 
+  etimer_stop(&nameptr->timer);
   memset(nameptr, 0, sizeof(*nameptr));
 
   strncpy(nameptr->name, name, sizeof(nameptr->name) - 1);
@@ -1298,9 +1453,11 @@ resolv_lookup(const char *name, uip_ipaddr_t **ipaddr)
       case STATE_ASKING:
         ret = RESOLV_STATUS_RESOLVING;
         break;
-      /* Almost certainly a not-found error from server */
+      /* A not-found response from a server, or no response at all */
       case STATE_ERROR:
-        ret = RESOLV_STATUS_NOT_FOUND;
+        ret = nameptr->err == DNS_FLAG2_ERR_NONE ||
+          nameptr->err == DNS_FLAG2_ERR_NAME ?
+          RESOLV_STATUS_NOT_FOUND : RESOLV_STATUS_ERROR;
 #if RESOLV_SUPPORTS_RECORD_EXPIRATION
         if(clock_seconds() > nameptr->expiration) {
           ret = RESOLV_STATUS_UNCACHED;
@@ -1313,6 +1470,10 @@ resolv_lookup(const char *name, uip_ipaddr_t **ipaddr)
         *ipaddr = &nameptr->ipaddr;
       }
 
+      /* Keep recently used names in the cache. */
+      nameptr->seqno = seqno;
+      ++seqno;
+
       /* Break out of for loop. */
       break;
     }
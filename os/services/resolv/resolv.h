@@ -61,8 +61,9 @@ enum {
    */
   RESOLV_STATUS_EXPIRED,
 
-  /** The server has returned a not-found response for this domain name.
-   *  This response is cached for the period described in the server.
+  /** The server has returned a not-found response for this domain name,
+   *  or a response without an address. This response is cached for the
+   *  period given in the SOA record of the response (RFC 2308).
    *  You may issue a new query at any time using resolv_query(), but
    *  you will generally want to wait until this domain's status becomes
    *  RESOLV_STATUS_EXPIRED.
@@ -73,8 +74,8 @@ enum {
   RESOLV_STATUS_RESOLVING,
 
   /** Some sort of server error was encountered while trying to look up this
-   *  record. This response is cached and will eventually expire to
-   *  RESOLV_STATUS_EXPIRED.
+   *  record, or no server answered. This response is cached for
+   *  RESOLV_CONF_ERROR_TTL seconds.
    */
   RESOLV_STATUS_ERROR,
 };
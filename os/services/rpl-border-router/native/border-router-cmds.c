@@ -105,7 +105,18 @@ dectoi(const uint8_t *buf, int len)
   return negative ? -v : v;
 }
 /*---------------------------------------------------------------------------*/
+/* Send a command to the radio given by a "@<radio>" suffix, or to all. */
+static void
+write_to_radios(const uint8_t *data, int len, const uint8_t *cmd, int cmd_len)
+{
+  const uint8_t *at = memchr(data, '@', len);
 
+  if(at != NULL) {
+    write_to_slip_radio(dectoi(at + 1, data + len - at - 1), cmd, cmd_len);
+  } else {
+    write_to_slip(cmd, cmd_len);
+  }
+}
 /*---------------------------------------------------------------------------*/
 /* TODO: the below code needs some way of identifying from where the command */
 /* comes. In this case it can be from stdin or from SLIP.                    */
@@ -128,7 +139,7 @@ border_router_cmd_handler(const uint8_t *data, int len)
         uint8_t set_param[] = {'!', 'V', 0, RADIO_PARAM_CHANNEL, 0, 0 };
         int channel = dectoi(&data[2], len - 2);
         set_param[5] = channel & 0xff;
-        write_to_slip(set_param, sizeof(set_param));
+        write_to_radios(data, len, set_param, sizeof(set_param));
         return 1;
       }
       case 'P': {
@@ -137,7 +148,7 @@ border_router_cmd_handler(const uint8_t *data, int len)
         int pan_id = dectoi(&data[2], len - 2);
         set_param[4] = (pan_id >> 8) & 0xff;
         set_param[5] = pan_id & 0xff;
-        write_to_slip(set_param, sizeof(set_param));
+        write_to_radios(data, len, set_param, sizeof(set_param));
         return 1;
       }
       default:
@@ -151,6 +162,9 @@ border_router_cmd_handler(const uint8_t *data, int len)
         border_router_set_mac(&data[2]);
         return 1;
       case 'V':
+        if(slip_radio_count() > 1) {
+          printf("Radio %d: ", slip_input_radio());
+        }
         if(data[3] == RADIO_PARAM_CHANNEL) {
           printf("Channel is %d\n", data[5]);
         }
@@ -161,8 +175,16 @@ border_router_cmd_handler(const uint8_t *data, int len)
       case 'R':
         LOG_DBG("Packet data report for sid:%d st:%d tx:%d\n",
                data[2], data[3], data[4]);
+        if(len >= 7) {
+          slip_radio_credits(data[5], data[6], 0);
+        }
         packet_sent(data[2], data[3], data[4]);
         return 1;
+      case 'F':
+        if(len >= 4) {
+          slip_radio_credits(data[2], data[3], 1);
+        }
+        return 1;
       default:
       return 0;
       }
@@ -185,12 +207,12 @@ border_router_cmd_handler(const uint8_t *data, int len)
     } else if(data[1] == 'C' && command_context == CMD_CONTEXT_STDIO) {
       /* send on a set-param thing! */
       uint8_t set_param[] = {'?', 'V', 0, RADIO_PARAM_CHANNEL};
-      write_to_slip(set_param, sizeof(set_param));
+      write_to_radios(data, len, set_param, sizeof(set_param));
       return 1;
     } else if(data[1] == 'P' && command_context == CMD_CONTEXT_STDIO) {
       /* send on a set-param thing! */
       uint8_t set_param[] = {'?', 'V', 0, RADIO_PARAM_PAN_ID};
-      write_to_slip(set_param, sizeof(set_param));
+      write_to_radios(data, len, set_param, sizeof(set_param));
       return 1;
     } else if(data[1] == 'S') {
       border_router_print_stat();
@@ -41,6 +41,7 @@
 #include "net/queuebuf.h"
 #include "net/netstack.h"
 #include "net/mac/mac-sequence.h"
+#include "net/nbr-table.h"
 #include "packetutils.h"
 #include "border-router.h"
 #include <string.h>
@@ -52,7 +53,7 @@
 #define LOG_LEVEL LOG_LEVEL_NONE
 
 #define MAX_CALLBACKS 16
-static int callback_pos;
+static int callback_pos[BORDER_ROUTER_MAX_RADIOS];
 
 /* a structure for calling back when packet data is coming back
    from radio... */
@@ -61,9 +62,51 @@ struct tx_callback {
   void *ptr;
   struct packetbuf_attr attrs[PACKETBUF_NUM_ATTRS];
   struct packetbuf_addr addrs[PACKETBUF_NUM_ADDRS];
+  /* the group of a packet sent on several radios, or -1 */
+  int8_t group;
 };
+
+/*
+ * A packet that is sent on several radios is reported to the upper
+ * layer once all radios have reported it, as sent if any radio sent it.
+ */
+struct tx_group {
+  uint8_t pending;
+  uint8_t status;
+  uint8_t tx;
+};
+
+/* The radio on which a neighbor was last heard or acknowledged a packet. */
+struct radio_map {
+  uint8_t radio;
+};
+/*---------------------------------------------------------------------------*/
+static struct tx_callback callbacks[BORDER_ROUTER_MAX_RADIOS][MAX_CALLBACKS];
+static struct tx_group groups[MAX_CALLBACKS];
+static int group_pos;
+NBR_TABLE(struct radio_map, radio_map);
 /*---------------------------------------------------------------------------*/
-static struct tx_callback callbacks[MAX_CALLBACKS];
+static void
+radio_map_learn(const linkaddr_t *addr, int radio)
+{
+  struct radio_map *entry;
+
+  if(slip_radio_count() <= 1 || linkaddr_cmp(addr, &linkaddr_null)) {
+    return;
+  }
+  entry = nbr_table_get_from_lladdr(radio_map, addr);
+  if(entry == NULL) {
+    entry = nbr_table_add_lladdr(radio_map, addr, NBR_TABLE_REASON_MAC, NULL);
+  }
+  if(entry != NULL) {
+    if(entry->radio != radio) {
+      LOG_INFO("neighbor ");
+      LOG_INFO_LLADDR(addr);
+      LOG_INFO_(" is on radio %d\n", radio);
+    }
+    entry->radio = radio;
+  }
+}
 /*---------------------------------------------------------------------------*/
 void
 init_sec(void)
@@ -78,16 +121,42 @@ init_sec(void)
 #endif
 }
 /*---------------------------------------------------------------------------*/
+static void
+report_sent(struct tx_callback *callback, uint8_t status, uint8_t tx)
+{
+  struct tx_group *group;
 
+  if(callback->group >= 0) {
+    group = &groups[callback->group];
+    if(group->status != MAC_TX_OK) {
+      group->status = status;
+    }
+    if(tx > group->tx) {
+      group->tx = tx;
+    }
+    if(group->pending == 0 || --group->pending > 0) {
+      return;
+    }
+    status = group->status;
+    tx = group->tx;
+  }
+  mac_call_sent_callback(callback->cback, callback->ptr, status, tx);
+}
+/*---------------------------------------------------------------------------*/
 void
 packet_sent(uint8_t sessionid, uint8_t status, uint8_t tx)
 {
+  int radio = slip_input_radio();
+
   if(sessionid < MAX_CALLBACKS) {
     struct tx_callback *callback;
-    callback = &callbacks[sessionid];
+    callback = &callbacks[radio][sessionid];
     packetbuf_clear();
     packetbuf_attr_copyfrom(callback->attrs, callback->addrs);
-    mac_call_sent_callback(callback->cback, callback->ptr, status, tx);
+    if(status == MAC_TX_OK) {
+      radio_map_learn(packetbuf_addr(PACKETBUF_ADDR_RECEIVER), radio);
+    }
+    report_sent(callback, status, tx);
   } else {
     LOG_ERR("Session id (%d) >= MAX_CALLBACKS (%d)\n", sessionid,
             MAX_CALLBACKS);
@@ -95,23 +164,44 @@ packet_sent(uint8_t sessionid, uint8_t status, uint8_t tx)
 }
 /*---------------------------------------------------------------------------*/
 static int
-setup_callback(mac_callback_t sent, void *ptr)
+setup_callback(int radio, mac_callback_t sent, void *ptr, int group)
 {
   struct tx_callback *callback;
-  int tmp = callback_pos;
-  callback = &callbacks[callback_pos];
+  int tmp = callback_pos[radio];
+  callback = &callbacks[radio][tmp];
   callback->cback = sent;
   callback->ptr = ptr;
+  callback->group = group;
   packetbuf_attr_copyto(callback->attrs, callback->addrs);
 
-  callback_pos++;
-  if(callback_pos >= MAX_CALLBACKS) {
-    callback_pos = 0;
+  callback_pos[radio]++;
+  if(callback_pos[radio] >= MAX_CALLBACKS) {
+    callback_pos[radio] = 0;
   }
 
   return tmp;
 }
 /*---------------------------------------------------------------------------*/
+/*
+ * Broadcasts, and unicasts to neighbors that have not been heard yet,
+ * are sent on all radios. Other unicasts go to the radio of the neighbor.
+ */
+static int
+select_radio(void)
+{
+  const struct radio_map *entry;
+
+  if(slip_radio_count() <= 1) {
+    return 0;
+  }
+  entry = nbr_table_get_from_lladdr(radio_map,
+                                    packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
+  if(entry != NULL && entry->radio < slip_radio_count()) {
+    return entry->radio;
+  }
+  return -1;
+}
+/*---------------------------------------------------------------------------*/
 static void
 send_packet(mac_callback_t sent, void *ptr)
 {
@@ -119,6 +209,8 @@ send_packet(mac_callback_t sent, void *ptr)
   /* 3 bytes per packet attribute is required for serialization */
   uint8_t buf[PACKETBUF_NUM_ATTRS * 3 + PACKETBUF_SIZE + 3];
   uint8_t sid;
+  int radio;
+  int group;
 
   packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &linkaddr_node_addr);
 
@@ -148,16 +240,35 @@ send_packet(mac_callback_t sent, void *ptr)
       LOG_WARN("send failed, too large header\n");
       mac_call_sent_callback(sent, ptr, MAC_TX_ERR_FATAL, 1);
     } else {
-      sid = setup_callback(sent, ptr);
-
       buf[0] = '!';
       buf[1] = 'S';
-      buf[2] = sid; /* sequence or session number for this packet */
 
       /* Copy packet data */
       memcpy(&buf[3 + size], packetbuf_hdrptr(), packetbuf_totlen());
 
-      write_to_slip(buf, packetbuf_totlen() + size + 3);
+      radio = select_radio();
+      if(radio >= 0) {
+        sid = setup_callback(radio, sent, ptr, -1);
+        buf[2] = sid; /* sequence or session number for this packet */
+        if(write_to_slip_radio(radio, buf, packetbuf_totlen() + size + 3) < 0) {
+          /* The radio is out of credits and the hold queue is full */
+          report_sent(&callbacks[radio][sid], MAC_TX_ERR, 0);
+        }
+      } else {
+        group = group_pos;
+        group_pos = (group_pos + 1) % MAX_CALLBACKS;
+        groups[group].pending = slip_radio_count();
+        groups[group].status = MAC_TX_ERR;
+        groups[group].tx = 0;
+        for(radio = 0; radio < slip_radio_count(); radio++) {
+          sid = setup_callback(radio, sent, ptr, group);
+          buf[2] = sid;
+          if(write_to_slip_radio(radio, buf,
+                                 packetbuf_totlen() + size + 3) < 0) {
+            report_sent(&callbacks[radio][sid], MAC_TX_ERR, 0);
+          }
+        }
+      }
     }
   }
 }
@@ -168,6 +279,7 @@ packet_input(void)
   if(NETSTACK_FRAMER.parse() < 0) {
     LOG_DBG("failed to parse %u\n", packetbuf_datalen());
   } else {
+    radio_map_learn(packetbuf_addr(PACKETBUF_ADDR_SENDER), slip_input_radio());
     NETSTACK_NETWORK.input();
   }
 }
@@ -194,7 +306,9 @@ max_payload()
 static void
 init(void)
 {
-  callback_pos = 0;
+  memset(callback_pos, 0, sizeof(callback_pos));
+  group_pos = 0;
+  nbr_table_register(radio_map, NULL);
   mac_sequence_init();
 }
 /*---------------------------------------------------------------------------*/
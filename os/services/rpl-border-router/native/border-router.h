@@ -41,9 +41,29 @@
 #include "net/ipv6/uip.h"
 #include <stdio.h>
 
+/** The largest number of radios that the border router can drive. */
+#ifdef BORDER_ROUTER_CONF_MAX_RADIOS
+#define BORDER_ROUTER_MAX_RADIOS BORDER_ROUTER_CONF_MAX_RADIOS
+#else
+#define BORDER_ROUTER_MAX_RADIOS 4
+#endif
+
+/* A radio given on the command line, on a serial device or over TCP. */
+struct slip_config_radio {
+  const char *siodev;
+  const char *host;
+  const char *port;
+};
+
 int border_router_cmd_handler(const uint8_t *data, int len);
 int slip_config_handle_arguments(int argc, char **argv);
 void write_to_slip(const uint8_t *buf, int len);
+int write_to_slip_radio(int radio, const uint8_t *buf, int len);
+int slip_radio_count(void);
+int slip_input_radio(void);
+void slip_print_stat(void);
+void slip_radio_credits(uint8_t free, uint8_t received, int sync);
+int slip_flow_controlled(void);
 
 void border_router_set_prefix_64(const uip_ipaddr_t *prefix_64);
 void border_router_set_mac(const uint8_t *data);
@@ -52,7 +72,7 @@ void border_router_print_stat(void);
 
 void tun_init(void);
 
-int slip_init(void);
+void slip_init(void);
 int slip_set_fd(int maxfd, fd_set *rset, fd_set *wset);
 void slip_handle_fd(fd_set *rset, fd_set *wset);
 
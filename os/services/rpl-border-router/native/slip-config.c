@@ -49,15 +49,18 @@
 #include "contiki.h"
 #include "sys/platform.h"
 #include "tun6-net.h"
+#include "border-router.h"
 
 int slip_config_verbose = 0;
 int slip_config_flowcontrol = 0;
 int slip_config_timestamp = 0;
-const char *slip_config_siodev = NULL;
-const char *slip_config_host = NULL;
-const char *slip_config_port = NULL;
+struct slip_config_radio slip_config_radios[BORDER_ROUTER_MAX_RADIOS];
+int slip_config_radio_count = 0;
 uint16_t slip_config_basedelay = 0;
 
+/* The port for TCP radios that are added before a port is given. */
+static const char *default_port;
+
 #ifndef BAUDRATE
 #define BAUDRATE B115200
 #endif
@@ -66,7 +69,8 @@ speed_t slip_config_b_rate = BAUDRATE;
 #define BAUDRATE_PRIO CONTIKI_VERBOSE_PRIO + 20
 
 CONTIKI_USAGE(300, " [ipaddress]\n"
-                   "example parameters: -L -v=2 -s /dev/ttyUSB1 fd00::1/64\n\n");
+                   "example parameters: -L -v=2 -s /dev/ttyUSB1 fd00::1/64\n"
+                   "Each -s or -a option adds a radio.\n\n");
 CONTIKI_EXTRA_HELP(300,
                    "\nVerbosity level:\n"
                    "  0   No messages\n"
@@ -123,26 +127,56 @@ CONTIKI_OPTION(BAUDRATE_PRIO + 1,
 CONTIKI_OPTION(BAUDRATE_PRIO + 2,
                { "L", no_argument, &slip_config_timestamp, 1 }, NULL,
                "log output format (adds time stamps)\n");
+static struct slip_config_radio *
+add_radio(void)
+{
+  if(slip_config_radio_count >= BORDER_ROUTER_MAX_RADIOS) {
+    fprintf(stderr, "too many radios (max %d)\n", BORDER_ROUTER_MAX_RADIOS);
+    return NULL;
+  }
+  return &slip_config_radios[slip_config_radio_count++];
+}
 static int
 device_callback(const char *optarg)
 {
-  slip_config_siodev = optarg;
+  struct slip_config_radio *radio = add_radio();
+
+  if(radio == NULL) {
+    return 1;
+  }
+  radio->siodev = optarg;
   return 0;
 }
 CONTIKI_OPTION(BAUDRATE_PRIO + 3, { "s", required_argument, NULL, 0 },
-               device_callback, "serial device\n");
+               device_callback, "serial device of a radio\n");
 static int
 host_callback(const char *optarg)
 {
-  slip_config_host = optarg;
+  struct slip_config_radio *radio = add_radio();
+
+  if(radio == NULL) {
+    return 1;
+  }
+  radio->host = optarg;
+  radio->port = default_port;
   return 0;
 }
 CONTIKI_OPTION(BAUDRATE_PRIO + 4, { "a", required_argument, NULL, 0 },
-               host_callback, "connect via TCP to server at <value>\n");
+               host_callback, "connect a radio via TCP to server at <value>\n");
 static int
 port_callback(const char *optarg)
 {
-  slip_config_port = optarg;
+  struct slip_config_radio *radio = NULL;
+
+  if(slip_config_radio_count > 0) {
+    radio = &slip_config_radios[slip_config_radio_count - 1];
+  }
+  /* the port belongs to the preceding -a option, if it has none yet */
+  if(radio != NULL && radio->host != NULL && radio->port == default_port) {
+    radio->port = optarg;
+  } else {
+    default_port = optarg;
+  }
   return 0;
 }
 CONTIKI_OPTION(BAUDRATE_PRIO + 5, { "p", required_argument, NULL, 0 },
@@ -163,7 +197,8 @@ CONTIKI_OPTION(BAUDRATE_PRIO + 6, { "d", optional_argument, NULL, 0 },
                delay_callback,
                "minimum delay between outgoing SLIP packets (default 10)\n"
                "\t\tActual delay is basedelay * (#6LowPAN fragments)"
-               " milliseconds.\n");
+               " milliseconds.\n"
+               "\t\tNot used with radios that report credits.\n");
 /*---------------------------------------------------------------------------*/
 int
 slip_config_handle_arguments(int argc, char **argv)
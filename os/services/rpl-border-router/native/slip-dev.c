@@ -52,15 +52,16 @@
 #include <err.h>
 
 #include "net/netstack.h"
+#include "lib/slip-codec.h"
 #include "net/packetbuf.h"
 #include "cmd.h"
+#include "border-router.h"
 #include "border-router-cmds.h"
 
 extern int slip_config_verbose;
 extern int slip_config_flowcontrol;
-extern const char *slip_config_siodev;
-extern const char *slip_config_host;
-extern const char *slip_config_port;
+extern struct slip_config_radio slip_config_radios[];
+extern int slip_config_radio_count;
 extern uint16_t slip_config_basedelay;
 extern speed_t slip_config_b_rate;
 
@@ -70,20 +71,70 @@ extern speed_t slip_config_b_rate;
 #define SEND_DELAY 0
 #endif
 
-static FILE *inslip;
+/*
+ * The number of packets that are held while a flow-controlled radio
+ * has no credits. This, plus the credits of the radio, must not exceed
+ * the number of session ids of the MAC layer.
+ */
+#ifdef SLIP_DEV_CONF_HOLD_QUEUE
+#define HOLD_QUEUE SLIP_DEV_CONF_HOLD_QUEUE
+#else
+#define HOLD_QUEUE 8
+#endif
+
+/* The largest "!S" frame, as built by the MAC layer. */
+#define HOLD_FRAME_SIZE (PACKETBUF_NUM_ATTRS * 3 + PACKETBUF_SIZE + 3)
+
+/* How long to wait for a credit report before asking for one. */
+#define CREDIT_TIMEOUT CLOCK_SECOND
 
 /* for statistics */
 long slip_sent = 0;
 long slip_received = 0;
 
-int slipfd = 0;
+struct held_frame {
+  uint16_t len;
+  uint8_t data[HOLD_FRAME_SIZE];
+};
+
+/*
+ * The state of a radio. The output buffer has room for several packets,
+ * so that packets that are sent together are written to serial in a
+ * single write() when there is no send delay. A radio that reports
+ * credits is sent packets without delay, and packets that exceed its
+ * credits are held until it reports more. Packets are also held while
+ * the radio is asked for its credits, and a radio that does not answer
+ * is paced with the send delay.
+ */
+struct slip_radio {
+  int fd;
+  const char *name;
+  slip_decoder_t decoder;
+  unsigned char inbuf[2048];
+  unsigned char buf[8 * 2048];
+  int end, begin, packet_end, packet_count;
+  struct timer send_delay_timer;
+  cmd_credits_t credits;
+  uint8_t credits_pending;
+  /* The number of packets sent since credits were last asked for */
+  uint8_t since_query;
+  struct timer credit_timer;
+  struct held_frame hold[HOLD_QUEUE];
+  int hold_first, hold_count;
+  long sent;
+  long received;
+  long held;
+  long dropped;
+};
+
+static struct slip_radio radios[BORDER_ROUTER_MAX_RADIOS];
+static int radio_count;
+/* The radio whose input is being handled. */
+static int input_radio;
 
 #define PROGRESS(s) do { } while(0)
 
-#define SLIP_END     0300
-#define SLIP_ESC     0333
-#define SLIP_ESC_END 0334
-#define SLIP_ESC_ESC 0335
+#define SLIP_END     SLIP_CODEC_END
 
 /*---------------------------------------------------------------------------*/
 static void *
@@ -167,197 +218,217 @@ slip_packet_input(unsigned char *data, int len)
 }
 /*---------------------------------------------------------------------------*/
 /*
- * Read from serial, when we have a packet call slip_packet_input. No output
- * buffering, input buffered by stdio.
+ * Handle a frame received from serial: a command from the radio, a
+ * debug line, or a packet that is passed to slip_packet_input.
  */
-void
-serial_input(FILE *inslip)
+static void
+frame_input(unsigned char *inbuf, int len)
 {
-  static unsigned char inbuf[2048];
-  static int inbufptr = 0;
-  int ret, i;
-  unsigned char c;
-
-#ifdef linux
-  ret = fread(&c, 1, 1, inslip);
-  if(ret == -1 || ret == 0) {
-    err(EXIT_FAILURE, "serial_input: read");
-  }
-  goto after_fread;
-#endif
+  int i;
 
-read_more:
-  if(inbufptr >= sizeof(inbuf)) {
-    fprintf(stderr, "*** dropping large %d byte packet\n", inbufptr);
-    inbufptr = 0;
-  }
-  ret = fread(&c, 1, 1, inslip);
-#ifdef linux
-after_fread:
-#endif
-  if(ret == -1) {
-    err(EXIT_FAILURE, "serial_input: read");
-  }
-  if(ret == 0) {
-    clearerr(inslip);
-    return;
-  }
-  slip_received++;
-  switch(c) {
-  case SLIP_END:
-    if(inbufptr > 0) {
-      if(inbuf[0] == '!') {
-        command_context = CMD_CONTEXT_RADIO;
-        cmd_input(inbuf, inbufptr);
-      } else if(inbuf[0] == '?') {
+  if(inbuf[0] == '!') {
+    command_context = CMD_CONTEXT_RADIO;
+    cmd_input(inbuf, len);
+  } else if(inbuf[0] == '?') {
 #define DEBUG_LINE_MARKER '\r'
-      } else if(inbuf[0] == DEBUG_LINE_MARKER) {
-        fwrite(inbuf + 1, inbufptr - 1, 1, stdout);
-      } else if(is_sensible_string(inbuf, inbufptr)) {
-        if(slip_config_verbose == 1) {   /* strings already echoed below for verbose>1 */
-          fwrite(inbuf, inbufptr, 1, stdout);
-        }
-      } else {
-        if(slip_config_verbose > 2) {
-          printf("Packet from SLIP of length %d - write TUN\n", inbufptr);
-          if(slip_config_verbose > 4) {
+  } else if(inbuf[0] == DEBUG_LINE_MARKER) {
+    fwrite(inbuf + 1, len - 1, 1, stdout);
+  } else if(is_sensible_string(inbuf, len)) {
+    if(slip_config_verbose == 1) {   /* strings already echoed below for verbose>1 */
+      fwrite(inbuf, len, 1, stdout);
+    }
+  } else {
+    if(slip_config_verbose > 2) {
+      printf("Packet from SLIP of length %d - write TUN\n", len);
+      if(slip_config_verbose > 4) {
 #if WIRESHARK_IMPORT_FORMAT
-            printf("0000");
-            for(i = 0; i < inbufptr; i++) {
-              printf(" %02x", inbuf[i]);
-            }
+        printf("0000");
+        for(i = 0; i < len; i++) {
+          printf(" %02x", inbuf[i]);
+        }
 #else
-            printf("         ");
-            for(i = 0; i < inbufptr; i++) {
-              printf("%02x", inbuf[i]);
-              if((i & 3) == 3) {
-                printf(" ");
-              }
-              if((i & 15) == 15) {
-                printf("\n         ");
-              }
-            }
-#endif
-            printf("\n");
+        printf("         ");
+        for(i = 0; i < len; i++) {
+          printf("%02x", inbuf[i]);
+          if((i & 3) == 3) {
+            printf(" ");
+          }
+          if((i & 15) == 15) {
+            printf("\n         ");
           }
         }
-        slip_packet_input(inbuf, inbufptr);
+#endif
+        printf("\n");
       }
-      inbufptr = 0;
     }
-    break;
+    slip_packet_input(inbuf, len);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Read from serial, when we have a packet call slip_packet_input. No output
+ * buffering; input is read in bulk and decoded by the SLIP codec.
+ */
+static void
+serial_input(struct slip_radio *radio)
+{
+  static unsigned char chunk[4096];
+  int ret, i;
 
-  case SLIP_ESC:
-    if(fread(&c, 1, 1, inslip) != 1) {
-      clearerr(inslip);
-      /* Put ESC back and give up! */
-      ungetc(SLIP_ESC, inslip);
+  ret = read(radio->fd, chunk, sizeof(chunk));
+  if(ret == -1) {
+    if(errno == EAGAIN || errno == EINTR) {
       return;
     }
+    err(EXIT_FAILURE, "serial_input: read");
+  }
+  if(ret == 0) {
+#ifdef linux
+    /* select() reported input, so the device is gone */
+    err(EXIT_FAILURE, "serial_input: read from %s", radio->name);
+#endif
+    return;
+  }
+  radio->received += ret;
+  slip_received += ret;
 
-    switch(c) {
-    case SLIP_ESC_END:
-      c = SLIP_END;
-      break;
-    case SLIP_ESC_ESC:
-      c = SLIP_ESC;
-      break;
-    }
-    /* FALLTHROUGH */
-  default:
-    inbuf[inbufptr++] = c;
-
-    /* Echo lines as they are received for verbose=2,3,5+ */
-    /* Echo all printable characters for verbose==4 */
-    if(slip_config_verbose == 4) {
+  /* Echo all printable characters for verbose==4 */
+  if(slip_config_verbose == 4) {
+    for(i = 0; i < ret; i++) {
+      unsigned char c = chunk[i];
       if(c == 0 || c == '\r' || c == '\n' || c == '\t' || (c >= ' ' && c <= '~')) {
         fwrite(&c, 1, 1, stdout);
       }
-    } else if(slip_config_verbose >= 2) {
-      if(c == '\n' && is_sensible_string(inbuf, inbufptr)) {
-        fwrite(inbuf, inbufptr, 1, stdout);
-        inbufptr = 0;
-      }
     }
-    break;
   }
 
-  goto read_more;
+  input_radio = radio - radios;
+  slip_decoder_input(&radio->decoder, chunk, ret);
+  for(;;) {
+    switch(slip_decoder_next(&radio->decoder)) {
+    case SLIP_DECODER_FRAME:
+      frame_input(radio->inbuf, radio->decoder.len);
+      break;
+    case SLIP_DECODER_LINE:
+      if(is_sensible_string(radio->inbuf, radio->decoder.len)) {
+        fwrite(radio->inbuf, radio->decoder.len, 1, stdout);
+        slip_decoder_reset(&radio->decoder);
+      }
+      break;
+    case SLIP_DECODER_OVERFLOW:
+      fprintf(stderr, "*** dropping large %d byte packet\n",
+              (int)radio->decoder.len);
+      break;
+    default:
+      return;
+    }
+  }
 }
-unsigned char slip_buf[2048];
-int slip_end, slip_begin, slip_packet_end, slip_packet_count;
-static struct timer send_delay_timer;
+/*---------------------------------------------------------------------------*/
 /* delay between slip packets */
 static clock_time_t send_delay = SEND_DELAY;
 /*---------------------------------------------------------------------------*/
 static void
-slip_send(int fd, unsigned char c)
+slip_send(struct slip_radio *radio, unsigned char c)
 {
-  if(slip_end >= sizeof(slip_buf)) {
+  if(radio->end >= sizeof(radio->buf)) {
     err(EXIT_FAILURE, "slip_send overflow");
   }
-  slip_buf[slip_end] = c;
-  slip_end++;
+  radio->buf[radio->end] = c;
+  radio->end++;
+  radio->sent++;
   slip_sent++;
   if(c == SLIP_END) {
     /* Full packet received. */
-    slip_packet_count++;
-    if(slip_packet_end == 0) {
-      slip_packet_end = slip_end;
+    radio->packet_count++;
+    if(radio->packet_end == 0) {
+      radio->packet_end = radio->end;
     }
   }
 }
 /*---------------------------------------------------------------------------*/
-int
-slip_empty()
+static void
+slip_send_frame(struct slip_radio *radio, const uint8_t *data, int len)
 {
-  return slip_packet_end == 0;
+  size_t n;
+
+  if(sizeof(radio->buf) - radio->end < (size_t)SLIP_CODEC_ENCODED_SIZE_MAX(len)) {
+    err(EXIT_FAILURE, "slip_send overflow");
+  }
+  n = slip_codec_encode(radio->buf + radio->end, data, len, 0);
+  radio->end += n;
+  radio->sent += n;
+  slip_sent += n;
+  radio->packet_count++;
+  if(radio->packet_end == 0) {
+    radio->packet_end = radio->end;
+  }
 }
 /*---------------------------------------------------------------------------*/
-void
-slip_flushbuf(int fd)
+static int
+slip_empty(struct slip_radio *radio)
+{
+  return radio->packet_end == 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+slip_flushbuf(struct slip_radio *radio)
 {
+  uint8_t *next;
+  int packet_done;
+  int end;
   int n;
 
-  if(slip_empty()) {
+  if(slip_empty(radio)) {
     return;
   }
 
-  n = write(fd, slip_buf + slip_begin, slip_packet_end - slip_begin);
+  /* Without a delay between packets, all queued packets are written at once. */
+  end = send_delay > 0 && !radio->credits.active ?
+    radio->packet_end : radio->end;
+  n = write(radio->fd, radio->buf + radio->begin, end - radio->begin);
 
   if(n == -1 && errno != EAGAIN) {
     err(EXIT_FAILURE, "slip_flushbuf write failed");
   } else if(n == -1) {
     PROGRESS("Q");		/* Outqueue is full! */
-  } else {
-    slip_begin += n;
-    if(slip_begin == slip_packet_end) {
-      slip_packet_count--;
-      if(slip_end > slip_packet_end) {
-        memmove(slip_buf, slip_buf + slip_packet_end,
-               slip_end - slip_packet_end);
-      }
-      slip_end -= slip_packet_end;
-      slip_begin = slip_packet_end = 0;
-      if(slip_end > 0) {
-        /* Find end of next slip packet */
-        for(n = 1; n < slip_end; n++) {
-          if(slip_buf[n] == SLIP_END) {
-            slip_packet_end = n + 1;
-            break;
-          }
-        }
-        /* a delay between slip packets to avoid losing data */
-        if(send_delay > 0) {
-          timer_set(&send_delay_timer, send_delay);
+  } else if(n > 0) {
+    radio->begin += n;
+    packet_done = radio->begin >= radio->packet_end;
+    if(radio->begin == radio->end) {
+      radio->packet_count = 0;
+      radio->end = radio->begin = radio->packet_end = 0;
+    } else {
+      /*
+       * Move what is left to the front, so that the buffer is reclaimed
+       * after every write, also after a short write that ended anywhere
+       * in a later packet.
+       */
+      memmove(radio->buf, radio->buf + radio->begin,
+              radio->end - radio->begin);
+      radio->end -= radio->begin;
+      radio->begin = 0;
+      /* Every SLIP_END that is left ends a packet. */
+      radio->packet_count = 0;
+      radio->packet_end = 0;
+      for(next = radio->buf;
+          (next = memchr(next, SLIP_END,
+                         radio->buf + radio->end - next)) != NULL;
+          next++) {
+        if(radio->packet_count++ == 0) {
+          radio->packet_end = next - radio->buf + 1;
         }
       }
     }
+    /* a delay between slip packets to avoid losing data */
+    if(packet_done && send_delay > 0 && !radio->credits.active) {
+      timer_set(&radio->send_delay_timer, send_delay);
+    }
   }
 }
 /*---------------------------------------------------------------------------*/
 static void
-write_to_serial(int outfd, const uint8_t *inbuf, int len)
+write_to_serial(struct slip_radio *radio, const uint8_t *inbuf, int len)
 {
   const uint8_t *p = inbuf;
   int i;
@@ -389,33 +460,166 @@ write_to_serial(int outfd, const uint8_t *inbuf, int len)
   /* It would be ``nice'' to send a SLIP_END here but it's not
    * really necessary.
    */
-  /* slip_send(outfd, SLIP_END); */
+  /* slip_send(radio, SLIP_END); */
 
-  for(i = 0; i < len; i++) {
-    switch(p[i]) {
-    case SLIP_END:
-      slip_send(outfd, SLIP_ESC);
-      slip_send(outfd, SLIP_ESC_END);
-      break;
-    case SLIP_ESC:
-      slip_send(outfd, SLIP_ESC);
-      slip_send(outfd, SLIP_ESC_ESC);
-      break;
-    default:
-      slip_send(outfd, p[i]);
-      break;
+  slip_send_frame(radio, p, len);
+  PROGRESS("t");
+}
+/*---------------------------------------------------------------------------*/
+static void
+query_credits(struct slip_radio *radio)
+{
+  write_to_serial(radio, (const uint8_t *)"?F", 2);
+  radio->credits_pending = 1;
+  radio->since_query = 0;
+  timer_set(&radio->credit_timer, CREDIT_TIMEOUT);
+}
+/*---------------------------------------------------------------------------*/
+static int
+may_send(struct slip_radio *radio)
+{
+  if(radio->credits.active) {
+    return cmd_credits_available(&radio->credits) > 0;
+  }
+  return !radio->credits_pending;
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_packet(struct slip_radio *radio, const uint8_t *buf, int len)
+{
+  write_to_serial(radio, buf, len);
+  radio->credits.sent++;
+  radio->since_query++;
+}
+/*---------------------------------------------------------------------------*/
+static int
+hold_frame(struct slip_radio *radio, const uint8_t *buf, int len)
+{
+  struct held_frame *frame;
+
+  if(radio->hold_count == HOLD_QUEUE || len > HOLD_FRAME_SIZE) {
+    radio->dropped++;
+    return -1;
+  }
+  if(radio->hold_count == 0) {
+    timer_set(&radio->credit_timer, CREDIT_TIMEOUT);
+  }
+  frame = &radio->hold[(radio->hold_first + radio->hold_count) % HOLD_QUEUE];
+  memcpy(frame->data, buf, len);
+  frame->len = len;
+  radio->hold_count++;
+  radio->held++;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+release_held(struct slip_radio *radio)
+{
+  struct held_frame *frame;
+
+  while(radio->hold_count > 0 && may_send(radio)) {
+    frame = &radio->hold[radio->hold_first];
+    send_packet(radio, frame->data, frame->len);
+    radio->hold_first = (radio->hold_first + 1) % HOLD_QUEUE;
+    radio->hold_count--;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* writes an 802.15.4 packet to a slip-radio */
+int
+write_to_slip_radio(int radio, const uint8_t *buf, int len)
+{
+  struct slip_radio *r;
+
+  if(radio < 0 || radio >= radio_count || radios[radio].fd <= 0) {
+    return -1;
+  }
+  r = &radios[radio];
+  if(len >= 2 && buf[0] == '!' && buf[1] == 'S') {
+    if(r->hold_count > 0 || !may_send(r)) {
+      return hold_frame(r, buf, len);
     }
+    send_packet(r, buf, len);
+  } else {
+    write_to_serial(r, buf, len);
   }
-  slip_send(outfd, SLIP_END);
-  PROGRESS("t");
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+slip_radio_credits(uint8_t free, uint8_t received, int sync)
+{
+  struct slip_radio *radio = &radios[input_radio];
+
+  if(!radio->credits.active) {
+    if(!sync) {
+      /* The radio was not asked, or has been restarted */
+      if(!radio->credits_pending) {
+        query_credits(radio);
+      }
+      return;
+    }
+    if(slip_config_verbose > 0) {
+      printf("radio %d: flow control with %u credits\n", input_radio, free);
+    }
+  }
+  cmd_credits_report(&radio->credits, free, received);
+  if(sync) {
+    /* The radio answered after receiving all packets sent before asking */
+    radio->credits.sent = received + radio->since_query;
+    radio->credits_pending = 0;
+  }
+  timer_set(&radio->credit_timer, CREDIT_TIMEOUT);
+  release_held(radio);
+}
+/*---------------------------------------------------------------------------*/
+int
+slip_flow_controlled(void)
+{
+  for(int i = 0; i < radio_count; i++) {
+    if(!radios[i].credits.active) {
+      return 0;
+    }
+  }
+  return radio_count > 0;
 }
 /*---------------------------------------------------------------------------*/
-/* writes an 802.15.4 packet to slip-radio */
+/* writes a packet or command to all slip-radios */
 void
 write_to_slip(const uint8_t *buf, int len)
 {
-  if(slipfd > 0) {
-    write_to_serial(slipfd, buf, len);
+  for(int i = 0; i < radio_count; i++) {
+    write_to_slip_radio(i, buf, len);
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+slip_radio_count(void)
+{
+  return radio_count;
+}
+/*---------------------------------------------------------------------------*/
+int
+slip_input_radio(void)
+{
+  return input_radio;
+}
+/*---------------------------------------------------------------------------*/
+void
+slip_print_stat(void)
+{
+  if(radio_count > 1) {
+    for(int i = 0; i < radio_count; i++) {
+      printf("radio %d (%s): %ld bytes received, %ld bytes sent\n",
+             i, radios[i].name, radios[i].received, radios[i].sent);
+    }
+  }
+  for(int i = 0; i < radio_count; i++) {
+    if(radios[i].credits.active) {
+      printf("radio %d: %d credits, %ld packets held, %ld dropped\n",
+             i, cmd_credits_available(&radios[i].credits),
+             radios[i].held, radios[i].dropped);
+    }
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -464,7 +668,8 @@ stty_telos(int fd)
   }
 
   i = TIOCM_DTR;
-  if(ioctl(fd, TIOCMBIS, &i) == -1) {
+  /* pseudo-terminals, such as emulated radios, have no modem lines */
+  if(ioctl(fd, TIOCMBIS, &i) == -1 && errno != ENOTTY) {
     err(EXIT_FAILURE, "ioctl");
   }
 #endif
@@ -480,83 +685,131 @@ stty_telos(int fd)
 static int
 set_fd(fd_set *rset, fd_set *wset)
 {
-  /* Anything to flush? */
-  if(!slip_empty() && (send_delay == 0 || timer_expired(&send_delay_timer))) {
-    FD_SET(slipfd, wset);
-  }
+  struct slip_radio *radio;
+
+  for(radio = radios; radio < radios + radio_count; radio++) {
+    /* Held packets and no credit report for a while? */
+    if((radio->hold_count > 0 || radio->credits_pending) &&
+       timer_expired(&radio->credit_timer)) {
+      if(radio->credits_pending && !radio->credits.active) {
+        /* No flow control; use the send delay */
+        radio->credits_pending = 0;
+        release_held(radio);
+      } else {
+        query_credits(radio);
+      }
+    }
+
+    /* Anything to flush? */
+    if(!slip_empty(radio) &&
+       (send_delay == 0 || radio->credits.active ||
+        timer_expired(&radio->send_delay_timer))) {
+      FD_SET(radio->fd, wset);
+    }
 
-  FD_SET(slipfd, rset);	/* Read from slip ASAP! */
+    FD_SET(radio->fd, rset);	/* Read from slip ASAP! */
+  }
   return 1;
 }
 /*---------------------------------------------------------------------------*/
 static void
 handle_fd(fd_set *rset, fd_set *wset)
 {
-  if(FD_ISSET(slipfd, rset)) {
-    serial_input(inslip);
-  }
+  struct slip_radio *radio;
 
-  if(FD_ISSET(slipfd, wset)) {
-    slip_flushbuf(slipfd);
+  for(radio = radios; radio < radios + radio_count; radio++) {
+    if(FD_ISSET(radio->fd, rset)) {
+      serial_input(radio);
+    }
+
+    if(FD_ISSET(radio->fd, wset)) {
+      slip_flushbuf(radio);
+    }
   }
 }
 /*---------------------------------------------------------------------------*/
 static const struct select_callback slip_callback = { set_fd, handle_fd };
 /*---------------------------------------------------------------------------*/
-void
-slip_init(void)
+static void
+open_radio(struct slip_radio *radio, struct slip_config_radio *config)
 {
-  setvbuf(stdout, NULL, _IOLBF, 0); /* Line buffered output. */
-
-  if(slip_config_host != NULL) {
-    if(slip_config_port == NULL) {
-      slip_config_port = "60001";
-    }
-    slipfd = connect_to_server(slip_config_host, slip_config_port);
-    if(slipfd == -1) {
-      err(EXIT_FAILURE, "can't connect to ``%s:%s''", slip_config_host,
-          slip_config_port);
+  if(config->host != NULL) {
+    if(config->port == NULL) {
+      config->port = "60001";
     }
-  } else if(slip_config_siodev != NULL) {
-    if(strcmp(slip_config_siodev, "null") == 0) {
-      /* Disable slip */
-      return;
-    }
-    slipfd = open(slip_config_siodev, O_RDWR | O_NONBLOCK);
-    if(slipfd == -1) {
-      err(EXIT_FAILURE, "can't open siodev ``%s''", slip_config_siodev);
+    radio->fd = connect_to_server(config->host, config->port);
+    if(radio->fd == -1) {
+      err(EXIT_FAILURE, "can't connect to ``%s:%s''", config->host,
+          config->port);
     }
+    radio->name = config->host;
+    fprintf(stderr, "********SLIP opened to ``%s:%s''\n", config->host,
+            config->port);
   } else {
-    static const char *siodevs[] = {
-      "/dev/ttyUSB0", "/dev/cuaU0", "/dev/ucom0" /* linux, fbsd6, fbsd5 */
-    };
-    for(int i = 0; i < 3; i++) {
-      slip_config_siodev = siodevs[i];
-      slipfd = open(slip_config_siodev, O_RDWR | O_NONBLOCK);
-      if(slipfd != -1) {
-        break;
+    if(config->siodev != NULL) {
+      radio->fd = open(config->siodev, O_RDWR | O_NONBLOCK);
+      if(radio->fd == -1) {
+        err(EXIT_FAILURE, "can't open siodev ``%s''", config->siodev);
+      }
+    } else {
+      static const char *siodevs[] = {
+        "/dev/ttyUSB0", "/dev/cuaU0", "/dev/ucom0" /* linux, fbsd6, fbsd5 */
+      };
+      for(int i = 0; i < 3; i++) {
+        config->siodev = siodevs[i];
+        radio->fd = open(config->siodev, O_RDWR | O_NONBLOCK);
+        if(radio->fd != -1) {
+          break;
+        }
+      }
+      if(radio->fd == -1) {
+        err(EXIT_FAILURE, "can't open siodev");
       }
     }
-    if(slipfd == -1) {
-      err(EXIT_FAILURE, "can't open siodev");
-    }
+    radio->name = config->siodev;
+    fprintf(stderr, "********SLIP started on ``/dev/%s''\n", config->siodev);
+    stty_telos(radio->fd);
   }
 
-  select_set_callback(slipfd, &slip_callback);
+  /* Echo lines as they are received for verbose=2,3,5+ */
+  slip_decoder_init(&radio->decoder, radio->inbuf, sizeof(radio->inbuf),
+                    slip_config_verbose >= 2 && slip_config_verbose != 4 ?
+                    SLIP_CODEC_LINES : 0);
+  timer_set(&radio->send_delay_timer, 0);
+  slip_send(radio, SLIP_END);
 
-  if(slip_config_host != NULL) {
-    fprintf(stderr, "********SLIP opened to ``%s:%s''\n", slip_config_host,
-            slip_config_port);
-  } else {
-    fprintf(stderr, "********SLIP started on ``/dev/%s''\n", slip_config_siodev);
-    stty_telos(slipfd);
+  /* A radio that supports flow control reports its credits */
+  query_credits(radio);
+}
+/*---------------------------------------------------------------------------*/
+void
+slip_init(void)
+{
+  static struct slip_config_radio default_radio;
+  struct slip_config_radio *config = slip_config_radios;
+  int count = slip_config_radio_count;
+  int maxfd = 0;
+
+  setvbuf(stdout, NULL, _IOLBF, 0); /* Line buffered output. */
+
+  if(count == 0) {
+    /* Look for a radio on the usual serial devices */
+    config = &default_radio;
+    count = 1;
+  } else if(count == 1 && config->siodev != NULL &&
+            strcmp(config->siodev, "null") == 0) {
+    /* Disable slip */
+    return;
   }
 
-  timer_set(&send_delay_timer, 0);
-  slip_send(slipfd, SLIP_END);
-  inslip = fdopen(slipfd, "r");
-  if(inslip == NULL) {
-    err(EXIT_FAILURE, "slip_init: fdopen");
+  for(radio_count = 0; radio_count < count; radio_count++) {
+    open_radio(&radios[radio_count], &config[radio_count]);
+    if(radios[radio_count].fd > maxfd) {
+      maxfd = radios[radio_count].fd;
+    }
   }
+
+  /* One callback serves all radios, registered at the highest descriptor */
+  select_set_callback(maxfd, &slip_callback);
 }
 /*---------------------------------------------------------------------------*/
@@ -58,7 +58,9 @@ tun_input_callback(void)
 {
   /* Optional delay between outgoing packets */
   /* Base delay times number of 6lowpan fragments to be sent */
-  if(!slip_config_basedelay || timer_expired(&delay_timer)) {
+  /* Not needed when the radios pace the packets with credits */
+  if(!slip_config_basedelay || slip_flow_controlled() ||
+     timer_expired(&delay_timer)) {
     uip_len = tun6_net_input(uip_buf, sizeof(uip_buf));
     tcpip_input();
 
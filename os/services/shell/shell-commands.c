@@ -46,6 +46,10 @@
 #include "shell.h"
 #include "shell-commands.h"
 #include "lib/list.h"
+#include "lib/heapmem.h"
+#include "lib/memb.h"
+#include "lib/mem-snapshot.h"
+#include "lib/hexconv.h"
 #include "sys/log.h"
 #include "dev/watchdog.h"
 #include "net/ipv6/uip.h"
@@ -66,6 +70,7 @@
 #endif
 #include "net/routing/routing.h"
 #include "net/mac/llsec802154.h"
+#include "net/net-stats.h"
 
 /* For RPL-specific commands */
 #if ROUTING_CONF_RPL_LITE
@@ -733,6 +738,8 @@ PT_THREAD(cmd_resolv(struct pt *pt, shell_output_func output, char *args))
     }
     if(ret == RESOLV_STATUS_NOT_FOUND) {
       SHELL_OUTPUT(output, "Did not find IPv6 address for host: %s\n", args);
+    } else if(ret == RESOLV_STATUS_ERROR) {
+      SHELL_OUTPUT(output, "No nameserver answered for host: %s\n", args);
     } else if(ret == RESOLV_STATUS_CACHED) {
       SHELL_OUTPUT(output, "Found IPv6 address for host: %s => ", args);
       shell_output_6addr(output, remote_addr);
@@ -809,6 +816,202 @@ PT_THREAD(cmd_reboot(struct pt *pt, shell_output_func output, char *args))
   watchdog_reboot();
   PT_END(pt);
 }
+#ifdef HEAPMEM_CONF_ARENA_SIZE
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_heapmem(struct pt *pt, shell_output_func output, char *args))
+{
+  heapmem_stats_t stats;
+  heapmem_zone_stats_t zone_stats;
+  char *next_args;
+
+  PT_BEGIN(pt);
+
+  SHELL_ARGS_INIT(args, next_args);
+  SHELL_ARGS_NEXT(args, next_args);
+
+  heapmem_stats(&stats);
+  SHELL_OUTPUT(output, "Heap: %lu bytes allocated in %lu chunks, %lu bytes overhead, %lu bytes available\n",
+               (unsigned long)stats.allocated, (unsigned long)stats.chunks,
+               (unsigned long)stats.overhead, (unsigned long)stats.available);
+  SHELL_OUTPUT(output, "Footprint: %lu bytes (max %lu bytes)\n",
+               (unsigned long)stats.footprint, (unsigned long)stats.max_footprint);
+
+  SHELL_OUTPUT(output, "Zones:\n");
+  for(heapmem_zone_t zone = HEAPMEM_ZONE_GENERAL;
+      heapmem_zone_stats(zone, &zone_stats);
+      zone++) {
+    SHELL_OUTPUT(output, "-- %u %s: %lu/%lu bytes (max %lu bytes), %u failures\n",
+                 zone, zone_stats.name,
+                 (unsigned long)zone_stats.allocated,
+                 (unsigned long)zone_stats.zone_size,
+                 (unsigned long)zone_stats.max_allocated,
+                 zone_stats.failures);
+  }
+
+#if HEAPMEM_DEBUG
+  if(args != NULL && !strcmp(args, "chunks")) {
+    heapmem_chunk_info_t info = { .ptr = NULL };
+
+    SHELL_OUTPUT(output, "Chunks:\n");
+    while(heapmem_chunk_next(&info)) {
+      SHELL_OUTPUT(output, "-- %p: %lu bytes in zone %u from %s:%u, age %lu seconds\n",
+                   info.ptr, (unsigned long)info.size, info.zone,
+                   info.file, info.line,
+                   (unsigned long)(info.age / CLOCK_SECOND));
+    }
+  }
+#endif /* HEAPMEM_DEBUG */
+
+  PT_END(pt);
+}
+#endif /* HEAPMEM_CONF_ARENA_SIZE */
+#if MEMB_STATS
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_memb(struct pt *pt, shell_output_func output, char *args))
+{
+  PT_BEGIN(pt);
+
+  SHELL_OUTPUT(output, "Memory block pools:\n");
+  for(struct memb *m = memb_stats_head(); m != NULL; m = m->next) {
+    SHELL_OUTPUT(output, "-- %s: %u/%u blocks of %u bytes (max %u), %u failures\n",
+                 m->name, m->num - m->free, m->num, m->size,
+                 m->max_used, m->failures);
+  }
+
+  PT_END(pt);
+}
+#endif /* MEMB_STATS */
+#if defined(HEAPMEM_CONF_ARENA_SIZE) || MEMB_STATS
+/*---------------------------------------------------------------------------*/
+static shell_output_func *snapshot_output;
+
+static void
+output_snapshot(const uint8_t *data, size_t len, void *ptr)
+{
+  char text[2 * MEM_SNAPSHOT_PART_MAX + 1];
+  int text_len;
+
+  text_len = hexconv_hexlify(data, len, text, sizeof(text));
+  text[text_len] = '\0';
+  SHELL_OUTPUT(snapshot_output, "memsnap %s\n", text);
+}
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_mem_snapshot(struct pt *pt, shell_output_func output, char *args))
+{
+  PT_BEGIN(pt);
+
+  snapshot_output = output;
+  mem_snapshot(output_snapshot, NULL);
+
+  PT_END(pt);
+}
+#endif /* defined(HEAPMEM_CONF_ARENA_SIZE) || MEMB_STATS */
+#if NET_STATS
+/*---------------------------------------------------------------------------*/
+static void
+output_net_stats(shell_output_func output, const struct net_stats *stats,
+                 clock_time_t interval)
+{
+  uint32_t delta;
+  uint64_t rate;
+  uint8_t i;
+
+  SHELL_OUTPUT(output, "%s:\n", stats->name);
+  for(i = 0; i < stats->count; i++) {
+    if(stats->gauges & NET_STATS_GAUGE(i)) {
+      SHELL_OUTPUT(output, "-- %s: %lu\n", stats->names[i],
+                   (unsigned long)stats->values[i]);
+      continue;
+    }
+    delta = net_stats_delta(stats, i);
+    /* The rate in tenths of events per second */
+    rate = interval ? (uint64_t)delta * 10 * CLOCK_SECOND / interval : 0;
+    SHELL_OUTPUT(output, "-- %s: %lu (+%lu, %lu.%lu/s)\n", stats->names[i],
+                 (unsigned long)stats->values[i], (unsigned long)delta,
+                 (unsigned long)(rate / 10), (unsigned long)(rate % 10));
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+output_net_stats_cbor(shell_output_func output, const struct net_stats *stats)
+{
+  static uint8_t cbor[NET_STATS_CBOR_MAX];
+  char text[2 * 32 + 1];
+  size_t len;
+  size_t offset;
+  int text_len;
+
+  len = net_stats_to_cbor(stats, cbor, sizeof(cbor));
+  if(len == 0) {
+    SHELL_OUTPUT(output, "Statistics of %s do not fit NET_STATS_CBOR_MAX\n",
+                 stats->name);
+    return;
+  }
+  SHELL_OUTPUT(output, "netstats ");
+  for(offset = 0; offset < len; offset += 32) {
+    text_len = hexconv_hexlify(cbor + offset, MIN(len - offset, 32),
+                               text, sizeof(text));
+    text[text_len] = '\0';
+    SHELL_OUTPUT(output, "%s", text);
+  }
+  SHELL_OUTPUT(output, "\n");
+}
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_net_stats(struct pt *pt, shell_output_func output, char *args))
+{
+  struct net_stats *stats;
+  struct net_stats *only = NULL;
+  clock_time_t interval;
+  bool cbor = false;
+  char *next_args;
+
+  PT_BEGIN(pt);
+
+  SHELL_ARGS_INIT(args, next_args);
+  SHELL_ARGS_NEXT(args, next_args);
+
+  if(args != NULL && !strcmp(args, "reset")) {
+    net_stats_reset();
+    SHELL_OUTPUT(output, "Statistics reset\n");
+    PT_EXIT(pt);
+  }
+  if(args != NULL && !strcmp(args, "cbor")) {
+    cbor = true;
+    SHELL_ARGS_NEXT(args, next_args);
+  }
+  if(args != NULL) {
+    only = net_stats_find(args);
+    if(only == NULL) {
+      SHELL_OUTPUT(output, "Unknown statistics group: %s\n", args);
+      PT_EXIT(pt);
+    }
+  }
+
+  net_stats_update();
+  interval = net_stats_interval();
+  if(!cbor) {
+    SHELL_OUTPUT(output, "Network statistics, changes over %lu ms:\n",
+                 (unsigned long)((uint64_t)interval * 1000 / CLOCK_SECOND));
+  }
+  for(stats = net_stats_head(); stats != NULL; stats = stats->next) {
+    if(only != NULL && stats != only) {
+      continue;
+    }
+    if(cbor) {
+      output_net_stats_cbor(output, stats);
+    } else {
+      output_net_stats(output, stats, interval);
+    }
+  }
+  net_stats_mark();
+
+  PT_END(pt);
+}
+#endif /* NET_STATS */
 #if MAC_CONF_WITH_TSCH
 /*---------------------------------------------------------------------------*/
 static
@@ -998,6 +1201,18 @@ const struct shell_command_t builtin_shell_commands[] = {
   { "reboot",               cmd_reboot,               "'> reboot': Reboot the board by watchdog_reboot()" },
   { "log",                  cmd_log,                  "'> log module level': Sets log level (0--4) for a given module (or \"all\"). For module \"mac\", level 4 also enables per-slot logging." },
   { "mac-addr",             cmd_macaddr,               "'> mac-addr': Shows the node's MAC address" },
+#ifdef HEAPMEM_CONF_ARENA_SIZE
+  { "heapmem",              cmd_heapmem,              "'> heapmem [chunks]': Shows heap memory statistics, and optionally the allocated chunks (with HEAPMEM_DEBUG)" },
+#endif /* HEAPMEM_CONF_ARENA_SIZE */
+#if MEMB_STATS
+  { "memb",                 cmd_memb,                 "'> memb': Shows the statistics of the memory block pools" },
+#endif /* MEMB_STATS */
+#if defined(HEAPMEM_CONF_ARENA_SIZE) || MEMB_STATS
+  { "mem-snapshot",         cmd_mem_snapshot,         "'> mem-snapshot': Prints a binary memory snapshot in hex, for tools/mem-snapshot" },
+#endif /* defined(HEAPMEM_CONF_ARENA_SIZE) || MEMB_STATS */
+#if NET_STATS
+  { "stats",                cmd_net_stats,            "'> stats [cbor] [group]': Shows the network stack counters, with their changes and rates since the last call, optionally as hex-encoded CBOR. '> stats reset' resets them." },
+#endif /* NET_STATS */
 #if NETSTACK_CONF_WITH_IPV6
   { "ip-addr",              cmd_ipaddr,               "'> ip-addr': Shows all IPv6 addresses" },
   { "ip-nbr",               cmd_ip_neighbors,         "'> ip-nbr': Shows all IPv6 neighbors" },
@@ -42,6 +42,54 @@
 
 #define CMD_TYPE_ERR 'E'
 
+/*
+ * Credit-based flow control between a host and a slip-radio. The radio
+ * reports "!F" <free> <received>, where free is the number of packets
+ * that it can accept, and received is the number of "!S" packets that
+ * it has received, modulo 256. The radio sends the report in response
+ * to "?F", and appends the same two bytes to each "!R" report. A host
+ * that has received a report keeps at most
+ * free - (sent - received) "!S" packets in flight.
+ */
+#define CMD_TYPE_FLOW_CONTROL 'F'
+
+/** The flow-control state of a host. */
+typedef struct cmd_credits {
+  uint8_t active;
+  uint8_t free;
+  uint8_t received;
+  uint8_t sent;
+} cmd_credits_t;
+
+/**
+ * \brief         Update the flow-control state with a report.
+ * \param credits The flow-control state.
+ * \param free    The number of packets that the radio can accept.
+ * \param received The number of packets that the radio has received.
+ */
+static inline void
+cmd_credits_report(cmd_credits_t *credits, uint8_t free, uint8_t received)
+{
+  credits->active = 1;
+  credits->free = free;
+  credits->received = received;
+}
+
+/**
+ * \brief         Get the number of packets that may be sent.
+ * \param credits The flow-control state.
+ * \return        The number of packets, or a negative value if the
+ *                radio has not reported its state.
+ */
+static inline int
+cmd_credits_available(const cmd_credits_t *credits)
+{
+  if(!credits->active) {
+    return -1;
+  }
+  return (int)credits->free - (uint8_t)(credits->sent - credits->received);
+}
+
 typedef int (* cmd_handler_t)(const uint8_t *data, int len);
 
 #define CMD_HANDLERS(...) \
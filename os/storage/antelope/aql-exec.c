@@ -37,6 +37,7 @@
  * 	Nicolas Tsiftes <nvt@sics.se>
  */
 
+#include <limits.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
@@ -48,6 +49,7 @@
 #include "relation.h"
 #include "result.h"
 #include "aql.h"
+#include "lvm.h"
 
 static aql_adt_t adt;
 
@@ -62,6 +64,81 @@ clear_handle(db_handle_t *handle)
   handle->join_rel = NULL;
 }
 
+#if DB_FEATURE_JOIN
+static int
+has_inline_index(attribute_t *attr)
+{
+  return index_exists(attr) &&
+         ((index_t *)attr->index)->type == INDEX_INLINE;
+}
+
+/*
+ * Select the join method that is estimated to read the fewest rows
+ * from storage. The index join is the default, and it remains the only
+ * method for attributes in non-numeric domains.
+ */
+static void
+select_join_method(db_handle_t *handle, aql_adt_t *adt)
+{
+  attribute_t *left_attr;
+  attribute_t *right_attr;
+#if DB_JOIN_HASH_SIZE > 0
+  tuple_id_t left_rows;
+  tuple_id_t right_rows;
+  tuple_id_t n;
+  unsigned long probe_cost;
+  unsigned long min_cost;
+#endif /* DB_JOIN_HASH_SIZE > 0 */
+
+  left_attr = relation_attribute_get(handle->left_rel, adt->attributes[0].name);
+  right_attr = relation_attribute_get(handle->right_rel, adt->attributes[0].name);
+  if(left_attr == NULL || right_attr == NULL ||
+     (left_attr->domain != DOMAIN_INT && left_attr->domain != DOMAIN_LONG) ||
+     (right_attr->domain != DOMAIN_INT && right_attr->domain != DOMAIN_LONG)) {
+    return;
+  }
+
+  /* Rows in relations with inline indexes are ordered on the indexed
+     attribute, so a single merge pass over both relations suffices. */
+  if(has_inline_index(left_attr) && has_inline_index(right_attr)) {
+    PRINTF("DB: Selected the merge join method\n");
+    handle->flags |= DB_HANDLE_FLAG_MERGE_JOIN;
+    return;
+  }
+
+#if DB_JOIN_HASH_SIZE > 0
+  left_rows = relation_cardinality(handle->left_rel);
+  right_rows = relation_cardinality(handle->right_rel);
+  if(left_rows == INVALID_TUPLE || right_rows == INVALID_TUPLE) {
+    return;
+  }
+
+  /* The index join looks up each left row in the index, and then
+     reads the matching right row. */
+  min_cost = ULONG_MAX;
+  if(index_exists(right_attr)) {
+    probe_cost = 1;
+    if(has_inline_index(right_attr)) {
+      /* A binary search reads about log2(n) rows. */
+      for(n = right_rows; n > 1; n >>= 1) {
+        probe_cost++;
+      }
+    }
+    min_cost = (unsigned long)left_rows * (probe_cost + 1);
+  }
+
+  /* The hash join reads the right relation once, and the left relation
+     once for every partition of the right relation. */
+  if((unsigned long)right_rows +
+     (unsigned long)left_rows * (right_rows / DB_JOIN_HASH_CAPACITY + 1) <
+     min_cost) {
+    PRINTF("DB: Selected the hash join method\n");
+    handle->flags |= DB_HANDLE_FLAG_HASH_JOIN;
+  }
+#endif /* DB_JOIN_HASH_SIZE > 0 */
+}
+#endif /* DB_FEATURE_JOIN */
+
 static db_result_t
 aql_execute(db_handle_t *handle, aql_adt_t *adt)
 {
@@ -171,6 +248,7 @@ aql_execute(db_handle_t *handle, aql_adt_t *adt)
       relation_release(handle->left_rel);
       break;
     }
+    select_join_method(handle, adt);
     result = relation_join(handle, adt);
     break;
 #endif /* DB_FEATURE_JOIN */
@@ -205,7 +283,9 @@ db_query(db_handle_t *handle, const char *format, ...)
     return DB_PARSING_ERROR;
   }
 
-  /*aql_optimize(&adt);*/
+  if(adt.lvm_instance != NULL) {
+    lvm_optimize(adt.lvm_instance);
+  }
 
   return aql_execute(handle, &adt);
 }
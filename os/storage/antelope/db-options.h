@@ -105,6 +105,12 @@
 #endif /* DB_MAX_ELEMENT_SIZE */
 
 
+/* The size of the buffer used for reading blocks of rows during
+   full relation scans. Set to 0 to read one row at a time. */
+#ifndef DB_SCAN_BUFFER_SIZE
+#define DB_SCAN_BUFFER_SIZE		256
+#endif /* DB_SCAN_BUFFER_SIZE */
+
 /* The maximum size of the LVM bytecode compiled from a
    single database query. */
 #ifndef DB_VM_BYTECODE_SIZE
@@ -205,6 +211,21 @@
 #define DB_MEMHASH_TABLE_SIZE		61
 #endif /* DB_MEMHASH_TABLE_SIZE */
 
+/* The number of slots in the hash table used for joining on attributes
+   without an index. Set to 0 to disable hash joins. */
+#ifndef DB_JOIN_HASH_SIZE
+#define DB_JOIN_HASH_SIZE		32
+#endif /* DB_JOIN_HASH_SIZE */
+
+#if DB_JOIN_HASH_SIZE > 0 && DB_JOIN_HASH_SIZE < 4
+#error DB_JOIN_HASH_SIZE must be 0 or at least 4.
+#endif
+
+/* The number of rows of the right relation inserted into the hash
+   table at a time. A quarter of the slots is kept free to keep
+   the probe sequences short. */
+#define DB_JOIN_HASH_CAPACITY		(DB_JOIN_HASH_SIZE - DB_JOIN_HASH_SIZE / 4)
+
 /* The maximum number of Maxheap indexes. */
 #ifndef DB_HEAP_INDEX_LIMIT
 #define DB_HEAP_INDEX_LIMIT		1
@@ -231,6 +252,12 @@
 #define LVM_MAX_VARIABLE_ID		AQL_ATTRIBUTE_LIMIT - 1
 #endif /* LVM_MAX_VARIABLE_ID */
 
+/* The maximum number of comparisons in a predicate that can be
+   evaluated without interpreting the LVM bytecode. */
+#ifndef LVM_FAST_PATH_LENGTH
+#define LVM_FAST_PATH_LENGTH		4
+#endif /* LVM_FAST_PATH_LENGTH */
+
 /* Specify whether floats should be used or not inside the LVM. */
 #ifndef LVM_USE_FLOATS
 #define LVM_USE_FLOATS			DB_FEATURE_FLOATS
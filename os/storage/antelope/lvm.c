@@ -162,6 +162,57 @@ operand_to_long(operand_t *operand)
   }
 }
 
+static lvm_ip_t
+node_end(lvm_instance_t *p, lvm_ip_t ip)
+{
+  node_type_t type;
+  operator_t op;
+
+  if(ip + sizeof(type) > p->end) {
+    return p->end + 1;
+  }
+
+  memcpy(&type, p->code + ip, sizeof(type));
+  ip += sizeof(type);
+  if(type == LVM_OPERAND) {
+    return ip + sizeof(operand_t);
+  }
+
+  memcpy(&op, p->code + ip, sizeof(op));
+  ip = node_end(p, ip + sizeof(op));
+  if(op != LVM_NOT) {
+    ip = node_end(p, ip);
+  }
+
+  return ip;
+}
+
+static lvm_status_t
+apply_operator(operator_t op, long value1, long value2, long *result)
+{
+  switch(op) {
+  case LVM_ADD:
+    *result = value1 + value2;
+    break;
+  case LVM_SUB:
+    *result = value1 - value2;
+    break;
+  case LVM_MUL:
+    *result = value1 * value2;
+    break;
+  case LVM_DIV:
+    if(value2 == 0) {
+      return LVM_MATH_ERROR;
+    }
+    *result = value1 / value2;
+    break;
+  default:
+    return LVM_EXECUTION_ERROR;
+  }
+
+  return LVM_TRUE;
+}
+
 static lvm_status_t
 eval_expr(lvm_instance_t *p, operator_t op, operand_t *result)
 {
@@ -192,24 +243,9 @@ eval_expr(lvm_instance_t *p, operator_t op, operand_t *result)
     value[i] = operand_to_long(&operand[i]);
   }
 
-  switch(op) {
-  case LVM_ADD:
-    result_value = value[0] + value[1];
-    break;
-  case LVM_SUB:
-    result_value = value[0] - value[1];
-    break;
-  case LVM_MUL:
-    result_value = value[0] * value[1];
-    break;
-  case LVM_DIV:
-    if(value[1] == 0) {
-      return LVM_MATH_ERROR;
-    }
-    result_value = value[0] / value[1];
-    break;
-  default:
-    return LVM_EXECUTION_ERROR;
+  r = apply_operator(op, value[0], value[1], &result_value);
+  if(LVM_ERROR(r)) {
+    return r;
   }
 
   result->type = LVM_LONG;
@@ -243,6 +279,13 @@ eval_logic(lvm_instance_t *p, operator_t *op)
       if(LVM_ERROR(logic_result[i])) {
 	return logic_result[i];
       }
+
+      /* Skip the second operand if the first one decides the result. */
+      if((*op == LVM_AND && logic_result[i] == LVM_FALSE) ||
+         (*op == LVM_OR && logic_result[i] == LVM_TRUE)) {
+        p->ip = node_end(p, p->ip);
+        return logic_result[i];
+      }
     }
 
     if(*op == LVM_NOT) {
@@ -297,6 +340,47 @@ eval_logic(lvm_instance_t *p, operator_t *op)
   return LVM_EXECUTION_ERROR;
 }
 
+static lvm_status_t
+execute_fast_path(lvm_instance_t *p)
+{
+  struct lvm_fast_comparison *comparison;
+  long l;
+  int result;
+
+  for(comparison = p->fast_path;
+      comparison < &p->fast_path[p->fast_path_length];
+      comparison++) {
+    l = variables[comparison->id].value.l;
+    switch(comparison->op) {
+    case LVM_EQ:
+      result = l == comparison->value;
+      break;
+    case LVM_NEQ:
+      result = l != comparison->value;
+      break;
+    case LVM_GE:
+      result = l > comparison->value;
+      break;
+    case LVM_GEQ:
+      result = l >= comparison->value;
+      break;
+    case LVM_LE:
+      result = l < comparison->value;
+      break;
+    case LVM_LEQ:
+      result = l <= comparison->value;
+      break;
+    default:
+      return LVM_EXECUTION_ERROR;
+    }
+    if(!result) {
+      return LVM_FALSE;
+    }
+  }
+
+  return LVM_TRUE;
+}
+
 void
 lvm_reset(lvm_instance_t *p, unsigned char *code, lvm_ip_t size)
 {
@@ -309,6 +393,7 @@ lvm_reset(lvm_instance_t *p, unsigned char *code, lvm_ip_t size)
 
   memset(variables, 0, sizeof(variables));
   memset(derivations, 0, sizeof(derivations));
+  p->fast_path_length = 0;
 }
 
 lvm_ip_t
@@ -377,6 +462,10 @@ lvm_execute(lvm_instance_t *p)
   operator_t *operator;
   lvm_status_t status;
 
+  if(p->fast_path_length > 0) {
+    return execute_fast_path(p);
+  }
+
   p->ip = 0;
   status = LVM_EXECUTION_ERROR;
   type = get_type(p);
@@ -516,6 +605,29 @@ lvm_set_variable_value(char *name, operand_value_t value)
   return LVM_TRUE;
 }
 
+variable_id_t
+lvm_get_variable_id(char *name)
+{
+  variable_id_t id;
+
+  id = lookup(name);
+  if(id == LVM_MAX_VARIABLE_ID || strcmp(variables[id].name, name) != 0) {
+    return LVM_MAX_VARIABLE_ID;
+  }
+  return id;
+}
+
+lvm_status_t
+lvm_set_variable_value_by_id(variable_id_t id, operand_value_t value)
+{
+  if(id >= LVM_MAX_VARIABLE_ID) {
+    return LVM_INVALID_IDENTIFIER;
+  }
+
+  variables[id].value = value;
+  return LVM_TRUE;
+}
+
 lvm_status_t
 lvm_set_variable(lvm_instance_t *p, char *name)
 {
@@ -588,14 +700,10 @@ create_union(derivation_t *result, derivation_t *d1, derivation_t *d2)
   int i;
 
   for(i = 0; i < LVM_MAX_VARIABLE_ID; i++) {
-    if(!d1[i].derived && !d2[i].derived) {
+    if(!d1[i].derived || !d2[i].derived) {
+      /* The variable is unconstrained in at least one of the
+         alternatives, so its range cannot be narrowed. */
       continue;
-    } else if(d1[i].derived && !d2[i].derived) {
-      result[i].min.l = d1[i].min.l;
-      result[i].max.l = d1[i].max.l;
-    } else if(!d1[i].derived && d2[i].derived) {
-      result[i].min.l = d2[i].min.l;
-      result[i].max.l = d2[i].max.l;
     } else {
       /* Both derivations have been made; create a
          union of the ranges. */
@@ -625,10 +733,28 @@ create_union(derivation_t *result, derivation_t *d1, derivation_t *d2)
 #endif /* DEBUG */
 }
 
+static operator_t
+mirror_operator(operator_t op)
+{
+  switch(op) {
+  case LVM_GE:
+    return LVM_LE;
+  case LVM_GEQ:
+    return LVM_LEQ;
+  case LVM_LE:
+    return LVM_GE;
+  case LVM_LEQ:
+    return LVM_GEQ;
+  default:
+    return op;
+  }
+}
+
 static int
 derive_relation(lvm_instance_t *p, derivation_t *local_derivations)
 {
   operator_t *operator;
+  operator_t op;
   node_type_t type;
   operand_t operand[2];
   int i;
@@ -680,16 +806,19 @@ derive_relation(lvm_instance_t *p, derivation_t *local_derivations)
     return LVM_DERIVATION_ERROR;
   }
 
-  /* Determine which of the operands that is the variable. */
+  /* Determine which of the operands that is the variable. If the
+     constant comes first, mirror the operator so that the range is
+     derived for "variable OP constant". */
+  op = *operator;
   if(operand[0].type == LVM_VARIABLE) {
-    if(operand[1].type == LVM_VARIABLE) {
-      return LVM_DERIVATION_ERROR;
-    }
     variable_id = operand[0].value.id;
     value = &operand[1].value;
-  } else {
+  } else if(operand[1].type == LVM_VARIABLE) {
     variable_id = operand[1].value.id;
     value = &operand[0].value;
+    op = mirror_operator(op);
+  } else {
+    return LVM_DERIVATION_ERROR;
   }
 
   if(variable_id >= LVM_MAX_VARIABLE_ID) {
@@ -703,7 +832,7 @@ derive_relation(lvm_instance_t *p, derivation_t *local_derivations)
   derivation->max.l = LONG_MAX;
   derivation->min.l = LONG_MIN;
 
-  switch(*operator) {
+  switch(op) {
   case LVM_EQ:
     derivation->max = *value;
     derivation->min = *value;
@@ -754,6 +883,202 @@ lvm_get_derived_range(lvm_instance_t *p, char *name,
   return LVM_INVALID_IDENTIFIER;
 }
 
+static int
+get_constant(lvm_instance_t *p, lvm_ip_t ip, long *value)
+{
+  node_type_t type;
+  operand_t operand;
+
+  memcpy(&type, p->code + ip, sizeof(type));
+  if(type != LVM_OPERAND) {
+    return 0;
+  }
+
+  memcpy(&operand, p->code + ip + sizeof(type), sizeof(operand));
+  if(operand.type != LVM_LONG) {
+    return 0;
+  }
+
+  *value = operand.value.l;
+  return 1;
+}
+
+static void
+reverse_code(unsigned char *start, unsigned char *end)
+{
+  unsigned char c;
+
+  while(start < --end) {
+    c = *start;
+    *start++ = *end;
+    *end = c;
+  }
+}
+
+/*
+ * Rewrite the subtree at ip to the position out. Arithmetic on
+ * constants is folded, and the operands of AND and OR are ordered so
+ * that the cheapest one is evaluated first. The rewritten code is never
+ * longer than the original, so it can overwrite the code in place.
+ * Returns the position following the original subtree, or -1 if the
+ * code is malformed.
+ */
+static lvm_ip_t
+optimize_node(lvm_instance_t *p, lvm_ip_t ip, lvm_ip_t *out, unsigned *cost)
+{
+  node_type_t type;
+  operator_t op;
+  operand_t operand;
+  lvm_ip_t child[2];
+  lvm_ip_t node;
+  unsigned child_cost;
+  unsigned first_cost;
+  long value[2];
+  long result;
+  int i;
+
+  if(ip < 0 || ip + sizeof(type) + sizeof(op) > p->end) {
+    return -1;
+  }
+
+  memcpy(&type, p->code + ip, sizeof(type));
+  if(type == LVM_OPERAND) {
+    if(ip + sizeof(type) + sizeof(operand) > p->end) {
+      return -1;
+    }
+    memmove(p->code + *out, p->code + ip, sizeof(type) + sizeof(operand));
+    *out += sizeof(type) + sizeof(operand);
+    *cost = 0;
+    return ip + sizeof(type) + sizeof(operand);
+  } else if(type != LVM_ARITH_OP && type != LVM_CMP_OP) {
+    return -1;
+  }
+
+  memcpy(&op, p->code + ip + sizeof(type), sizeof(op));
+  node = *out;
+  memmove(p->code + node, p->code + ip, sizeof(type) + sizeof(op));
+  *out += sizeof(type) + sizeof(op);
+  ip += sizeof(type) + sizeof(op);
+
+  *cost = 1;
+  first_cost = 0;
+  for(i = 0; i < (op == LVM_NOT ? 1 : 2); i++) {
+    child[i] = *out;
+    ip = optimize_node(p, ip, out, &child_cost);
+    if(ip < 0) {
+      return -1;
+    }
+    if(i == 0) {
+      first_cost = child_cost;
+    }
+    *cost += child_cost;
+  }
+
+  if(type == LVM_ARITH_OP &&
+     get_constant(p, child[0], &value[0]) &&
+     get_constant(p, child[1], &value[1]) &&
+     apply_operator(op, value[0], value[1], &result) == LVM_TRUE) {
+    /* Replace the operation with its result. A division by zero is
+       kept so that it is reported when the predicate is executed. */
+    type = LVM_OPERAND;
+    operand.type = LVM_LONG;
+    operand.value.l = result;
+    memcpy(p->code + node, &type, sizeof(type));
+    memcpy(p->code + node + sizeof(type), &operand, sizeof(operand));
+    *out = node + sizeof(type) + sizeof(operand);
+    *cost = 0;
+  } else if((op == LVM_AND || op == LVM_OR) &&
+            child_cost < first_cost) {
+    /* Swap the operands by rotating the code of the two subtrees. */
+    reverse_code(p->code + child[0], p->code + child[1]);
+    reverse_code(p->code + child[1], p->code + *out);
+    reverse_code(p->code + child[0], p->code + *out);
+  }
+
+  return ip;
+}
+
+static lvm_ip_t
+compile_fast_path(lvm_instance_t *p, lvm_ip_t ip)
+{
+  node_type_t type;
+  operator_t op;
+  operand_t operand[2];
+  struct lvm_fast_comparison *comparison;
+  int i;
+
+  memcpy(&type, p->code + ip, sizeof(type));
+  memcpy(&op, p->code + ip + sizeof(type), sizeof(op));
+  ip += sizeof(type) + sizeof(op);
+  if(type != LVM_CMP_OP) {
+    return -1;
+  }
+
+  if(op == LVM_AND) {
+    ip = compile_fast_path(p, ip);
+    return ip < 0 ? -1 : compile_fast_path(p, ip);
+  } else if(IS_CONNECTIVE(op) || p->fast_path_length == LVM_FAST_PATH_LENGTH) {
+    return -1;
+  }
+
+  for(i = 0; i < 2; i++) {
+    memcpy(&type, p->code + ip, sizeof(type));
+    if(type != LVM_OPERAND) {
+      return -1;
+    }
+    memcpy(&operand[i], p->code + ip + sizeof(type), sizeof(operand[i]));
+    ip += sizeof(type) + sizeof(operand[i]);
+  }
+
+  comparison = &p->fast_path[p->fast_path_length];
+  if(operand[0].type == LVM_VARIABLE && operand[1].type == LVM_LONG) {
+    comparison->id = operand[0].value.id;
+    comparison->value = operand[1].value.l;
+    comparison->op = op;
+  } else if(operand[0].type == LVM_LONG && operand[1].type == LVM_VARIABLE) {
+    comparison->id = operand[1].value.id;
+    comparison->value = operand[0].value.l;
+    comparison->op = mirror_operator(op);
+  } else {
+    return -1;
+  }
+
+  if(comparison->id >= LVM_MAX_VARIABLE_ID) {
+    return -1;
+  }
+  p->fast_path_length++;
+
+  return ip;
+}
+
+lvm_status_t
+lvm_optimize(lvm_instance_t *p)
+{
+  lvm_ip_t end;
+  unsigned cost;
+
+  p->fast_path_length = 0;
+
+  end = 0;
+  if(optimize_node(p, 0, &end, &cost) != p->end) {
+    PRINTF("Error: malformed code cannot be optimized\n");
+    return LVM_SEMANTIC_ERROR;
+  }
+  p->end = end;
+  p->ip = 0;
+
+  /* Conjunctions of comparisons between variables and constants
+     are evaluated without the interpreter. */
+  if(compile_fast_path(p, 0) != p->end) {
+    p->fast_path_length = 0;
+  }
+
+  PRINTF("Optimized code (%d fast comparisons): ", p->fast_path_length);
+  lvm_print_code(p);
+
+  return LVM_TRUE;
+}
+
 #if DEBUG
 static lvm_ip_t
 print_operator(lvm_instance_t *p, lvm_ip_t index)
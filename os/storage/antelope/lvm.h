@@ -40,6 +40,7 @@
 #ifndef LVM_H
 #define LVM_H
 
+#include <stdint.h>
 #include <stdlib.h>
 
 #include "db-options.h"
@@ -63,15 +64,6 @@ typedef enum lvm_status lvm_status_t;
 
 typedef int lvm_ip_t;
 
-struct lvm_instance {
-  unsigned char *code;
-  lvm_ip_t size;
-  lvm_ip_t end;
-  lvm_ip_t ip;
-  unsigned error;
-};
-typedef struct lvm_instance lvm_instance_t;
-
 enum node_type {
   LVM_ARITH_OP = 0x10,
   LVM_OPERAND = 0x20,
@@ -120,6 +112,28 @@ struct operand {
 };
 typedef struct operand operand_t;
 
+/*
+ * A comparison of a variable with a constant. Predicates that are
+ * conjunctions of such comparisons are compiled by lvm_optimize() into
+ * an array that is evaluated without interpreting the bytecode.
+ */
+struct lvm_fast_comparison {
+  long value;
+  operator_t op;
+  variable_id_t id;
+};
+
+struct lvm_instance {
+  unsigned char *code;
+  lvm_ip_t size;
+  lvm_ip_t end;
+  lvm_ip_t ip;
+  unsigned error;
+  struct lvm_fast_comparison fast_path[LVM_FAST_PATH_LENGTH];
+  uint8_t fast_path_length;
+};
+typedef struct lvm_instance lvm_instance_t;
+
 void lvm_reset(lvm_instance_t *p, unsigned char *code, lvm_ip_t size);
 void lvm_clone(lvm_instance_t *dst, lvm_instance_t *src);
 lvm_status_t lvm_derive(lvm_instance_t *p);
@@ -127,9 +141,13 @@ lvm_status_t lvm_get_derived_range(lvm_instance_t *p, char *name,
                                    operand_value_t *min,
                                    operand_value_t *max);
 void lvm_print_derivations(lvm_instance_t *p);
+lvm_status_t lvm_optimize(lvm_instance_t *p);
 lvm_status_t lvm_execute(lvm_instance_t *p);
 lvm_status_t lvm_register_variable(char *name, operand_type_t type);
 lvm_status_t lvm_set_variable_value(char *name, operand_value_t value);
+variable_id_t lvm_get_variable_id(char *name);
+lvm_status_t lvm_set_variable_value_by_id(variable_id_t id,
+                                          operand_value_t value);
 void lvm_print_code(lvm_instance_t *p);
 lvm_ip_t lvm_jump_to_operand(lvm_instance_t *p);
 lvm_ip_t lvm_shift_for_operator(lvm_instance_t *p, lvm_ip_t end);
@@ -64,6 +64,10 @@ struct source_dest_map {
   attribute_t *to_attr;
   unsigned from_offset;
   unsigned to_offset;
+  operand_value_t min;
+  operand_value_t max;
+  uint8_t constrained;
+  variable_id_t variable_id;
 };
 
 static struct source_dest_map attr_map[AQL_ATTRIBUTE_LIMIT];
@@ -79,6 +83,41 @@ struct source_map {
 };
 
 static struct source_map source_map[AQL_ATTRIBUTE_LIMIT];
+
+/*
+ * The join state keeps track of the progress of hash joins and merge
+ * joins between successive calls to relation_process_join().
+ */
+struct join_state {
+  tuple_id_t build_end;
+  tuple_id_t right_tuple;
+  tuple_id_t mark;
+  long left_key;
+  long mark_key;
+  unsigned probe_slot;
+  uint8_t flags;
+};
+
+#define JOIN_STATE_TABLE_BUILT	0x01
+#define JOIN_STATE_LEFT_LOADED	0x02
+#define JOIN_STATE_MARKED	0x04
+
+static struct join_state join_state;
+
+#if DB_JOIN_HASH_SIZE > 0
+/*
+ * The hash table is built over a partition of the right relation, and
+ * holds the join attribute value and the tuple ID of each row. Collisions
+ * are resolved by linear probing, and rows with identical values are
+ * stored in separate slots.
+ */
+struct join_hash_item {
+  long key;
+  tuple_id_t tuple_id;
+};
+
+static struct join_hash_item join_table[DB_JOIN_HASH_SIZE];
+#endif /* DB_JOIN_HASH_SIZE > 0 */
 #endif /* DB_FEATURE_JOIN */
 
 static unsigned char row[DB_MAX_ATTRIBUTES_PER_RELATION * DB_MAX_ELEMENT_SIZE];
@@ -88,6 +127,24 @@ static unsigned char * const left_row = row;
 static unsigned char * const right_row = extra_row;
 static unsigned char * const join_row = result_row;
 
+#if DB_SCAN_BUFFER_SIZE > 0
+/*
+ * The scan buffer holds a block of consecutive rows from the relation
+ * being scanned. The block is read with a single storage operation,
+ * and the rows are thereafter handed out one at a time by
+ * relation_process_select().
+ */
+static struct {
+  relation_t *rel;
+  tuple_id_t first_tuple;
+  unsigned row_count;
+  unsigned char rows[DB_SCAN_BUFFER_SIZE];
+} scan;
+#endif /* DB_SCAN_BUFFER_SIZE > 0 */
+
+/* Whether the attribute map contains ranges derived from the predicate. */
+static uint8_t use_pushdown;
+
 LIST(relations);
 MEMB(relations_memb, relation_t, DB_RELATION_POOL_SIZE);
 MEMB(attributes_memb, attribute_t, DB_ATTRIBUTE_POOL_SIZE);
@@ -671,11 +728,107 @@ select_index(db_handle_t *handle, lvm_instance_t *lvm_instance)
   }
 }
 
+static long
+get_predicate_value(attribute_t *attr, unsigned char *ptr)
+{
+  if(attr->domain == DOMAIN_INT) {
+    return ptr[0] << 8 | ptr[1];
+  }
+  return (uint32_t)ptr[0] << 24 | (uint32_t)ptr[1] << 16 |
+         (uint32_t)ptr[2] << 8 | ptr[3];
+}
+
+static void
+select_pushdown(lvm_instance_t *lvm_instance, unsigned attribute_count)
+{
+  struct source_dest_map *attr_map_ptr;
+  attribute_t *attr;
+
+  /*
+   * Store the ranges derived from the predicate in the attribute map, so
+   * that rows can be rejected by comparing their physical values against
+   * the ranges, before binding any LVM variables and executing the
+   * predicate. The derived ranges are always supersets of the values
+   * that satisfy the predicate, so a row within the ranges must still be
+   * evaluated by the LVM.
+   */
+  use_pushdown = 0;
+  for(attr_map_ptr = attr_map;
+      attr_map_ptr < attr_map + attribute_count;
+      attr_map_ptr++) {
+    attr = attr_map_ptr->to_attr;
+    attr_map_ptr->constrained = 0;
+    if(attr->domain != DOMAIN_INT && attr->domain != DOMAIN_LONG) {
+      continue;
+    }
+    if(!LVM_ERROR(lvm_get_derived_range(lvm_instance, attr->name,
+                                        &attr_map_ptr->min,
+                                        &attr_map_ptr->max))) {
+      PRINTF("DB: Push down the range (%ld,%ld) for attribute %s\n",
+             attr_map_ptr->min.l, attr_map_ptr->max.l, attr->name);
+      attr_map_ptr->constrained = 1;
+      use_pushdown = 1;
+    }
+  }
+}
+
+static int
+pushdown_accepts(unsigned char *row_ptr, struct source_dest_map *attr_map_end)
+{
+  struct source_dest_map *attr_map_ptr;
+  long value;
+
+  for(attr_map_ptr = attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
+    if(attr_map_ptr->constrained) {
+      value = get_predicate_value(attr_map_ptr->to_attr,
+                                  row_ptr + attr_map_ptr->from_offset);
+      if(value < attr_map_ptr->min.l || value > attr_map_ptr->max.l) {
+        return 0;
+      }
+    }
+  }
+
+  return 1;
+}
+
+static db_result_t
+get_scan_row(relation_t *rel, tuple_id_t tuple_id, unsigned char **row_ptr,
+             unsigned char *row_buf)
+{
+#if DB_SCAN_BUFFER_SIZE > 0
+  unsigned count;
+  db_result_t result;
+
+  count = rel->row_length > 0 ? DB_SCAN_BUFFER_SIZE / rel->row_length : 0;
+  if(count > 1) {
+    if(scan.rel != rel || tuple_id < scan.first_tuple ||
+       tuple_id >= scan.first_tuple + scan.row_count) {
+      /* The row is not in the buffer; read the next block of rows. */
+      result = storage_get_rows(rel, &tuple_id, scan.rows, &count);
+      if(result != DB_OK) {
+        scan.rel = NULL;
+        return result;
+      }
+      scan.rel = rel;
+      scan.first_tuple = tuple_id;
+      scan.row_count = count;
+    }
+
+    *row_ptr = scan.rows + (tuple_id - scan.first_tuple) * rel->row_length;
+    return DB_OK;
+  }
+#endif /* DB_SCAN_BUFFER_SIZE > 0 */
+
+  *row_ptr = row_buf;
+  return storage_get_row(rel, &tuple_id, row_buf);
+}
+
 static db_result_t
 generate_selection_result(db_handle_t *handle, relation_t *rel, aql_adt_t *adt)
 {
   relation_t *result_rel;
   unsigned attribute_count;
+  unsigned i;
   attribute_t *attr;
 
   result_rel = handle->result_rel;
@@ -696,10 +849,22 @@ generate_selection_result(db_handle_t *handle, relation_t *rel, aql_adt_t *adt)
     return DB_IMPLEMENTATION_ERROR;
   }
 
+#if DB_SCAN_BUFFER_SIZE > 0
+  scan.rel = NULL;
+#endif
+  use_pushdown = 0;
+
+  /* Resolve the predicate variables once instead of for every row. */
+  for(i = 0; i < attribute_count; i++) {
+    attr_map[i].variable_id = adt->lvm_instance == NULL ? LVM_MAX_VARIABLE_ID :
+      lvm_get_variable_id(attr_map[i].to_attr->name);
+  }
+
   if(adt->lvm_instance != NULL) {
     /* Try to establish acceptable ranges for the attribute values. */
     if(!LVM_ERROR(lvm_derive(adt->lvm_instance))) {
       select_index(handle, adt->lvm_instance);
+      select_pushdown(adt->lvm_instance, attribute_count);
     }
   }
 
@@ -746,6 +911,9 @@ relation_process_select(void *handle_ptr)
   uint8_t intbuf[2];
   attribute_value_t value;
   lvm_status_t wanted_result;
+  lvm_status_t predicate_result;
+  unsigned char *row_ptr;
+  int rejected;
 
   handle = (db_handle_t *)handle_ptr;
   adt = (aql_adt_t *)handle->adt;
@@ -770,8 +938,14 @@ relation_process_select(void *handle_ptr)
   }
 
   /* Put the tuples fulfilling the given condition into a new relation.
-     The tuples may be projected. */
-  result = storage_get_row(handle->rel, &handle->tuple_id, row);
+     The tuples may be projected. Full scans read the rows in blocks,
+     whereas index searches read only the rows that the index refers to. */
+  if(handle->flags & DB_HANDLE_FLAG_SEARCH_INDEX) {
+    row_ptr = row;
+    result = storage_get_row(handle->rel, &handle->tuple_id, row);
+  } else {
+    result = get_scan_row(handle->rel, handle->tuple_id, &row_ptr, row);
+  }
   handle->tuple_id++;
   if(DB_ERROR(result)) {
     PRINTF("DB: Failed to get a row in relation %s!\n", handle->rel->name);
@@ -783,21 +957,28 @@ relation_process_select(void *handle_ptr)
     return DB_FINISHED;
   }
 
+  wanted_result = LVM_TRUE;
+  if(AQL_GET_FLAGS(adt) & AQL_FLAG_INVERSE_LOGIC) {
+    wanted_result = LVM_FALSE;
+  }
+
+  /* Reject rows that are outside of the derived ranges directly. */
+  rejected = use_pushdown && !pushdown_accepts(row_ptr, attr_map_end);
+  if(rejected && wanted_result == LVM_TRUE) {
+    return DB_OK;
+  }
+
   /* Process the attributes in the result relation. */
   for(attr_map_ptr = attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
-    from_ptr = row + attr_map_ptr->from_offset;
+    from_ptr = row_ptr + attr_map_ptr->from_offset;
     result_attr = attr_map_ptr->to_attr;
 
     /* Update the internal state of the PLE. */
-    if(result_attr->domain == DOMAIN_INT) {
-      operand_value.l = from_ptr[0] << 8 | from_ptr[1];
-      lvm_set_variable_value(result_attr->name, operand_value);
-    } else if(result_attr->domain == DOMAIN_LONG) {
-      operand_value.l = (uint32_t)from_ptr[0] << 24 |
-                        (uint32_t)from_ptr[1] << 16 |
-                        (uint32_t)from_ptr[2] << 8 |
-                        from_ptr[3];
-      lvm_set_variable_value(result_attr->name, operand_value);
+    if(!rejected && attr_map_ptr->variable_id < LVM_MAX_VARIABLE_ID &&
+       (result_attr->domain == DOMAIN_INT ||
+        result_attr->domain == DOMAIN_LONG)) {
+      operand_value.l = get_predicate_value(result_attr, from_ptr);
+      lvm_set_variable_value_by_id(attr_map_ptr->variable_id, operand_value);
     }
 
     if(result_attr->flags & ATTRIBUTE_FLAG_NO_STORE) {
@@ -813,17 +994,19 @@ relation_process_select(void *handle_ptr)
     }
   }
 
-  wanted_result = LVM_TRUE;
-  if(AQL_GET_FLAGS(adt) & AQL_FLAG_INVERSE_LOGIC) {
-    wanted_result = LVM_FALSE;
+  /* Check whether the given predicate is true for this tuple. */
+  if(adt->lvm_instance == NULL) {
+    predicate_result = wanted_result;
+  } else if(rejected) {
+    predicate_result = LVM_FALSE;
+  } else {
+    predicate_result = lvm_execute(adt->lvm_instance);
   }
 
-  /* Check whether the given predicate is true for this tuple. */
-  if(adt->lvm_instance == NULL ||
-     lvm_execute(adt->lvm_instance) == wanted_result) {
+  if(predicate_result == wanted_result) {
     if(AQL_GET_FLAGS(adt) & AQL_FLAG_AGGREGATE) {
       for(attr_map_ptr = attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
-        from_ptr = row + attr_map_ptr->from_offset;
+        from_ptr = row_ptr + attr_map_ptr->from_offset;
         result = db_phy_to_value(&value, attr_map_ptr->to_attr, from_ptr);
         if(DB_ERROR(result)) {
 	  return result;
@@ -880,6 +1063,7 @@ relation_select(void *handle_ptr, relation_t *rel, void *adt_ptr)
   attribute_t *attr;
   int i;
   int normal_attributes;
+  int aggregated_attributes;
 
   adt = (aql_adt_t *)adt_ptr;
 
@@ -903,7 +1087,8 @@ relation_select(void *handle_ptr, relation_t *rel, void *adt_ptr)
     return DB_ALLOCATION_ERROR;
   }
 
-  for(i = normal_attributes = 0; i < AQL_ATTRIBUTE_COUNT(adt); i++) {
+  normal_attributes = aggregated_attributes = 0;
+  for(i = 0; i < AQL_ATTRIBUTE_COUNT(adt); i++) {
     attribute_name = adt->attributes[i].name;
 
     attr = relation_attribute_get(rel, attribute_name);
@@ -927,6 +1112,9 @@ relation_select(void *handle_ptr, relation_t *rel, void *adt_ptr)
     }
 
     attr->aggregator = adt->aggregators[i];
+    if(attr->aggregator != AQL_NONE) {
+      aggregated_attributes++;
+    }
     switch(attr->aggregator) {
     case AQL_NONE:
       if(!(adt->attributes[i].flags & ATTRIBUTE_FLAG_NO_STORE)) {
@@ -950,8 +1138,7 @@ relation_select(void *handle_ptr, relation_t *rel, void *adt_ptr)
 
   /* Preclude mixes of normal attributes and aggregated ones in 
      selection results. */
-  if(normal_attributes > 0 &&
-     handle->result_rel->attribute_count > normal_attributes) {
+  if(normal_attributes > 0 && aggregated_attributes > 0) {
      return DB_RELATIONAL_ERROR;
   }
 
@@ -959,6 +1146,243 @@ relation_select(void *handle_ptr, relation_t *rel, void *adt_ptr)
 }
 
 #if DB_FEATURE_JOIN
+static db_result_t
+get_join_key(relation_t *rel, attribute_t *attr, unsigned char *row_ptr,
+             long *key)
+{
+  attribute_value_t value;
+
+  if(DB_ERROR(relation_get_value(rel, attr, row_ptr, &value))) {
+    PRINTF("DB: Failed to get a value of the attribute \"%s\" to join on\n",
+           attr->name);
+    return DB_IMPLEMENTATION_ERROR;
+  }
+
+  *key = db_value_to_long(&value);
+  return DB_OK;
+}
+
+static db_result_t
+emit_join_row(db_handle_t *handle)
+{
+  relation_t *join_rel;
+  unsigned char *join_next_attribute_ptr;
+  size_t element_size;
+  int i;
+
+  join_rel = handle->join_rel;
+
+  /* Use the source attribute map to fill in the physical representation
+     of the resulting tuple. */
+  join_next_attribute_ptr = join_row;
+
+  for(i = 0; i < join_rel->attribute_count; i++) {
+    element_size = source_map[i].attr->element_size;
+
+    memcpy(join_next_attribute_ptr, source_map[i].from_ptr, element_size);
+    join_next_attribute_ptr += element_size;
+  }
+
+  if(((aql_adt_t *)handle->adt)->flags & AQL_FLAG_ASSIGN) {
+    if(DB_ERROR(storage_put_row(join_rel, join_row))) {
+      return DB_STORAGE_ERROR;
+    }
+  }
+
+  handle->current_row++;
+  return DB_GOT_ROW;
+}
+
+#if DB_JOIN_HASH_SIZE > 0
+static unsigned
+join_hash(long key)
+{
+  return (unsigned)(((unsigned long)key * 2654435761UL) % DB_JOIN_HASH_SIZE);
+}
+
+static db_result_t
+build_hash_table(db_handle_t *handle)
+{
+  unsigned char *row_ptr;
+  unsigned slot;
+  unsigned items;
+  long key;
+  db_result_t result;
+
+  for(slot = 0; slot < DB_JOIN_HASH_SIZE; slot++) {
+    join_table[slot].tuple_id = INVALID_TUPLE;
+  }
+
+  /* Insert the next partition of the right relation. */
+  for(items = 0; items < DB_JOIN_HASH_CAPACITY; items++) {
+    result = get_scan_row(handle->right_rel, join_state.build_end,
+                          &row_ptr, right_row);
+    if(result == DB_FINISHED) {
+      break;
+    } else if(DB_ERROR(result)) {
+      return result;
+    }
+
+    if(DB_ERROR(get_join_key(handle->right_rel, handle->right_join_attr,
+                             row_ptr, &key))) {
+      return DB_IMPLEMENTATION_ERROR;
+    }
+
+    for(slot = join_hash(key);
+        join_table[slot].tuple_id != INVALID_TUPLE;
+        slot = (slot + 1) % DB_JOIN_HASH_SIZE);
+    join_table[slot].key = key;
+    join_table[slot].tuple_id = join_state.build_end++;
+  }
+
+  PRINTF("DB: Built a hash table partition of %u rows\n", items);
+
+  return items > 0 ? DB_OK : DB_FINISHED;
+}
+
+static db_result_t
+process_hash_join(db_handle_t *handle)
+{
+  relation_t *left_rel;
+  unsigned char *row_ptr;
+  struct join_hash_item *item;
+  tuple_id_t right_tuple_id;
+  db_result_t result;
+
+  left_rel = handle->left_rel;
+
+  for(;;) {
+    if(!(join_state.flags & JOIN_STATE_TABLE_BUILT)) {
+      result = build_hash_table(handle);
+      if(result != DB_OK) {
+        return result;
+      }
+      join_state.flags |= JOIN_STATE_TABLE_BUILT;
+      handle->tuple_id = 0;
+    }
+
+    if(!(join_state.flags & JOIN_STATE_LEFT_LOADED)) {
+      result = get_scan_row(left_rel, handle->tuple_id, &row_ptr, left_row);
+      if(result == DB_FINISHED) {
+        /* The whole left relation has been matched against this
+           partition; continue with the next partition. */
+        join_state.flags &= ~JOIN_STATE_TABLE_BUILT;
+        continue;
+      } else if(DB_ERROR(result)) {
+        return result;
+      }
+
+      if(row_ptr != left_row) {
+        memcpy(left_row, row_ptr, left_rel->row_length);
+      }
+      if(DB_ERROR(get_join_key(left_rel, handle->left_join_attr, left_row,
+                               &join_state.left_key))) {
+        return DB_IMPLEMENTATION_ERROR;
+      }
+      join_state.probe_slot = join_hash(join_state.left_key);
+      join_state.flags |= JOIN_STATE_LEFT_LOADED;
+    }
+
+    /* Continue the probe sequence from where the last call stopped. */
+    for(;;) {
+      item = &join_table[join_state.probe_slot];
+      if(item->tuple_id == INVALID_TUPLE) {
+        break;
+      }
+      join_state.probe_slot = (join_state.probe_slot + 1) % DB_JOIN_HASH_SIZE;
+
+      if(item->key == join_state.left_key) {
+        right_tuple_id = item->tuple_id;
+        result = storage_get_row(handle->right_rel, &right_tuple_id, right_row);
+        if(result != DB_OK) {
+          PRINTF("DB: Failed to get row %lu in right relation %s!\n",
+                 (unsigned long)right_tuple_id, handle->right_rel->name);
+          return DB_ERROR(result) ? result : DB_IMPLEMENTATION_ERROR;
+        }
+        return emit_join_row(handle);
+      }
+    }
+
+    join_state.flags &= ~JOIN_STATE_LEFT_LOADED;
+    handle->tuple_id++;
+  }
+}
+#endif /* DB_JOIN_HASH_SIZE > 0 */
+
+static db_result_t
+process_merge_join(db_handle_t *handle)
+{
+  relation_t *left_rel;
+  relation_t *right_rel;
+  unsigned char *row_ptr;
+  long right_key;
+  db_result_t result;
+
+  left_rel = handle->left_rel;
+  right_rel = handle->right_rel;
+
+  /* Both relations are ordered on the join attribute, so they can be
+     merged by reading each of them sequentially. */
+  for(;;) {
+    if(!(join_state.flags & JOIN_STATE_LEFT_LOADED)) {
+      result = storage_get_row(left_rel, &handle->tuple_id, left_row);
+      if(result != DB_OK) {
+        return result;
+      }
+      if(DB_ERROR(get_join_key(left_rel, handle->left_join_attr, left_row,
+                               &join_state.left_key))) {
+        return DB_IMPLEMENTATION_ERROR;
+      }
+      if((join_state.flags & JOIN_STATE_MARKED) &&
+         join_state.left_key == join_state.mark_key) {
+        /* Match the duplicate left value against the same group
+           of right rows again. */
+        join_state.right_tuple = join_state.mark;
+      }
+      join_state.flags |= JOIN_STATE_LEFT_LOADED;
+    }
+
+    result = get_scan_row(right_rel, join_state.right_tuple, &row_ptr,
+                          right_row);
+    if(DB_ERROR(result)) {
+      return result;
+    } else if(result == DB_FINISHED) {
+      if(!(join_state.flags & JOIN_STATE_MARKED) ||
+         join_state.left_key != join_state.mark_key) {
+        /* No remaining left row can match any right row. */
+        return DB_FINISHED;
+      }
+    } else if(DB_ERROR(get_join_key(right_rel, handle->right_join_attr,
+                                    row_ptr, &right_key))) {
+      return DB_IMPLEMENTATION_ERROR;
+    }
+
+    if(result == DB_FINISHED || right_key > join_state.left_key) {
+      join_state.flags &= ~JOIN_STATE_LEFT_LOADED;
+      handle->tuple_id++;
+      continue;
+    }
+
+    if(right_key < join_state.left_key) {
+      join_state.right_tuple++;
+      continue;
+    }
+
+    if(!(join_state.flags & JOIN_STATE_MARKED) ||
+       join_state.mark_key != join_state.left_key) {
+      join_state.mark = join_state.right_tuple;
+      join_state.mark_key = join_state.left_key;
+      join_state.flags |= JOIN_STATE_MARKED;
+    }
+
+    if(row_ptr != right_row) {
+      memcpy(right_row, row_ptr, right_rel->row_length);
+    }
+    join_state.right_tuple++;
+    return emit_join_row(handle);
+  }
+}
+
 db_result_t
 relation_process_join(void *handle_ptr)
 {
@@ -966,17 +1390,21 @@ relation_process_join(void *handle_ptr)
   db_result_t result;
   relation_t *left_rel;
   relation_t *right_rel;
-  relation_t *join_rel;
-  unsigned char *join_next_attribute_ptr;
-  size_t element_size;
   tuple_id_t right_tuple_id;
   attribute_value_t value;
-  int i;
 
   handle = (db_handle_t *)handle_ptr;
   left_rel = handle->left_rel;
   right_rel = handle->right_rel;
-  join_rel = handle->join_rel;
+
+#if DB_JOIN_HASH_SIZE > 0
+  if(handle->flags & DB_HANDLE_FLAG_HASH_JOIN) {
+    return process_hash_join(handle);
+  }
+#endif /* DB_JOIN_HASH_SIZE > 0 */
+  if(handle->flags & DB_HANDLE_FLAG_MERGE_JOIN) {
+    return process_merge_join(handle);
+  }
 
   if(!(handle->flags & DB_HANDLE_FLAG_INDEX_STEP)) {
     goto inner_loop;
@@ -1030,25 +1458,7 @@ inner_loop:
         return DB_IMPLEMENTATION_ERROR;
       }
 
-      /* Use the source attribute map to fill in the physical representation
-	 of the resulting tuple. */
-      join_next_attribute_ptr = join_row;
-
-      for(i = 0; i < join_rel->attribute_count; i++) {
-	element_size = source_map[i].attr->element_size;
-
-	memcpy(join_next_attribute_ptr, source_map[i].from_ptr, element_size);
-	join_next_attribute_ptr += element_size;
-      }
-
-      if(((aql_adt_t *)handle->adt)->flags & AQL_FLAG_ASSIGN) {
-        if(DB_ERROR(storage_put_row(join_rel, join_row))) {
-          return DB_STORAGE_ERROR;
-        }
-      }
-
-      handle->current_row++;
-      return DB_GOT_ROW;
+      return emit_join_row(handle);
     }
   }
 
@@ -1102,6 +1512,11 @@ generate_join_result(db_handle_t *handle)
     source_pair->from_ptr = from_ptr;
   }
 
+  memset(&join_state, 0, sizeof(join_state));
+#if DB_SCAN_BUFFER_SIZE > 0
+  scan.rel = NULL;
+#endif
+
   handle->flags |= DB_HANDLE_FLAG_PROCESSING;
 
   return DB_OK;
@@ -1127,7 +1542,9 @@ relation_join(void *query_result, void *adt_ptr)
   handle->current_row = 0;
   handle->ncolumns = 0;
   handle->adt = adt;
-  handle->flags = DB_HANDLE_FLAG_INDEX_STEP;
+  /* Keep the join method selected by the query executor. */
+  handle->flags = (handle->flags & DB_HANDLE_JOIN_METHOD) |
+                  DB_HANDLE_FLAG_INDEX_STEP;
 
   if(AQL_GET_FLAGS(adt) & AQL_FLAG_ASSIGN) {
     name = adt->relations[0];
@@ -1158,7 +1575,8 @@ relation_join(void *query_result, void *adt_ptr)
     return DB_RELATIONAL_ERROR;
   }
 
-  if(!index_exists(handle->right_join_attr)) {
+  if(!(handle->flags & DB_HANDLE_JOIN_METHOD) &&
+     !index_exists(handle->right_join_attr)) {
     PRINTF("DB: The attribute to join on is not indexed\n");
     return DB_INDEX_ERROR;
   }
@@ -453,6 +453,55 @@ storage_get_row(relation_t *rel, tuple_id_t *tuple_id, storage_row_t row)
   return DB_OK;
 }
 
+db_result_t
+storage_get_rows(relation_t *rel, tuple_id_t *tuple_id,
+                 storage_row_t buffer, unsigned *count)
+{
+  unsigned length;
+  unsigned nread;
+  unsigned i;
+  int r;
+
+  if(rel->row_length == 0 || *count == 0) {
+    return DB_FINISHED;
+  }
+
+  if(cfs_seek(rel->tuple_storage, *tuple_id * rel->row_length, CFS_SEEK_SET) ==
+              (cfs_offset_t)-1) {
+    return DB_STORAGE_ERROR;
+  }
+
+  /* Read as many rows as possible with a single seek. The read will
+     end prematurely when reaching the last row of the relation. */
+  length = *count * rel->row_length;
+  for(nread = 0; nread < length; nread += r) {
+    r = cfs_read(rel->tuple_storage, buffer + nread, length - nread);
+    if(r < 0) {
+      PRINTF("DB: Reading failed on fd %d\n", rel->tuple_storage);
+      return DB_STORAGE_ERROR;
+    } else if(r == 0) {
+      break;
+    }
+  }
+
+  *count = nread / rel->row_length;
+  if(*count == 0) {
+    if(nread > 0) {
+      PRINTF("DB: Incomplete record: %u < %u\n", nread, rel->row_length);
+      return DB_STORAGE_ERROR;
+    }
+    return DB_FINISHED;
+  }
+
+  for(i = 1; i <= *count; i++) {
+    buffer[i * rel->row_length - 1] ^= ROW_XOR;
+  }
+
+  PRINTF("DB: Read %u rows from relation %s\n", *count, rel->name);
+
+  return DB_OK;
+}
+
 db_result_t
 storage_put_row(relation_t *rel, storage_row_t row)
 {
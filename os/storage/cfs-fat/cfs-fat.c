@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup cfs-fat
+ * @{
+ */
+
+/**
+ * \file
+ *         CFS implementation on top of FatFs.
+ */
+
+#include "cfs-fat.h"
+#include "ff.h"
+
+#include <string.h>
+
+static FATFS fs;
+static uint8_t mounted;
+static FIL files[CFS_FAT_MAX_OPEN_FILES];
+static DIR dirs[CFS_FAT_MAX_OPEN_DIRS];
+static uint8_t dirs_used[CFS_FAT_MAX_OPEN_DIRS];
+/*---------------------------------------------------------------------------*/
+static FIL *
+get_file(int fd)
+{
+  /* FatFs clears the file system pointer of closed file objects. */
+  if(fd < 0 || fd >= CFS_FAT_MAX_OPEN_FILES || files[fd].obj.fs == NULL) {
+    return NULL;
+  }
+  return &files[fd];
+}
+/*---------------------------------------------------------------------------*/
+int
+cfs_fat_mount(void)
+{
+  if(!mounted) {
+    if(f_mount(&fs, CFS_FAT_VOLUME, 1) != FR_OK) {
+      return -1;
+    }
+    mounted = 1;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+cfs_fat_unmount(void)
+{
+  int i;
+
+  for(i = 0; i < CFS_FAT_MAX_OPEN_FILES; i++) {
+    cfs_close(i);
+  }
+  memset(dirs_used, 0, sizeof(dirs_used));
+
+  if(mounted) {
+    f_mount(NULL, CFS_FAT_VOLUME, 0);
+    mounted = 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+cfs_fat_format(void)
+{
+#if _USE_MKFS && !_FS_READONLY
+  BYTE work[_MAX_SS];
+
+  cfs_fat_unmount();
+  if(f_mkfs(CFS_FAT_VOLUME, FM_ANY, 0, work, sizeof(work)) != FR_OK) {
+    return -1;
+  }
+  return cfs_fat_mount();
+#else
+  return -1;
+#endif
+}
+/*---------------------------------------------------------------------------*/
+int
+cfs_open(const char *name, int flags)
+{
+  BYTE mode;
+  int fd;
+
+  if(cfs_fat_mount() < 0) {
+    return -1;
+  }
+
+  for(fd = 0; fd < CFS_FAT_MAX_OPEN_FILES; fd++) {
+    if(files[fd].obj.fs == NULL) {
+      break;
+    }
+  }
+  if(fd == CFS_FAT_MAX_OPEN_FILES) {
+    return -1;
+  }
+
+  mode = 0;
+  if(flags & CFS_READ) {
+    mode |= FA_READ;
+  }
+  if(flags & CFS_WRITE) {
+    mode |= FA_WRITE;
+    mode |= (flags & CFS_APPEND) ? FA_OPEN_APPEND : FA_CREATE_ALWAYS;
+  }
+  if(mode == 0) {
+    return -1;
+  }
+
+  if(f_open(&files[fd], name, mode) != FR_OK) {
+    return -1;
+  }
+  return fd;
+}
+/*---------------------------------------------------------------------------*/
+void
+cfs_close(int fd)
+{
+  FIL *fp;
+
+  fp = get_file(fd);
+  if(fp != NULL) {
+    f_close(fp);
+    /* Release the descriptor even if the file could not be synchronized. */
+    fp->obj.fs = NULL;
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+cfs_read(int fd, void *buf, unsigned int len)
+{
+  FIL *fp;
+  UINT n;
+
+  fp = get_file(fd);
+  if(fp == NULL || f_read(fp, buf, len, &n) != FR_OK) {
+    return -1;
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+int
+cfs_write(int fd, const void *buf, unsigned int len)
+{
+  FIL *fp;
+  UINT n;
+
+  fp = get_file(fd);
+  if(fp == NULL || f_write(fp, buf, len, &n) != FR_OK) {
+    return -1;
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+cfs_offset_t
+cfs_seek(int fd, cfs_offset_t offset, int whence)
+{
+  FIL *fp;
+  FSIZE_t base;
+
+  fp = get_file(fd);
+  if(fp == NULL) {
+    return (cfs_offset_t)-1;
+  }
+
+  switch(whence) {
+  case CFS_SEEK_SET:
+    base = 0;
+    break;
+  case CFS_SEEK_CUR:
+    base = f_tell(fp);
+    break;
+  case CFS_SEEK_END:
+    base = f_size(fp);
+    break;
+  default:
+    return (cfs_offset_t)-1;
+  }
+
+  if(offset < 0 && (FSIZE_t)-offset > base) {
+    return (cfs_offset_t)-1;
+  }
+
+  /* A file that is open for writing is extended when seeking beyond
+     its end. */
+  if(f_lseek(fp, base + offset) != FR_OK) {
+    return (cfs_offset_t)-1;
+  }
+  return (cfs_offset_t)f_tell(fp);
+}
+/*---------------------------------------------------------------------------*/
+int
+cfs_remove(const char *name)
+{
+  if(cfs_fat_mount() < 0 || f_unlink(name) != FR_OK) {
+    return -1;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+cfs_opendir(struct cfs_dir *dirp, const char *name)
+{
+  int i;
+
+  if(cfs_fat_mount() < 0) {
+    return -1;
+  }
+
+  for(i = 0; i < CFS_FAT_MAX_OPEN_DIRS; i++) {
+    if(!dirs_used[i]) {
+      break;
+    }
+  }
+  if(i == CFS_FAT_MAX_OPEN_DIRS) {
+    return -1;
+  }
+
+  /* The CFS directory "/" is the root directory of the volume. */
+  if(f_opendir(&dirs[i], name) != FR_OK) {
+    return -1;
+  }
+  dirs_used[i] = 1;
+  dirp->state[0] = i;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+cfs_readdir(struct cfs_dir *dirp, struct cfs_dirent *dirent)
+{
+  FILINFO info;
+  int i;
+
+  i = dirp->state[0];
+  if(i < 0 || i >= CFS_FAT_MAX_OPEN_DIRS || !dirs_used[i]) {
+    return -1;
+  }
+
+  if(f_readdir(&dirs[i], &info) != FR_OK || info.fname[0] == '\0') {
+    return -1;
+  }
+
+  strncpy(dirent->name, info.fname, sizeof(dirent->name) - 1);
+  dirent->name[sizeof(dirent->name) - 1] = '\0';
+  dirent->size = info.fsize;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+cfs_closedir(struct cfs_dir *dirp)
+{
+  int i;
+
+  i = dirp->state[0];
+  if(i >= 0 && i < CFS_FAT_MAX_OPEN_DIRS && dirs_used[i]) {
+    f_closedir(&dirs[i]);
+    dirs_used[i] = 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
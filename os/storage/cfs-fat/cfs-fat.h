@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup cfs
+ * @{
+ */
+
+/**
+ * \defgroup cfs-fat CFS on top of FatFs
+ *
+ * The cfs-fat module implements the Contiki file system interface on
+ * top of the FatFs module, so that applications and Antelope can store
+ * files on FAT-formatted storage such as SD cards. The module replaces
+ * Coffee or cfs-posix, and is used on the native platform by building
+ * with MAKE_CFS = MAKE_CFS_FAT, which stores the volume in a disk image
+ * file.
+ *
+ * The FatFs disk I/O layer is provided by a sector cache on top of a
+ * disk driver; see disk-cache.h.
+ *
+ * The volume is mounted when a file or a directory is opened for the
+ * first time. As with cfs-posix, opening a file for writing without
+ * CFS_APPEND truncates it.
+ *
+ * @{
+ */
+
+/**
+ * \file
+ *         Header file for the CFS implementation on top of FatFs.
+ */
+
+#ifndef CFS_FAT_H_
+#define CFS_FAT_H_
+
+#include "contiki.h"
+#include "cfs/cfs.h"
+
+/** The maximum number of files that can be open at the same time. */
+#ifdef CFS_FAT_CONF_MAX_OPEN_FILES
+#define CFS_FAT_MAX_OPEN_FILES CFS_FAT_CONF_MAX_OPEN_FILES
+#else
+#define CFS_FAT_MAX_OPEN_FILES 4
+#endif
+
+/** The maximum number of directories that can be open at the same time. */
+#ifdef CFS_FAT_CONF_MAX_OPEN_DIRS
+#define CFS_FAT_MAX_OPEN_DIRS CFS_FAT_CONF_MAX_OPEN_DIRS
+#else
+#define CFS_FAT_MAX_OPEN_DIRS 1
+#endif
+
+/** The logical drive that holds the files, in FatFs path syntax. */
+#ifdef CFS_FAT_CONF_VOLUME
+#define CFS_FAT_VOLUME CFS_FAT_CONF_VOLUME
+#else
+#define CFS_FAT_VOLUME ""
+#endif
+
+/**
+ * \brief      Mount the volume.
+ * \return     0 on success, or -1 if the volume does not contain a
+ *             valid FAT file system or the disk could not be accessed.
+ *
+ *             The volume is otherwise mounted on first use.
+ */
+int cfs_fat_mount(void);
+
+/**
+ * \brief      Close all files and unmount the volume.
+ */
+void cfs_fat_unmount(void);
+
+/**
+ * \brief      Create a FAT file system on the disk.
+ * \return     0 on success, or -1 on failure.
+ *
+ *             All open files are closed, and all data on the disk
+ *             is lost. The volume is mounted after being formatted.
+ */
+int cfs_fat_format(void);
+
+#endif /* CFS_FAT_H_ */
+
+/** @} */
+/** @} */
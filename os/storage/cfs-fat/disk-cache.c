@@ -0,0 +1,510 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup cfs-fat
+ * @{
+ */
+
+/**
+ * \file
+ *         A sector cache between FatFs and a disk driver.
+ */
+
+#include "disk-cache.h"
+#include "ff.h"
+#include "diskio.h"
+#include "lib/list.h"
+
+#include <string.h>
+
+#define SECTOR_SIZE _MAX_SS
+
+#if _MIN_SS != _MAX_SS
+#error The sector cache requires a fixed sector size.
+#endif
+
+extern const struct disk_driver DISK_CACHE_DRIVER;
+
+static struct disk_cache_stats stats;
+
+#if DISK_CACHE_LINES > 0
+struct cache_line {
+  struct cache_line *next;
+  /* The first sector of the line, which is a multiple of the line size. */
+  uint32_t first;
+  /* Bitmaps of the sectors that are cached and that must be written back. */
+  uint32_t valid;
+  uint32_t dirty;
+  uint8_t drive;
+  uint8_t data[DISK_CACHE_LINE_SECTORS][SECTOR_SIZE];
+};
+
+static struct cache_line lines[DISK_CACHE_LINES];
+
+/* The lines in order of use, with the least recently used one last. */
+LIST(lru);
+
+/* The sector following the last one that was read, which is used
+   to detect sequential reads. */
+static uint32_t next_sector;
+static uint8_t next_drive;
+
+/* The number of sectors of each drive, or 0 if it is unknown. */
+static uint32_t sector_count[_VOLUMES];
+#endif /* DISK_CACHE_LINES > 0 */
+/*---------------------------------------------------------------------------*/
+static DRESULT
+convert_result(disk_result_t result)
+{
+  switch(result) {
+  default:
+  case DISK_RESULT_NO_INIT:
+  case DISK_RESULT_IO_ERROR: return RES_ERROR;
+  case DISK_RESULT_OK: return RES_OK;
+  case DISK_RESULT_WR_PROTECTED: return RES_WRPRT;
+  case DISK_RESULT_INVALID_ARG: return RES_PARERR;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static disk_result_t
+read_sectors(uint8_t drive, void *buf, uint32_t sector, uint32_t count)
+{
+  stats.disk_reads++;
+  stats.sectors_read += count;
+  return DISK_CACHE_DRIVER.read(drive, buf, sector, count);
+}
+/*---------------------------------------------------------------------------*/
+static disk_result_t
+write_sectors(uint8_t drive, const void *buf, uint32_t sector, uint32_t count)
+{
+  stats.disk_writes++;
+  stats.sectors_written += count;
+  return DISK_CACHE_DRIVER.write(drive, buf, sector, count);
+}
+/*---------------------------------------------------------------------------*/
+#if DISK_CACHE_LINES > 0
+/* Get a bitmap of the sectors from index "from" up to, but not
+   including, index "to" of a line. */
+static uint32_t
+range_mask(unsigned from, unsigned to)
+{
+  return (to >= 32 ? 0 : (uint32_t)1 << to) - ((uint32_t)1 << from);
+}
+/*---------------------------------------------------------------------------*/
+static struct cache_line *
+find_line(uint8_t drive, uint32_t first)
+{
+  struct cache_line *line;
+
+  for(line = list_head(lru); line != NULL; line = list_item_next(line)) {
+    if(line->valid != 0 && line->drive == drive && line->first == first) {
+      return line;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+touch_line(struct cache_line *line)
+{
+  list_remove(lru, line);
+  list_push(lru, line);
+}
+/*---------------------------------------------------------------------------*/
+static disk_result_t
+write_back_line(struct cache_line *line)
+{
+  disk_result_t result;
+  unsigned from;
+  unsigned to;
+
+  for(from = 0; line->dirty != 0; from = to) {
+    while(!(line->dirty & ((uint32_t)1 << from))) {
+      from++;
+    }
+    for(to = from + 1;
+        to < DISK_CACHE_LINE_SECTORS && (line->dirty & ((uint32_t)1 << to));
+        to++);
+
+    result = write_sectors(line->drive, line->data[from],
+                           line->first + from, to - from);
+    if(result != DISK_RESULT_OK) {
+      return result;
+    }
+    line->dirty &= ~range_mask(from, to);
+  }
+  return DISK_RESULT_OK;
+}
+/*---------------------------------------------------------------------------*/
+static disk_result_t
+write_back_drive(uint8_t drive)
+{
+  struct cache_line *line;
+  disk_result_t result;
+
+  for(line = list_head(lru); line != NULL; line = list_item_next(line)) {
+    if(line->dirty != 0 && line->drive == drive) {
+      result = write_back_line(line);
+      if(result != DISK_RESULT_OK) {
+        return result;
+      }
+    }
+  }
+  return DISK_RESULT_OK;
+}
+/*---------------------------------------------------------------------------*/
+static struct cache_line *
+allocate_line(uint8_t drive, uint32_t first)
+{
+  struct cache_line *line;
+
+  line = list_tail(lru);
+  if(line == NULL ||
+     (line->dirty != 0 && write_back_line(line) != DISK_RESULT_OK)) {
+    return NULL;
+  }
+
+  line->first = first;
+  line->drive = drive;
+  line->valid = 0;
+  touch_line(line);
+  return line;
+}
+/*---------------------------------------------------------------------------*/
+/* Read the sectors that are not cached in a range of a line. Runs of
+   consecutive sectors are read with a single request to the disk. */
+static disk_result_t
+fill_line(struct cache_line *line, unsigned from, unsigned to)
+{
+  disk_result_t result;
+  unsigned end;
+
+  for(; from < to; from = end) {
+    if(line->valid & ((uint32_t)1 << from)) {
+      end = from + 1;
+      continue;
+    }
+    for(end = from + 1; end < to && !(line->valid & ((uint32_t)1 << end));
+        end++);
+
+    result = read_sectors(line->drive, line->data[from],
+                          line->first + from, end - from);
+    if(result != DISK_RESULT_OK) {
+      return result;
+    }
+    line->valid |= range_mask(from, end);
+  }
+  return DISK_RESULT_OK;
+}
+/*---------------------------------------------------------------------------*/
+static disk_result_t
+read_cached(uint8_t drive, uint8_t *buf, uint32_t sector)
+{
+  struct cache_line *line;
+  disk_result_t result;
+  uint32_t first;
+  unsigned index;
+  unsigned end;
+
+  index = sector % DISK_CACHE_LINE_SECTORS;
+  first = sector - index;
+
+  line = find_line(drive, first);
+  if(line != NULL && (line->valid & ((uint32_t)1 << index))) {
+    stats.hits++;
+  } else {
+    stats.misses++;
+    if(line == NULL) {
+      line = allocate_line(drive, first);
+      if(line == NULL) {
+        return DISK_RESULT_IO_ERROR;
+      }
+    }
+
+    end = index + 1;
+    if(drive == next_drive && sector == next_sector) {
+      /* Read ahead to the end of the line. */
+      end = DISK_CACHE_LINE_SECTORS;
+      if(drive < _VOLUMES && sector_count[drive] > first &&
+         sector_count[drive] - first < end) {
+        end = sector_count[drive] - first;
+      }
+    }
+
+    result = fill_line(line, index, end);
+    if(result != DISK_RESULT_OK) {
+      return result;
+    }
+  }
+
+  touch_line(line);
+  memcpy(buf, line->data[index], SECTOR_SIZE);
+  next_sector = sector + 1;
+  next_drive = drive;
+  return DISK_RESULT_OK;
+}
+/*---------------------------------------------------------------------------*/
+static disk_result_t
+write_cached(uint8_t drive, const uint8_t *buf, uint32_t sector)
+{
+  struct cache_line *line;
+  uint32_t first;
+  unsigned index;
+
+  index = sector % DISK_CACHE_LINE_SECTORS;
+  first = sector - index;
+
+  line = find_line(drive, first);
+  if(line == NULL) {
+    line = allocate_line(drive, first);
+    if(line == NULL) {
+      return DISK_RESULT_IO_ERROR;
+    }
+  } else {
+    touch_line(line);
+  }
+
+  memcpy(line->data[index], buf, SECTOR_SIZE);
+  line->valid |= (uint32_t)1 << index;
+  line->dirty |= (uint32_t)1 << index;
+  return DISK_RESULT_OK;
+}
+/*---------------------------------------------------------------------------*/
+/* Copy between a buffer of consecutive sectors and the cached sectors
+   that overlap with it. When "to_cache" is set, the cached copies
+   are updated and marked clean; otherwise, the cached copies, which
+   may be newer than the disk, are copied to the buffer. */
+static void
+copy_overlap(uint8_t drive, uint8_t *buf, uint32_t sector, uint32_t count,
+             int to_cache)
+{
+  struct cache_line *line;
+  uint32_t s;
+  uint32_t end;
+  unsigned index;
+
+  for(line = list_head(lru); line != NULL; line = list_item_next(line)) {
+    if(line->valid == 0 || line->drive != drive ||
+       line->first + DISK_CACHE_LINE_SECTORS <= sector ||
+       line->first >= sector + count) {
+      continue;
+    }
+
+    s = line->first > sector ? line->first : sector;
+    end = line->first + DISK_CACHE_LINE_SECTORS;
+    if(end > sector + count) {
+      end = sector + count;
+    }
+    for(; s < end; s++) {
+      index = s - line->first;
+      if(!(line->valid & ((uint32_t)1 << index))) {
+        continue;
+      }
+      if(to_cache) {
+        memcpy(line->data[index], buf + (s - sector) * SECTOR_SIZE,
+               SECTOR_SIZE);
+        line->dirty &= ~((uint32_t)1 << index);
+      } else {
+        memcpy(buf + (s - sector) * SECTOR_SIZE, line->data[index],
+               SECTOR_SIZE);
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+invalidate_range(uint8_t drive, uint32_t sector, uint32_t count)
+{
+  struct cache_line *line;
+  uint32_t from;
+  uint32_t to;
+
+  for(line = list_head(lru); line != NULL; line = list_item_next(line)) {
+    if(line->valid == 0 || line->drive != drive ||
+       line->first + DISK_CACHE_LINE_SECTORS <= sector ||
+       line->first >= sector + count) {
+      continue;
+    }
+    from = line->first > sector ? 0 : sector - line->first;
+    to = sector + count - line->first;
+    if(to > DISK_CACHE_LINE_SECTORS) {
+      to = DISK_CACHE_LINE_SECTORS;
+    }
+    line->valid &= ~range_mask(from, to);
+    line->dirty &= ~range_mask(from, to);
+  }
+}
+#endif /* DISK_CACHE_LINES > 0 */
+/*---------------------------------------------------------------------------*/
+DSTATUS
+disk_status(BYTE pdrv)
+{
+  return ~DISK_CACHE_DRIVER.status(pdrv) &
+    (STA_NOINIT | STA_NODISK | STA_PROTECT);
+}
+/*---------------------------------------------------------------------------*/
+DSTATUS
+disk_initialize(BYTE pdrv)
+{
+  disk_status_t status;
+#if DISK_CACHE_LINES > 0
+  static uint8_t initialized;
+  struct cache_line *line;
+  uint32_t count;
+  int i;
+
+  if(!initialized) {
+    list_init(lru);
+    for(i = 0; i < DISK_CACHE_LINES; i++) {
+      list_add(lru, &lines[i]);
+    }
+    initialized = 1;
+  }
+
+  /* The medium may have been replaced, so the cached sectors of the
+     drive are dropped after having been written back. */
+  write_back_drive(pdrv);
+  for(line = list_head(lru); line != NULL; line = list_item_next(line)) {
+    if(line->drive == pdrv) {
+      line->valid = 0;
+      line->dirty = 0;
+    }
+  }
+#endif /* DISK_CACHE_LINES > 0 */
+
+  status = DISK_CACHE_DRIVER.initialize(pdrv);
+
+#if DISK_CACHE_LINES > 0
+  if(pdrv < _VOLUMES) {
+    if(!(status & DISK_STATUS_INIT) ||
+       DISK_CACHE_DRIVER.ioctl(pdrv, DISK_IOCTL_GET_SECTOR_COUNT,
+                               &count) != DISK_RESULT_OK) {
+      count = 0;
+    }
+    sector_count[pdrv] = count;
+  }
+#endif /* DISK_CACHE_LINES > 0 */
+
+  return ~status & (STA_NOINIT | STA_NODISK | STA_PROTECT);
+}
+/*---------------------------------------------------------------------------*/
+DRESULT
+disk_read(BYTE pdrv, BYTE *buff, DWORD sector, UINT count)
+{
+  disk_result_t result;
+
+#if DISK_CACHE_LINES > 0
+  if(count == 1) {
+    return convert_result(read_cached(pdrv, buff, sector));
+  }
+#endif /* DISK_CACHE_LINES > 0 */
+
+  result = read_sectors(pdrv, buff, sector, count);
+
+#if DISK_CACHE_LINES > 0
+  if(result == DISK_RESULT_OK) {
+    copy_overlap(pdrv, buff, sector, count, 0);
+    next_sector = sector + count;
+    next_drive = pdrv;
+  }
+#endif /* DISK_CACHE_LINES > 0 */
+
+  return convert_result(result);
+}
+/*---------------------------------------------------------------------------*/
+DRESULT
+disk_write(BYTE pdrv, const BYTE *buff, DWORD sector, UINT count)
+{
+  disk_result_t result;
+
+#if DISK_CACHE_LINES > 0
+  if(count == 1) {
+    return convert_result(write_cached(pdrv, buff, sector));
+  }
+#endif /* DISK_CACHE_LINES > 0 */
+
+  result = write_sectors(pdrv, buff, sector, count);
+
+#if DISK_CACHE_LINES > 0
+  if(result == DISK_RESULT_OK) {
+    copy_overlap(pdrv, (uint8_t *)buff, sector, count, 1);
+  } else {
+    invalidate_range(pdrv, sector, count);
+  }
+#endif /* DISK_CACHE_LINES > 0 */
+
+  return convert_result(result);
+}
+/*---------------------------------------------------------------------------*/
+DRESULT
+disk_ioctl(BYTE pdrv, BYTE cmd, void *buff)
+{
+#if DISK_CACHE_LINES > 0
+  disk_result_t result;
+
+  if(cmd == CTRL_SYNC) {
+    result = write_back_drive(pdrv);
+    if(result != DISK_RESULT_OK) {
+      return convert_result(result);
+    }
+  }
+#endif /* DISK_CACHE_LINES > 0 */
+
+  return convert_result(DISK_CACHE_DRIVER.ioctl(pdrv, cmd, buff));
+}
+/*---------------------------------------------------------------------------*/
+int
+disk_cache_flush(void)
+{
+#if DISK_CACHE_LINES > 0
+  struct cache_line *line;
+
+  for(line = list_head(lru); line != NULL; line = list_item_next(line)) {
+    if(line->dirty != 0 && write_back_line(line) != DISK_RESULT_OK) {
+      return -1;
+    }
+  }
+#endif /* DISK_CACHE_LINES > 0 */
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+disk_cache_get_stats(struct disk_cache_stats *s)
+{
+  memcpy(s, &stats, sizeof(stats));
+}
+/*---------------------------------------------------------------------------*/
+void
+disk_cache_reset_stats(void)
+{
+  memset(&stats, 0, sizeof(stats));
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup cfs-fat
+ * @{
+ */
+
+/**
+ * \file
+ *         Header file for the sector cache between FatFs and a disk driver.
+ *
+ *         The cache implements the FatFs disk I/O functions declared in
+ *         diskio.h on top of a disk driver, and replaces the default
+ *         port of the platform. Sectors are grouped in lines of
+ *         consecutive sectors, aligned to the line size. Lines are
+ *         replaced in least recently used order.
+ *
+ *         A single-sector read that continues the previous read fills
+ *         the rest of its line with one multi-sector read of the disk.
+ *         Written sectors are kept in the cache, and the dirty sectors
+ *         of a line are written back in runs of consecutive sectors
+ *         when the line is replaced or when FatFs synchronizes the
+ *         disk. Multi-sector transfers, which FatFs uses for whole
+ *         sectors of file data, bypass the cache.
+ */
+
+#ifndef DISK_CACHE_H_
+#define DISK_CACHE_H_
+
+#include "contiki.h"
+#include "dev/storage/disk/disk.h"
+
+#include <stdint.h>
+
+/** The number of cache lines. Set to 0 to disable the cache. */
+#ifdef DISK_CACHE_CONF_LINES
+#define DISK_CACHE_LINES DISK_CACHE_CONF_LINES
+#else
+#define DISK_CACHE_LINES 4
+#endif
+
+/** The number of sectors in a cache line, at most 32. */
+#ifdef DISK_CACHE_CONF_LINE_SECTORS
+#define DISK_CACHE_LINE_SECTORS DISK_CACHE_CONF_LINE_SECTORS
+#else
+#define DISK_CACHE_LINE_SECTORS 4
+#endif
+
+/** The disk driver below the cache. */
+#ifdef DISK_CACHE_CONF_DRIVER
+#define DISK_CACHE_DRIVER DISK_CACHE_CONF_DRIVER
+#else
+#define DISK_CACHE_DRIVER mmc_driver
+#endif
+
+#if DISK_CACHE_LINE_SECTORS < 1 || DISK_CACHE_LINE_SECTORS > 32
+#error DISK_CACHE_LINE_SECTORS must be between 1 and 32.
+#endif
+
+/** Counters of the accesses to the cache and to the disk. */
+struct disk_cache_stats {
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t disk_reads;
+  uint32_t disk_writes;
+  uint32_t sectors_read;
+  uint32_t sectors_written;
+};
+
+/**
+ * \brief      Write all dirty sectors to the disk.
+ * \return     0 on success, or -1 if a sector could not be written.
+ */
+int disk_cache_flush(void);
+
+/**
+ * \brief       Get the access counters of the cache.
+ * \param stats A pointer to where the counters are copied.
+ */
+void disk_cache_get_stats(struct disk_cache_stats *stats);
+
+/**
+ * \brief      Reset the access counters of the cache.
+ */
+void disk_cache_reset_stats(void);
+
+#endif /* DISK_CACHE_H_ */
+
+/** @} */
@@ -0,0 +1,538 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup tsdb
+ * @{
+ */
+
+/**
+ * \file
+ *         Time-series storage with compressed blocks on top of CFS.
+ */
+
+#include "contiki.h"
+#include "cfs/cfs.h"
+#if TSDB_COFFEE_RESERVE_SIZE > 0
+#include "cfs/cfs-coffee.h"
+#endif
+#include "tsdb.h"
+
+#include <string.h>
+
+/* Log configuration */
+#include "sys/log.h"
+#define LOG_MODULE "TSDB"
+#define LOG_LEVEL LOG_LEVEL_NONE
+
+/*
+ * The file of a series is a sequence of blocks of TSDB_BLOCK_SIZE
+ * bytes. The file is only ever appended to, which suits both flash
+ * file systems and cfs-posix, where files opened for appending cannot
+ * be modified in place.
+ *
+ * A block starts with a header that holds the first sample and a
+ * summary of the block. The remaining samples follow as a bit stream.
+ * For each sample, the stream contains the difference between its time
+ * delta and the previous time delta, followed by the difference between
+ * its value and the previous value. A difference is zigzag-encoded and
+ * written with a unary prefix that selects the number of bits used:
+ *
+ *   0          The difference is zero.
+ *   10   + 7   bits
+ *   110  + 12  bits
+ *   1110 + 20  bits
+ *   1111 + 32  bits holding the time delta or the value itself.
+ */
+#define HEADER_SIZE       sizeof(struct tsdb_block_header)
+#define PAYLOAD_BITS      ((TSDB_BLOCK_SIZE - HEADER_SIZE) * 8)
+
+#define CODE_BUCKETS      4
+#define RAW_BITS          32
+
+static const uint8_t bucket_bits[CODE_BUCKETS] = { 0, 7, 12, 20 };
+/*---------------------------------------------------------------------------*/
+static uint64_t
+zigzag_encode(int64_t diff)
+{
+  return ((uint64_t)diff << 1) ^ (uint64_t)(diff >> 63);
+}
+/*---------------------------------------------------------------------------*/
+static int64_t
+zigzag_decode(uint64_t zigzag)
+{
+  return (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+}
+/*---------------------------------------------------------------------------*/
+static unsigned
+code_bucket(uint64_t zigzag)
+{
+  unsigned i;
+
+  for(i = 0; i < CODE_BUCKETS; i++) {
+    if(zigzag < ((uint64_t)1 << bucket_bits[i])) {
+      break;
+    }
+  }
+  return i;
+}
+/*---------------------------------------------------------------------------*/
+static unsigned
+code_length(uint64_t zigzag)
+{
+  unsigned bucket;
+
+  bucket = code_bucket(zigzag);
+  if(bucket == CODE_BUCKETS) {
+    return CODE_BUCKETS + RAW_BITS;
+  }
+  return bucket + 1 + bucket_bits[bucket];
+}
+/*---------------------------------------------------------------------------*/
+static void
+write_bits(uint8_t *payload, uint16_t *bit, uint32_t value, unsigned count)
+{
+  unsigned free_bits;
+  unsigned n;
+
+  while(count > 0) {
+    free_bits = 8 - (*bit & 7);
+    n = count < free_bits ? count : free_bits;
+    count -= n;
+    payload[*bit >> 3] |= ((value >> count) & ((1U << n) - 1)) <<
+      (free_bits - n);
+    *bit += n;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+read_bits(const uint8_t *payload, uint16_t *bit, unsigned count)
+{
+  uint32_t value;
+  unsigned available;
+  unsigned n;
+
+  if(*bit + count > PAYLOAD_BITS) {
+    /* Mark the cursor as being past the end of a corrupt block. */
+    *bit = PAYLOAD_BITS + 1;
+    return 0;
+  }
+
+  for(value = 0; count > 0; count -= n) {
+    available = 8 - (*bit & 7);
+    n = count < available ? count : available;
+    value = (value << n) |
+      ((payload[*bit >> 3] >> (available - n)) & ((1U << n) - 1));
+    *bit += n;
+  }
+  return value;
+}
+/*---------------------------------------------------------------------------*/
+static void
+write_code(uint8_t *payload, uint16_t *bit, uint64_t zigzag, uint32_t raw)
+{
+  unsigned bucket;
+
+  bucket = code_bucket(zigzag);
+  if(bucket == CODE_BUCKETS) {
+    write_bits(payload, bit, (1U << CODE_BUCKETS) - 1, CODE_BUCKETS);
+    write_bits(payload, bit, raw, RAW_BITS);
+  } else {
+    write_bits(payload, bit, ((1U << bucket) - 1) << 1, bucket + 1);
+    write_bits(payload, bit, (uint32_t)zigzag, bucket_bits[bucket]);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Read a code from the payload. Returns 1 if the code holds a
+ * difference, and 0 if it holds a raw value.
+ */
+static int
+read_code(const uint8_t *payload, uint16_t *bit, int64_t *diff, uint32_t *raw)
+{
+  unsigned bucket;
+
+  for(bucket = 0; bucket < CODE_BUCKETS; bucket++) {
+    if(read_bits(payload, bit, 1) == 0) {
+      *diff = zigzag_decode(read_bits(payload, bit, bucket_bits[bucket]));
+      return 1;
+    }
+  }
+
+  *raw = read_bits(payload, bit, RAW_BITS);
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+get_header(const uint8_t *block, struct tsdb_block_header *header)
+{
+  memcpy(header, block, sizeof(*header));
+}
+/*---------------------------------------------------------------------------*/
+static void
+put_header(uint8_t *block, const struct tsdb_block_header *header)
+{
+  memcpy(block, header, sizeof(*header));
+}
+/*---------------------------------------------------------------------------*/
+static int
+read_block(tsdb_t *db, uint32_t block_no, void *buf, unsigned len)
+{
+  cfs_offset_t offset;
+
+  offset = (cfs_offset_t)block_no * TSDB_BLOCK_SIZE;
+  if(cfs_seek(db->fd, offset, CFS_SEEK_SET) != offset ||
+     cfs_read(db->fd, buf, len) != len) {
+    LOG_ERR("failed to read block %lu\n", (unsigned long)block_no);
+    return -1;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+write_block(tsdb_t *db)
+{
+  cfs_offset_t offset;
+
+  offset = (cfs_offset_t)db->blocks * TSDB_BLOCK_SIZE;
+  if(cfs_seek(db->fd, offset, CFS_SEEK_SET) != offset ||
+     cfs_write(db->fd, db->block, TSDB_BLOCK_SIZE) != TSDB_BLOCK_SIZE) {
+    LOG_ERR("failed to write block %lu\n", (unsigned long)db->blocks);
+    return -1;
+  }
+
+  db->blocks++;
+  db->dirty = 0;
+  memset(db->block, 0, sizeof(db->block));
+  db->cursor.bit = 0;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsdb_open(tsdb_t *db, const char *name)
+{
+  struct tsdb_block_header header;
+  cfs_offset_t size;
+  unsigned padding;
+
+  memset(db, 0, sizeof(*db));
+
+#if TSDB_COFFEE_RESERVE_SIZE > 0
+  /* Fails harmlessly if the file exists already. */
+  cfs_coffee_reserve(name, TSDB_COFFEE_RESERVE_SIZE);
+#endif
+
+  db->fd = cfs_open(name, CFS_READ | CFS_WRITE | CFS_APPEND);
+  if(db->fd < 0) {
+    LOG_ERR("failed to open %s\n", name);
+    return -1;
+  }
+
+  size = cfs_seek(db->fd, 0, CFS_SEEK_END);
+  if(size < 0) {
+    cfs_close(db->fd);
+    return -1;
+  }
+
+  /* A block that was interrupted while being written is padded with
+     zeros, which turns it into an empty block that queries skip. */
+  padding = size % TSDB_BLOCK_SIZE;
+  if(padding > 0) {
+    padding = TSDB_BLOCK_SIZE - padding;
+    LOG_WARN("padding an incomplete block with %u bytes\n", padding);
+    if(cfs_write(db->fd, db->block, padding) != padding) {
+      cfs_close(db->fd);
+      return -1;
+    }
+    size += padding;
+  }
+  db->blocks = size / TSDB_BLOCK_SIZE;
+
+  /* New samples are appended to a new block, but must not precede
+     the samples that have been stored already. */
+  if(db->blocks > 0) {
+    if(read_block(db, db->blocks - 1, &header, sizeof(header)) < 0) {
+      cfs_close(db->fd);
+      return -1;
+    }
+    db->cursor.time = header.last_time;
+  }
+
+  LOG_INFO("opened %s with %lu blocks\n", name, (unsigned long)db->blocks);
+
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsdb_close(tsdb_t *db)
+{
+  tsdb_flush(db);
+  cfs_close(db->fd);
+  db->fd = -1;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsdb_append(tsdb_t *db, uint32_t time, int32_t value)
+{
+  struct tsdb_block_header header;
+  uint32_t delta;
+  uint64_t time_code;
+  uint64_t value_code;
+
+  if(time < db->cursor.time) {
+    LOG_WARN("rejecting a sample that precedes the last one\n");
+    return -1;
+  }
+
+  get_header(db->block, &header);
+
+  if(header.count > 0) {
+    delta = time - db->cursor.time;
+    time_code = zigzag_encode((int64_t)delta - db->cursor.delta);
+    value_code = zigzag_encode((int64_t)value - db->cursor.value);
+
+    if(header.count == UINT16_MAX ||
+       db->cursor.bit + code_length(time_code) + code_length(value_code) >
+       PAYLOAD_BITS) {
+      if(write_block(db) < 0) {
+        return -1;
+      }
+      header.count = 0;
+    }
+  }
+
+  if(header.count == 0) {
+    /* The first sample of a block is stored in the header. */
+    header.first_time = header.last_time = time;
+    header.first_value = header.min_value = header.max_value = value;
+    header.count = 1;
+    header.bits = 0;
+    db->cursor.delta = 0;
+  } else {
+    write_code(db->block + HEADER_SIZE, &db->cursor.bit, time_code, delta);
+    write_code(db->block + HEADER_SIZE, &db->cursor.bit, value_code,
+               (uint32_t)value);
+    header.last_time = time;
+    if(value < header.min_value) {
+      header.min_value = value;
+    }
+    if(value > header.max_value) {
+      header.max_value = value;
+    }
+    header.count++;
+    header.bits = db->cursor.bit;
+    db->cursor.delta = delta;
+  }
+
+  db->cursor.time = time;
+  db->cursor.value = value;
+  put_header(db->block, &header);
+  db->dirty = 1;
+
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsdb_flush(tsdb_t *db)
+{
+  if(!db->dirty) {
+    return 0;
+  }
+  return write_block(db);
+}
+/*---------------------------------------------------------------------------*/
+unsigned long
+tsdb_size(tsdb_t *db)
+{
+  struct tsdb_block_header header;
+  unsigned long size;
+
+  size = (unsigned long)db->blocks * TSDB_BLOCK_SIZE;
+  get_header(db->block, &header);
+  if(header.count > 0) {
+    size += HEADER_SIZE + (header.bits + 7) / 8;
+  }
+  return size;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsdb_iterate(tsdb_iterator_t *it, tsdb_t *db, uint32_t from, uint32_t to)
+{
+  struct tsdb_block_header header;
+  uint32_t low;
+  uint32_t high;
+  uint32_t middle;
+
+  it->db = db;
+  it->from = from;
+  it->to = to;
+  it->min = TSDB_VALUE_MIN;
+  it->max = TSDB_VALUE_MAX;
+  it->count = 0;
+  it->cursor.index = 0;
+
+  /* The blocks are ordered by time, so the first block that can hold
+     samples in the range is found with a binary search. */
+  low = 0;
+  high = db->blocks;
+  while(low < high) {
+    middle = low + (high - low) / 2;
+    if(read_block(db, middle, &header, sizeof(header)) < 0) {
+      low = 0;
+      break;
+    }
+    if(header.count > 0 && header.last_time < from) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  it->block_no = low;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsdb_iterate_values(tsdb_iterator_t *it, int32_t min, int32_t max)
+{
+  it->min = min;
+  it->max = max;
+}
+/*---------------------------------------------------------------------------*/
+static void
+finish_iteration(tsdb_iterator_t *it)
+{
+  it->block_no = it->db->blocks + 1;
+  it->count = 0;
+  it->cursor.index = 0;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Load the next block that may hold samples matching the iteration.
+ * Returns 1 if a block was loaded, 0 if there are no more blocks, and
+ * -1 if a block could not be read.
+ */
+static int
+load_block(tsdb_iterator_t *it)
+{
+  struct tsdb_block_header header;
+  tsdb_t *db;
+
+  db = it->db;
+  for(; it->block_no <= db->blocks; it->block_no++) {
+    if(it->block_no == db->blocks) {
+      /* The block that is being filled. */
+      get_header(db->block, &header);
+    } else if(read_block(db, it->block_no, &header, sizeof(header)) < 0) {
+      return -1;
+    }
+
+    if(header.count > 0 && header.first_time > it->to) {
+      break;
+    }
+    if(header.count == 0 || header.last_time < it->from ||
+       header.max_value < it->min || header.min_value > it->max) {
+      continue;
+    }
+
+    if(it->block_no == db->blocks) {
+      memcpy(it->block, db->block, TSDB_BLOCK_SIZE);
+    } else if(read_block(db, it->block_no, it->block, TSDB_BLOCK_SIZE) < 0) {
+      return -1;
+    }
+
+    it->block_no++;
+    it->count = header.count;
+    it->bits = header.bits;
+    it->cursor.time = header.first_time;
+    it->cursor.value = header.first_value;
+    it->cursor.delta = 0;
+    it->cursor.bit = 0;
+    it->cursor.index = 0;
+    return 1;
+  }
+
+  finish_iteration(it);
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsdb_next(tsdb_iterator_t *it, tsdb_sample_t *sample)
+{
+  struct tsdb_cursor *cursor;
+  const uint8_t *payload;
+  int64_t diff;
+  uint32_t raw;
+  int r;
+
+  cursor = &it->cursor;
+  payload = it->block + HEADER_SIZE;
+
+  for(;;) {
+    if(cursor->index == it->count) {
+      r = load_block(it);
+      if(r <= 0) {
+        return r;
+      }
+    }
+
+    if(cursor->index > 0) {
+      if(read_code(payload, &cursor->bit, &diff, &raw)) {
+        cursor->delta += (uint32_t)diff;
+      } else {
+        cursor->delta = raw;
+      }
+      cursor->time += cursor->delta;
+
+      if(read_code(payload, &cursor->bit, &diff, &raw)) {
+        cursor->value = (int32_t)((uint32_t)cursor->value + (uint32_t)diff);
+      } else {
+        cursor->value = (int32_t)raw;
+      }
+
+      if(cursor->bit > it->bits) {
+        LOG_ERR("corrupt block %lu\n", (unsigned long)it->block_no - 1);
+        return -1;
+      }
+    }
+    cursor->index++;
+
+    if(cursor->time > it->to) {
+      finish_iteration(it);
+      return 0;
+    }
+
+    if(cursor->time >= it->from &&
+       cursor->value >= it->min && cursor->value <= it->max) {
+      sample->time = cursor->time;
+      sample->value = cursor->value;
+      return 1;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup cfs
+ * @{
+ */
+
+/**
+ * \defgroup tsdb Time-series storage on top of CFS
+ *
+ * The tsdb module stores periodic sensor samples, each consisting of
+ * a 32-bit timestamp and a 32-bit signed value, in a file of the
+ * Contiki file system. Samples are compressed into fixed-size blocks:
+ * timestamps are stored as the difference between consecutive time
+ * deltas (delta-of-delta), and values as the difference from the
+ * previous value. Both differences are written with a variable-length
+ * bit code, so a sample taken at a fixed period with a slowly changing
+ * value typically needs only a couple of bytes.
+ *
+ * Each block begins with a header that summarizes the time range and
+ * the value range of the samples in the block, which allows queries to
+ * skip blocks without decoding them.
+ *
+ * Samples must be appended in non-decreasing timestamp order. The
+ * block that is being filled is kept in RAM and appended to the file
+ * when it is full, when tsdb_flush() is called, or when the series is
+ * closed.
+ *
+ * The module uses only the generic CFS interface, so it works with
+ * both Coffee and cfs-posix.
+ *
+ * @{
+ */
+
+/**
+ * \file
+ *         Header file for the time-series storage module.
+ */
+
+#ifndef TSDB_H
+#define TSDB_H
+
+#include "contiki.h"
+
+#include <stdint.h>
+
+/** The size of a block in bytes, including its header. */
+#ifdef TSDB_CONF_BLOCK_SIZE
+#define TSDB_BLOCK_SIZE TSDB_CONF_BLOCK_SIZE
+#else
+#define TSDB_BLOCK_SIZE 256
+#endif
+
+/**
+ * The file size to reserve with cfs_coffee_reserve() when a series is
+ * created. Set to 0 to let the file system decide, which is required
+ * when using a file system other than Coffee.
+ */
+#ifdef TSDB_CONF_COFFEE_RESERVE_SIZE
+#define TSDB_COFFEE_RESERVE_SIZE TSDB_CONF_COFFEE_RESERVE_SIZE
+#else
+#define TSDB_COFFEE_RESERVE_SIZE 0
+#endif
+
+/** The smallest and largest values accepted by value filters. */
+#define TSDB_VALUE_MIN INT32_MIN
+#define TSDB_VALUE_MAX INT32_MAX
+
+/** The earliest and latest timestamps accepted by time filters. */
+#define TSDB_TIME_MIN 0
+#define TSDB_TIME_MAX UINT32_MAX
+
+typedef struct tsdb_sample {
+  uint32_t time;
+  int32_t value;
+} tsdb_sample_t;
+
+/* The summary stored at the beginning of each block. */
+struct tsdb_block_header {
+  uint32_t first_time;
+  uint32_t last_time;
+  int32_t first_value;
+  int32_t min_value;
+  int32_t max_value;
+  uint16_t count;
+  uint16_t bits;
+};
+
+#if TSDB_BLOCK_SIZE < 64 || TSDB_BLOCK_SIZE > 4096
+#error TSDB_BLOCK_SIZE must be between 64 and 4096 bytes.
+#endif
+
+/* The state of the encoder or decoder in a block. */
+struct tsdb_cursor {
+  uint32_t time;
+  uint32_t delta;
+  int32_t value;
+  uint16_t bit;
+  uint16_t index;
+};
+
+/**
+ * A series of samples stored in a single file.
+ */
+typedef struct tsdb {
+  int fd;
+  /* The number of blocks preceding the block that is being filled. */
+  uint32_t blocks;
+  struct tsdb_cursor cursor;
+  uint8_t dirty;
+  uint8_t block[TSDB_BLOCK_SIZE];
+} tsdb_t;
+
+/**
+ * An iterator over the samples of a series that fall within a time
+ * range and a value range.
+ */
+typedef struct tsdb_iterator {
+  tsdb_t *db;
+  uint32_t from;
+  uint32_t to;
+  int32_t min;
+  int32_t max;
+  uint32_t block_no;
+  struct tsdb_cursor cursor;
+  uint16_t count;
+  uint16_t bits;
+  uint8_t block[TSDB_BLOCK_SIZE];
+} tsdb_iterator_t;
+
+/**
+ * \brief      Open a series, creating its file if it does not exist.
+ * \param db   A pointer to the series structure.
+ * \param name The name of the file that stores the series.
+ * \return     0 on success, or -1 if the file could not be opened or
+ *             is not a valid series.
+ *
+ *             Samples appended to an existing series start a new block.
+ */
+int tsdb_open(tsdb_t *db, const char *name);
+
+/**
+ * \brief      Write the block that is being filled and close the series.
+ * \param db   A pointer to the series structure.
+ */
+void tsdb_close(tsdb_t *db);
+
+/**
+ * \brief       Append a sample to a series.
+ * \param db    A pointer to the series structure.
+ * \param time  The timestamp of the sample.
+ * \param value The value of the sample.
+ * \return      0 on success, or -1 if the timestamp precedes the last
+ *              sample or a block could not be written.
+ */
+int tsdb_append(tsdb_t *db, uint32_t time, int32_t value);
+
+/**
+ * \brief      Write the block that is being filled to the file.
+ * \param db   A pointer to the series structure.
+ * \return     0 on success, or -1 if the block could not be written.
+ *
+ *             Since the file is only appended to, the block is sealed
+ *             even if it is not full, and subsequent samples start a
+ *             new block. Flushing often therefore reduces compression.
+ */
+int tsdb_flush(tsdb_t *db);
+
+/**
+ * \brief      Get the number of bytes used by a series.
+ * \param db   A pointer to the series structure.
+ * \return     The size of the written blocks plus the used part of the
+ *             block that is being filled.
+ */
+unsigned long tsdb_size(tsdb_t *db);
+
+/**
+ * \brief      Start iterating over the samples in a time range.
+ * \param it   A pointer to the iterator.
+ * \param db   A pointer to the series structure.
+ * \param from The earliest timestamp to include.
+ * \param to   The latest timestamp to include.
+ *
+ *             The series must not be appended to while it is being
+ *             iterated over.
+ */
+void tsdb_iterate(tsdb_iterator_t *it, tsdb_t *db, uint32_t from, uint32_t to);
+
+/**
+ * \brief      Restrict an iteration to a range of values.
+ * \param it   A pointer to an iterator started with tsdb_iterate().
+ * \param min  The smallest value to include.
+ * \param max  The largest value to include.
+ *
+ *             Blocks whose value summaries are outside of the range
+ *             are skipped without being decoded.
+ */
+void tsdb_iterate_values(tsdb_iterator_t *it, int32_t min, int32_t max);
+
+/**
+ * \brief        Get the next sample of an iteration.
+ * \param it     A pointer to the iterator.
+ * \param sample A pointer to where the sample is stored.
+ * \return       1 if a sample was stored, 0 if the iteration is
+ *               finished, or -1 if a block could not be read.
+ */
+int tsdb_next(tsdb_iterator_t *it, tsdb_sample_t *sample);
+
+#endif /* TSDB_H */
+
+/** @} */
+/** @} */
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <string.h>
+#include <time.h>
+
+#include <lib/memb.h>
+
+/*
+ * Microbenchmark of memb_alloc() and memb_free() with pools of
+ * different sizes. Each pool is exercised in two ways:
+ *
+ * - fill: all blocks are allocated, and then freed in reverse order.
+ * - churn: the pool is kept half full while a pseudo-randomly chosen
+ *   block is freed and a new block allocated, which is the typical
+ *   pattern of queue buffers and table entries.
+ */
+
+#define OPERATIONS 2000000UL
+#define DATA_LEN 24
+
+typedef struct test_struct {
+  uint8_t index;
+  char data[DATA_LEN];
+} test_struct_t;
+
+MEMB(pool_8, test_struct_t, 8);
+MEMB(pool_64, test_struct_t, 64);
+MEMB(pool_512, test_struct_t, 512);
+
+static test_struct_t *blocks[512];
+static uint32_t seed = 1;
+
+static uint32_t
+next_random(void)
+{
+  seed = seed * 1103515245 + 12345;
+  return seed >> 8;
+}
+
+static double
+elapsed_ns(const struct timespec *start)
+{
+  struct timespec end;
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return (end.tv_sec - start->tv_sec) * 1e9 + (end.tv_nsec - start->tv_nsec);
+}
+
+static int
+fill(struct memb *m, unsigned num, double *ns)
+{
+  struct timespec start;
+  unsigned long rounds;
+  unsigned long r;
+  int i;
+
+  rounds = OPERATIONS / num;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for(r = 0; r < rounds; r++) {
+    for(i = 0; i < num; i++) {
+      blocks[i] = memb_alloc(m);
+      if(blocks[i] == NULL) {
+        printf("test failed: memb_alloc() returns NULL with i==%d\n", i);
+        return -1;
+      }
+    }
+    if(memb_alloc(m) != NULL) {
+      printf("test failed: memb_alloc() allocates more memory than defined\n");
+      return -1;
+    }
+    for(i = num - 1; i >= 0; i--) {
+      if(memb_free(m, blocks[i]) != 0) {
+        printf("test failed: cannot memb_free() %p\n", blocks[i]);
+        return -1;
+      }
+    }
+  }
+  *ns = elapsed_ns(&start) / (rounds * num);
+  return 0;
+}
+
+static int
+churn(struct memb *m, unsigned num, double *ns)
+{
+  struct timespec start;
+  unsigned long n;
+  unsigned live;
+  unsigned i;
+
+  live = num / 2;
+  for(i = 0; i < live; i++) {
+    blocks[i] = memb_alloc(m);
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for(n = 0; n < OPERATIONS; n++) {
+    i = next_random() % live;
+    if(memb_free(m, blocks[i]) != 0) {
+      printf("test failed: cannot memb_free() %p\n", blocks[i]);
+      return -1;
+    }
+    blocks[i] = memb_alloc(m);
+    if(blocks[i] == NULL) {
+      printf("test failed: memb_alloc() returns NULL\n");
+      return -1;
+    }
+  }
+  *ns = elapsed_ns(&start) / OPERATIONS;
+
+  if(memb_numfree(m) != num - live) {
+    printf("test failed: memb_numfree() returns %u, which should be %u\n",
+           (unsigned)memb_numfree(m), num - live);
+    return -1;
+  }
+  for(i = 0; i < live; i++) {
+    memb_free(m, blocks[i]);
+  }
+  return 0;
+}
+
+static int
+run(const char *name, struct memb *m, unsigned num)
+{
+  double fill_ns;
+  double churn_ns;
+
+  memb_init(m);
+  if(fill(m, num, &fill_ns) < 0 || churn(m, num, &churn_ns) < 0) {
+    return -1;
+  }
+  if(memb_numfree(m) != num) {
+    printf("test failed: %s leaks blocks\n", name);
+    return -1;
+  }
+
+  printf("- %-8s fill: %6.1f ns per alloc/free, churn: %6.1f ns per free/alloc\n",
+         name, fill_ns, churn_ns);
+  return 0;
+}
+
+int
+main(void)
+{
+  if(run("pool_8", &pool_8, 8) < 0 ||
+     run("pool_64", &pool_64, 64) < 0 ||
+     run("pool_512", &pool_512, 512) < 0) {
+    return -1;
+  }
+  return 0;
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Tests of the statistics kept for memb pools when
+ *         MEMB_CONF_STATS is set.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <lib/memb.h>
+
+#if !MEMB_STATS
+#error This test must be compiled with MEMB_CONF_STATS=1.
+#endif
+
+#define NUM_BLOCKS 4
+
+MEMB(pool_a, uint32_t, NUM_BLOCKS);
+MEMB(pool_b, uint64_t, 40);
+
+#define CHECK(cond) do {                                \
+    if(!(cond)) {                                       \
+      printf("test failed: %s (line %d)\n", #cond, __LINE__); \
+      return -1;                                        \
+    }                                                   \
+  } while(0)
+
+int
+main(void)
+{
+  void *blocks[NUM_BLOCKS];
+
+  /* A pool is listed when it is initialized or first allocated from,
+     but only once. */
+  CHECK(memb_stats_head() == NULL);
+  memb_init(&pool_a);
+  memb_init(&pool_a);
+  CHECK(memb_stats_head() == &pool_a);
+  CHECK(memb_alloc(&pool_b) != NULL);
+  CHECK(memb_stats_head() == &pool_b);
+  CHECK(pool_b.next == &pool_a);
+  CHECK(pool_a.next == NULL);
+  CHECK(strcmp(pool_a.name, "pool_a") == 0);
+  printf("- pool list is OK\n");
+
+  /* The high-water mark persists when blocks are freed. */
+  for(int i = 0; i < NUM_BLOCKS; i++) {
+    blocks[i] = memb_alloc(&pool_a);
+    CHECK(blocks[i] != NULL);
+  }
+  CHECK(pool_a.max_used == NUM_BLOCKS);
+  CHECK(memb_free(&pool_a, blocks[0]) == 0);
+  CHECK(memb_free(&pool_a, blocks[1]) == 0);
+  CHECK(pool_a.max_used == NUM_BLOCKS);
+  CHECK(pool_b.max_used == 1);
+  printf("- high-water marks are OK\n");
+
+  /* Failed allocations are counted. */
+  CHECK(pool_a.failures == 0);
+  CHECK(memb_alloc(&pool_a) != NULL);
+  CHECK(memb_alloc(&pool_a) != NULL);
+  CHECK(memb_alloc(&pool_a) == NULL);
+  CHECK(memb_alloc(&pool_a) == NULL);
+  CHECK(pool_a.failures == 2);
+  printf("- failure counts are OK\n");
+
+  /* Initialization resets the statistics. */
+  memb_init(&pool_a);
+  CHECK(pool_a.max_used == 0);
+  CHECK(pool_a.failures == 0);
+  CHECK(memb_stats_head() == &pool_b);
+  printf("- reset is OK\n");
+
+  return 0;
+}
@@ -38,9 +38,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "contiki.h"
 #include "lib/heapmem.h"
+#include "lib/mem-snapshot.h"
 #include "unit-test/unit-test.h"
 /*****************************************************************************/
 /* Configuration for the Many Allocations test. */
@@ -66,6 +68,22 @@
 #else
 #define TEST_MAX_SIZE       200
 #endif
+
+/* Configuration for the stress test. */
+
+/* Total number of operations. */
+#ifdef TEST_CONF_STRESS_OPS
+#define TEST_STRESS_OPS TEST_CONF_STRESS_OPS
+#else
+#define TEST_STRESS_OPS 200000
+#endif
+
+/* Maximum number of concurrent allocations. */
+#ifdef TEST_CONF_STRESS_SLOTS
+#define TEST_STRESS_SLOTS TEST_CONF_STRESS_SLOTS
+#else
+#define TEST_STRESS_SLOTS 512
+#endif
 /*****************************************************************************/
 PROCESS(test_heapmem_process, "Heapmem test process");
 AUTOSTART_PROCESSES(&test_heapmem_process);
@@ -269,6 +287,168 @@ UNIT_TEST(zero_init_alloc)
   UNIT_TEST_END();
 }
 /*****************************************************************************/
+/*
+ * A mix of allocation sizes resembling that of network protocols:
+ * mostly small objects such as options and tokens, many messages, and
+ * a few large payloads.
+ */
+static size_t
+stress_size(void)
+{
+  int r = rand() % 100;
+
+  if(r < 60) {
+    return 1 + rand() % 64;
+  } else if(r < 90) {
+    return 65 + rand() % 192;
+  }
+  return 257 + rand() % 1024;
+}
+/*****************************************************************************/
+static uint64_t
+time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*****************************************************************************/
+static bool
+stress_check(const uint8_t *ptr, size_t size, uint8_t pattern)
+{
+  for(size_t i = 0; i < size; i++) {
+    if(ptr[i] != (uint8_t)(pattern + i)) {
+      return false;
+    }
+  }
+  return true;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(stress, "Randomized stress and fragmentation");
+UNIT_TEST(stress)
+{
+  static struct {
+    uint8_t *ptr;
+    size_t size;
+    uint8_t pattern;
+  } slots[TEST_STRESS_SLOTS];
+  unsigned allocations = 0;
+  unsigned reallocations = 0;
+  unsigned failed_allocations = 0;
+  unsigned corruptions = 0;
+  uint64_t alloc_time = 0;
+  uint64_t max_alloc_time = 0;
+  size_t live = 0;
+  size_t max_live = 0;
+
+  UNIT_TEST_BEGIN();
+
+  heapmem_zone_t zone = heapmem_zone_register("Stress", 100000);
+  UNIT_TEST_ASSERT(zone != HEAPMEM_ZONE_INVALID);
+
+  /*
+   * Pick a random slot in each operation. An empty slot gets a new
+   * object, which is placed in the stress zone every fourth time. An
+   * occupied slot has its object either reallocated or freed, after
+   * its contents have been verified.
+   */
+  for(unsigned op = 0; op < TEST_STRESS_OPS; op++) {
+    unsigned i = rand() % TEST_STRESS_SLOTS;
+    size_t size = stress_size();
+
+    if(slots[i].ptr == NULL) {
+      uint64_t start = time_ns();
+      if(rand() % 4 == 0) {
+        slots[i].ptr = heapmem_zone_alloc(zone, size);
+      } else {
+        slots[i].ptr = heapmem_alloc(size);
+      }
+      uint64_t elapsed = time_ns() - start;
+
+      allocations++;
+      alloc_time += elapsed;
+      if(elapsed > max_alloc_time) {
+        max_alloc_time = elapsed;
+      }
+      if(slots[i].ptr == NULL) {
+        failed_allocations++;
+        continue;
+      }
+      slots[i].size = size;
+      slots[i].pattern = rand();
+      live += size;
+    } else {
+      if(!stress_check(slots[i].ptr, slots[i].size, slots[i].pattern)) {
+        corruptions++;
+      }
+      live -= slots[i].size;
+
+      if(rand() % 5 == 0) {
+        uint8_t *ptr = heapmem_realloc(slots[i].ptr, size);
+        reallocations++;
+        if(ptr == NULL) {
+          failed_allocations++;
+          heapmem_free(slots[i].ptr);
+          slots[i].ptr = NULL;
+          continue;
+        }
+        /* The common prefix must have been preserved. */
+        if(!stress_check(ptr, MIN(size, slots[i].size), slots[i].pattern)) {
+          corruptions++;
+        }
+        slots[i].ptr = ptr;
+        slots[i].size = size;
+        live += size;
+      } else {
+        heapmem_free(slots[i].ptr);
+        slots[i].ptr = NULL;
+        continue;
+      }
+    }
+
+    for(size_t j = 0; j < slots[i].size; j++) {
+      slots[i].ptr[j] = slots[i].pattern + j;
+    }
+    if(live > max_live) {
+      max_live = live;
+    }
+  }
+
+  heapmem_stats_t stats;
+  heapmem_stats(&stats);
+
+  printf("Allocations: %u, reallocations: %u, failed: %u\n",
+         allocations, reallocations, failed_allocations);
+  printf("Allocation time: average %lu ns, maximum %lu ns\n",
+         (unsigned long)(alloc_time / (allocations ? allocations : 1)),
+         (unsigned long)max_alloc_time);
+  printf("Live data: %zu bytes (maximum %zu bytes)\n", live, max_live);
+  printf("Footprint: %zu bytes, free chunks: %zu bytes, overhead: %zu bytes\n",
+         stats.footprint,
+         stats.footprint - stats.allocated - stats.overhead,
+         stats.overhead);
+  printf("Fragmentation: %lu%% of the footprint is not live data\n",
+         (unsigned long)(stats.footprint == 0 ? 0 :
+                         100 * (stats.footprint - live) / stats.footprint));
+
+  for(unsigned i = 0; i < TEST_STRESS_SLOTS; i++) {
+    if(slots[i].ptr != NULL) {
+      if(!stress_check(slots[i].ptr, slots[i].size, slots[i].pattern)) {
+        corruptions++;
+      }
+      UNIT_TEST_ASSERT(heapmem_free(slots[i].ptr));
+    }
+  }
+
+  UNIT_TEST_ASSERT(failed_allocations == 0);
+  UNIT_TEST_ASSERT(corruptions == 0);
+  /* The allocated chunks must be able to hold all live data. */
+  UNIT_TEST_ASSERT(stats.allocated >= live);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
 UNIT_TEST_REGISTER(stats_check, "Heapmem statistics validation");
 UNIT_TEST(stats_check)
 {
@@ -317,6 +497,74 @@ UNIT_TEST(zones)
   UNIT_TEST_END();
 }
 /*****************************************************************************/
+static unsigned snapshot_chunks;
+static size_t snapshot_size;
+
+static void
+count_chunk_records(const uint8_t *data, size_t len, void *ptr)
+{
+  /* Each record is passed as a separate part after the header. */
+  if(snapshot_size >= 11 && data[0] == MEM_SNAPSHOT_CHUNK) {
+    snapshot_chunks++;
+  }
+  snapshot_size += len;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(tracking, "Allocation tracking");
+UNIT_TEST(tracking)
+{
+  heapmem_zone_stats_t before, after;
+
+  UNIT_TEST_BEGIN();
+
+  heapmem_zone_t zone = heapmem_zone_register("Tracking", 500);
+  UNIT_TEST_ASSERT(zone != HEAPMEM_ZONE_INVALID);
+  UNIT_TEST_ASSERT(heapmem_zone_stats(zone, &before));
+  UNIT_TEST_ASSERT(strcmp(before.name, "Tracking") == 0);
+  UNIT_TEST_ASSERT(before.zone_size == 500);
+  UNIT_TEST_ASSERT(before.allocated == 0);
+  UNIT_TEST_ASSERT(!heapmem_zone_stats(HEAPMEM_ZONE_INVALID, &before));
+
+  void *ptr1 = heapmem_zone_alloc(zone, 100);
+  void *ptr2 = heapmem_zone_alloc(zone, 200);
+  UNIT_TEST_ASSERT(ptr1 != NULL && ptr2 != NULL);
+  /* This allocation exceeds the zone limit. */
+  UNIT_TEST_ASSERT(heapmem_zone_alloc(zone, 300) == NULL);
+
+#if HEAPMEM_DEBUG
+  unsigned found = 0;
+  heapmem_chunk_info_t info = { .ptr = NULL };
+  while(heapmem_chunk_next(&info)) {
+    if(info.ptr == ptr1 || info.ptr == ptr2) {
+      UNIT_TEST_ASSERT(info.zone == zone);
+      UNIT_TEST_ASSERT(info.size >= (info.ptr == ptr1 ? 100 : 200));
+      UNIT_TEST_ASSERT(strcmp(info.file, __FILE__) == 0);
+      found++;
+    }
+  }
+  UNIT_TEST_ASSERT(found == 2);
+#endif /* HEAPMEM_DEBUG */
+
+  snapshot_chunks = 0;
+  snapshot_size = 0;
+  size_t size = mem_snapshot(count_chunk_records, NULL);
+  UNIT_TEST_ASSERT(size == snapshot_size);
+  UNIT_TEST_ASSERT(snapshot_chunks == (HEAPMEM_DEBUG ? 2 : 0));
+
+  UNIT_TEST_ASSERT(heapmem_free(ptr1));
+  ptr2 = heapmem_realloc(ptr2, 50);
+  UNIT_TEST_ASSERT(ptr2 != NULL);
+  UNIT_TEST_ASSERT(heapmem_zone_stats(zone, &after));
+  UNIT_TEST_ASSERT(after.allocated < after.max_allocated);
+  UNIT_TEST_ASSERT(after.max_allocated >= 300);
+  UNIT_TEST_ASSERT(after.failures == 1);
+  UNIT_TEST_ASSERT(heapmem_free(ptr2));
+  UNIT_TEST_ASSERT(heapmem_zone_stats(zone, &after));
+  UNIT_TEST_ASSERT(after.allocated == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
 PROCESS_THREAD(test_heapmem_process, ev, data)
 {
   PROCESS_BEGIN();
@@ -333,16 +581,20 @@ PROCESS_THREAD(test_heapmem_process, ev, data)
   UNIT_TEST_RUN(invalid_freeing);
   UNIT_TEST_RUN(reallocations);
   UNIT_TEST_RUN(zero_init_alloc);
+  UNIT_TEST_RUN(stress);
   UNIT_TEST_RUN(stats_check);
   UNIT_TEST_RUN(zones);
+  UNIT_TEST_RUN(tracking);
 
   if(!UNIT_TEST_PASSED(do_many_allocations) ||
      !UNIT_TEST_PASSED(max_alloc) ||
      !UNIT_TEST_PASSED(invalid_freeing) ||
      !UNIT_TEST_PASSED(reallocations) ||
      !UNIT_TEST_PASSED(zero_init_alloc) ||
+     !UNIT_TEST_PASSED(stress) ||
      !UNIT_TEST_PASSED(stats_check) ||
-     !UNIT_TEST_PASSED(zones)) {
+     !UNIT_TEST_PASSED(zones) ||
+     !UNIT_TEST_PASSED(tracking)) {
     printf("=check-me= FAILED\n");
     printf("---\n");
   }
@@ -33,8 +33,10 @@
 #include "lib/sha-256.h"
 #include "lib/hexconv.h"
 #include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <time.h>
 
 PROCESS(test_process, "test");
 AUTOSTART_PROCESSES(&test_process);
@@ -432,6 +434,84 @@ UNIT_TEST(sha_256_hkdf)
   UNIT_TEST_END();
 }
 /*---------------------------------------------------------------------------*/
+#define ACCEL_MAX_LEN 300
+
+static uint8_t accel_data[ACCEL_MAX_LEN];
+
+UNIT_TEST_REGISTER(sha_256_accel, "SHA-256 accelerated driver");
+UNIT_TEST(sha_256_accel)
+{
+  uint8_t digest[SHA_256_DIGEST_LENGTH];
+  uint8_t accel_digest[SHA_256_DIGEST_LENGTH];
+
+  UNIT_TEST_BEGIN();
+
+  for(size_t i = 0; i < ACCEL_MAX_LEN; i++) {
+    accel_data[i] = rand();
+  }
+
+  /* Cover all padding cases. */
+  for(size_t len = 0; len <= ACCEL_MAX_LEN; len++) {
+    sha_256_driver.init();
+    sha_256_driver.update(accel_data, len);
+    sha_256_driver.finalize(digest);
+    sha_256_accel_driver.hash(accel_data, len, accel_digest);
+    UNIT_TEST_ASSERT(!memcmp(digest, accel_digest, sizeof(digest)));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+#define IMAGE_SIZE (256 * 1024)
+#define IMAGE_ROUNDS 8
+
+static uint8_t image[IMAGE_SIZE];
+
+static uint64_t
+time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static double
+image_throughput(const struct sha_256_driver *driver,
+                 uint8_t digest[static SHA_256_DIGEST_LENGTH])
+{
+  uint64_t start = time_ns();
+
+  for(size_t round = 0; round < IMAGE_ROUNDS; round++) {
+    driver->init();
+    driver->update(image, sizeof(image));
+    driver->finalize(digest);
+  }
+
+  /* MB/s */
+  return (double)IMAGE_ROUNDS * sizeof(image) * 1000 / (time_ns() - start);
+}
+
+UNIT_TEST_REGISTER(sha_256_bench, "SHA-256 throughput");
+UNIT_TEST(sha_256_bench)
+{
+  uint8_t digest[SHA_256_DIGEST_LENGTH];
+  uint8_t accel_digest[SHA_256_DIGEST_LENGTH];
+
+  UNIT_TEST_BEGIN();
+
+  for(size_t i = 0; i < sizeof(image); i++) {
+    image[i] = rand();
+  }
+
+  printf("256 KB image: portable %.1f MB/s, accelerated %.1f MB/s\n",
+         image_throughput(&sha_256_driver, digest),
+         image_throughput(&sha_256_accel_driver, accel_digest));
+  UNIT_TEST_ASSERT(!memcmp(digest, accel_digest, sizeof(digest)));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
 PROCESS_THREAD(test_process, ev, data)
 {
   PROCESS_BEGIN();
@@ -444,12 +524,16 @@ PROCESS_THREAD(test_process, ev, data)
   UNIT_TEST_RUN(sha_256_hash_shorthand);
   UNIT_TEST_RUN(sha_256_hmac);
   UNIT_TEST_RUN(sha_256_hkdf);
+  UNIT_TEST_RUN(sha_256_accel);
+  UNIT_TEST_RUN(sha_256_bench);
 
   if(!UNIT_TEST_PASSED(sha_256_hash_stepwise)
      || !UNIT_TEST_PASSED(sha_256_hash_with_checkpoint)
      || !UNIT_TEST_PASSED(sha_256_hash_shorthand)
      || !UNIT_TEST_PASSED(sha_256_hmac)
-     || !UNIT_TEST_PASSED(sha_256_hkdf)) {
+     || !UNIT_TEST_PASSED(sha_256_hkdf)
+     || !UNIT_TEST_PASSED(sha_256_accel)
+     || !UNIT_TEST_PASSED(sha_256_bench)) {
     printf("=check-me= FAILED\n");
     printf("---\n");
   }
@@ -40,6 +40,7 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
+#include <time.h>
 
 /* Log configuration */
 #include "sys/log.h"
@@ -177,6 +178,501 @@ UNIT_TEST(test_write_read)
   UNIT_TEST_END();
 }
 /*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_skip_find, "Skip items and find nested items");
+UNIT_TEST(test_skip_find)
+{
+  /* {"a": [1, [_ 2, 3], h'0102'], 1: (_ "ab", "c"),
+      "b": 1(1.5), -3: {_ "x": [], "y": [_ 4, 5]}}, followed by 0 */
+  static const uint8_t cbor_data[] = {
+    0xa4, 0x61, 0x61, 0x83, 0x01, 0x9f, 0x02, 0x03, 0xff, 0x42, 0x01, 0x02,
+    0x01, 0x7f, 0x62, 0x61, 0x62, 0x61, 0x63, 0xff,
+    0x61, 0x62, 0xc1, 0xf9, 0x3e, 0x00,
+    0x22, 0xbf, 0x61, 0x78, 0x80, 0x61, 0x79, 0x9f, 0x04, 0x05, 0xff, 0xff,
+    0x00
+  };
+  static const cbor_path_element_t a_1_1[] = {
+    CBOR_PATH_TEXT("a"), CBOR_PATH_INDEX(1), CBOR_PATH_INDEX(1)
+  };
+  static const cbor_path_element_t y_1[] = {
+    CBOR_PATH_KEY(-3), CBOR_PATH_TEXT("y"), CBOR_PATH_INDEX(1)
+  };
+  static const cbor_path_element_t a_3[] = {
+    CBOR_PATH_TEXT("a"), CBOR_PATH_INDEX(3)
+  };
+  static const cbor_path_element_t b[] = { CBOR_PATH_TEXT("b") };
+  static const cbor_path_element_t one[] = { CBOR_PATH_KEY(1) };
+  static const cbor_path_element_t c[] = { CBOR_PATH_TEXT("c") };
+  uint8_t nested[2 * (CBOR_MAX_NESTING + 2) + 1];
+  cbor_reader_state_t reader;
+  cbor_reader_state_t copy;
+  const uint8_t *item;
+  size_t item_size;
+  uint64_t value;
+
+  UNIT_TEST_BEGIN();
+
+  /* skip the whole map */
+  cbor_init_reader(&reader, cbor_data, sizeof(cbor_data));
+  UNIT_TEST_ASSERT(cbor_skip(&reader));
+  UNIT_TEST_ASSERT(reader.cbor_size == 1);
+  UNIT_TEST_ASSERT(cbor_skip(&reader));
+  UNIT_TEST_ASSERT(cbor_end_reader(&reader));
+  UNIT_TEST_ASSERT(!cbor_skip(&reader));
+
+  /* a truncated map cannot be skipped */
+  cbor_init_reader(&reader, cbor_data, sizeof(cbor_data) - 2);
+  UNIT_TEST_ASSERT(!cbor_skip(&reader));
+  UNIT_TEST_ASSERT(reader.cbor == cbor_data);
+
+  /* paths through definite and indefinite arrays and maps */
+  cbor_init_reader(&reader, cbor_data, sizeof(cbor_data));
+  copy = reader;
+  UNIT_TEST_ASSERT(cbor_find(&copy, a_1_1, 3));
+  UNIT_TEST_ASSERT(cbor_read_unsigned(&copy, &value) != CBOR_SIZE_NONE);
+  UNIT_TEST_ASSERT(value == 3);
+
+  copy = reader;
+  UNIT_TEST_ASSERT(cbor_find(&copy, y_1, 3));
+  UNIT_TEST_ASSERT(cbor_read_unsigned(&copy, &value) != CBOR_SIZE_NONE);
+  UNIT_TEST_ASSERT(value == 5);
+
+  /* items are returned as pointers into the input */
+  copy = reader;
+  UNIT_TEST_ASSERT(cbor_find(&copy, b, 1));
+  item = cbor_read_item(&copy, &item_size);
+  UNIT_TEST_ASSERT(item == cbor_data + 22);
+  UNIT_TEST_ASSERT(item_size == 4);
+
+  copy = reader;
+  UNIT_TEST_ASSERT(cbor_find(&copy, one, 1));
+  item = cbor_read_item(&copy, &item_size);
+  UNIT_TEST_ASSERT(item == cbor_data + 13);
+  UNIT_TEST_ASSERT(item_size == 7);
+
+  /* missing items leave the reader unchanged */
+  copy = reader;
+  UNIT_TEST_ASSERT(!cbor_find(&copy, a_3, 2));
+  UNIT_TEST_ASSERT(!cbor_find(&copy, c, 1));
+  UNIT_TEST_ASSERT(copy.cbor == cbor_data);
+
+  /* [[[...[0, 0]...], 0], 0] needs to come back to all but the outermost
+     array, so nesting beyond CBOR_MAX_NESTING + 1 arrays is rejected */
+  for(size_t depth = CBOR_MAX_NESTING + 1; depth <= CBOR_MAX_NESTING + 2;
+      depth++) {
+    memset(nested, 0x82, depth);
+    memset(nested + depth, 0x00, depth + 1);
+    cbor_init_reader(&reader, nested, 2 * depth + 1);
+    UNIT_TEST_ASSERT(cbor_skip(&reader) == (depth == CBOR_MAX_NESTING + 1));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+#define BENCH_ROUNDS 2000
+#define SENML_RECORDS 64
+#define SENML_TARGET 50
+
+/* SenML-CBOR labels, as used by LwM2M */
+#define SENML_NAME 0
+#define SENML_VALUE 2
+#define SENML_TIME 6
+
+struct senml_record {
+  const char *name;
+  size_t name_size;
+  int64_t value;
+  int64_t time;
+};
+
+static uint8_t senml[SENML_RECORDS * 32];
+static size_t senml_size;
+static uint8_t envelope[2048];
+static size_t envelope_size;
+
+static uint64_t
+time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* The fastest run is reported, as it is the least disturbed by the host. */
+static uint64_t
+fastest(uint64_t start, uint64_t best)
+{
+  uint64_t elapsed = time_ns() - start;
+
+  return elapsed < best ? elapsed : best;
+}
+/*---------------------------------------------------------------------------*/
+static void
+write_senml(void)
+{
+  cbor_writer_state_t writer;
+  char name[16];
+
+  cbor_init_writer(&writer, senml, sizeof(senml));
+  cbor_open_array(&writer);
+  for(int i = 0; i < SENML_RECORDS; i++) {
+    snprintf(name, sizeof(name), "/3303/%d/5700", i);
+    cbor_open_map(&writer);
+    cbor_write_signed(&writer, SENML_NAME);
+    cbor_write_text(&writer, name, strlen(name));
+    cbor_write_signed(&writer, SENML_VALUE);
+    cbor_write_signed(&writer, 2000 + i * 7);
+    cbor_write_signed(&writer, SENML_TIME);
+    cbor_write_signed(&writer, -60 * i);
+    cbor_close_map(&writer);
+  }
+  cbor_close_array(&writer);
+  senml_size = cbor_end_writer(&writer);
+}
+/*---------------------------------------------------------------------------*/
+/* A SUIT-style envelope: {2: bstr(authentication), 3: bstr({1: 1, 2: 42,
+   3: bstr({2: [[h'00']], 4: bstr([commands])}), 9: bstr([commands])}),
+   "#image": bstr(image)} */
+static void
+write_commands(cbor_writer_state_t *writer, int count)
+{
+  cbor_open_array(writer);
+  for(int i = 0; i < count; i++) {
+    cbor_write_unsigned(writer, 20);
+    cbor_open_map(writer);
+    cbor_write_unsigned(writer, 1);
+    cbor_write_data(writer, (const uint8_t *)"vendor-identifier", 16);
+    cbor_write_unsigned(writer, 3);
+    cbor_write_data(writer, (const uint8_t *)"0123456789abcdef0123456789abcdef", 32);
+    cbor_write_unsigned(writer, 14);
+    cbor_write_unsigned(writer, 34768 + i);
+    cbor_close_map(writer);
+  }
+  cbor_close_array(writer);
+}
+
+static void
+write_envelope(void)
+{
+  static const uint8_t image[1024];
+  cbor_writer_state_t writer;
+
+  cbor_init_writer(&writer, envelope, sizeof(envelope));
+  cbor_open_map(&writer);
+  cbor_write_unsigned(&writer, 2);
+  cbor_open_data(&writer);
+  cbor_open_array(&writer);
+  cbor_write_data(&writer, image, 32);
+  cbor_write_data(&writer, image, 64);
+  cbor_close_array(&writer);
+  cbor_close_data(&writer);
+  cbor_write_unsigned(&writer, 3);
+  cbor_open_data(&writer);
+  cbor_open_map(&writer);
+  cbor_write_unsigned(&writer, 1);
+  cbor_write_unsigned(&writer, 1);
+  cbor_write_unsigned(&writer, 2);
+  cbor_write_unsigned(&writer, 42);
+  cbor_write_unsigned(&writer, 3);
+  cbor_open_data(&writer);
+  cbor_open_map(&writer);
+  cbor_write_unsigned(&writer, 2);
+  cbor_open_array(&writer);
+  cbor_open_array(&writer);
+  cbor_write_data(&writer, image, 1);
+  cbor_close_array(&writer);
+  cbor_close_array(&writer);
+  cbor_write_unsigned(&writer, 4);
+  cbor_open_data(&writer);
+  write_commands(&writer, 8);
+  cbor_close_data(&writer);
+  cbor_close_map(&writer);
+  cbor_close_data(&writer);
+  cbor_write_unsigned(&writer, 9);
+  cbor_open_data(&writer);
+  write_commands(&writer, 4);
+  cbor_close_data(&writer);
+  cbor_close_map(&writer);
+  cbor_close_data(&writer);
+  cbor_write_text(&writer, "#image", 6);
+  cbor_write_data(&writer, image, sizeof(image));
+  cbor_close_map(&writer);
+  envelope_size = cbor_end_writer(&writer);
+}
+/*---------------------------------------------------------------------------*/
+/* Skips the next item with the sequential reader, which decodes every item
+   nested in it. */
+static bool
+sequential_skip(cbor_reader_state_t *reader)
+{
+  uint64_t value;
+  int64_t signed_value;
+  size_t size;
+  size_t count;
+
+  switch(cbor_peek_next(reader)) {
+  case CBOR_MAJOR_TYPE_UNSIGNED:
+    return cbor_read_unsigned(reader, &value) != CBOR_SIZE_NONE;
+  case CBOR_MAJOR_TYPE_SIGNED:
+    return cbor_read_signed(reader, &signed_value) != CBOR_SIZE_NONE;
+  case CBOR_MAJOR_TYPE_BYTE_STRING:
+    return cbor_read_data(reader, &size) != NULL;
+  case CBOR_MAJOR_TYPE_TEXT_STRING:
+    return cbor_read_text(reader, &size) != NULL;
+  case CBOR_MAJOR_TYPE_ARRAY:
+    count = cbor_read_array(reader);
+    break;
+  case CBOR_MAJOR_TYPE_MAP:
+    count = cbor_read_map(reader);
+    if(count != SIZE_MAX) {
+      count *= 2;
+    }
+    break;
+  case CBOR_MAJOR_TYPE_SIMPLE:
+    return cbor_read_simple(reader) != CBOR_SIMPLE_VALUE_NONE;
+  default:
+    return false;
+  }
+  if(count == SIZE_MAX) {
+    return false;
+  }
+  while(count--) {
+    if(!sequential_skip(reader)) {
+      return false;
+    }
+  }
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+/* Decodes SenML records in order until the requested one. */
+static bool
+sequential_senml_value(size_t index, int64_t *value)
+{
+  cbor_reader_state_t reader;
+  struct senml_record record;
+  size_t records;
+  size_t labels;
+  int64_t label;
+
+  cbor_init_reader(&reader, senml, senml_size);
+  records = cbor_read_array(&reader);
+  if(records == SIZE_MAX || index >= records) {
+    return false;
+  }
+  for(size_t i = 0; i <= index; i++) {
+    labels = cbor_read_map(&reader);
+    if(labels == SIZE_MAX) {
+      return false;
+    }
+    while(labels--) {
+      if(cbor_read_signed(&reader, &label) == CBOR_SIZE_NONE) {
+        return false;
+      }
+      switch(label) {
+      case SENML_NAME:
+        record.name = cbor_read_text(&reader, &record.name_size);
+        if(!record.name) {
+          return false;
+        }
+        break;
+      case SENML_VALUE:
+        if(cbor_read_signed(&reader, &record.value) == CBOR_SIZE_NONE) {
+          return false;
+        }
+        break;
+      case SENML_TIME:
+        if(cbor_read_signed(&reader, &record.time) == CBOR_SIZE_NONE) {
+          return false;
+        }
+        break;
+      default:
+        if(!sequential_skip(&reader)) {
+          return false;
+        }
+        break;
+      }
+    }
+  }
+  *value = record.value;
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+cursor_senml_value(size_t index, int64_t *value)
+{
+  const cbor_path_element_t path[] = {
+    CBOR_PATH_INDEX(index), CBOR_PATH_KEY(SENML_VALUE)
+  };
+  cbor_reader_state_t reader;
+
+  cbor_init_reader(&reader, senml, senml_size);
+  return cbor_find(&reader, path, 2)
+         && (cbor_read_signed(&reader, value) != CBOR_SIZE_NONE);
+}
+/*---------------------------------------------------------------------------*/
+/* Finds the map entry with an unsigned key using the sequential reader. */
+static bool
+sequential_map_entry(cbor_reader_state_t *reader, uint64_t key)
+{
+  size_t entries;
+  uint64_t entry_key;
+
+  entries = cbor_read_map(reader);
+  if(entries == SIZE_MAX) {
+    return false;
+  }
+  while(entries--) {
+    if(cbor_peek_next(reader) == CBOR_MAJOR_TYPE_UNSIGNED) {
+      if(cbor_read_unsigned(reader, &entry_key) == CBOR_SIZE_NONE) {
+        return false;
+      }
+      if(entry_key == key) {
+        return true;
+      }
+    } else if(!sequential_skip(reader)) {
+      return false;
+    }
+    if(!sequential_skip(reader)) {
+      return false;
+    }
+  }
+  return false;
+}
+/*---------------------------------------------------------------------------*/
+/* Gets the last command of the shared sequence in the common section. */
+static const uint8_t *
+sequential_suit_command(size_t *command_size)
+{
+  cbor_reader_state_t reader;
+  const uint8_t *data;
+  size_t data_size;
+  size_t commands;
+  const uint8_t *command;
+
+  cbor_init_reader(&reader, envelope, envelope_size);
+  if(!sequential_map_entry(&reader, 3)
+     || !(data = cbor_read_data(&reader, &data_size))) {
+    return NULL;
+  }
+  cbor_init_reader(&reader, data, data_size);
+  if(!sequential_map_entry(&reader, 3)
+     || !(data = cbor_read_data(&reader, &data_size))) {
+    return NULL;
+  }
+  cbor_init_reader(&reader, data, data_size);
+  if(!sequential_map_entry(&reader, 4)
+     || !(data = cbor_read_data(&reader, &data_size))) {
+    return NULL;
+  }
+  cbor_init_reader(&reader, data, data_size);
+  commands = cbor_read_array(&reader);
+  if(commands == SIZE_MAX || commands < 2) {
+    return NULL;
+  }
+  for(size_t i = 0; i < commands - 1; i++) {
+    if(!sequential_skip(&reader)) {
+      return NULL;
+    }
+  }
+  command = reader.cbor;
+  if(!sequential_skip(&reader)) {
+    return NULL;
+  }
+  *command_size = reader.cbor - command;
+  return command;
+}
+/*---------------------------------------------------------------------------*/
+static const uint8_t *
+cursor_suit_command(size_t *command_size)
+{
+  static const cbor_path_element_t manifest[] = { CBOR_PATH_KEY(3) };
+  static const cbor_path_element_t common[] = { CBOR_PATH_KEY(3) };
+  static const cbor_path_element_t shared_sequence[] = { CBOR_PATH_KEY(4) };
+  static const cbor_path_element_t last_command[] = { CBOR_PATH_INDEX(15) };
+  cbor_reader_state_t reader;
+  const uint8_t *data;
+  size_t data_size;
+
+  cbor_init_reader(&reader, envelope, envelope_size);
+  if(!cbor_find(&reader, manifest, 1)
+     || !(data = cbor_read_data(&reader, &data_size))) {
+    return NULL;
+  }
+  cbor_init_reader(&reader, data, data_size);
+  if(!cbor_find(&reader, common, 1)
+     || !(data = cbor_read_data(&reader, &data_size))) {
+    return NULL;
+  }
+  cbor_init_reader(&reader, data, data_size);
+  if(!cbor_find(&reader, shared_sequence, 1)
+     || !(data = cbor_read_data(&reader, &data_size))) {
+    return NULL;
+  }
+  cbor_init_reader(&reader, data, data_size);
+  if(!cbor_find(&reader, last_command, 1)) {
+    return NULL;
+  }
+  return cbor_read_item(&reader, command_size);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_find_bench, "Path lookups versus sequential reading");
+UNIT_TEST(test_find_bench)
+{
+  int64_t sequential_value = 0;
+  int64_t cursor_value = 0;
+  const uint8_t *sequential_command = NULL;
+  const uint8_t *cursor_command = NULL;
+  size_t sequential_size = 0;
+  size_t cursor_size = 0;
+  uint64_t start;
+  uint64_t sequential_time = UINT64_MAX;
+  uint64_t cursor_time = UINT64_MAX;
+  bool ok = true;
+
+  UNIT_TEST_BEGIN();
+
+  write_senml();
+  write_envelope();
+  UNIT_TEST_ASSERT(senml_size);
+  UNIT_TEST_ASSERT(envelope_size);
+
+  for(int i = 0; i < BENCH_ROUNDS; i++) {
+    start = time_ns();
+    ok &= sequential_senml_value(SENML_TARGET, &sequential_value);
+    sequential_time = fastest(start, sequential_time);
+    start = time_ns();
+    ok &= cursor_senml_value(SENML_TARGET, &cursor_value);
+    cursor_time = fastest(start, cursor_time);
+  }
+  printf("SenML record %d of %d (%zu bytes): sequential %lu ns, cursor %lu ns\n",
+         SENML_TARGET, SENML_RECORDS, senml_size,
+         (unsigned long)sequential_time, (unsigned long)cursor_time);
+
+  UNIT_TEST_ASSERT(ok);
+  UNIT_TEST_ASSERT(cursor_value == 2000 + SENML_TARGET * 7);
+  UNIT_TEST_ASSERT(sequential_value == cursor_value);
+
+  sequential_time = UINT64_MAX;
+  cursor_time = UINT64_MAX;
+  for(int i = 0; i < BENCH_ROUNDS; i++) {
+    start = time_ns();
+    sequential_command = sequential_suit_command(&sequential_size);
+    sequential_time = fastest(start, sequential_time);
+    start = time_ns();
+    cursor_command = cursor_suit_command(&cursor_size);
+    cursor_time = fastest(start, cursor_time);
+  }
+  printf("SUIT command (%zu bytes): sequential %lu ns, cursor %lu ns\n",
+         envelope_size,
+         (unsigned long)sequential_time, (unsigned long)cursor_time);
+
+  UNIT_TEST_ASSERT(cursor_command);
+  UNIT_TEST_ASSERT(cursor_command == sequential_command);
+  UNIT_TEST_ASSERT(cursor_size == sequential_size);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
 PROCESS_THREAD(test_process, ev, data)
 {
   PROCESS_BEGIN();
@@ -185,8 +681,12 @@ PROCESS_THREAD(test_process, ev, data)
   printf("---\n");
 
   UNIT_TEST_RUN(test_write_read);
+  UNIT_TEST_RUN(test_skip_find);
+  UNIT_TEST_RUN(test_find_bench);
 
-  if(!UNIT_TEST_PASSED(test_write_read)) {
+  if(!UNIT_TEST_PASSED(test_write_read)
+     || !UNIT_TEST_PASSED(test_skip_find)
+     || !UNIT_TEST_PASSED(test_find_bench)) {
     printf("=check-me= FAILED\n");
     printf("---\n");
   }
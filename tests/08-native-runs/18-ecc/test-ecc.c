@@ -31,8 +31,10 @@
 #include "contiki.h"
 #include "unit-test.h"
 #include "lib/ecc.h"
+#include "uECC.h"
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 #define ECC_CURVE (&ecc_curve_p_256)
 #define ECC_CURVE_SIZE (ECC_CURVE_P_256_SIZE)
@@ -212,6 +214,200 @@ UNIT_TEST(ecc_ecdsa)
   UNIT_TEST_END();
 }
 /*---------------------------------------------------------------------------*/
+/* P-256 public keys of private keys that exercise the first and last comb
+   columns, and a signature made with a known nonce. The keys 1 and n - 1
+   are left out, since the Montgomery ladder cannot compute them. */
+static const struct {
+  uint8_t private_key[ECC_CURVE_SIZE];
+  uint8_t public_key[ECC_CURVE_SIZE * 2];
+} key_vectors[] = {
+  { { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02 },
+    { 0x7c, 0xf2, 0x7b, 0x18, 0x8d, 0x03, 0x4f, 0x7e,
+      0x8a, 0x52, 0x38, 0x03, 0x04, 0xb5, 0x1a, 0xc3,
+      0xc0, 0x89, 0x69, 0xe2, 0x77, 0xf2, 0x1b, 0x35,
+      0xa6, 0x0b, 0x48, 0xfc, 0x47, 0x66, 0x99, 0x78,
+      0x07, 0x77, 0x55, 0x10, 0xdb, 0x8e, 0xd0, 0x40,
+      0x29, 0x3d, 0x9a, 0xc6, 0x9f, 0x74, 0x30, 0xdb,
+      0xba, 0x7d, 0xad, 0xe6, 0x3c, 0xe9, 0x82, 0x29,
+      0x9e, 0x04, 0xb7, 0x9d, 0x22, 0x78, 0x73, 0xd1 } },
+  { { 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+    { 0xd7, 0x52, 0x3c, 0xde, 0x95, 0x5c, 0x9c, 0x2b,
+      0xf1, 0x2d, 0x46, 0x1a, 0x08, 0xf3, 0x5e, 0x66,
+      0x87, 0xd4, 0x2a, 0x1d, 0xda, 0x8f, 0x8f, 0x23,
+      0x87, 0x34, 0x91, 0x97, 0x7d, 0xaa, 0x3f, 0xb3,
+      0x62, 0x97, 0x4d, 0x3a, 0x44, 0xef, 0x23, 0xb4,
+      0x83, 0xcc, 0x9b, 0xc5, 0xe2, 0x1b, 0xcc, 0x67,
+      0x8c, 0x5c, 0x64, 0x46, 0xd7, 0xb0, 0x73, 0x06,
+      0xdd, 0x93, 0x41, 0xb2, 0x72, 0x4b, 0xc4, 0xd8 } },
+  { { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xf3 },
+    { 0x5f, 0x20, 0x70, 0x5f, 0xed, 0x47, 0x78, 0xe6,
+      0x09, 0xe6, 0x2c, 0xa7, 0x8d, 0xdc, 0x64, 0x17,
+      0xaa, 0x1f, 0xe4, 0xae, 0xc1, 0x7f, 0x78, 0xaf,
+      0x77, 0x7a, 0xea, 0xbc, 0x45, 0x00, 0x14, 0xec,
+      0x0d, 0x8f, 0xeb, 0x44, 0x98, 0x77, 0xa5, 0x35,
+      0x10, 0x22, 0x0a, 0x83, 0xd5, 0x51, 0x29, 0x53,
+      0x66, 0x3d, 0x40, 0x29, 0x72, 0x47, 0x1d, 0x0e,
+      0x29, 0x25, 0xd4, 0xb4, 0x50, 0x93, 0x15, 0x49 } },
+  { { 0x3f, 0x1c, 0x8e, 0x2a, 0x9b, 0x5d, 0x07, 0xc4,
+      0xe6, 0xa1, 0xf2, 0xb3, 0xc4, 0xd5, 0xe6, 0xf7,
+      0x08, 0x19, 0x2a, 0x3b, 0x4c, 0x5d, 0x6e, 0x7f,
+      0x80, 0x91, 0xa2, 0xb3, 0xc4, 0xd5, 0xe6, 0xf7 },
+    { 0x0c, 0x2d, 0x04, 0x7d, 0x8a, 0x80, 0x4c, 0x90,
+      0xdd, 0x18, 0x98, 0x86, 0x7d, 0x9c, 0x84, 0x6f,
+      0x03, 0x0c, 0x8e, 0x30, 0xc9, 0xc1, 0x2a, 0xb9,
+      0x1d, 0x9d, 0xa4, 0xbe, 0x55, 0x38, 0xa4, 0x1d,
+      0x0a, 0xf9, 0xbd, 0xbf, 0xdc, 0x72, 0x10, 0x6e,
+      0x70, 0xa9, 0xf3, 0xfb, 0x37, 0xda, 0x6f, 0x13,
+      0x0c, 0x48, 0x1d, 0xf0, 0xab, 0x48, 0x43, 0x2b,
+      0x76, 0xa0, 0x09, 0x6c, 0xf8, 0x86, 0x15, 0x41 } },
+};
+
+/* Made with the last key above. */
+static const uint8_t vector_hash[ECC_CURVE_SIZE] = {
+  0x9f, 0x86, 0xd0, 0x81, 0x88, 0x4c, 0x7d, 0x65,
+  0x9a, 0x2f, 0xea, 0xa0, 0xc5, 0x5a, 0xd0, 0x15,
+  0xa3, 0xbf, 0x4f, 0x1b, 0x2b, 0x0b, 0x82, 0x2c,
+  0xd1, 0x5d, 0x6c, 0x15, 0xb0, 0xf0, 0x0a, 0x08
+};
+static const uint8_t vector_signature[ECC_CURVE_SIZE * 2] = {
+  0x6f, 0xa2, 0xc1, 0xc5, 0x36, 0x93, 0xdd, 0xa2,
+  0xb2, 0x97, 0xdd, 0xb4, 0x29, 0x6a, 0x2b, 0x90,
+  0xec, 0x7e, 0x0b, 0x13, 0x77, 0x3a, 0xb2, 0x9c,
+  0x8b, 0x7d, 0x18, 0xaf, 0x25, 0xac, 0x2d, 0x0e,
+  0x4d, 0x19, 0xcb, 0x18, 0x3c, 0xed, 0x9e, 0xb7,
+  0x07, 0x1e, 0x3c, 0x04, 0xd2, 0x2e, 0x97, 0x1a,
+  0x9d, 0xc6, 0x14, 0xd0, 0x46, 0x98, 0xc8, 0xd7,
+  0xca, 0x42, 0x17, 0x02, 0xab, 0xc6, 0x8a, 0xfa
+};
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(ecc_vectors, "Public keys and signature of known values");
+UNIT_TEST(ecc_vectors)
+{
+  uint8_t public_key[ECC_CURVE_SIZE * 2];
+  uint8_t signature[ECC_CURVE_SIZE * 2];
+  size_t i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < sizeof(key_vectors) / sizeof(key_vectors[0]); i++) {
+    UNIT_TEST_ASSERT(uECC_compute_public_key(key_vectors[i].private_key,
+                                             public_key, uECC_secp256r1()));
+    UNIT_TEST_ASSERT(!memcmp(public_key, key_vectors[i].public_key,
+                             sizeof(public_key)));
+  }
+
+  UNIT_TEST_ASSERT(uECC_verify(key_vectors[i - 1].public_key,
+                               vector_hash, sizeof(vector_hash),
+                               vector_signature, uECC_secp256r1()));
+
+  memcpy(signature, vector_signature, sizeof(signature));
+  signature[sizeof(signature) - 1] ^= 1;
+  UNIT_TEST_ASSERT(!uECC_verify(key_vectors[i - 1].public_key,
+                                vector_hash, sizeof(vector_hash),
+                                signature, uECC_secp256r1()));
+  UNIT_TEST_ASSERT(!uECC_verify(key_vectors[0].public_key,
+                                vector_hash, sizeof(vector_hash),
+                                vector_signature, uECC_secp256r1()));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+#define BENCH_ROUNDS 50
+
+static uint64_t
+time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* The fastest run is reported, as it is the least disturbed by the host. */
+static uint64_t
+fastest(uint64_t start, uint64_t best)
+{
+  uint64_t elapsed = time_ns() - start;
+
+  return elapsed < best ? elapsed : best;
+}
+
+UNIT_TEST_REGISTER(ecc_bench, "ECC latency");
+UNIT_TEST(ecc_bench)
+{
+  uint8_t public_key[ECC_CURVE_SIZE * 2];
+  uint8_t private_key[ECC_CURVE_SIZE];
+  uint8_t secret[ECC_CURVE_SIZE];
+  uint8_t peer_secret[ECC_CURVE_SIZE];
+  uint8_t signature[ECC_CURVE_SIZE * 2];
+  uint64_t start;
+  uint64_t keygen_time = UINT64_MAX;
+  uint64_t sign_time = UINT64_MAX;
+  uint64_t verify_time = UINT64_MAX;
+  uint64_t ecdh_time = UINT64_MAX;
+  unsigned ok = 0;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  /* The ECC driver installs the RNG that uECC needs for keys and nonces. */
+  PT_WAIT_UNTIL(&unit_test_pt, process_mutex_try_lock(ecc_get_mutex()));
+  UNIT_TEST_ASSERT(!ecc_enable(ECC_CURVE));
+
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    start = time_ns();
+    ok += uECC_make_key(public_key, private_key, uECC_secp256r1());
+    keygen_time = fastest(start, keygen_time);
+  }
+
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    start = time_ns();
+    ok += uECC_sign(private_key, vector_hash, sizeof(vector_hash),
+                    signature, uECC_secp256r1());
+    sign_time = fastest(start, sign_time);
+  }
+
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    start = time_ns();
+    ok += uECC_verify(public_key, vector_hash, sizeof(vector_hash),
+                      signature, uECC_secp256r1());
+    verify_time = fastest(start, verify_time);
+  }
+
+  for(i = 0; i < BENCH_ROUNDS; i++) {
+    start = time_ns();
+    ok += uECC_shared_secret(key_vectors[3].public_key, private_key,
+                             secret, uECC_secp256r1());
+    ecdh_time = fastest(start, ecdh_time);
+  }
+
+  ok += uECC_shared_secret(public_key, key_vectors[3].private_key,
+                           peer_secret, uECC_secp256r1());
+
+  ecc_disable();
+
+  printf("P-256 (comb table %u bytes, verify window %u): "
+         "keygen %.2f ms, sign %.2f ms, verify %.2f ms, ECDH %.2f ms\n",
+         uECC_FIXED_BASE_COMB ? 15 * ECC_CURVE_SIZE * 2 : 0,
+         uECC_VERIFY_WINDOW,
+         keygen_time / 1e6, sign_time / 1e6,
+         verify_time / 1e6, ecdh_time / 1e6);
+
+  UNIT_TEST_ASSERT(ok == 4 * BENCH_ROUNDS + 1);
+  UNIT_TEST_ASSERT(!memcmp(secret, peer_secret, sizeof(secret)));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
 PROCESS_THREAD(test_process, ev, data)
 {
   PROCESS_BEGIN();
@@ -222,10 +418,14 @@ PROCESS_THREAD(test_process, ev, data)
   UNIT_TEST_RUN(ecc_compress);
   UNIT_TEST_RUN(ecc_ecdh);
   UNIT_TEST_RUN(ecc_ecdsa);
+  UNIT_TEST_RUN(ecc_vectors);
+  UNIT_TEST_RUN(ecc_bench);
 
   if(!UNIT_TEST_PASSED(ecc_compress)
      || !UNIT_TEST_PASSED(ecc_ecdh)
-     || !UNIT_TEST_PASSED(ecc_ecdsa)) {
+     || !UNIT_TEST_PASSED(ecc_ecdsa)
+     || !UNIT_TEST_PASSED(ecc_vectors)
+     || !UNIT_TEST_PASSED(ecc_bench)) {
     printf("=check-me= FAILED\n");
     printf("---\n");
   }
@@ -0,0 +1,576 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests and benchmarks for the Antelope database.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "cfs/cfs-coffee.h"
+#include "antelope.h"
+#include "lvm.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* The number of rows inserted into the sample relation. */
+#ifdef TEST_CONF_ROWS
+#define TEST_ROWS TEST_CONF_ROWS
+#else
+#define TEST_ROWS       2000
+#endif
+
+/* The number of full scans done when measuring the scan throughput. */
+#ifdef TEST_CONF_SCANS
+#define TEST_SCANS TEST_CONF_SCANS
+#else
+#define TEST_SCANS       500
+#endif
+
+/* The number of times each join is repeated when measuring join time. */
+#ifdef TEST_CONF_JOINS
+#define TEST_JOINS TEST_CONF_JOINS
+#else
+#define TEST_JOINS        50
+#endif
+
+/* The number of passes over the sample values when measuring the
+   cost of evaluating a predicate. */
+#ifdef TEST_CONF_PREDICATE_PASSES
+#define TEST_PREDICATE_PASSES TEST_CONF_PREDICATE_PASSES
+#else
+#define TEST_PREDICATE_PASSES 2000
+#endif
+
+#define SAMPLE_VALUE(id) (((id) * 7) % 1000)
+
+/* Each device has four readings in the join tests. */
+#define READINGS_PER_DEVICE 4
+/*****************************************************************************/
+PROCESS(test_antelope_process, "Antelope test process");
+AUTOSTART_PROCESSES(&test_antelope_process);
+/*****************************************************************************/
+static db_handle_t handle;
+/*****************************************************************************/
+static db_result_t
+run_query(const char *query, unsigned long *matches)
+{
+  db_result_t result;
+
+  *matches = 0;
+
+  result = db_query(&handle, "%s", query);
+  if(DB_ERROR(result)) {
+    printf("Query \"%s\" failed: %s\n", query, db_get_result_message(result));
+    db_free(&handle);
+    return result;
+  }
+
+  while(db_processing(&handle)) {
+    result = db_process(&handle);
+    if(result == DB_GOT_ROW) {
+      (*matches)++;
+    } else if(result != DB_OK) {
+      break;
+    }
+  }
+
+  db_free(&handle);
+
+  if(DB_ERROR(result)) {
+    printf("Processing \"%s\" failed: %s\n",
+           query, db_get_result_message(result));
+    return result;
+  }
+
+  return DB_OK;
+}
+/*****************************************************************************/
+static unsigned long
+count_expected(int (*match)(unsigned long, unsigned long))
+{
+  unsigned long id;
+  unsigned long count;
+
+  for(id = count = 0; id < TEST_ROWS; id++) {
+    if(match(id, SAMPLE_VALUE(id))) {
+      count++;
+    }
+  }
+  return count;
+}
+/*****************************************************************************/
+static int
+match_value_range(unsigned long id, unsigned long value)
+{
+  return value > 100 && value <= 200;
+}
+/*****************************************************************************/
+static int
+match_constant_first(unsigned long id, unsigned long value)
+{
+  return id > 1500;
+}
+/*****************************************************************************/
+static int
+match_disjunction(unsigned long id, unsigned long value)
+{
+  return id < 10 || value > 990;
+}
+/*****************************************************************************/
+static int
+match_arithmetic(unsigned long id, unsigned long value)
+{
+  return id + value < 300;
+}
+/*****************************************************************************/
+static int
+match_folded(unsigned long id, unsigned long value)
+{
+  return value > 100 && id < 1500 && value != 107;
+}
+/*****************************************************************************/
+static int
+match_reordered(unsigned long id, unsigned long value)
+{
+  return id + value < 600 && id < 100;
+}
+/*****************************************************************************/
+static int
+match_small_id(unsigned long id, unsigned long value)
+{
+  return id < 100;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(populate, "Populate a relation");
+UNIT_TEST(populate)
+{
+  unsigned long id;
+  unsigned long matches;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(cfs_coffee_format() == 0);
+  db_init();
+
+  UNIT_TEST_ASSERT(DB_SUCCESS(db_query(NULL, "CREATE RELATION samples;")));
+  UNIT_TEST_ASSERT(DB_SUCCESS(db_query(NULL,
+      "CREATE ATTRIBUTE id DOMAIN INT IN samples;")));
+  UNIT_TEST_ASSERT(DB_SUCCESS(db_query(NULL,
+      "CREATE ATTRIBUTE value DOMAIN LONG IN samples;")));
+
+  for(id = 0; id < TEST_ROWS; id++) {
+    UNIT_TEST_ASSERT(DB_SUCCESS(db_query(NULL, "INSERT (%lu, %lu) INTO samples;",
+                                         id, SAMPLE_VALUE(id))));
+  }
+
+  UNIT_TEST_ASSERT(run_query("SELECT id FROM samples;", &matches) == DB_OK);
+  UNIT_TEST_ASSERT(matches == TEST_ROWS);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(selections, "Selections with predicates");
+UNIT_TEST(selections)
+{
+  unsigned long matches;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(run_query("SELECT id FROM samples WHERE value > 100 AND value <= 200;",
+                             &matches) == DB_OK);
+  UNIT_TEST_ASSERT(matches == count_expected(match_value_range));
+
+  UNIT_TEST_ASSERT(run_query("SELECT id FROM samples WHERE 1500 < id;",
+                             &matches) == DB_OK);
+  UNIT_TEST_ASSERT(matches == count_expected(match_constant_first));
+
+  UNIT_TEST_ASSERT(run_query("SELECT id FROM samples WHERE id < 10 OR value > 990;",
+                             &matches) == DB_OK);
+  UNIT_TEST_ASSERT(matches == count_expected(match_disjunction));
+
+  UNIT_TEST_ASSERT(run_query("SELECT id FROM samples WHERE id + value < 300;",
+                             &matches) == DB_OK);
+  UNIT_TEST_ASSERT(matches == count_expected(match_arithmetic));
+
+  UNIT_TEST_ASSERT(run_query("SELECT id FROM samples WHERE value > 50 * 2 AND 1000 + 500 > id AND value <> 107;",
+                             &matches) == DB_OK);
+  UNIT_TEST_ASSERT(matches == count_expected(match_folded));
+
+  UNIT_TEST_ASSERT(run_query("SELECT id FROM samples WHERE id + value < 600 AND id < 100;",
+                             &matches) == DB_OK);
+  UNIT_TEST_ASSERT(matches == count_expected(match_reordered));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(scan_throughput, "Scan throughput");
+UNIT_TEST(scan_throughput)
+{
+  static unsigned scan;
+  unsigned long matches;
+  clock_time_t start;
+  clock_time_t ticks;
+
+  UNIT_TEST_BEGIN();
+
+  start = clock_time();
+  for(scan = 0; scan < TEST_SCANS; scan++) {
+    UNIT_TEST_ASSERT(run_query("SELECT id FROM samples WHERE value < 50;",
+                               &matches) == DB_OK);
+  }
+  ticks = clock_time() - start;
+  if(ticks == 0) {
+    ticks = 1;
+  }
+
+  printf("Scanned %lu rows in %lu ticks: %lu rows/s (scan buffer %u bytes)\n",
+         (unsigned long)TEST_ROWS * TEST_SCANS, (unsigned long)ticks,
+         (unsigned long)((unsigned long long)TEST_ROWS * TEST_SCANS *
+                         CLOCK_SECOND / ticks),
+         (unsigned)DB_SCAN_BUFFER_SIZE);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+static lvm_instance_t predicate;
+static unsigned char predicate_code[DB_VM_BYTECODE_SIZE];
+/*****************************************************************************/
+static void
+build_folded(void)
+{
+  /* value > 50 * 2 AND 1000 + 500 > id AND value <> 107 */
+  lvm_set_relation(&predicate, LVM_AND);
+  lvm_set_relation(&predicate, LVM_GE);
+  lvm_set_variable(&predicate, "value");
+  lvm_set_op(&predicate, LVM_MUL);
+  lvm_set_long(&predicate, 50);
+  lvm_set_long(&predicate, 2);
+  lvm_set_relation(&predicate, LVM_AND);
+  lvm_set_relation(&predicate, LVM_GE);
+  lvm_set_op(&predicate, LVM_ADD);
+  lvm_set_long(&predicate, 1000);
+  lvm_set_long(&predicate, 500);
+  lvm_set_variable(&predicate, "id");
+  lvm_set_relation(&predicate, LVM_NEQ);
+  lvm_set_variable(&predicate, "value");
+  lvm_set_long(&predicate, 107);
+}
+/*****************************************************************************/
+static void
+build_reordered(void)
+{
+  /* id + value < 600 AND id < 100 */
+  lvm_set_relation(&predicate, LVM_AND);
+  lvm_set_relation(&predicate, LVM_LE);
+  lvm_set_op(&predicate, LVM_ADD);
+  lvm_set_variable(&predicate, "id");
+  lvm_set_variable(&predicate, "value");
+  lvm_set_long(&predicate, 600);
+  lvm_set_relation(&predicate, LVM_LE);
+  lvm_set_variable(&predicate, "id");
+  lvm_set_long(&predicate, 100);
+}
+/*****************************************************************************/
+static int
+time_predicate(const char *name, void (*build)(void),
+               int (*match)(unsigned long, unsigned long), int optimize)
+{
+  unsigned long id;
+  unsigned long pass;
+  unsigned long count;
+  operand_value_t value;
+  variable_id_t id_variable;
+  variable_id_t value_variable;
+  clock_time_t start;
+  clock_time_t ticks;
+
+  lvm_reset(&predicate, predicate_code, sizeof(predicate_code));
+  lvm_register_variable("id", LVM_LONG);
+  lvm_register_variable("value", LVM_LONG);
+  build();
+  if(optimize && LVM_ERROR(lvm_optimize(&predicate))) {
+    return 0;
+  }
+
+  id_variable = lvm_get_variable_id("id");
+  value_variable = lvm_get_variable_id("value");
+
+  count = 0;
+  start = clock_time();
+  for(pass = 0; pass < TEST_PREDICATE_PASSES; pass++) {
+    for(id = 0; id < TEST_ROWS; id++) {
+      value.l = id;
+      lvm_set_variable_value_by_id(id_variable, value);
+      value.l = SAMPLE_VALUE(id);
+      lvm_set_variable_value_by_id(value_variable, value);
+      if(lvm_execute(&predicate) == LVM_TRUE) {
+        count++;
+      }
+    }
+  }
+  ticks = clock_time() - start;
+  if(ticks == 0) {
+    ticks = 1;
+  }
+
+  printf("Predicate %s (%s): %lu ns/row\n", name,
+         optimize ? "optimized" : "interpreted",
+         (unsigned long)((unsigned long long)ticks * 1000000000 /
+                         CLOCK_SECOND / TEST_ROWS / TEST_PREDICATE_PASSES));
+
+  return count == count_expected(match) * TEST_PREDICATE_PASSES;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(predicates, "Predicate evaluation");
+UNIT_TEST(predicates)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(time_predicate("folded", build_folded, match_folded, 0));
+  UNIT_TEST_ASSERT(time_predicate("folded", build_folded, match_folded, 1));
+  UNIT_TEST_ASSERT(time_predicate("reordered", build_reordered,
+                                  match_reordered, 0));
+  UNIT_TEST_ASSERT(time_predicate("reordered", build_reordered,
+                                  match_reordered, 1));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+static lvm_instance_t other_predicate;
+static unsigned char other_predicate_code[DB_VM_BYTECODE_SIZE];
+/*****************************************************************************/
+UNIT_TEST_REGISTER(interleaved_predicates, "Interleaved predicates");
+UNIT_TEST(interleaved_predicates)
+{
+  unsigned long id;
+  unsigned long count;
+  unsigned long other_count;
+  operand_value_t value;
+
+  UNIT_TEST_BEGIN();
+
+  /* Both predicates are optimized before either is executed, so each
+     one must keep its own compiled comparisons. */
+  lvm_reset(&predicate, predicate_code, sizeof(predicate_code));
+  lvm_register_variable("id", LVM_LONG);
+  lvm_register_variable("value", LVM_LONG);
+  build_folded();
+  UNIT_TEST_ASSERT(!LVM_ERROR(lvm_optimize(&predicate)));
+
+  /* id < 100 */
+  lvm_reset(&other_predicate, other_predicate_code,
+            sizeof(other_predicate_code));
+  lvm_register_variable("id", LVM_LONG);
+  lvm_register_variable("value", LVM_LONG);
+  lvm_set_relation(&other_predicate, LVM_LE);
+  lvm_set_variable(&other_predicate, "id");
+  lvm_set_long(&other_predicate, 100);
+  UNIT_TEST_ASSERT(!LVM_ERROR(lvm_optimize(&other_predicate)));
+
+  count = 0;
+  other_count = 0;
+  for(id = 0; id < TEST_ROWS; id++) {
+    value.l = id;
+    lvm_set_variable_value("id", value);
+    value.l = SAMPLE_VALUE(id);
+    lvm_set_variable_value("value", value);
+    if(lvm_execute(&predicate) == LVM_TRUE) {
+      count++;
+    }
+    if(lvm_execute(&other_predicate) == LVM_TRUE) {
+      other_count++;
+    }
+  }
+  UNIT_TEST_ASSERT(count == count_expected(match_folded));
+  UNIT_TEST_ASSERT(other_count == count_expected(match_small_id));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+static const char *
+join_method(void)
+{
+  if(handle.flags & DB_HANDLE_FLAG_HASH_JOIN) {
+    return "hash";
+  } else if(handle.flags & DB_HANDLE_FLAG_MERGE_JOIN) {
+    return "merge";
+  }
+  return "index";
+}
+/*****************************************************************************/
+static int
+time_join(const char *query, unsigned long expected, const char *method)
+{
+  unsigned i;
+  unsigned long matches;
+  clock_time_t start;
+  const char *selected_method;
+
+  selected_method = NULL;
+  start = clock_time();
+  for(i = 0; i < TEST_JOINS; i++) {
+    if(DB_ERROR(db_query(&handle, "%s", query))) {
+      printf("Query \"%s\" failed\n", query);
+      db_free(&handle);
+      return 0;
+    }
+    selected_method = join_method();
+
+    for(matches = 0; db_processing(&handle);) {
+      db_result_t result = db_process(&handle);
+      if(result == DB_GOT_ROW) {
+        matches++;
+      } else if(result != DB_OK) {
+        break;
+      }
+    }
+    db_free(&handle);
+
+    if(matches != expected) {
+      printf("Join \"%s\" returned %lu rows; expected %lu\n",
+             query, matches, expected);
+      return 0;
+    }
+  }
+
+  printf("%s join of %lu rows: %lu ticks for %u joins\n", selected_method,
+         expected, (unsigned long)(clock_time() - start), TEST_JOINS);
+
+  return method == NULL || strcmp(selected_method, method) == 0;
+}
+/*****************************************************************************/
+static int
+create_join_relations(unsigned long devices, int index_devices,
+                      int index_readings)
+{
+  unsigned long i;
+
+  db_query(NULL, "REMOVE RELATION devices;");
+  db_query(NULL, "REMOVE RELATION readings;");
+
+  if(DB_ERROR(db_query(NULL, "CREATE RELATION devices;")) ||
+     DB_ERROR(db_query(NULL, "CREATE ATTRIBUTE id DOMAIN INT IN devices;")) ||
+     DB_ERROR(db_query(NULL, "CREATE ATTRIBUTE kind DOMAIN INT IN devices;")) ||
+     DB_ERROR(db_query(NULL, "CREATE RELATION readings;")) ||
+     DB_ERROR(db_query(NULL, "CREATE ATTRIBUTE id DOMAIN INT IN readings;")) ||
+     DB_ERROR(db_query(NULL, "CREATE ATTRIBUTE temp DOMAIN LONG IN readings;"))) {
+    return 0;
+  }
+
+  /* Inline indexes are ready immediately when created for empty relations. */
+  if(index_devices &&
+     DB_ERROR(db_query(NULL, "CREATE INDEX devices.id TYPE INLINE;"))) {
+    return 0;
+  }
+  if(index_readings &&
+     DB_ERROR(db_query(NULL, "CREATE INDEX readings.id TYPE INLINE;"))) {
+    return 0;
+  }
+
+  for(i = 0; i < devices; i++) {
+    if(DB_ERROR(db_query(NULL, "INSERT (%lu, %lu) INTO devices;", i, i % 3))) {
+      return 0;
+    }
+  }
+
+  for(i = 0; i < devices * READINGS_PER_DEVICE; i++) {
+    if(DB_ERROR(db_query(NULL, "INSERT (%lu, %lu) INTO readings;",
+                         i / READINGS_PER_DEVICE, SAMPLE_VALUE(i)))) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(joins, "Join methods");
+UNIT_TEST(joins)
+{
+  static unsigned long devices;
+  unsigned long readings;
+
+  UNIT_TEST_BEGIN();
+
+  for(devices = 25; devices <= 200; devices *= 2) {
+    readings = devices * READINGS_PER_DEVICE;
+
+    /* Without indexes, only the hash join is possible. */
+    UNIT_TEST_ASSERT(create_join_relations(devices, 0, 0));
+    UNIT_TEST_ASSERT(time_join("JOIN devices, readings ON id PROJECT kind, temp;",
+                               readings, "hash"));
+    UNIT_TEST_ASSERT(time_join("JOIN readings, devices ON id PROJECT kind, temp;",
+                               readings, "hash"));
+
+    /* The cost rule chooses between an index join and a hash join. */
+    UNIT_TEST_ASSERT(create_join_relations(devices, 1, 0));
+    UNIT_TEST_ASSERT(time_join("JOIN readings, devices ON id PROJECT kind, temp;",
+                               readings, NULL));
+
+    /* Both relations are ordered on the join attribute. */
+    UNIT_TEST_ASSERT(create_join_relations(devices, 1, 1));
+    UNIT_TEST_ASSERT(time_join("JOIN devices, readings ON id PROJECT kind, temp;",
+                               readings, "merge"));
+    UNIT_TEST_ASSERT(time_join("JOIN readings, devices ON id PROJECT kind, temp;",
+                               readings, "merge"));
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_antelope_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(populate);
+  UNIT_TEST_RUN(selections);
+  UNIT_TEST_RUN(scan_throughput);
+  UNIT_TEST_RUN(predicates);
+  UNIT_TEST_RUN(interleaved_predicates);
+  UNIT_TEST_RUN(joins);
+
+  if(!UNIT_TEST_PASSED(populate) ||
+     !UNIT_TEST_PASSED(selections) ||
+     !UNIT_TEST_PASSED(scan_throughput) ||
+     !UNIT_TEST_PASSED(predicates) ||
+     !UNIT_TEST_PASSED(joins)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests and benchmarks for the time-series storage module.
+ */
+
+#include <stdio.h>
+
+#include "contiki.h"
+#include "cfs/cfs.h"
+#if TEST_CONF_COFFEE
+#include "cfs/cfs-coffee.h"
+#endif
+#include "antelope.h"
+#include "relation.h"
+#include "tsdb.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* The number of samples stored in the series. */
+#ifdef TEST_CONF_SAMPLES
+#define TEST_SAMPLES TEST_CONF_SAMPLES
+#else
+#define TEST_SAMPLES    5000
+#endif
+
+/* The number of times each query is repeated when measuring its speed. */
+#ifdef TEST_CONF_QUERIES
+#define TEST_QUERIES TEST_CONF_QUERIES
+#else
+#define TEST_QUERIES     200
+#endif
+
+#define SERIES_FILE "series"
+
+/* The sampling period, and the times at which the queries start and end. */
+#define PERIOD        30
+#define QUERY_FROM    (PERIOD * (TEST_SAMPLES / 2))
+#define QUERY_TO      (QUERY_FROM + PERIOD * (TEST_SAMPLES / 10))
+/*****************************************************************************/
+PROCESS(test_tsdb_process, "Time-series storage test process");
+AUTOSTART_PROCESSES(&test_tsdb_process);
+/*****************************************************************************/
+static tsdb_t series;
+static tsdb_iterator_t iterator;
+static db_handle_t handle;
+/*****************************************************************************/
+/*
+ * Generate a sample of a slowly changing periodic signal. The
+ * timestamps have some jitter and an occasional long gap, and the
+ * values have occasional spikes, so all code lengths are exercised.
+ */
+static void
+generate_sample(unsigned long i, tsdb_sample_t *sample)
+{
+  sample->time = PERIOD * i + (i % 17 == 0 ? 3 : 0) +
+    (i >= TEST_SAMPLES - 10 ? 1000000 : 0);
+  sample->value = 2000 + (int32_t)(i % 100) - (int32_t)((i / 100) % 2 * 100);
+  if(i % 777 == 0) {
+    sample->value = -1000000 * (int32_t)(i % 3);
+  }
+}
+/*****************************************************************************/
+static unsigned long
+count_expected(uint32_t from, uint32_t to, int32_t min, int32_t max)
+{
+  unsigned long i;
+  unsigned long count;
+  tsdb_sample_t sample;
+
+  for(i = count = 0; i < TEST_SAMPLES; i++) {
+    generate_sample(i, &sample);
+    if(sample.time >= from && sample.time <= to &&
+       sample.value >= min && sample.value <= max) {
+      count++;
+    }
+  }
+  return count;
+}
+/*****************************************************************************/
+static long
+count_samples(uint32_t from, uint32_t to, int32_t min, int32_t max)
+{
+  tsdb_sample_t sample;
+  long count;
+  int r;
+
+  tsdb_iterate(&iterator, &series, from, to);
+  tsdb_iterate_values(&iterator, min, max);
+  for(count = 0; (r = tsdb_next(&iterator, &sample)) == 1; count++);
+
+  return r < 0 ? -1 : count;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(roundtrip, "Store and read samples");
+UNIT_TEST(roundtrip)
+{
+  unsigned long i;
+  tsdb_sample_t expected;
+  tsdb_sample_t sample;
+
+  UNIT_TEST_BEGIN();
+
+#if TEST_CONF_COFFEE
+  UNIT_TEST_ASSERT(cfs_coffee_format() == 0);
+#else
+  cfs_remove(SERIES_FILE);
+#endif
+
+  UNIT_TEST_ASSERT(tsdb_open(&series, SERIES_FILE) == 0);
+  for(i = 0; i < TEST_SAMPLES / 2; i++) {
+    generate_sample(i, &sample);
+    UNIT_TEST_ASSERT(tsdb_append(&series, sample.time, sample.value) == 0);
+  }
+
+  /* Samples must not go back in time. */
+  UNIT_TEST_ASSERT(tsdb_append(&series, sample.time - 1, 0) < 0);
+
+  /* Appending continues in a new block after the series is reopened. */
+  tsdb_close(&series);
+  UNIT_TEST_ASSERT(tsdb_open(&series, SERIES_FILE) == 0);
+  UNIT_TEST_ASSERT(tsdb_append(&series, sample.time - 1, 0) < 0);
+  for(; i < TEST_SAMPLES; i++) {
+    generate_sample(i, &sample);
+    UNIT_TEST_ASSERT(tsdb_append(&series, sample.time, sample.value) == 0);
+  }
+
+  /* Read back all samples, including those that are only in RAM. */
+  tsdb_iterate(&iterator, &series, TSDB_TIME_MIN, TSDB_TIME_MAX);
+  for(i = 0; i < TEST_SAMPLES; i++) {
+    generate_sample(i, &expected);
+    UNIT_TEST_ASSERT(tsdb_next(&iterator, &sample) == 1);
+    UNIT_TEST_ASSERT(sample.time == expected.time);
+    UNIT_TEST_ASSERT(sample.value == expected.value);
+  }
+  UNIT_TEST_ASSERT(tsdb_next(&iterator, &sample) == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(queries, "Time and value range queries");
+UNIT_TEST(queries)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(count_samples(QUERY_FROM, QUERY_TO,
+                                 TSDB_VALUE_MIN, TSDB_VALUE_MAX) ==
+                   count_expected(QUERY_FROM, QUERY_TO,
+                                  TSDB_VALUE_MIN, TSDB_VALUE_MAX));
+  UNIT_TEST_ASSERT(count_samples(QUERY_FROM, QUERY_TO, 1950, 2000) ==
+                   count_expected(QUERY_FROM, QUERY_TO, 1950, 2000));
+  UNIT_TEST_ASSERT(count_samples(TSDB_TIME_MIN, TSDB_TIME_MAX,
+                                 TSDB_VALUE_MIN, -1) ==
+                   count_expected(TSDB_TIME_MIN, TSDB_TIME_MAX,
+                                  TSDB_VALUE_MIN, -1));
+  UNIT_TEST_ASSERT(count_samples(0, 0, TSDB_VALUE_MIN, TSDB_VALUE_MAX) ==
+                   count_expected(0, 0, TSDB_VALUE_MIN, TSDB_VALUE_MAX));
+  UNIT_TEST_ASSERT(count_samples(TSDB_TIME_MAX, TSDB_TIME_MAX,
+                                 TSDB_VALUE_MIN, TSDB_VALUE_MAX) == 0);
+
+  /* The last block is written when the series is closed. */
+  tsdb_close(&series);
+  UNIT_TEST_ASSERT(tsdb_open(&series, SERIES_FILE) == 0);
+  UNIT_TEST_ASSERT(count_samples(TSDB_TIME_MIN, TSDB_TIME_MAX,
+                                 TSDB_VALUE_MIN, TSDB_VALUE_MAX) ==
+                   TEST_SAMPLES);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+static int
+antelope_query(const char *query, unsigned long *matches)
+{
+  db_result_t result;
+
+  *matches = 0;
+  result = db_query(&handle, "%s", query);
+  if(DB_ERROR(result)) {
+    return 0;
+  }
+
+  while(db_processing(&handle)) {
+    result = db_process(&handle);
+    if(result == DB_GOT_ROW) {
+      (*matches)++;
+    } else if(result != DB_OK) {
+      break;
+    }
+  }
+  db_free(&handle);
+
+  return DB_SUCCESS(result);
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(benchmark, "Compare with Antelope");
+UNIT_TEST(benchmark)
+{
+  static char query[80];
+  unsigned long i;
+  unsigned long matches;
+  unsigned long expected;
+  tsdb_sample_t sample;
+  relation_t *rel;
+  clock_time_t start;
+  clock_time_t tsdb_ticks;
+  clock_time_t antelope_ticks;
+
+  UNIT_TEST_BEGIN();
+
+  db_init();
+  db_query(NULL, "REMOVE RELATION samples;");
+  UNIT_TEST_ASSERT(DB_SUCCESS(db_query(NULL, "CREATE RELATION samples;")));
+  UNIT_TEST_ASSERT(DB_SUCCESS(db_query(NULL,
+      "CREATE ATTRIBUTE time DOMAIN LONG IN samples;")));
+  UNIT_TEST_ASSERT(DB_SUCCESS(db_query(NULL,
+      "CREATE ATTRIBUTE value DOMAIN LONG IN samples;")));
+  for(i = 0; i < TEST_SAMPLES; i++) {
+    generate_sample(i, &sample);
+    UNIT_TEST_ASSERT(DB_SUCCESS(db_query(NULL,
+        "INSERT (%lu, %ld) INTO samples;",
+        (unsigned long)sample.time, (long)sample.value)));
+  }
+
+  rel = relation_load("samples");
+  UNIT_TEST_ASSERT(rel != NULL);
+  printf("Bytes per sample: tsdb %lu.%02lu, Antelope %lu\n",
+         tsdb_size(&series) / TEST_SAMPLES,
+         tsdb_size(&series) * 100 / TEST_SAMPLES % 100,
+         (unsigned long)rel->row_length);
+  relation_release(rel);
+
+  expected = count_expected(QUERY_FROM, QUERY_TO,
+                            TSDB_VALUE_MIN, TSDB_VALUE_MAX);
+
+  start = clock_time();
+  for(i = 0; i < TEST_QUERIES; i++) {
+    UNIT_TEST_ASSERT(count_samples(QUERY_FROM, QUERY_TO,
+                                   TSDB_VALUE_MIN, TSDB_VALUE_MAX) ==
+                     expected);
+  }
+  tsdb_ticks = clock_time() - start;
+
+  snprintf(query, sizeof(query),
+           "SELECT value FROM samples WHERE time >= %lu AND time <= %lu;",
+           (unsigned long)QUERY_FROM, (unsigned long)QUERY_TO);
+  start = clock_time();
+  for(i = 0; i < TEST_QUERIES; i++) {
+    UNIT_TEST_ASSERT(antelope_query(query, &matches));
+    UNIT_TEST_ASSERT(matches == expected);
+  }
+  antelope_ticks = clock_time() - start;
+
+  printf("Time range query of %lu samples: tsdb %lu ticks, Antelope %lu ticks for %u queries\n",
+         expected, (unsigned long)tsdb_ticks, (unsigned long)antelope_ticks,
+         TEST_QUERIES);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_tsdb_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(roundtrip);
+  UNIT_TEST_RUN(queries);
+  UNIT_TEST_RUN(benchmark);
+
+  /* Leave no files behind when running on the host file system. */
+  tsdb_close(&series);
+  cfs_remove(SERIES_FILE);
+  db_query(NULL, "REMOVE RELATION samples;");
+
+  if(!UNIT_TEST_PASSED(roundtrip) ||
+     !UNIT_TEST_PASSED(queries) ||
+     !UNIT_TEST_PASSED(benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
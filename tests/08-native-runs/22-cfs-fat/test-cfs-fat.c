@@ -0,0 +1,397 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests and benchmarks for the CFS implementation on top of FatFs.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "cfs/cfs.h"
+#include "cfs-fat.h"
+#include "disk-cache.h"
+#include "disk-file.h"
+#include "antelope.h"
+#include "lib/random.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* The size of the file that is checked against a copy in RAM. */
+#define CHECK_FILE_SIZE  (64 * 1024UL)
+
+/* The size of the file used for measuring throughput. */
+#ifdef TEST_CONF_BENCHMARK_SIZE
+#define BENCHMARK_SIZE TEST_CONF_BENCHMARK_SIZE
+#else
+#define BENCHMARK_SIZE   (1024 * 1024UL)
+#endif
+
+/* The number of random accesses in the benchmark. */
+#define RANDOM_ACCESSES  4000
+
+#define CHECK_FILE      "check.bin"
+#define BENCHMARK_FILE  "bench.bin"
+/*****************************************************************************/
+PROCESS(test_cfs_fat_process, "CFS on FatFs test process");
+AUTOSTART_PROCESSES(&test_cfs_fat_process);
+/*****************************************************************************/
+static uint8_t mirror[CHECK_FILE_SIZE];
+static uint8_t buf[4096];
+/*****************************************************************************/
+static unsigned long
+random_offset(unsigned long limit)
+{
+  return (((unsigned long)random_rand() << 16) | random_rand()) % limit;
+}
+/*****************************************************************************/
+static int
+file_matches_mirror(void)
+{
+  unsigned long offset;
+  int fd;
+  int r;
+
+  fd = cfs_open(CHECK_FILE, CFS_READ);
+  if(fd < 0) {
+    return 0;
+  }
+  for(offset = 0; offset < CHECK_FILE_SIZE; offset += r) {
+    r = cfs_read(fd, buf, 1000);
+    if(r <= 0 || memcmp(buf, &mirror[offset], r) != 0) {
+      break;
+    }
+  }
+  r = cfs_read(fd, buf, 1);
+  cfs_close(fd);
+  return offset == CHECK_FILE_SIZE && r == 0;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(files, "File operations");
+UNIT_TEST(files)
+{
+  struct cfs_dir dir;
+  struct cfs_dirent dirent;
+  int fds[CFS_FAT_MAX_OPEN_FILES];
+  int found;
+  int fd;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(cfs_fat_format() == 0);
+
+  fd = cfs_open("a.txt", CFS_WRITE);
+  UNIT_TEST_ASSERT(fd >= 0);
+  UNIT_TEST_ASSERT(cfs_write(fd, "hello", 5) == 5);
+  cfs_close(fd);
+
+  fd = cfs_open("a.txt", CFS_READ);
+  UNIT_TEST_ASSERT(fd >= 0);
+  UNIT_TEST_ASSERT(cfs_read(fd, buf, sizeof(buf)) == 5);
+  UNIT_TEST_ASSERT(memcmp(buf, "hello", 5) == 0);
+  UNIT_TEST_ASSERT(cfs_read(fd, buf, sizeof(buf)) == 0);
+  UNIT_TEST_ASSERT(cfs_write(fd, "x", 1) < 0);
+  cfs_close(fd);
+
+  /* Appending keeps the contents. */
+  fd = cfs_open("a.txt", CFS_WRITE | CFS_APPEND);
+  UNIT_TEST_ASSERT(fd >= 0);
+  UNIT_TEST_ASSERT(cfs_write(fd, " world", 6) == 6);
+  cfs_close(fd);
+
+  fd = cfs_open("a.txt", CFS_READ);
+  UNIT_TEST_ASSERT(cfs_read(fd, buf, sizeof(buf)) == 11);
+  UNIT_TEST_ASSERT(memcmp(buf, "hello world", 11) == 0);
+  UNIT_TEST_ASSERT(cfs_seek(fd, 0, CFS_SEEK_END) == 11);
+  UNIT_TEST_ASSERT(cfs_seek(fd, -5, CFS_SEEK_CUR) == 6);
+  UNIT_TEST_ASSERT(cfs_read(fd, buf, 5) == 5);
+  UNIT_TEST_ASSERT(memcmp(buf, "world", 5) == 0);
+  UNIT_TEST_ASSERT(cfs_seek(fd, -1, CFS_SEEK_SET) == (cfs_offset_t)-1);
+  cfs_close(fd);
+
+  /* Opening for writing without appending truncates the file. */
+  fd = cfs_open("a.txt", CFS_WRITE);
+  UNIT_TEST_ASSERT(cfs_write(fd, "x", 1) == 1);
+  cfs_close(fd);
+
+  UNIT_TEST_ASSERT(cfs_opendir(&dir, "/") == 0);
+  found = 0;
+  while(cfs_readdir(&dir, &dirent) == 0) {
+    if(strcmp(dirent.name, "a.txt") == 0 && dirent.size == 1) {
+      found = 1;
+    }
+  }
+  cfs_closedir(&dir);
+  UNIT_TEST_ASSERT(found);
+
+  UNIT_TEST_ASSERT(cfs_remove("a.txt") == 0);
+  UNIT_TEST_ASSERT(cfs_open("a.txt", CFS_READ) < 0);
+  UNIT_TEST_ASSERT(cfs_remove("a.txt") < 0);
+
+  /* The number of open files is limited. */
+  for(i = 0; i < CFS_FAT_MAX_OPEN_FILES; i++) {
+    snprintf((char *)buf, sizeof(buf), "f%d", i);
+    fds[i] = cfs_open((char *)buf, CFS_WRITE);
+    UNIT_TEST_ASSERT(fds[i] >= 0);
+  }
+  UNIT_TEST_ASSERT(cfs_open("extra", CFS_WRITE) < 0);
+  for(i = 0; i < CFS_FAT_MAX_OPEN_FILES; i++) {
+    cfs_close(fds[i]);
+    snprintf((char *)buf, sizeof(buf), "f%d", i);
+    UNIT_TEST_ASSERT(cfs_remove((char *)buf) == 0);
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(consistency, "Random writes against a copy in RAM");
+UNIT_TEST(consistency)
+{
+  unsigned long offset;
+  unsigned len;
+  int fd;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  random_init(1);
+  for(offset = 0; offset < CHECK_FILE_SIZE; offset++) {
+    mirror[offset] = random_rand();
+  }
+
+  /* Write the file in chunks that are not aligned to sectors. */
+  fd = cfs_open(CHECK_FILE, CFS_READ | CFS_WRITE);
+  UNIT_TEST_ASSERT(fd >= 0);
+  for(offset = 0; offset < CHECK_FILE_SIZE; offset += len) {
+    len = 1 + random_rand() % 1500;
+    if(len > CHECK_FILE_SIZE - offset) {
+      len = CHECK_FILE_SIZE - offset;
+    }
+    UNIT_TEST_ASSERT(cfs_write(fd, &mirror[offset], len) == len);
+  }
+
+  /* Overwrite and read back random ranges, some of which span
+     several sectors. */
+  for(i = 0; i < 500; i++) {
+    len = 1 + random_rand() % 2000;
+    offset = random_offset(CHECK_FILE_SIZE - len);
+    UNIT_TEST_ASSERT(cfs_seek(fd, offset, CFS_SEEK_SET) == offset);
+    if(i % 2 == 0) {
+      memset(&mirror[offset], i, len);
+      UNIT_TEST_ASSERT(cfs_write(fd, &mirror[offset], len) == len);
+    } else {
+      UNIT_TEST_ASSERT(cfs_read(fd, buf, len) == len);
+      UNIT_TEST_ASSERT(memcmp(buf, &mirror[offset], len) == 0);
+    }
+  }
+  cfs_close(fd);
+  UNIT_TEST_ASSERT(file_matches_mirror());
+
+  /* The data must also be on the disk after remounting, which drops
+     both the FatFs buffers and the sector cache. */
+  cfs_fat_unmount();
+  UNIT_TEST_ASSERT(cfs_fat_mount() == 0);
+  UNIT_TEST_ASSERT(file_matches_mirror());
+
+  UNIT_TEST_ASSERT(cfs_remove(CHECK_FILE) == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(antelope, "Antelope relation on FatFs");
+UNIT_TEST(antelope)
+{
+  db_handle_t handle;
+  db_result_t result;
+  unsigned long rows;
+  unsigned long i;
+
+  UNIT_TEST_BEGIN();
+
+  db_init();
+  UNIT_TEST_ASSERT(DB_SUCCESS(db_query(NULL, "CREATE RELATION samples;")));
+  UNIT_TEST_ASSERT(DB_SUCCESS(db_query(NULL,
+      "CREATE ATTRIBUTE id DOMAIN INT IN samples;")));
+  UNIT_TEST_ASSERT(DB_SUCCESS(db_query(NULL,
+      "CREATE ATTRIBUTE value DOMAIN LONG IN samples;")));
+  for(i = 0; i < 200; i++) {
+    UNIT_TEST_ASSERT(DB_SUCCESS(db_query(NULL,
+        "INSERT (%lu, %lu) INTO samples;", i, i % 10)));
+  }
+
+  UNIT_TEST_ASSERT(DB_SUCCESS(db_query(&handle,
+      "SELECT id FROM samples WHERE value = 3;")));
+  rows = 0;
+  while(db_processing(&handle)) {
+    result = db_process(&handle);
+    if(result == DB_GOT_ROW) {
+      rows++;
+    } else if(result != DB_OK) {
+      break;
+    }
+  }
+  db_free(&handle);
+  UNIT_TEST_ASSERT(rows == 20);
+
+  UNIT_TEST_ASSERT(DB_SUCCESS(db_query(NULL, "REMOVE RELATION samples;")));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+static void
+print_result(const char *name, unsigned long bytes, clock_time_t ticks)
+{
+  struct disk_cache_stats stats;
+  unsigned long ms;
+
+  disk_cache_get_stats(&stats);
+  ms = (unsigned long)ticks * 1000 / CLOCK_SECOND;
+  printf("%-22s %6lu KiB/s, %6lu disk requests (%lu sectors), "
+         "%lu%% cache hits\n",
+         name, ms == 0 ? 0 : bytes * 1000 / 1024 / ms,
+         (unsigned long)(stats.disk_reads + stats.disk_writes),
+         (unsigned long)(stats.sectors_read + stats.sectors_written),
+         stats.hits + stats.misses == 0 ? 0 :
+         (unsigned long)stats.hits * 100 / (stats.hits + stats.misses));
+}
+/*****************************************************************************/
+static int
+sequential(int flags, unsigned chunk)
+{
+  unsigned long offset;
+  int fd;
+  int r;
+
+  fd = cfs_open(BENCHMARK_FILE, flags);
+  if(fd < 0) {
+    return 0;
+  }
+  memset(buf, 0x5a, sizeof(buf));
+  for(offset = 0; offset < BENCHMARK_SIZE; offset += chunk) {
+    r = (flags & CFS_WRITE) ? cfs_write(fd, buf, chunk) :
+      cfs_read(fd, buf, chunk);
+    if(r != chunk) {
+      break;
+    }
+  }
+  cfs_close(fd);
+  return offset == BENCHMARK_SIZE;
+}
+/*****************************************************************************/
+static int
+random_access(int flags, unsigned chunk)
+{
+  int fd;
+  int i;
+  int r;
+
+  fd = cfs_open(BENCHMARK_FILE, flags);
+  if(fd < 0) {
+    return 0;
+  }
+  for(i = 0; i < RANDOM_ACCESSES; i++) {
+    cfs_seek(fd, random_offset(BENCHMARK_SIZE / chunk) * chunk, CFS_SEEK_SET);
+    r = (flags & CFS_WRITE) ? cfs_write(fd, buf, chunk) :
+      cfs_read(fd, buf, chunk);
+    if(r != chunk) {
+      break;
+    }
+  }
+  cfs_close(fd);
+  return i == RANDOM_ACCESSES;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(benchmark, "Throughput");
+UNIT_TEST(benchmark)
+{
+  clock_time_t start;
+
+  UNIT_TEST_BEGIN();
+
+  printf("Cache: %u lines of %u sectors\n",
+         DISK_CACHE_LINES, DISK_CACHE_LINE_SECTORS);
+
+#define MEASURE(name, bytes, call) do {                 \
+    disk_cache_reset_stats();                           \
+    start = clock_time();                               \
+    UNIT_TEST_ASSERT(call);                             \
+    print_result(name, bytes, clock_time() - start);    \
+  } while(0)
+
+  random_init(2);
+  MEASURE("Sequential write 64 B", BENCHMARK_SIZE,
+          sequential(CFS_WRITE, 64));
+  MEASURE("Sequential read 64 B", BENCHMARK_SIZE,
+          sequential(CFS_READ, 64));
+  MEASURE("Sequential write 4 KiB", BENCHMARK_SIZE,
+          sequential(CFS_WRITE, 4096));
+  MEASURE("Sequential read 4 KiB", BENCHMARK_SIZE,
+          sequential(CFS_READ, 4096));
+  MEASURE("Random read 64 B", RANDOM_ACCESSES * 64UL,
+          random_access(CFS_READ, 64));
+  MEASURE("Random write 64 B", RANDOM_ACCESSES * 64UL,
+          random_access(CFS_READ | CFS_WRITE | CFS_APPEND, 64));
+
+  UNIT_TEST_ASSERT(cfs_remove(BENCHMARK_FILE) == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_cfs_fat_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(files);
+  UNIT_TEST_RUN(consistency);
+  UNIT_TEST_RUN(antelope);
+  UNIT_TEST_RUN(benchmark);
+
+  /* Leave no disk image behind. */
+  cfs_fat_unmount();
+  remove(DISK_FILE_NAME);
+
+  if(!UNIT_TEST_PASSED(files) ||
+     !UNIT_TEST_PASSED(consistency) ||
+     !UNIT_TEST_PASSED(antelope) ||
+     !UNIT_TEST_PASSED(benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
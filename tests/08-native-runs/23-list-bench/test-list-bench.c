@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      A benchmark comparing the singly-linked list module with the
+ *      circular, doubly-linked list module in the access patterns of
+ *      the route table and the CSMA neighbor queues.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "contiki.h"
+#include "lib/list.h"
+#include "lib/dbl-circ-list.h"
+#include "unit-test/unit-test.h"
+
+PROCESS(test_list_bench_process, "List benchmark");
+AUTOSTART_PROCESSES(&test_list_bench_process);
+
+#define MAX_ELEMENTS 256
+#define OPERATIONS   100000
+
+struct sl_element {
+  struct sl_element *next;
+  unsigned id;
+};
+
+struct dl_element {
+  struct dl_element *next;
+  struct dl_element *previous;
+  unsigned id;
+};
+
+static struct sl_element sl_elements[MAX_ELEMENTS];
+static struct dl_element dl_elements[MAX_ELEMENTS];
+static uint16_t indices[OPERATIONS];
+
+LIST(sl_list);
+DBL_CIRC_LIST(dl_list);
+
+static const unsigned list_sizes[] = { 16, 64, 256 };
+
+enum workload {
+  MOVE_TO_FRONT, /* Route lookup: move the route to the head. */
+  EVICT_TAIL,    /* Route add: replace the least recently used route. */
+  REMOVE_APPEND  /* Neighbor queue: remove a neighbor, add one at the tail. */
+};
+/*****************************************************************************/
+static uint64_t
+time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*****************************************************************************/
+static void
+fill_lists(unsigned count)
+{
+  list_init(sl_list);
+  dbl_circ_list_init(dl_list);
+  memset(sl_elements, 0, sizeof(sl_elements));
+  memset(dl_elements, 0, sizeof(dl_elements));
+
+  for(unsigned i = 0; i < count; i++) {
+    sl_elements[i].id = i;
+    dl_elements[i].id = i;
+    list_add(sl_list, &sl_elements[i]);
+    dbl_circ_list_add_tail(dl_list, &dl_elements[i]);
+  }
+}
+/*****************************************************************************/
+static uint64_t
+run_sl(enum workload workload)
+{
+  struct sl_element *e;
+  uint64_t start = time_ns();
+
+  for(unsigned i = 0; i < OPERATIONS; i++) {
+    switch(workload) {
+    case MOVE_TO_FRONT:
+      e = &sl_elements[indices[i]];
+      list_remove(sl_list, e);
+      list_push(sl_list, e);
+      break;
+    case EVICT_TAIL:
+      e = list_tail(sl_list);
+      list_remove(sl_list, e);
+      list_push(sl_list, e);
+      break;
+    case REMOVE_APPEND:
+      e = &sl_elements[indices[i]];
+      list_remove(sl_list, e);
+      list_add(sl_list, e);
+      break;
+    }
+  }
+
+  return time_ns() - start;
+}
+/*****************************************************************************/
+static uint64_t
+run_dl(enum workload workload)
+{
+  struct dl_element *e;
+  uint64_t start = time_ns();
+
+  for(unsigned i = 0; i < OPERATIONS; i++) {
+    switch(workload) {
+    case MOVE_TO_FRONT:
+      dbl_circ_list_add_head(dl_list, &dl_elements[indices[i]]);
+      break;
+    case EVICT_TAIL:
+      e = dbl_circ_list_tail(dl_list);
+      dbl_circ_list_remove(dl_list, e);
+      dbl_circ_list_add_head(dl_list, e);
+      break;
+    case REMOVE_APPEND:
+      e = &dl_elements[indices[i]];
+      dbl_circ_list_remove(dl_list, e);
+      dbl_circ_list_add_tail(dl_list, e);
+      break;
+    }
+  }
+
+  return time_ns() - start;
+}
+/*****************************************************************************/
+static bool
+same_order(unsigned count)
+{
+  struct sl_element *s = list_head(sl_list);
+  struct dl_element *d = dbl_circ_list_head(dl_list);
+
+  for(unsigned i = 0; i < count; i++) {
+    if(s == NULL || d == NULL || s->id != d->id) {
+      return false;
+    }
+    s = list_item_next(s);
+    d = d->next;
+  }
+
+  return s == NULL && d == dbl_circ_list_head(dl_list);
+}
+/*****************************************************************************/
+static bool
+bench(const char *name, enum workload workload)
+{
+  for(unsigned i = 0; i < sizeof(list_sizes) / sizeof(list_sizes[0]); i++) {
+    unsigned count = list_sizes[i];
+    uint64_t sl_time;
+    uint64_t dl_time;
+
+    for(unsigned j = 0; j < OPERATIONS; j++) {
+      indices[j] = rand() % count;
+    }
+
+    fill_lists(count);
+    sl_time = run_sl(workload);
+    dl_time = run_dl(workload);
+
+    printf("%-13s %3u elements: list %6.1f ns/op, dbl-circ-list %6.1f ns/op\n",
+           name, count, (double)sl_time / OPERATIONS,
+           (double)dl_time / OPERATIONS);
+
+    if(list_length(sl_list) != count ||
+       dbl_circ_list_length(dl_list) != count ||
+       !same_order(count)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(move_to_front, "Move to front");
+UNIT_TEST(move_to_front)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(bench("move-to-front", MOVE_TO_FRONT));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(evict_tail, "Evict tail");
+UNIT_TEST(evict_tail)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(bench("evict-tail", EVICT_TAIL));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(remove_append, "Remove and append");
+UNIT_TEST(remove_append)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(bench("remove-append", REMOVE_APPEND));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_list_bench_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  srand(500);
+
+  UNIT_TEST_RUN(move_to_front);
+  UNIT_TEST_RUN(evict_tail);
+  UNIT_TEST_RUN(remove_append);
+
+  if(!UNIT_TEST_PASSED(move_to_front) ||
+     !UNIT_TEST_PASSED(evict_tail) ||
+     !UNIT_TEST_PASSED(remove_append)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,440 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Unit test of the streaming JSON tokenizer and writer.
+ */
+
+#include "contiki.h"
+#include "jsonparse.h"
+#include "jsonstream.h"
+#include "jsonwriter.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* The tokens of a document in a compact form, such as N(name)0(1)t. */
+struct trace {
+  char text[512];
+  int len;
+  int in_string;
+  int tokens;
+};
+
+/*---------------------------------------------------------------------------*/
+static void
+trace_append(struct trace *trace, const char *text, int len)
+{
+  if(trace->len + len < (int)sizeof(trace->text)) {
+    memcpy(trace->text + trace->len, text, len);
+    trace->len += len;
+    trace->text[trace->len] = '\0';
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+trace_token(struct jsonstream_state *state, int type, const char *value,
+            int len, int last)
+{
+  struct trace *trace = state->ptr;
+  char c = type;
+
+  switch(type) {
+  case JSON_TYPE_PAIR_NAME:
+  case JSON_TYPE_STRING:
+  case JSON_TYPE_NUMBER:
+    if(!trace->in_string) {
+      trace_append(trace, &c, 1);
+      trace_append(trace, "(", 1);
+      trace->in_string = 1;
+    }
+    trace_append(trace, value, len);
+    if(last) {
+      trace_append(trace, ")", 1);
+      trace->in_string = 0;
+    }
+    break;
+  default:
+    trace_append(trace, &c, 1);
+    break;
+  }
+  trace->tokens += last;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+tokenize(const char *json, int chunk_size, struct trace *trace)
+{
+  struct jsonstream_state state;
+  int len = strlen(json);
+  int n;
+  int error;
+
+  memset(trace, 0, sizeof(*trace));
+  jsonstream_setup(&state, trace_token, trace);
+  for(int i = 0; i < len; i += n) {
+    n = len - i < chunk_size ? len - i : chunk_size;
+    error = jsonstream_feed(&state, json + i, n);
+    if(error != JSON_ERROR_OK) {
+      return error;
+    }
+  }
+  return jsonstream_finish(&state);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_tokens, "Tokenize chunked documents");
+UNIT_TEST(test_tokens)
+{
+  static const char json[] =
+    " {\"name\" : \"caf\\u00e9 \\\"x\\\"\",\n"
+    "  \"list\":[1, -2.5e3, true,false ,null, [ ], {}],\r\n"
+    "  \"emoji\":\"\\ud83d\\ude00\", \"n\":{\"deep\":[0]}}\t";
+  static const char tokens[] =
+    "{N(name)\"(caf\xc3\xa9 \"x\")"
+    "N(list)[0(1)0(-2.5e3)tfn[]{}]"
+    "N(emoji)\"(\xf0\x9f\x98\x80)N(n){N(deep)[0(0)]}}";
+  static const int chunk_sizes[] = { sizeof(json), 1, 2, 3, 7, 16 };
+  struct trace trace;
+
+  UNIT_TEST_BEGIN();
+
+  for(int i = 0; i < (int)(sizeof(chunk_sizes) / sizeof(chunk_sizes[0])); i++) {
+    UNIT_TEST_ASSERT(tokenize(json, chunk_sizes[i], &trace) == JSON_ERROR_OK);
+    UNIT_TEST_ASSERT(!strcmp(trace.text, tokens));
+    UNIT_TEST_ASSERT(trace.tokens == 25);
+  }
+
+  /* a number at the top level ends with the document */
+  UNIT_TEST_ASSERT(tokenize("-12.5", 2, &trace) == JSON_ERROR_OK);
+  UNIT_TEST_ASSERT(!strcmp(trace.text, "0(-12.5)"));
+  UNIT_TEST_ASSERT(tokenize("\"\"", 1, &trace) == JSON_ERROR_OK);
+  UNIT_TEST_ASSERT(!strcmp(trace.text, "\"()"));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+static int
+abort_on_number(struct jsonstream_state *state, int type, const char *value,
+                int len, int last)
+{
+  return type == JSON_TYPE_NUMBER;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_errors, "Reject malformed documents");
+UNIT_TEST(test_errors)
+{
+  static const char *const malformed[] = {
+    "", "{\"a\" 1}", "[1,]", "{\"a\":1,}", "[1 2]", "01", "1.", "-", "1e",
+    "\"abc", "tru", "trUe", "[1]]", "[}", "{]", "{1:2}", "{\"a\"}", "[1] 2",
+    "\"\x01\"", "\"\\x\"", "\"\\u12g4\"", "\"\\ud800x\"", "\"\\ude00\"",
+    "[\"a\",", "{\"a\":[1}"
+  };
+  char deep[JSONSTREAM_MAX_DEPTH + 2];
+  char long_number[JSONSTREAM_NUMBER_SIZE + 2];
+  struct jsonstream_state state;
+  struct trace trace;
+
+  UNIT_TEST_BEGIN();
+
+  for(int i = 0; i < (int)(sizeof(malformed) / sizeof(malformed[0])); i++) {
+    for(int chunk_size = 1; chunk_size <= 4; chunk_size++) {
+      UNIT_TEST_ASSERT(tokenize(malformed[i], chunk_size, &trace)
+                       != JSON_ERROR_OK);
+    }
+  }
+
+  memset(deep, '[', sizeof(deep) - 1);
+  deep[sizeof(deep) - 1] = '\0';
+  UNIT_TEST_ASSERT(tokenize(deep, 8, &trace) == JSON_ERROR_TOO_DEEP);
+  UNIT_TEST_ASSERT(tokenize(deep + 1, 8, &trace) == JSON_ERROR_SYNTAX);
+
+  memset(long_number, '1', sizeof(long_number) - 1);
+  long_number[sizeof(long_number) - 1] = '\0';
+  UNIT_TEST_ASSERT(tokenize(long_number, 8, &trace) == JSON_ERROR_TOO_LONG);
+  UNIT_TEST_ASSERT(tokenize(long_number + 1, 8, &trace) == JSON_ERROR_OK);
+
+  /* the callback can stop the tokenizer, which then stays stopped */
+  jsonstream_setup(&state, abort_on_number, NULL);
+  UNIT_TEST_ASSERT(jsonstream_feed(&state, "[\"a\",1,", 7)
+                   == JSON_ERROR_ABORTED);
+  UNIT_TEST_ASSERT(jsonstream_feed(&state, "2]", 2) == JSON_ERROR_ABORTED);
+  UNIT_TEST_ASSERT(jsonstream_finish(&state) == JSON_ERROR_ABORTED);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+struct sink {
+  char text[512];
+  int len;
+  int flushes;
+};
+
+static int
+sink_flush(struct jsonwriter *writer, const char *data, int len)
+{
+  struct sink *sink = writer->ptr;
+
+  if(sink->len + len >= (int)sizeof(sink->text)) {
+    return 1;
+  }
+  memcpy(sink->text + sink->len, data, len);
+  sink->len += len;
+  sink->text[sink->len] = '\0';
+  sink->flushes++;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+write_document(struct jsonwriter *writer)
+{
+  jsonwriter_object_start(writer);
+  jsonwriter_name(writer, "name");
+  jsonwriter_string(writer, "caf\xc3\xa9 \"x\"\n\x01");
+  jsonwriter_name(writer, "list");
+  jsonwriter_array_start(writer);
+  jsonwriter_int(writer, 1);
+  jsonwriter_int(writer, -2500);
+  jsonwriter_bool(writer, 1);
+  jsonwriter_bool(writer, 0);
+  jsonwriter_null(writer);
+  jsonwriter_array_start(writer);
+  jsonwriter_array_end(writer);
+  jsonwriter_object_start(writer);
+  jsonwriter_object_end(writer);
+  jsonwriter_array_end(writer);
+  jsonwriter_name(writer, "max");
+  jsonwriter_uint(writer, 4294967295UL);
+  jsonwriter_name(writer, "n");
+  jsonwriter_object_start(writer);
+  jsonwriter_name(writer, "deep");
+  jsonwriter_array_start(writer);
+  jsonwriter_int(writer, 0);
+  jsonwriter_array_end(writer);
+  jsonwriter_object_end(writer);
+  jsonwriter_object_end(writer);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_writer, "Write documents");
+UNIT_TEST(test_writer)
+{
+  static const char json[] =
+    "{\"name\":\"caf\xc3\xa9 \\\"x\\\"\\n\\u0001\","
+    "\"list\":[1,-2500,true,false,null,[],{}],"
+    "\"max\":4294967295,\"n\":{\"deep\":[0]}}";
+  static const char tokens[] =
+    "{N(name)\"(caf\xc3\xa9 \"x\"\n\x01)"
+    "N(list)[0(1)0(-2500)tfn[]{}]"
+    "N(max)0(4294967295)N(n){N(deep)[0(0)]}}";
+  struct jsonwriter writer;
+  struct sink sink;
+  struct trace trace;
+  char buf[128];
+
+  UNIT_TEST_BEGIN();
+
+  /* the whole document in the buffer */
+  jsonwriter_setup(&writer, buf, sizeof(buf), NULL, NULL);
+  write_document(&writer);
+  UNIT_TEST_ASSERT(jsonwriter_end(&writer) == sizeof(json) - 1);
+  UNIT_TEST_ASSERT(!strcmp(buf, json));
+  UNIT_TEST_ASSERT(tokenize(buf, 5, &trace) == JSON_ERROR_OK);
+  UNIT_TEST_ASSERT(!strcmp(trace.text, tokens));
+
+  /* a small buffer that is flushed when full */
+  memset(&sink, 0, sizeof(sink));
+  jsonwriter_setup(&writer, buf, 16, sink_flush, &sink);
+  write_document(&writer);
+  UNIT_TEST_ASSERT(jsonwriter_end(&writer) == sizeof(json) - 1);
+  UNIT_TEST_ASSERT(!strcmp(sink.text, json));
+  UNIT_TEST_ASSERT(sink.flushes == (sizeof(json) - 1 + 15) / 16);
+
+  /* a small buffer without flushing */
+  jsonwriter_setup(&writer, buf, 16, NULL, NULL);
+  write_document(&writer);
+  UNIT_TEST_ASSERT(jsonwriter_end(&writer) == -1);
+  UNIT_TEST_ASSERT(writer.error == JSON_ERROR_TOO_LONG);
+
+  /* incomplete and misnested documents */
+  jsonwriter_setup(&writer, buf, sizeof(buf), NULL, NULL);
+  jsonwriter_array_start(&writer);
+  UNIT_TEST_ASSERT(jsonwriter_end(&writer) == -1);
+  jsonwriter_setup(&writer, buf, sizeof(buf), NULL, NULL);
+  jsonwriter_array_start(&writer);
+  jsonwriter_object_end(&writer);
+  UNIT_TEST_ASSERT(jsonwriter_end(&writer) == -1);
+  jsonwriter_setup(&writer, buf, sizeof(buf), NULL, NULL);
+  jsonwriter_array_start(&writer);
+  jsonwriter_name(&writer, "a");
+  UNIT_TEST_ASSERT(jsonwriter_end(&writer) == -1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+#define BENCH_RECORDS 200
+#define BENCH_ROUNDS 200
+#define BENCH_CHUNK_SIZE 512
+
+static char document[BENCH_RECORDS * 96];
+static long document_len;
+
+static uint64_t
+time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* The fastest run is reported, as it is the least disturbed by the host. */
+static uint64_t
+fastest(uint64_t start, uint64_t best)
+{
+  uint64_t elapsed = time_ns() - start;
+
+  return elapsed < best ? elapsed : best;
+}
+/*---------------------------------------------------------------------------*/
+static int
+count_token(struct jsonstream_state *state, int type, const char *value,
+            int len, int last)
+{
+  (*(int *)state->ptr) += last;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_bench, "Tokenizer throughput");
+UNIT_TEST(test_bench)
+{
+  struct jsonwriter writer;
+  struct jsonparse_state parser;
+  struct jsonstream_state state;
+  char name[16];
+  uint64_t start;
+  uint64_t parse_time = UINT64_MAX;
+  uint64_t stream_time = UINT64_MAX;
+  int parse_tokens = 0;
+  int stream_tokens = 0;
+  int error = JSON_ERROR_OK;
+
+  UNIT_TEST_BEGIN();
+
+  /* an array of sensor readings, as a REST API might return */
+  jsonwriter_setup(&writer, document, sizeof(document), NULL, NULL);
+  jsonwriter_array_start(&writer);
+  for(int i = 0; i < BENCH_RECORDS; i++) {
+    snprintf(name, sizeof(name), "sensor-%d", i);
+    jsonwriter_object_start(&writer);
+    jsonwriter_name(&writer, "id");
+    jsonwriter_int(&writer, i);
+    jsonwriter_name(&writer, "name");
+    jsonwriter_string(&writer, name);
+    jsonwriter_name(&writer, "value");
+    jsonwriter_int(&writer, -123 * i);
+    jsonwriter_name(&writer, "ok");
+    jsonwriter_bool(&writer, i & 1);
+    jsonwriter_name(&writer, "tags");
+    jsonwriter_array_start(&writer);
+    jsonwriter_string(&writer, "indoor");
+    jsonwriter_string(&writer, "temperature");
+    jsonwriter_array_end(&writer);
+    jsonwriter_object_end(&writer);
+  }
+  jsonwriter_array_end(&writer);
+  document_len = jsonwriter_end(&writer);
+  UNIT_TEST_ASSERT(document_len > 0);
+
+  for(int round = 0; round < BENCH_ROUNDS; round++) {
+    /* jsonparse needs the whole document in RAM */
+    parse_tokens = 0;
+    start = time_ns();
+    jsonparse_setup(&parser, document, document_len);
+    while(jsonparse_next(&parser) != 0) {
+      parse_tokens++;
+    }
+    parse_time = fastest(start, parse_time);
+
+    stream_tokens = 0;
+    start = time_ns();
+    jsonstream_setup(&state, count_token, &stream_tokens);
+    for(long i = 0; i < document_len; i += BENCH_CHUNK_SIZE) {
+      jsonstream_feed(&state, document + i,
+                      document_len - i < BENCH_CHUNK_SIZE
+                      ? document_len - i : BENCH_CHUNK_SIZE);
+    }
+    error |= jsonstream_finish(&state);
+    stream_time = fastest(start, stream_time);
+  }
+
+  printf("%ld bytes: jsonparse %lu ns (%d tokens), "
+         "jsonstream in %d-byte chunks %lu ns (%d tokens)\n",
+         document_len, (unsigned long)parse_time, parse_tokens,
+         BENCH_CHUNK_SIZE, (unsigned long)stream_time, stream_tokens);
+  printf("State: jsonparse %d bytes + document, jsonstream %d bytes\n",
+         (int)sizeof(parser), (int)sizeof(state));
+
+  UNIT_TEST_ASSERT(error == JSON_ERROR_OK);
+  UNIT_TEST_ASSERT(parser.error == JSON_ERROR_OK);
+  UNIT_TEST_ASSERT(stream_tokens == BENCH_RECORDS * 15 + 2);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(test_tokens);
+  UNIT_TEST_RUN(test_errors);
+  UNIT_TEST_RUN(test_writer);
+  UNIT_TEST_RUN(test_bench);
+
+  if(!UNIT_TEST_PASSED(test_tokens)
+     || !UNIT_TEST_PASSED(test_errors)
+     || !UNIT_TEST_PASSED(test_writer)
+     || !UNIT_TEST_PASSED(test_bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Unit test of the CRC16 implementations.
+ */
+
+#include "contiki.h"
+#include "lib/crc16.h"
+#include "lib/random.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+/*---------------------------------------------------------------------------*/
+/* The reference is computed one bit at a time from the definition. */
+static unsigned short
+reference_crc16(const unsigned char *data, int len, unsigned short acc)
+{
+  while(len--) {
+    acc ^= *data++;
+    for(int bit = 0; bit < 8; bit++) {
+      acc = acc & 1 ? (acc >> 1) ^ 0x8408 : acc >> 1;
+    }
+  }
+  return acc;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_vectors, "CRC16 test vectors");
+UNIT_TEST(test_vectors)
+{
+  static const struct {
+    const char *data;
+    unsigned short acc;
+    unsigned short crc;
+  } vectors[] = {
+    { "", 0x0000, 0x0000 },
+    { "", 0x1234, 0x1234 },
+    { "123456789", 0x0000, 0x2189 },  /* CRC-16/KERMIT */
+    { "123456789", 0xffff, 0x6f91 },  /* CRC-16/MCRF4XX */
+    { "123456789", 0x554d, 0x63d0 },  /* CRC-16/RIELLO */
+    { "A", 0x0000, 0x538d },
+    { "The quick brown fox jumps over the lazy dog", 0x0000, 0xc459 },
+  };
+  static unsigned char data[300];
+  unsigned short crc;
+
+  UNIT_TEST_BEGIN();
+
+  for(int i = 0; i < (int)(sizeof(vectors) / sizeof(vectors[0])); i++) {
+    const unsigned char *text = (const unsigned char *)vectors[i].data;
+    int len = strlen(vectors[i].data);
+
+    UNIT_TEST_ASSERT(crc16_data(text, len, vectors[i].acc) == vectors[i].crc);
+    UNIT_TEST_ASSERT(reference_crc16(text, len, vectors[i].acc)
+                     == vectors[i].crc);
+    crc = vectors[i].acc;
+    for(int j = 0; j < len; j++) {
+      crc = crc16_add(text[j], crc);
+    }
+    UNIT_TEST_ASSERT(crc == vectors[i].crc);
+  }
+
+  /* all lengths, alignments, and split points */
+  for(int i = 0; i < (int)sizeof(data); i++) {
+    data[i] = random_rand();
+  }
+  for(int offset = 0; offset < 8; offset++) {
+    for(int len = 0; len <= (int)sizeof(data) - offset; len += 1 + len / 16) {
+      unsigned short expected = reference_crc16(data + offset, len, 0xffff);
+      int split = len / 3;
+
+      UNIT_TEST_ASSERT(crc16_data(data + offset, len, 0xffff) == expected);
+      crc = crc16_data(data + offset, split, 0xffff);
+      crc = crc16_data(data + offset + split, len - split, crc);
+      UNIT_TEST_ASSERT(crc == expected);
+    }
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+#define BENCH_ROUNDS 50
+
+static uint64_t
+time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* The fastest run is reported, as it is the least disturbed by the host. */
+static uint64_t
+fastest(uint64_t start, uint64_t best)
+{
+  uint64_t elapsed = time_ns() - start;
+
+  return elapsed < best ? elapsed : best;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_bench, "CRC16 throughput");
+UNIT_TEST(test_bench)
+{
+  static unsigned char data[64 * 1024];
+  static const int sizes[] = { 16, 128, sizeof(data) };
+  volatile unsigned short crc = 0;
+  unsigned short expected;
+  uint64_t start;
+  uint64_t best;
+  int reps;
+
+  UNIT_TEST_BEGIN();
+
+  for(int i = 0; i < (int)sizeof(data); i++) {
+    data[i] = random_rand();
+  }
+
+  for(int s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); s++) {
+    /* short blocks, such as frames, are checksummed repeatedly */
+    reps = sizeof(data) / sizes[s];
+    best = UINT64_MAX;
+    for(int round = 0; round < BENCH_ROUNDS; round++) {
+      start = time_ns();
+      for(int i = 0; i < reps; i++) {
+        crc = crc16_data(data + i * sizes[s], sizes[s], crc);
+      }
+      best = fastest(start, best);
+    }
+    printf("CRC16 method %d, %d-byte blocks: %lu MB/s\n",
+           CRC16_METHOD, sizes[s],
+           (unsigned long)(sizeof(data) * 1000ULL / best));
+  }
+
+  expected = reference_crc16(data, sizeof(data), 0);
+  UNIT_TEST_ASSERT(crc16_data(data, sizeof(data), 0) == expected);
+  (void)crc;
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(test_vectors);
+  UNIT_TEST_RUN(test_bench);
+
+  if(!UNIT_TEST_PASSED(test_vectors) || !UNIT_TEST_PASSED(test_bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
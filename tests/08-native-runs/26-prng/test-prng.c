@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Unit test of the seedable pseudo-random number streams.
+ */
+
+#include "contiki.h"
+#include "lib/prng.h"
+#include "lib/random.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_generator, "Generator outputs");
+UNIT_TEST(test_generator)
+{
+  /* the reference outputs of xoshiro128** for the state {1, 2, 3, 4} */
+  static const uint32_t expected[] = {
+    11520, 0, 5927040, 70819200, 2031721883, 1637235492
+  };
+  prng_t prng = { { 1, 2, 3, 4 } };
+  prng_t a;
+  prng_t b;
+  unsigned short sequence[8];
+
+  UNIT_TEST_BEGIN();
+
+  for(int i = 0; i < (int)(sizeof(expected) / sizeof(expected[0])); i++) {
+    UNIT_TEST_ASSERT(prng_rand32(&prng) == expected[i]);
+  }
+
+  /* seeding is reproducible, and streams differ */
+  prng_seed(&a, 42, 0);
+  UNIT_TEST_ASSERT(prng_rand32(&a) == 0x250c2552);
+  UNIT_TEST_ASSERT(prng_rand32(&a) == 0xa5a2cc57);
+  prng_seed(&a, 42, 0);
+  prng_seed(&b, 42, 0);
+  UNIT_TEST_ASSERT(prng_rand64(&a) == prng_rand64(&b));
+  prng_seed(&b, 42, 1);
+  UNIT_TEST_ASSERT(prng_rand64(&a) != prng_rand64(&b));
+  prng_seed(&b, 43, 0);
+  UNIT_TEST_ASSERT(prng_rand64(&a) != prng_rand64(&b));
+
+  /* random_rand() stays reproducible for a seed */
+  random_init(5);
+  for(int i = 0; i < 8; i++) {
+    sequence[i] = random_rand();
+  }
+  random_init(5);
+  for(int i = 0; i < 8; i++) {
+    UNIT_TEST_ASSERT(random_rand() == sequence[i]);
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_streams, "Independent streams");
+UNIT_TEST(test_streams)
+{
+  uint32_t trickle[8];
+
+  UNIT_TEST_BEGIN();
+
+  prng_set_seed(1234);
+  for(int i = 0; i < 8; i++) {
+    trickle[i] = prng_rand32(prng_stream(PRNG_STREAM_TRICKLE));
+  }
+
+  /* drawing from other streams does not change the trickle stream */
+  prng_set_seed(1234);
+  for(int i = 0; i < 8; i++) {
+    prng_rand32(prng_stream(PRNG_STREAM_MAC));
+    random_rand();
+    UNIT_TEST_ASSERT(prng_rand32(prng_stream(PRNG_STREAM_TRICKLE))
+                     == trickle[i]);
+  }
+
+  prng_set_seed(1235);
+  UNIT_TEST_ASSERT(prng_rand32(prng_stream(PRNG_STREAM_TRICKLE))
+                   != trickle[0]);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_bounded, "Bounded numbers without bias");
+UNIT_TEST(test_bounded)
+{
+  prng_t prng;
+  uint32_t value;
+  int counts[3] = { 0 };
+  int low = 0;
+  const int draws = 300000;
+
+  UNIT_TEST_BEGIN();
+
+  prng_seed(&prng, 1, 0);
+  UNIT_TEST_ASSERT(prng_uniform(&prng, 0) == 0);
+  UNIT_TEST_ASSERT(prng_uniform(&prng, 1) == 0);
+  UNIT_TEST_ASSERT(prng_range(&prng, 7, 7) == 7);
+
+  for(int i = 0; i < 10000; i++) {
+    value = prng_range(&prng, 10, 20);
+    UNIT_TEST_ASSERT(value >= 10 && value <= 20);
+    value = prng_range(&prng, UINT32_MAX - 1, UINT32_MAX);
+    UNIT_TEST_ASSERT(value >= UINT32_MAX - 1);
+    prng_range(&prng, 0, UINT32_MAX);
+  }
+
+  for(int i = 0; i < draws; i++) {
+    counts[prng_uniform(&prng, 3)]++;
+  }
+  for(int i = 0; i < 3; i++) {
+    UNIT_TEST_ASSERT(abs(counts[i] - draws / 3) < draws / 100);
+  }
+
+  /*
+   * With a bound of 3 * 2^30, prng_rand32() % bound would return the
+   * quarter below 2^30 twice as often as the rest. Without bias, a
+   * third of the results fall there.
+   */
+  for(int i = 0; i < draws; i++) {
+    low += prng_uniform(&prng, 0xc0000000) < 0x40000000;
+  }
+  UNIT_TEST_ASSERT(abs(low - draws / 3) < draws / 100);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+#define BENCH_DRAWS 100000
+#define BENCH_ROUNDS 20
+
+static uint64_t
+time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* The fastest run is reported, as it is the least disturbed by the host. */
+static uint64_t
+fastest(uint64_t start, uint64_t best)
+{
+  uint64_t elapsed = time_ns() - start;
+
+  return elapsed < best ? elapsed : best;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_bench, "Generator speed");
+UNIT_TEST(test_bench)
+{
+  static const char *const names[] = {
+    "libc rand()", "random_rand()", "prng_rand32()", "prng_rand64()",
+    "prng_rand32() % 1000", "prng_uniform(1000)"
+  };
+  uint64_t best[sizeof(names) / sizeof(names[0])];
+  volatile uint64_t sink = 0;
+  uint64_t start;
+  prng_t prng;
+
+  UNIT_TEST_BEGIN();
+
+  prng_seed(&prng, 1, 0);
+  for(int n = 0; n < (int)(sizeof(names) / sizeof(names[0])); n++) {
+    best[n] = UINT64_MAX;
+    for(int round = 0; round < BENCH_ROUNDS; round++) {
+      start = time_ns();
+      for(int i = 0; i < BENCH_DRAWS; i++) {
+        switch(n) {
+        case 0: sink += rand(); break;
+        case 1: sink += random_rand(); break;
+        case 2: sink += prng_rand32(&prng); break;
+        case 3: sink += prng_rand64(&prng); break;
+        case 4: sink += prng_rand32(&prng) % 1000; break;
+        case 5: sink += prng_uniform(&prng, 1000); break;
+        }
+      }
+      best[n] = fastest(start, best[n]);
+    }
+    printf("%-22s %5.2f ns\n", names[n], (double)best[n] / BENCH_DRAWS);
+  }
+  (void)sink;
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(test_generator);
+  UNIT_TEST_RUN(test_streams);
+  UNIT_TEST_RUN(test_bounded);
+  UNIT_TEST_RUN(test_bench);
+
+  if(!UNIT_TEST_PASSED(test_generator)
+     || !UNIT_TEST_PASSED(test_streams)
+     || !UNIT_TEST_PASSED(test_bounded)
+     || !UNIT_TEST_PASSED(test_bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
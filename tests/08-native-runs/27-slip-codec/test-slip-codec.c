@@ -0,0 +1,354 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Unit test of the SLIP codec.
+ */
+
+#include "contiki.h"
+#include "lib/slip-codec.h"
+#include "lib/random.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define MAX_FRAME 1500
+
+/*---------------------------------------------------------------------------*/
+/* The reference escapes one byte at a time, as the host tools used to. */
+static size_t
+reference_encode(uint8_t *dst, const uint8_t *src, size_t len, int xonxoff)
+{
+  size_t n = 0;
+
+  for(size_t i = 0; i < len; i++) {
+    switch(src[i]) {
+    case SLIP_CODEC_END:
+      dst[n++] = SLIP_CODEC_ESC;
+      dst[n++] = SLIP_CODEC_ESC_END;
+      break;
+    case SLIP_CODEC_ESC:
+      dst[n++] = SLIP_CODEC_ESC;
+      dst[n++] = SLIP_CODEC_ESC_ESC;
+      break;
+    case SLIP_CODEC_XON:
+    case SLIP_CODEC_XOFF:
+      if(xonxoff) {
+        dst[n++] = SLIP_CODEC_ESC;
+        dst[n++] = src[i] == SLIP_CODEC_XON ?
+          SLIP_CODEC_ESC_XON : SLIP_CODEC_ESC_XOFF;
+        break;
+      }
+      /* FALLTHROUGH */
+    default:
+      dst[n++] = src[i];
+      break;
+    }
+  }
+  dst[n++] = SLIP_CODEC_END;
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+struct reference_decoder {
+  uint8_t buf[MAX_FRAME];
+  size_t len;
+  int escaped;
+};
+
+/* Returns the length of a received frame, or 0. */
+static size_t
+reference_decode_byte(struct reference_decoder *r, uint8_t c)
+{
+  size_t len;
+
+  if(r->escaped) {
+    r->escaped = 0;
+    switch(c) {
+    case SLIP_CODEC_ESC_END:
+      c = SLIP_CODEC_END;
+      break;
+    case SLIP_CODEC_ESC_ESC:
+      c = SLIP_CODEC_ESC;
+      break;
+    case SLIP_CODEC_ESC_XON:
+      c = SLIP_CODEC_XON;
+      break;
+    case SLIP_CODEC_ESC_XOFF:
+      c = SLIP_CODEC_XOFF;
+      break;
+    }
+  } else if(c == SLIP_CODEC_END) {
+    len = r->len;
+    r->len = 0;
+    return len;
+  } else if(c == SLIP_CODEC_ESC) {
+    r->escaped = 1;
+    return 0;
+  }
+  r->buf[r->len++] = c;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Payloads with few special bytes, or with many. */
+static void
+fill(uint8_t *data, size_t len, int dense)
+{
+  static const uint8_t special[] = {
+    SLIP_CODEC_END, SLIP_CODEC_ESC, SLIP_CODEC_XON, SLIP_CODEC_XOFF, '\n'
+  };
+
+  for(size_t i = 0; i < len; i++) {
+    data[i] = random_rand();
+    if(dense && (random_rand() & 3) == 0) {
+      data[i] = special[random_rand() % sizeof(special)];
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_roundtrip, "SLIP encoding and decoding");
+UNIT_TEST(test_roundtrip)
+{
+  static uint8_t payload[3][300];
+  static uint8_t stream[3 * SLIP_CODEC_ENCODED_SIZE_MAX(300)];
+  static uint8_t expected[SLIP_CODEC_ENCODED_SIZE_MAX(300)];
+  static uint8_t buf[300];
+  slip_decoder_t d;
+  size_t lens[3];
+  size_t n;
+  int frame;
+
+  UNIT_TEST_BEGIN();
+
+  for(int flags = 0; flags <= SLIP_CODEC_XONXOFF; flags++) {
+    for(size_t len = 0; len <= sizeof(payload[0]); len += 1 + len / 8) {
+      /* the encoding matches the reference at every alignment */
+      for(int offset = 0; offset < 4; offset++) {
+        fill(payload[0], len, len & 1);
+        n = slip_codec_encode(stream + offset, payload[0], len, flags);
+        UNIT_TEST_ASSERT(n == reference_encode(expected, payload[0], len,
+                                               flags));
+        UNIT_TEST_ASSERT(memcmp(stream + offset, expected, n) == 0);
+      }
+
+      /* three frames are decoded from the stream split at any point */
+      n = 0;
+      for(int i = 0; i < 3; i++) {
+        lens[i] = (len + i * 37) % (sizeof(payload[0]) + 1);
+        fill(payload[i], lens[i], i != 1);
+        n += slip_codec_encode(stream + n, payload[i], lens[i], flags);
+      }
+      for(size_t split = 0; split <= n; split += 1 + split / 32) {
+        slip_decoder_init(&d, buf, sizeof(buf), flags);
+        frame = 0;
+        slip_decoder_input(&d, stream, split);
+        for(int part = 0; part < 2; part++) {
+          int event;
+
+          while((event = slip_decoder_next(&d)) != SLIP_DECODER_NONE) {
+            UNIT_TEST_ASSERT(event == SLIP_DECODER_FRAME);
+            while(lens[frame] == 0) {
+              frame++;
+            }
+            UNIT_TEST_ASSERT(d.len == lens[frame]);
+            UNIT_TEST_ASSERT(memcmp(d.buf, payload[frame], d.len) == 0);
+            frame++;
+          }
+          slip_decoder_input(&d, stream + split, n - split);
+        }
+        while(frame < 3 && lens[frame] == 0) {
+          frame++;
+        }
+        UNIT_TEST_ASSERT(frame == 3);
+      }
+    }
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_lines, "SLIP lines and overflow");
+UNIT_TEST(test_lines)
+{
+  static const uint8_t input[] = "debug\nline two\n\300\333\334x\300"
+    "0123456789abcdef0123\333\335\n\300tail";
+  uint8_t buf[16];
+  slip_decoder_t d;
+
+  UNIT_TEST_BEGIN();
+
+  slip_decoder_init(&d, buf, sizeof(buf), SLIP_CODEC_LINES);
+  slip_decoder_input(&d, input, sizeof(input) - 1);
+
+  /* a line that the caller keeps */
+  UNIT_TEST_ASSERT(slip_decoder_next(&d) == SLIP_DECODER_LINE);
+  UNIT_TEST_ASSERT(d.len == 6 && memcmp(d.buf, "debug\n", 6) == 0);
+  /* a line that the caller drops */
+  UNIT_TEST_ASSERT(slip_decoder_next(&d) == SLIP_DECODER_LINE);
+  UNIT_TEST_ASSERT(d.len == 15 && memcmp(d.buf + 6, "line two\n", 9) == 0);
+  slip_decoder_reset(&d);
+
+  UNIT_TEST_ASSERT(slip_decoder_next(&d) == SLIP_DECODER_FRAME);
+  UNIT_TEST_ASSERT(d.len == 2 && d.buf[0] == SLIP_CODEC_END && d.buf[1] == 'x');
+
+  /* 21 bytes do not fit, and the rest starts over */
+  UNIT_TEST_ASSERT(slip_decoder_next(&d) == SLIP_DECODER_OVERFLOW);
+  UNIT_TEST_ASSERT(d.len == sizeof(buf));
+  UNIT_TEST_ASSERT(slip_decoder_next(&d) == SLIP_DECODER_LINE);
+  UNIT_TEST_ASSERT(d.len == 6 && memcmp(d.buf, "0123\333\n", 6) == 0);
+  UNIT_TEST_ASSERT(slip_decoder_next(&d) == SLIP_DECODER_FRAME);
+  UNIT_TEST_ASSERT(slip_decoder_next(&d) == SLIP_DECODER_NONE);
+  UNIT_TEST_ASSERT(d.len == 4 && memcmp(d.buf, "tail", 4) == 0);
+  UNIT_TEST_ASSERT(d.frames == 2 && d.overflows == 1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+#define BENCH_ROUNDS 20
+#define BENCH_FRAMES 256
+#define BENCH_CHUNK  4096
+
+static uint64_t
+time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* The fastest run is reported, as it is the least disturbed by the host. */
+static uint64_t
+fastest(uint64_t start, uint64_t best)
+{
+  uint64_t elapsed = time_ns() - start;
+
+  return elapsed < best ? elapsed : best;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * A loopback of IPv6-sized frames: the frames are encoded into one
+ * stream, which is decoded in read()-sized chunks.
+ */
+UNIT_TEST_REGISTER(test_bench, "SLIP loopback throughput");
+UNIT_TEST(test_bench)
+{
+  static uint8_t payload[BENCH_FRAMES][1280];
+  static uint8_t stream[BENCH_FRAMES * SLIP_CODEC_ENCODED_SIZE_MAX(1280)];
+  static uint8_t buf[MAX_FRAME];
+  static struct reference_decoder r;
+  slip_decoder_t d;
+  unsigned long bytes = sizeof(payload);
+  unsigned long frames;
+  uint64_t start;
+  uint64_t best[4];
+  size_t n = 0;
+
+  UNIT_TEST_BEGIN();
+
+  fill(&payload[0][0], sizeof(payload), 0);
+
+  for(int i = 0; i < 4; i++) {
+    best[i] = UINT64_MAX;
+  }
+  for(int round = 0; round < BENCH_ROUNDS; round++) {
+    start = time_ns();
+    n = 0;
+    for(int i = 0; i < BENCH_FRAMES; i++) {
+      n += reference_encode(stream + n, payload[i], sizeof(payload[i]), 0);
+    }
+    best[0] = fastest(start, best[0]);
+
+    start = time_ns();
+    frames = 0;
+    for(size_t i = 0; i < n; i++) {
+      if(reference_decode_byte(&r, stream[i]) > 0) {
+        frames++;
+      }
+    }
+    best[1] = fastest(start, best[1]);
+    UNIT_TEST_ASSERT(frames == BENCH_FRAMES);
+
+    start = time_ns();
+    n = 0;
+    for(int i = 0; i < BENCH_FRAMES; i++) {
+      n += slip_codec_encode(stream + n, payload[i], sizeof(payload[i]), 0);
+    }
+    best[2] = fastest(start, best[2]);
+
+    start = time_ns();
+    slip_decoder_init(&d, buf, sizeof(buf), 0);
+    for(size_t i = 0; i < n; i += BENCH_CHUNK) {
+      slip_decoder_input(&d, stream + i,
+                         n - i < BENCH_CHUNK ? n - i : BENCH_CHUNK);
+      while(slip_decoder_next(&d) != SLIP_DECODER_NONE);
+    }
+    best[3] = fastest(start, best[3]);
+    UNIT_TEST_ASSERT(d.frames == BENCH_FRAMES);
+    UNIT_TEST_ASSERT(memcmp(d.buf, payload[BENCH_FRAMES - 1], d.len) == 0);
+  }
+
+  printf("bytewise encode: %lu MB/s, decode: %lu MB/s\n",
+         (unsigned long)(bytes * 1000ULL / best[0]),
+         (unsigned long)(bytes * 1000ULL / best[1]));
+  printf("slip-codec encode: %lu MB/s, decode: %lu MB/s (simd %d)\n",
+         (unsigned long)(bytes * 1000ULL / best[2]),
+         (unsigned long)(bytes * 1000ULL / best[3]), SLIP_CODEC_SIMD);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(test_roundtrip);
+  UNIT_TEST_RUN(test_lines);
+  UNIT_TEST_RUN(test_bench);
+
+  if(!UNIT_TEST_PASSED(test_roundtrip) || !UNIT_TEST_PASSED(test_lines) ||
+     !UNIT_TEST_PASSED(test_bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
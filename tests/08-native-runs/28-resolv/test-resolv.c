@@ -0,0 +1,404 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Unit test of the DNS resolver, against a DNS stand-in that
+ *         answers on two local addresses.
+ */
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-nameserver.h"
+#include "net/ipv6/uip-udp-packet.h"
+#include "resolv.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define DNS_PORT 53
+#define ANSWER_TTL 2
+#define SOA_TTL 60
+#define SOA_MINIMUM 2
+
+#define DNS_RCODE_NONE 0
+#define DNS_RCODE_SERVFAIL 2
+#define DNS_RCODE_NXDOMAIN 3
+
+PROCESS(dns_process, "DNS stand-in");
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* How a server of the stand-in treats queries. */
+enum {
+  SERVER_ANSWER,
+  SERVER_SILENT,
+  SERVER_FAIL,
+};
+
+#define SERVERS 2
+static struct {
+  uip_ipaddr_t addr;
+  uint8_t mode;
+  uint8_t queries;
+} servers[SERVERS];
+
+/* The queries that are answered when the stand-in is polled. */
+#define MAX_PENDING 4
+#define MAX_QUERY 64
+static struct {
+  uint8_t server;
+  uip_ipaddr_t addr;
+  uint16_t port;
+  uint16_t len;
+  uint8_t query[MAX_QUERY];
+} pending[MAX_PENDING];
+static uint8_t npending;
+
+static struct uip_udp_conn *dns_conn;
+static struct etimer et;
+static clock_time_t start;
+static uip_ipaddr_t *addr;
+/*---------------------------------------------------------------------------*/
+static void
+net_init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static void
+net_input(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t
+net_output(const linkaddr_t *localdest)
+{
+  /* Only the packets to the stand-in are of interest, and they never
+     leave the node. */
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+const struct network_driver dns_test_net_driver = {
+  "dns-test",
+  net_init,
+  net_input,
+  net_output
+};
+/*---------------------------------------------------------------------------*/
+static void
+receive_query(void)
+{
+  uint8_t i;
+
+  for(i = 0; i < SERVERS; i++) {
+    if(uip_ipaddr_cmp(&UIP_IP_BUF->destipaddr, &servers[i].addr)) {
+      break;
+    }
+  }
+  if(i == SERVERS) {
+    return;
+  }
+  servers[i].queries++;
+  if(servers[i].mode == SERVER_SILENT || npending == MAX_PENDING ||
+     uip_datalen() > MAX_QUERY) {
+    return;
+  }
+  pending[npending].server = i;
+  uip_ipaddr_copy(&pending[npending].addr, &UIP_IP_BUF->srcipaddr);
+  pending[npending].port = UIP_UDP_BUF->srcport;
+  pending[npending].len = uip_datalen();
+  memcpy(pending[npending].query, uip_appdata, uip_datalen());
+  npending++;
+  tcpip_poll_udp(dns_conn);
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t *
+put_record(uint8_t *ptr, uint16_t type, uint32_t ttl, uint16_t len)
+{
+  /* The name is a pointer to the question. */
+  *ptr++ = 0xc0;
+  *ptr++ = 12;
+  *ptr++ = type >> 8;
+  *ptr++ = type & 0xff;
+  *ptr++ = 0;
+  *ptr++ = 1;
+  *ptr++ = ttl >> 24;
+  *ptr++ = ttl >> 16;
+  *ptr++ = ttl >> 8;
+  *ptr++ = ttl & 0xff;
+  *ptr++ = len >> 8;
+  *ptr++ = len & 0xff;
+  return ptr;
+}
+/*---------------------------------------------------------------------------*/
+static void
+answer(uint8_t n)
+{
+  static uint8_t response[MAX_QUERY + 64];
+  uint8_t *query = pending[n].query;
+  uint8_t *ptr = query + 12;
+  uint8_t rcode = DNS_RCODE_NONE;
+  uint8_t answers = 0;
+  uint8_t authority = 0;
+
+  /* Skip the question. */
+  while(ptr < query + pending[n].len && *ptr != 0) {
+    ptr += *ptr + 1;
+  }
+  ptr += 5;
+  if(ptr > query + pending[n].len) {
+    return;
+  }
+  memcpy(response, query, ptr - query);
+  ptr = response + (ptr - query);
+
+  if(servers[pending[n].server].mode == SERVER_FAIL) {
+    rcode = DNS_RCODE_SERVFAIL;
+  } else if(query[12] == 2 && memcmp(&query[13], "nx", 2) == 0) {
+    /* A name that does not exist, with an SOA record that gives the
+       time to cache that. */
+    rcode = DNS_RCODE_NXDOMAIN;
+    ptr = put_record(ptr, 6, SOA_TTL, 22);
+    *ptr++ = 0;
+    *ptr++ = 0;
+    memset(ptr, 0, 16);
+    ptr += 16;
+    *ptr++ = 0;
+    *ptr++ = 0;
+    *ptr++ = 0;
+    *ptr++ = SOA_MINIMUM;
+    authority = 1;
+  } else if(query[12] == 6 && memcmp(&query[13], "nodata", 6) == 0) {
+    /* A name without an address, and without an SOA record. */
+  } else {
+    ptr = put_record(ptr, 28, ANSWER_TTL, 16);
+    uip_ip6addr((uip_ipaddr_t *)ptr, 0xfd00, 0, 0, 0, 0, 0, 0xa,
+                pending[n].server + 1);
+    ptr += 16;
+    answers = 1;
+  }
+
+  response[2] = 0x81;
+  response[3] = 0x80 | rcode;
+  response[7] = answers;
+  response[9] = authority;
+  response[11] = 0;
+  uip_udp_packet_sendto(dns_conn, response, ptr - response,
+                        &pending[n].addr, pending[n].port);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(dns_process, ev, data)
+{
+  uint8_t i;
+
+  PROCESS_BEGIN();
+
+  for(i = 0; i < SERVERS; i++) {
+    uip_ip6addr(&servers[i].addr, 0xfd00, 0, 0, 0, 0, 0, 0x53, i + 1);
+    uip_ds6_addr_add(&servers[i].addr, 0, ADDR_MANUAL);
+    uip_nameserver_update(&servers[i].addr, UIP_NAMESERVER_INFINITE_LIFETIME);
+  }
+  dns_conn = udp_new(NULL, 0, NULL);
+  udp_bind(dns_conn, UIP_HTONS(DNS_PORT));
+
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == tcpip_event);
+    if(uip_newdata()) {
+      receive_query();
+    } else if(uip_poll()) {
+      for(i = 0; i < npending; i++) {
+        answer(i);
+      }
+      npending = 0;
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_servers(uint8_t mode0, uint8_t mode1)
+{
+  servers[0].mode = mode0;
+  servers[1].mode = mode1;
+  servers[0].queries = 0;
+  servers[1].queries = 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Waits until the resolver is done with a name. */
+#define WAIT_RESOLVED(name)                                                 \
+  start = clock_time();                                                     \
+  while(resolv_lookup(name, NULL) == RESOLV_STATUS_RESOLVING &&             \
+        clock_time() - start < 10 * CLOCK_SECOND) {                         \
+    etimer_set(&et, 1);                                                     \
+    PT_YIELD_UNTIL(&unit_test_pt, etimer_expired(&et));                     \
+  }
+
+#define SLEEP(ticks)                                                        \
+  etimer_set(&et, ticks);                                                   \
+  PT_YIELD_UNTIL(&unit_test_pt, etimer_expired(&et))
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_positive, "Positive caching");
+UNIT_TEST(test_positive)
+{
+  UNIT_TEST_BEGIN();
+
+  set_servers(SERVER_ANSWER, SERVER_ANSWER);
+  resolv_query("host.test");
+  /* A pending query is not restarted. */
+  resolv_query("host.test");
+  WAIT_RESOLVED("host.test");
+  UNIT_TEST_ASSERT(resolv_lookup("host.test", &addr) == RESOLV_STATUS_CACHED);
+  UNIT_TEST_ASSERT(addr->u16[6] == UIP_HTONS(0xa));
+
+  /* Both servers are asked at once, and only once. */
+  UNIT_TEST_ASSERT(servers[0].queries == 1);
+  UNIT_TEST_ASSERT(servers[1].queries == 1);
+
+  /* The answer expires with its TTL. */
+  SLEEP(CLOCK_SECOND * (ANSWER_TTL + 1) + CLOCK_SECOND / 2);
+  UNIT_TEST_ASSERT(resolv_lookup("host.test", NULL) == RESOLV_STATUS_EXPIRED);
+  UNIT_TEST_ASSERT(servers[0].queries == 1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_negative, "Negative caching");
+UNIT_TEST(test_negative)
+{
+  UNIT_TEST_BEGIN();
+
+  set_servers(SERVER_ANSWER, SERVER_ANSWER);
+  resolv_query("nx.test");
+  WAIT_RESOLVED("nx.test");
+  UNIT_TEST_ASSERT(resolv_lookup("nx.test", NULL) == RESOLV_STATUS_NOT_FOUND);
+  resolv_query("nodata.test");
+  WAIT_RESOLVED("nodata.test");
+  UNIT_TEST_ASSERT(resolv_lookup("nodata.test", NULL) ==
+                   RESOLV_STATUS_NOT_FOUND);
+  UNIT_TEST_ASSERT(servers[0].queries == 2);
+
+  /* A name that does not exist is cached for the SOA minimum, and a
+     name without an address for the default time. */
+  SLEEP(CLOCK_SECOND * (SOA_MINIMUM + 1) + CLOCK_SECOND / 2);
+  UNIT_TEST_ASSERT(resolv_lookup("nx.test", NULL) == RESOLV_STATUS_UNCACHED);
+  UNIT_TEST_ASSERT(resolv_lookup("nodata.test", NULL) ==
+                   RESOLV_STATUS_NOT_FOUND);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_parallel, "Parallel queries");
+UNIT_TEST(test_parallel)
+{
+  UNIT_TEST_BEGIN();
+
+  /* A silent server does not delay the answer of another one. */
+  set_servers(SERVER_SILENT, SERVER_ANSWER);
+  resolv_query("silent.test");
+  WAIT_RESOLVED("silent.test");
+  UNIT_TEST_ASSERT(clock_time() - start < CLOCK_SECOND / 4);
+  UNIT_TEST_ASSERT(resolv_lookup("silent.test", &addr) ==
+                   RESOLV_STATUS_CACHED);
+  UNIT_TEST_ASSERT(addr->u16[7] == UIP_HTONS(2));
+
+  /* A failed server is not asked again while another one may answer. */
+  set_servers(SERVER_FAIL, SERVER_SILENT);
+  resolv_query("fail.test");
+  WAIT_RESOLVED("fail.test");
+  UNIT_TEST_ASSERT(resolv_lookup("fail.test", NULL) == RESOLV_STATUS_ERROR);
+  UNIT_TEST_ASSERT(servers[0].queries == 1);
+  UNIT_TEST_ASSERT(servers[1].queries == 2);
+
+  /* A query fails at once when all servers have failed. */
+  set_servers(SERVER_FAIL, SERVER_FAIL);
+  resolv_query("fail2.test");
+  WAIT_RESOLVED("fail2.test");
+  UNIT_TEST_ASSERT(clock_time() - start < CLOCK_SECOND / 4);
+  UNIT_TEST_ASSERT(resolv_lookup("fail2.test", NULL) == RESOLV_STATUS_ERROR);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_lru, "Least recently used replacement");
+UNIT_TEST(test_lru)
+{
+  static const char *names[] = { "a.test", "b.test", "c.test", "d.test" };
+  static uint8_t i;
+
+  UNIT_TEST_BEGIN();
+
+  set_servers(SERVER_ANSWER, SERVER_ANSWER);
+  for(i = 0; i < 4; i++) {
+    resolv_query(names[i]);
+    WAIT_RESOLVED(names[i]);
+  }
+
+  /* The oldest name is used, so the second oldest is replaced. */
+  UNIT_TEST_ASSERT(resolv_lookup("a.test", NULL) == RESOLV_STATUS_CACHED);
+  resolv_query("e.test");
+  WAIT_RESOLVED("e.test");
+  UNIT_TEST_ASSERT(resolv_lookup("e.test", NULL) == RESOLV_STATUS_CACHED);
+  UNIT_TEST_ASSERT(resolv_lookup("b.test", NULL) == RESOLV_STATUS_UNCACHED);
+  UNIT_TEST_ASSERT(resolv_lookup("a.test", NULL) == RESOLV_STATUS_CACHED);
+  UNIT_TEST_ASSERT(resolv_lookup("c.test", NULL) == RESOLV_STATUS_CACHED);
+  UNIT_TEST_ASSERT(resolv_lookup("d.test", NULL) == RESOLV_STATUS_CACHED);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  process_start(&dns_process, NULL);
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(test_positive);
+  UNIT_TEST_RUN(test_negative);
+  UNIT_TEST_RUN(test_parallel);
+  UNIT_TEST_RUN(test_lru);
+
+  if(!UNIT_TEST_PASSED(test_positive) ||
+     !UNIT_TEST_PASSED(test_negative) ||
+     !UNIT_TEST_PASSED(test_parallel) ||
+     !UNIT_TEST_PASSED(test_lru)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,439 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Unit test and benchmark of the IPv6/IPv4 translation of ip64.
+ */
+
+#include "contiki.h"
+#include "ip64/ip64.h"
+#include "ip64/ip64-addrmap.h"
+#include "ipv6/ip64-addr.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define IPV6_HDRLEN 40
+#define IPV4_HDRLEN 20
+#define UDP_HDRLEN  8
+#define TCP_HDRLEN  20
+#define ICMP_HDRLEN 8
+
+#define PROTO_ICMPV4 1
+#define PROTO_TCP    6
+#define PROTO_UDP    17
+#define PROTO_ICMPV6 58
+
+#define SERVER_PORT 5683
+#define HOST_PORT   40000
+
+/* One flow per address mapping. */
+#define FLOWS       IP64_ADDRMAP_CONF_ENTRIES
+#define ROUND_TRIPS 100000
+
+static uint8_t v6packet[UIP_BUFSIZE];
+static uint8_t v4packet[UIP_BUFSIZE];
+static uint8_t result[UIP_BUFSIZE];
+static uip_ip4addr_t hostaddr;
+static uip_ip4addr_t server;
+static struct etimer et;
+/*---------------------------------------------------------------------------*/
+static uint64_t
+time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+sum(uint32_t acc, const uint8_t *data, uint16_t len)
+{
+  for(; len > 1; data += 2, len -= 2) {
+    acc += (data[0] << 8) | data[1];
+  }
+  if(len) {
+    acc += data[0] << 8;
+  }
+  return acc;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+fold(uint32_t acc)
+{
+  while(acc >> 16) {
+    acc = (acc & 0xffff) + (acc >> 16);
+  }
+  return acc;
+}
+/*---------------------------------------------------------------------------*/
+static void
+put16(uint8_t *p, uint16_t value)
+{
+  p[0] = value >> 8;
+  p[1] = value & 0xff;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+get16(const uint8_t *p)
+{
+  return (p[0] << 8) | p[1];
+}
+/*---------------------------------------------------------------------------*/
+/* The offset of the checksum in a transport header. */
+static uint8_t
+chksum_offset(uint8_t proto)
+{
+  return proto == PROTO_UDP ? 6 : proto == PROTO_TCP ? 16 : 2;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+v6_transport_sum(const uint8_t *packet)
+{
+  uint16_t len = get16(&packet[4]);
+
+  return fold(sum(len + packet[6], &packet[8], 32) +
+              sum(0, &packet[IPV6_HDRLEN], len));
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+v4_transport_sum(const uint8_t *packet)
+{
+  uint16_t len = get16(&packet[2]) - IPV4_HDRLEN;
+  uint32_t acc = 0;
+
+  if(packet[9] != PROTO_ICMPV4) {
+    acc = sum(len + packet[9], &packet[12], 8);
+  }
+  return fold(acc + sum(0, &packet[IPV4_HDRLEN], len));
+}
+/*---------------------------------------------------------------------------*/
+static bool
+v4_valid(const uint8_t *packet)
+{
+  return fold(sum(0, packet, IPV4_HDRLEN)) == 0xffff &&
+    v4_transport_sum(packet) == 0xffff;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+transport_header(uint8_t *p, uint8_t proto, uint16_t srcport,
+                 uint16_t destport, uint16_t len)
+{
+  uint16_t hdrlen;
+
+  if(proto == PROTO_UDP) {
+    hdrlen = UDP_HDRLEN;
+    memset(p, 0, hdrlen);
+    put16(&p[4], hdrlen + len);
+  } else if(proto == PROTO_TCP) {
+    hdrlen = TCP_HDRLEN;
+    memset(p, 0, hdrlen);
+    put16(&p[4], 0x1234);
+    p[12] = 0x50;
+    p[13] = 0x10; /* ACK */
+    put16(&p[14], 1024);
+  } else {
+    hdrlen = ICMP_HDRLEN;
+    memset(p, 0, hdrlen);
+    put16(&p[4], srcport);
+    put16(&p[6], destport);
+    return hdrlen;
+  }
+  put16(&p[0], srcport);
+  put16(&p[2], destport);
+  return hdrlen;
+}
+/*---------------------------------------------------------------------------*/
+/* Builds an IPv6 packet from a host in the IPv6 network to the server. */
+static uint16_t
+make_v6(uint8_t *packet, uint8_t proto, uint16_t host, uint16_t len)
+{
+  uint8_t *transport = &packet[IPV6_HDRLEN];
+  uint16_t i, chksum;
+  uip_ip6addr_t addr;
+
+  len += transport_header(transport, proto, HOST_PORT + host, SERVER_PORT,
+                          len);
+  memset(packet, 0, IPV6_HDRLEN);
+  packet[0] = 0x60;
+  put16(&packet[4], len);
+  packet[6] = proto;
+  packet[7] = 64;
+  uip_ip6addr(&addr, 0xfd00, 0, 0, 0, 0, 0, 0, host + 1);
+  memcpy(&packet[8], &addr, 16);
+  ip64_addr_4to6(&server, &addr);
+  memcpy(&packet[24], &addr, 16);
+  if(proto == PROTO_ICMPV6) {
+    transport[0] = 129; /* echo reply */
+  }
+  for(i = len - 1; i >= (proto == PROTO_TCP ? TCP_HDRLEN : UDP_HDRLEN); i--) {
+    transport[i] = i * 7;
+  }
+  chksum = ~v6_transport_sum(packet);
+  put16(&transport[chksum_offset(proto)], chksum == 0 ? 0xffff : chksum);
+  return IPV6_HDRLEN + len;
+}
+/*---------------------------------------------------------------------------*/
+/* Builds an IPv4 packet from the server to a mapped port of ip64. */
+static uint16_t
+make_v4(uint8_t *packet, uint8_t proto, uint16_t port, uint16_t len)
+{
+  uint8_t *transport = &packet[IPV4_HDRLEN];
+  uint16_t i, chksum;
+
+  len += transport_header(transport, proto, SERVER_PORT, port, len);
+  memset(packet, 0, IPV4_HDRLEN);
+  packet[0] = 0x45;
+  put16(&packet[2], IPV4_HDRLEN + len);
+  packet[8] = 64;
+  packet[9] = proto;
+  memcpy(&packet[12], &server, 4);
+  memcpy(&packet[16], &hostaddr, 4);
+  put16(&packet[10], ~fold(sum(0, packet, IPV4_HDRLEN)));
+  if(proto == PROTO_ICMPV4) {
+    transport[0] = 8; /* echo request */
+  }
+  for(i = len - 1; i >= (proto == PROTO_TCP ? TCP_HDRLEN : UDP_HDRLEN); i--) {
+    transport[i] = i * 5;
+  }
+  chksum = ~v4_transport_sum(packet);
+  put16(&transport[chksum_offset(proto)], chksum == 0 ? 0xffff : chksum);
+  return IPV4_HDRLEN + len;
+}
+/*---------------------------------------------------------------------------*/
+/* Translates a packet from a host and the reply to it, and checks the
+   checksums and the mapping of the reply to the host. */
+static bool
+round_trip(uint8_t proto, uint16_t host, uint16_t len)
+{
+  uip_ip6addr_t addr;
+  uint16_t port;
+  int n;
+
+  n = ip64_6to4(v6packet, make_v6(v6packet, proto, host, len), v4packet);
+  if(n != IPV4_HDRLEN + len + (proto == PROTO_TCP ? TCP_HDRLEN : UDP_HDRLEN) ||
+     !v4_valid(v4packet)) {
+    return false;
+  }
+
+  port = get16(&v4packet[IPV4_HDRLEN]);
+  n = ip64_4to6(v4packet, make_v4(v4packet, proto, port, len), result);
+  if(n <= IPV6_HDRLEN || v6_transport_sum(result) != 0xffff) {
+    return false;
+  }
+  uip_ip6addr(&addr, 0xfd00, 0, 0, 0, 0, 0, 0, host + 1);
+  return memcmp(&result[24], &addr, 16) == 0 &&
+    get16(&result[IPV6_HDRLEN + 2]) == HOST_PORT + host;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_translation, "Translation and checksums");
+UNIT_TEST(test_translation)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(round_trip(PROTO_UDP, 0, 0));
+  UNIT_TEST_ASSERT(round_trip(PROTO_UDP, 1, 33));
+  UNIT_TEST_ASSERT(round_trip(PROTO_UDP, 2, 512));
+  UNIT_TEST_ASSERT(round_trip(PROTO_TCP, 3, 0));
+  UNIT_TEST_ASSERT(round_trip(PROTO_TCP, 4, 101));
+
+  /* Echo replies go out, and echo requests come in. */
+  UNIT_TEST_ASSERT(ip64_6to4(v6packet, make_v6(v6packet, PROTO_ICMPV6, 5, 20),
+                             v4packet) == IPV4_HDRLEN + ICMP_HDRLEN + 20);
+  UNIT_TEST_ASSERT(v4packet[IPV4_HDRLEN] == 0);
+  UNIT_TEST_ASSERT(v4_valid(v4packet));
+  UNIT_TEST_ASSERT(ip64_4to6(v4packet, make_v4(v4packet, PROTO_ICMPV4, 0, 20),
+                             result) == IPV6_HDRLEN + ICMP_HDRLEN + 20);
+  UNIT_TEST_ASSERT(result[IPV6_HDRLEN] == 128);
+  UNIT_TEST_ASSERT(v6_transport_sum(result) == 0xffff);
+
+  /* A corrupted packet stays corrupted. */
+  make_v6(v6packet, PROTO_UDP, 6, 40);
+  v6packet[IPV6_HDRLEN + 20] ^= 0x01;
+  UNIT_TEST_ASSERT(ip64_6to4(v6packet, IPV6_HDRLEN + UDP_HDRLEN + 40,
+                             v4packet) > 0);
+  UNIT_TEST_ASSERT(v4_transport_sum(v4packet) != 0xffff);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_mappings, "Address mappings");
+UNIT_TEST(test_mappings)
+{
+  static uip_ip6addr_t addr;
+  static struct ip64_addrmap_entry *m;
+  static uint16_t i;
+
+  UNIT_TEST_BEGIN();
+
+  ip64_addrmap_init();
+
+  /* Each flow keeps its mapping. */
+  for(i = 0; i < FLOWS; i++) {
+    UNIT_TEST_ASSERT(round_trip(PROTO_UDP, i, 16));
+  }
+  for(i = 0; i < FLOWS; i++) {
+    UNIT_TEST_ASSERT(round_trip(PROTO_UDP, FLOWS - 1 - i, 16));
+  }
+
+  /* The table is full, and nothing can be recycled. */
+  uip_ip6addr(&addr, 0xfd00, 0, 0, 0, 0, 0, 0, 0xffff);
+  UNIT_TEST_ASSERT(ip64_addrmap_create(&addr, HOST_PORT, &server, SERVER_PORT,
+                                       PROTO_UDP) == NULL);
+
+  /* The recyclable mapping that expires first is recycled. */
+  uip_ip6addr(&addr, 0xfd00, 0, 0, 0, 0, 0, 0, 2);
+  m = ip64_addrmap_lookup(&addr, HOST_PORT + 1, &server, SERVER_PORT,
+                          PROTO_UDP);
+  UNIT_TEST_ASSERT(m != NULL);
+  ip64_addrmap_set_lifetime(m, CLOCK_SECOND * 30);
+  ip64_addrmap_set_recycleble(m);
+  uip_ip6addr(&addr, 0xfd00, 0, 0, 0, 0, 0, 0, 3);
+  m = ip64_addrmap_lookup(&addr, HOST_PORT + 2, &server, SERVER_PORT,
+                          PROTO_UDP);
+  UNIT_TEST_ASSERT(m != NULL);
+  ip64_addrmap_set_lifetime(m, CLOCK_SECOND * 10);
+  ip64_addrmap_set_recycleble(m);
+  uip_ip6addr(&addr, 0xfd00, 0, 0, 0, 0, 0, 0, 0xffff);
+  UNIT_TEST_ASSERT(ip64_addrmap_create(&addr, HOST_PORT, &server, SERVER_PORT,
+                                       PROTO_UDP) != NULL);
+  uip_ip6addr(&addr, 0xfd00, 0, 0, 0, 0, 0, 0, 3);
+  UNIT_TEST_ASSERT(ip64_addrmap_lookup(&addr, HOST_PORT + 2, &server,
+                                       SERVER_PORT, PROTO_UDP) == NULL);
+  uip_ip6addr(&addr, 0xfd00, 0, 0, 0, 0, 0, 0, 2);
+  UNIT_TEST_ASSERT(ip64_addrmap_lookup(&addr, HOST_PORT + 1, &server,
+                                       SERVER_PORT, PROTO_UDP) != NULL);
+
+  /* A mapping is gone when its lifetime ends. */
+  uip_ip6addr(&addr, 0xfd00, 0, 0, 0, 0, 0, 0, 1);
+  m = ip64_addrmap_lookup(&addr, HOST_PORT, &server, SERVER_PORT, PROTO_UDP);
+  UNIT_TEST_ASSERT(m != NULL);
+  ip64_addrmap_set_lifetime(m, CLOCK_SECOND);
+  i = m->mapped_port;
+  UNIT_TEST_ASSERT(ip64_addrmap_lookup_port(i, PROTO_UDP) == m);
+  etimer_set(&et, CLOCK_SECOND * 2 + CLOCK_SECOND / 2);
+  PT_YIELD_UNTIL(&unit_test_pt, etimer_expired(&et));
+  UNIT_TEST_ASSERT(ip64_addrmap_lookup_port(i, PROTO_UDP) == NULL);
+  UNIT_TEST_ASSERT(ip64_addrmap_lookup(&addr, HOST_PORT, &server, SERVER_PORT,
+                                       PROTO_UDP) == NULL);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+static bool
+bench(uint8_t proto, uint16_t len)
+{
+  static uint16_t v6len[FLOWS];
+  static uint8_t v6packets[FLOWS][IPV6_HDRLEN + TCP_HDRLEN + 512];
+  uint64_t start, elapsed;
+  uint32_t i;
+  uint16_t host, port;
+
+  ip64_addrmap_init();
+  for(host = 0; host < FLOWS; host++) {
+    v6len[host] = make_v6(v6packets[host], proto, host, len);
+  }
+
+  start = time_ns();
+  for(i = 0; i < ROUND_TRIPS; i++) {
+    host = (i * 7) % FLOWS;
+    if(ip64_6to4(v6packets[host], v6len[host], v4packet) == 0) {
+      return false;
+    }
+    /* The reply is the translated packet with swapped ports and
+       addresses. */
+    port = get16(&v4packet[IPV4_HDRLEN]);
+    memcpy(&v4packet[IPV4_HDRLEN], &v4packet[IPV4_HDRLEN + 2], 2);
+    put16(&v4packet[IPV4_HDRLEN + 2], port);
+    memcpy(&v4packet[12], &server, 4);
+    memcpy(&v4packet[16], &hostaddr, 4);
+    if(ip64_4to6(v4packet, get16(&v4packet[2]), result) == 0) {
+      return false;
+    }
+  }
+  elapsed = time_ns() - start;
+
+  printf("%s, %u bytes, %u flows: %lu ns per packet\n",
+         proto == PROTO_UDP ? "UDP" : "TCP", len, FLOWS,
+         (unsigned long)(elapsed / (2 * ROUND_TRIPS)));
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_bench, "Translation throughput");
+UNIT_TEST(test_bench)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(bench(PROTO_UDP, 32));
+  UNIT_TEST_ASSERT(bench(PROTO_UDP, 512));
+  UNIT_TEST_ASSERT(bench(PROTO_TCP, 32));
+  UNIT_TEST_ASSERT(bench(PROTO_TCP, 512));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  static uip_ip4addr_t netmask;
+
+  PROCESS_BEGIN();
+
+  ip64_init();
+  uip_ipaddr(&hostaddr, 10, 0, 0, 2);
+  uip_ipaddr(&netmask, 255, 255, 255, 0);
+  uip_ipaddr(&server, 10, 0, 0, 1);
+  ip64_set_ipv4_address(&hostaddr, &netmask);
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(test_translation);
+  UNIT_TEST_RUN(test_mappings);
+  UNIT_TEST_RUN(test_bench);
+
+  if(!UNIT_TEST_PASSED(test_translation) ||
+     !UNIT_TEST_PASSED(test_mappings) ||
+     !UNIT_TEST_PASSED(test_bench)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
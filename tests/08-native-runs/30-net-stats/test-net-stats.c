@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Unit test of the network stack statistics.
+ */
+
+#include "contiki.h"
+#include "net/net-stats.h"
+#include "net/ipv6/uip.h"
+#include "lib/cbor.h"
+#include "shell.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+enum {
+  TEST_STATS_RX,
+  TEST_STATS_TX,
+  TEST_STATS_QUEUED,
+};
+
+static const char *const test_stats_names[] = { "rx", "tx", "queued" };
+static unsigned updates;
+static uint32_t queued;
+
+static void
+test_stats_update(struct net_stats *stats)
+{
+  updates++;
+  stats->values[TEST_STATS_QUEUED] = queued;
+}
+
+NET_STATS_GROUP(test_stats, "test", test_stats_names,
+                NET_STATS_GAUGE(TEST_STATS_QUEUED), test_stats_update);
+
+static struct etimer et;
+static char shell_text[1024];
+/*---------------------------------------------------------------------------*/
+static void
+shell_output(const char *str)
+{
+  strncat(shell_text, str, sizeof(shell_text) - strlen(shell_text) - 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+run_shell(const char *command)
+{
+  static char line[64];
+  struct pt pt;
+
+  shell_text[0] = '\0';
+  strncpy(line, command, sizeof(line) - 1);
+  PT_INIT(&pt);
+  while(PT_SCHEDULE(shell_input(&pt, shell_output, line)));
+}
+/*---------------------------------------------------------------------------*/
+static bool
+read_cbor_value(const uint8_t *cbor, size_t len,
+                const char *map, const char *key, uint64_t *value)
+{
+  cbor_reader_state_t reader;
+  cbor_path_element_t path[] = {
+    { map, strlen(map), 0 },
+    { key, strlen(key), 0 },
+  };
+
+  cbor_init_reader(&reader, cbor, len);
+  return cbor_find(&reader, path, 2)
+         && cbor_read_unsigned(&reader, value) != CBOR_SIZE_NONE;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_registry, "Registry");
+UNIT_TEST(test_registry)
+{
+  struct net_stats *stats;
+  int count;
+
+  UNIT_TEST_BEGIN();
+
+  /* The layers of the network stack registered their groups. */
+  UNIT_TEST_ASSERT(net_stats_find("ipv6") != NULL);
+  UNIT_TEST_ASSERT(net_stats_find("none") == NULL);
+
+  /* A group is registered once. */
+  NET_STATS_REGISTER(test_stats);
+  NET_STATS_REGISTER(test_stats);
+  count = 0;
+  for(stats = net_stats_head(); stats != NULL; stats = stats->next) {
+    if(stats == &test_stats) {
+      count++;
+    }
+  }
+  UNIT_TEST_ASSERT(count == 1);
+  UNIT_TEST_ASSERT(net_stats_find("test") == &test_stats);
+  UNIT_TEST_ASSERT(test_stats.count == 3);
+
+  /* The IPv6 group follows the uIP statistics. */
+  stats = net_stats_find("ipv6");
+  uip_stat.ip.recv += 3;
+  net_stats_mark();
+  net_stats_update();
+  UNIT_TEST_ASSERT(net_stats_delta(stats, 0) == 3);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_counters, "Counters, gauges and intervals");
+UNIT_TEST(test_counters)
+{
+  /* Static, since it is used across a yield. */
+  static clock_time_t start;
+
+  UNIT_TEST_BEGIN();
+
+  net_stats_reset();
+  UNIT_TEST_ASSERT(test_stats.values[TEST_STATS_RX] == 0);
+
+  NET_STATS_INC(test_stats, TEST_STATS_RX);
+  NET_STATS_ADD(test_stats, TEST_STATS_TX, 5);
+  queued = 7;
+  updates = 0;
+  net_stats_update();
+  UNIT_TEST_ASSERT(updates == 1);
+  UNIT_TEST_ASSERT(test_stats.values[TEST_STATS_QUEUED] == 7);
+  UNIT_TEST_ASSERT(net_stats_delta(&test_stats, TEST_STATS_RX) == 1);
+  UNIT_TEST_ASSERT(net_stats_delta(&test_stats, TEST_STATS_TX) == 5);
+  /* A gauge has no change. */
+  UNIT_TEST_ASSERT(net_stats_delta(&test_stats, TEST_STATS_QUEUED) == 0);
+
+  /* The changes are counted from the last mark, across a wrap-around. */
+  net_stats_mark();
+  UNIT_TEST_ASSERT(net_stats_delta(&test_stats, TEST_STATS_TX) == 0);
+  test_stats.values[TEST_STATS_RX] = UINT32_MAX - 1;
+  net_stats_mark();
+  NET_STATS_ADD(test_stats, TEST_STATS_RX, 4);
+  UNIT_TEST_ASSERT(test_stats.values[TEST_STATS_RX] == 2);
+  UNIT_TEST_ASSERT(net_stats_delta(&test_stats, TEST_STATS_RX) == 4);
+
+  /* A reset keeps the gauges. */
+  start = clock_time();
+  net_stats_reset();
+  UNIT_TEST_ASSERT(test_stats.values[TEST_STATS_RX] == 0);
+  UNIT_TEST_ASSERT(test_stats.values[TEST_STATS_TX] == 0);
+  UNIT_TEST_ASSERT(test_stats.values[TEST_STATS_QUEUED] == 7);
+
+  /* The interval runs from the last mark. The timer may expire late,
+     so the interval is bounded by the time measured here. */
+  UNIT_TEST_ASSERT(net_stats_interval() <= clock_time() - start);
+  etimer_set(&et, CLOCK_SECOND / 2);
+  PT_YIELD_UNTIL(&unit_test_pt, etimer_expired(&et));
+  UNIT_TEST_ASSERT(net_stats_interval() >= CLOCK_SECOND / 2);
+  UNIT_TEST_ASSERT(net_stats_interval() <= clock_time() - start);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_cbor, "CBOR encoding");
+UNIT_TEST(test_cbor)
+{
+  uint8_t cbor[NET_STATS_CBOR_MAX];
+  cbor_reader_state_t reader;
+  cbor_path_element_t group_path[] = { CBOR_PATH_TEXT("group") };
+  const char *text;
+  size_t text_size;
+  size_t len;
+  uint64_t value;
+
+  UNIT_TEST_BEGIN();
+
+  net_stats_reset();
+  NET_STATS_ADD(test_stats, TEST_STATS_RX, 300);
+  net_stats_mark();
+  NET_STATS_ADD(test_stats, TEST_STATS_RX, 20);
+  queued = 2;
+  net_stats_update();
+
+  len = net_stats_to_cbor(&test_stats, cbor, sizeof(cbor));
+  UNIT_TEST_ASSERT(len > 0);
+
+  cbor_init_reader(&reader, cbor, len);
+  UNIT_TEST_ASSERT(cbor_find(&reader, group_path, 1));
+  text = cbor_read_text(&reader, &text_size);
+  UNIT_TEST_ASSERT(text != NULL && text_size == 4 && !memcmp(text, "test", 4));
+
+  UNIT_TEST_ASSERT(read_cbor_value(cbor, len, "values", "rx", &value));
+  UNIT_TEST_ASSERT(value == 320);
+  UNIT_TEST_ASSERT(read_cbor_value(cbor, len, "values", "queued", &value));
+  UNIT_TEST_ASSERT(value == 2);
+  UNIT_TEST_ASSERT(read_cbor_value(cbor, len, "deltas", "rx", &value));
+  UNIT_TEST_ASSERT(value == 20);
+  UNIT_TEST_ASSERT(read_cbor_value(cbor, len, "deltas", "tx", &value));
+  UNIT_TEST_ASSERT(value == 0);
+  /* A gauge has no change. */
+  UNIT_TEST_ASSERT(!read_cbor_value(cbor, len, "deltas", "queued", &value));
+
+  /* An encoding that does not fit is reported as such. */
+  UNIT_TEST_ASSERT(net_stats_to_cbor(&test_stats, cbor, len - 1) == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_shell, "Shell command");
+UNIT_TEST(test_shell)
+{
+  static const char tx_line[] = "-- tx: 12 (+12, ";
+  clock_time_t interval;
+  unsigned long expected_rate;
+  unsigned long rate_integer;
+  unsigned long rate_tenths;
+  char *tx;
+
+  UNIT_TEST_BEGIN();
+
+  run_shell("stats reset");
+  UNIT_TEST_ASSERT(strstr(shell_text, "Statistics reset") != NULL);
+
+  NET_STATS_ADD(test_stats, TEST_STATS_TX, 12);
+  etimer_set(&et, CLOCK_SECOND * 2);
+  PT_YIELD_UNTIL(&unit_test_pt, etimer_expired(&et));
+
+  /* The timer may expire late, so the rate is compared with the one
+     expected for the interval that actually passed. */
+  interval = net_stats_interval();
+  run_shell("stats test");
+  UNIT_TEST_ASSERT(strstr(shell_text, "test:\n") != NULL);
+  tx = strstr(shell_text, tx_line);
+  UNIT_TEST_ASSERT(tx != NULL);
+  UNIT_TEST_ASSERT(sscanf(tx + strlen(tx_line), "%lu.%lu/s)",
+                          &rate_integer, &rate_tenths) == 2);
+  /* In tenths of events per second. The clock may advance between
+     the measurement and the command. */
+  expected_rate = 12UL * 10 * CLOCK_SECOND / interval;
+  UNIT_TEST_ASSERT(rate_integer * 10 + rate_tenths + 1 >= expected_rate &&
+                   rate_integer * 10 + rate_tenths <= expected_rate + 1);
+  UNIT_TEST_ASSERT(strstr(shell_text, "-- queued: 2\n") != NULL);
+  /* Only the requested group is shown. */
+  UNIT_TEST_ASSERT(strstr(shell_text, "ipv6:") == NULL);
+
+  /* The changes start over after each call. */
+  run_shell("stats test");
+  UNIT_TEST_ASSERT(strstr(shell_text, "-- tx: 12 (+0, 0.0/s)") != NULL);
+
+  run_shell("stats cbor test");
+  UNIT_TEST_ASSERT(!strncmp(shell_text, "netstats a4", 11));
+
+  run_shell("stats none");
+  UNIT_TEST_ASSERT(strstr(shell_text, "Unknown statistics group") != NULL);
+
+  run_shell("stats");
+  UNIT_TEST_ASSERT(strstr(shell_text, "ipv6:") != NULL);
+  UNIT_TEST_ASSERT(strstr(shell_text, "test:") != NULL);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(test_registry);
+  UNIT_TEST_RUN(test_counters);
+  UNIT_TEST_RUN(test_cbor);
+  UNIT_TEST_RUN(test_shell);
+
+  if(!UNIT_TEST_PASSED(test_registry) ||
+     !UNIT_TEST_PASSED(test_counters) ||
+     !UNIT_TEST_PASSED(test_cbor) ||
+     !UNIT_TEST_PASSED(test_shell)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
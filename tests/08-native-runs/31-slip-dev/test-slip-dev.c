@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Test of the output queue of the native border router with a
+ *         serial device that takes a few bytes per write().
+ */
+
+#include "contiki.h"
+#include "lib/random.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+/*
+ * The queue is internal to slip-dev.c, which is included here with its
+ * writes redirected to a device that accepts at most a few bytes at a
+ * time, and that keeps what it accepted.
+ */
+static ssize_t short_write(int fd, const void *buf, size_t count);
+#define write short_write
+#include "slip-dev.c"
+#undef write
+
+int slip_config_verbose;
+int slip_config_flowcontrol;
+struct slip_config_radio slip_config_radios[BORDER_ROUTER_MAX_RADIOS];
+int slip_config_radio_count;
+uint16_t slip_config_basedelay;
+speed_t slip_config_b_rate;
+uint8_t command_context;
+
+int
+cmd_input(const uint8_t *data, int data_len)
+{
+  return 0;
+}
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define FRAMES      20000
+#define MAX_PAYLOAD 200
+/* Bytes that the device takes per write(), at most */
+#define MAX_WRITE   (MAX_PAYLOAD + 40)
+
+static uint8_t device[1 << 16];
+static size_t device_len;
+static slip_decoder_t decoder;
+static uint8_t frame[MAX_PAYLOAD + 1];
+static unsigned long next_frame;
+static int failed;
+
+/*---------------------------------------------------------------------------*/
+static void
+fill(uint8_t *payload, size_t len, unsigned long seq)
+{
+  for(size_t i = 0; i < len; i++) {
+    /* SLIP_END and SLIP_ESC bytes appear in the payload too */
+    payload[i] = (seq * 31 + i * 7) % 256;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static size_t
+payload_len(unsigned long seq)
+{
+  return 1 + seq * 13 % MAX_PAYLOAD;
+}
+/*---------------------------------------------------------------------------*/
+/* Check the frames that the device has received so far. */
+static void
+check_device(void)
+{
+  uint8_t expected[MAX_PAYLOAD];
+
+  slip_decoder_input(&decoder, device, device_len);
+  while(slip_decoder_next(&decoder) == SLIP_DECODER_FRAME) {
+    if(decoder.len == 0) {
+      /* The SLIP_END that opens the link */
+      continue;
+    }
+    fill(expected, payload_len(next_frame), next_frame);
+    if(decoder.len != payload_len(next_frame) ||
+       memcmp(decoder.buf, expected, decoder.len) != 0) {
+      failed = 1;
+    }
+    next_frame++;
+  }
+  device_len = 0;
+}
+/*---------------------------------------------------------------------------*/
+static ssize_t
+short_write(int fd, const void *buf, size_t count)
+{
+  size_t n = 1 + random_rand() % MAX_WRITE;
+
+  if(n > count) {
+    n = count;
+  }
+  memcpy(device + device_len, buf, n);
+  device_len += n;
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+/* The queue counts the packets that are left, and where the first ends. */
+static int
+queue_consistent(const struct slip_radio *radio)
+{
+  int packets = 0;
+  int packet_end = 0;
+
+  if(radio->begin != 0) {
+    return 0;
+  }
+  for(int i = 0; i < radio->end; i++) {
+    if(radio->buf[i] == SLIP_END && packets++ == 0) {
+      packet_end = i + 1;
+    }
+  }
+  return packets == radio->packet_count && packet_end == radio->packet_end;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Frames are queued faster than the device takes them, so that the
+ * writes end anywhere in the queue, and are flushed once per frame. A
+ * queue that is not reclaimed after such writes overflows.
+ */
+static int
+run(int delay, int credits)
+{
+  struct slip_radio *radio = &radios[0];
+  unsigned long seq;
+  int max_end = 0;
+  int consistent = 1;
+
+  memset(radio, 0, sizeof(*radio));
+  radio_count = 1;
+  send_delay = delay;
+  radio->credits.active = credits;
+  timer_set(&radio->send_delay_timer, 0);
+  slip_decoder_init(&decoder, frame, sizeof(frame), 0);
+  device_len = 0;
+  next_frame = 0;
+  failed = 0;
+
+  slip_send(radio, SLIP_END);
+  for(seq = 0; seq < FRAMES; seq++) {
+    uint8_t payload[MAX_PAYLOAD];
+
+    fill(payload, payload_len(seq), seq);
+    slip_send_frame(radio, payload, payload_len(seq));
+    if(radio->end > max_end) {
+      max_end = radio->end;
+    }
+    slip_flushbuf(radio);
+    consistent &= queue_consistent(radio);
+    check_device();
+  }
+  while(!slip_empty(radio)) {
+    slip_flushbuf(radio);
+    consistent &= queue_consistent(radio);
+    check_device();
+  }
+
+  printf("send delay %d, credits %d: %lu frames, queue up to %d bytes\n",
+         delay, credits, next_frame, max_end);
+  return consistent && !failed && next_frame == FRAMES && radio->end == 0;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_short_writes, "SLIP output queue with short writes");
+UNIT_TEST(test_short_writes)
+{
+  UNIT_TEST_BEGIN();
+
+  random_init(1);
+  /* all queued packets are written at once */
+  UNIT_TEST_ASSERT(run(0, 0));
+  /* the same with flow control, also with a send delay */
+  UNIT_TEST_ASSERT(run(0, 1));
+  UNIT_TEST_ASSERT(run(1, 1));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(test_short_writes);
+
+  if(!UNIT_TEST_PASSED(test_short_writes)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
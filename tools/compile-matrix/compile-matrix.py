@@ -0,0 +1,272 @@
+#!/usr/bin/env python3
+"""Build a matrix of examples, targets and configurations in parallel.
+
+The combinations are either those of the compile tests, read from the
+EXAMPLES list of their Makefiles:
+
+  compile-matrix.py --tests tests/01-compile-base
+
+or the product of examples, targets, and configurations of make
+variables, where each --config adds one configuration:
+
+  compile-matrix.py --examples 'examples/hello-world' 'examples/nullnet' \\
+      --targets native cooja --config '' --config MAKE_NET=MAKE_NET_NULLNET
+
+A target can carry variables too, as in simplelink:BOARD=sensortag/cc2650.
+Without --examples, the examples are all directories below examples/
+that have a Makefile.
+
+Each combination is built in a build directory of its own, and the
+combinations are built in parallel. The objects are shared between the
+combinations through objcache.py, which caches them by the hash of
+their preprocessed source and compiler flags, and which is kept between
+runs. For each combination, the build time, the number of objects taken
+from the cache, and the text, data and bss size of each binary are
+reported. With --csv, the results are also written to a file, which can
+be given as the --baseline of a later run to report the binaries that
+grew.
+"""
+
+import argparse
+import concurrent.futures
+import csv
+import glob
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+CONTIKI = os.path.normpath(os.path.join(os.path.dirname(
+    os.path.abspath(__file__)), '..', '..'))
+OBJCACHE = os.path.join(CONTIKI, 'tools', 'compile-matrix', 'objcache.py')
+FIELDS = ['combination', 'binary', 'status', 'seconds', 'hits', 'objects',
+          'text', 'data', 'bss']
+
+
+class Combination:
+    def __init__(self, directory, target, variables):
+        self.directory = directory
+        self.target = target
+        self.variables = variables
+        self.name = ':'.join([os.path.relpath(directory, CONTIKI) + '/' +
+                              target] + variables)
+        self.status = None
+        self.seconds = 0
+        self.hits = 0
+        self.objects = 0
+        self.sizes = {}
+        self.log = ''
+
+
+def split_entry(entry):
+    """Split target:VAR=value:... into the target and its variables."""
+    parts = entry.split(':')
+    return parts[0], [part for part in parts[1:] if '=' in part]
+
+
+def makefile_variables(path):
+    """The simple assignments of a Makefile, with continued lines joined."""
+    with open(path) as f:
+        text = re.sub(r'\\\n', ' ', f.read())
+    variables = {}
+    for line in text.splitlines():
+        match = re.match(r'^(\w+)\s*[:?]?=\s*(.*)$', line)
+        if match:
+            variables[match.group(1)] = match.group(2).split()
+    return variables
+
+
+def from_tests(directory):
+    variables = makefile_variables(os.path.join(directory, 'Makefile'))
+    examples = os.path.join(directory,
+                            ' '.join(variables.get('EXAMPLESDIR', ['.'])))
+    combinations = []
+    for entry in variables.get('EXAMPLES', []):
+        path, variables_ = split_entry(entry)
+        example, target = os.path.split(path)
+        combinations.append(Combination(
+            os.path.normpath(os.path.join(examples, example)), target,
+            variables_))
+    return combinations
+
+
+def from_product(examples, targets, configs):
+    if not examples:
+        examples = sorted(os.path.dirname(path) for path in glob.glob(
+            os.path.join(CONTIKI, 'examples', '**', 'Makefile'),
+            recursive=True))
+    combinations = []
+    for example in examples:
+        for entry in targets:
+            target, target_variables = split_entry(entry)
+            for config in configs:
+                combinations.append(Combination(
+                    os.path.abspath(example), target,
+                    target_variables + config.split()))
+    return combinations
+
+
+def build(combination, index, args):
+    build_dir = os.path.join(args.build_dir, str(index))
+    shutil.rmtree(build_dir, ignore_errors=True)
+    os.makedirs(build_dir)
+    size_log = os.path.join(build_dir, 'sizes.log')
+    cache_log = os.path.join(build_dir, 'objcache.log')
+    command = [args.make, '-C', combination.directory,
+               'TARGET=' + combination.target, 'BUILD_DIR=' + build_dir,
+               'BINARY_SIZE_LOGFILE=' + size_log] + combination.variables
+    if args.make_jobs > 1:
+        command.append('-j{}'.format(args.make_jobs))
+    env = dict(os.environ, OBJCACHE_LOG=cache_log)
+    if args.cache:
+        command.append('CCACHE=' + OBJCACHE)
+        env['OBJCACHE_DIR'] = args.cache
+
+    start = time.monotonic()
+    result = subprocess.run(command, env=env, stdout=subprocess.PIPE,
+                            stderr=subprocess.STDOUT, stdin=subprocess.DEVNULL)
+    combination.seconds = time.monotonic() - start
+    combination.log = result.stdout.decode(errors='replace')
+
+    if os.path.exists(cache_log):
+        with open(cache_log) as f:
+            results = [line.split()[0] for line in f]
+        combination.hits = results.count('hit')
+        combination.objects = len(results)
+    if os.path.exists(size_log):
+        with open(size_log) as f:
+            for line in f:
+                fields = line.split()
+                if len(fields) >= 6 and fields[0].isdigit():
+                    combination.sizes[os.path.basename(fields[5])] = [
+                        int(field) for field in fields[:3]]
+    if result.returncode != 0:
+        combination.status = 'failed'
+    elif combination.sizes:
+        combination.status = 'ok'
+    else:
+        combination.status = 'skipped'
+    if not args.keep:
+        shutil.rmtree(build_dir, ignore_errors=True)
+    return combination
+
+
+def rows(combinations):
+    for c in combinations:
+        common = [c.name, c.status, '{:.1f}'.format(c.seconds), c.hits,
+                  c.objects]
+        for binary, sizes in sorted(c.sizes.items()) or [('', ['', '', ''])]:
+            yield dict(zip(FIELDS, common[:1] + [binary] + common[1:] +
+                           sizes))
+
+
+def read_baseline(path):
+    baseline = {}
+    with open(path) as f:
+        for row in csv.DictReader(f):
+            if row['text']:
+                baseline[row['combination'], row['binary']] = row
+    return baseline
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--tests', nargs='+', default=[],
+                        help='compile test directories to take the'
+                        ' combinations from')
+    parser.add_argument('--examples', nargs='+', default=[])
+    parser.add_argument('--targets', nargs='+', default=[])
+    parser.add_argument('--config', action='append', default=[],
+                        help='make variables of a configuration')
+    parser.add_argument('-j', '--jobs', type=int, default=os.cpu_count(),
+                        help='combinations built at the same time')
+    parser.add_argument('--make-jobs', type=int, default=1,
+                        help='jobs of each make')
+    parser.add_argument('--make', default=os.environ.get('MAKE', 'make'))
+    parser.add_argument('--cache', default=os.path.join(
+        os.environ.get('XDG_CACHE_HOME', os.path.expanduser('~/.cache')),
+        'contiki-ng', 'objects'), help='object cache directory')
+    parser.add_argument('--no-cache', dest='cache', action='store_const',
+                        const=None)
+    parser.add_argument('--build-dir',
+                        help='where to build (default: a temporary directory)')
+    parser.add_argument('--keep', action='store_true',
+                        help='keep the build directories')
+    parser.add_argument('--csv', help='write the results to a file')
+    parser.add_argument('--baseline', help='results of an earlier run')
+    parser.add_argument('--threshold', type=int, default=0,
+                        help='bytes a binary may grow by')
+    parser.add_argument('-v', '--verbose', action='store_true',
+                        help='show the output of failed builds')
+    args = parser.parse_args()
+
+    combinations = []
+    for directory in args.tests:
+        combinations += from_tests(directory)
+    if args.targets:
+        combinations += from_product(args.examples, args.targets,
+                                     args.config or [''])
+    if not combinations:
+        parser.error('no combinations; give --tests or --targets')
+    temporary = args.build_dir is None
+    if temporary:
+        args.build_dir = tempfile.mkdtemp(prefix='compile-matrix-')
+    args.build_dir = os.path.abspath(args.build_dir)
+
+    start = time.monotonic()
+    width = max(len(c.name) for c in combinations)
+    with concurrent.futures.ThreadPoolExecutor(args.jobs) as executor:
+        futures = [executor.submit(build, c, i, args)
+                   for i, c in enumerate(combinations)]
+        for future in concurrent.futures.as_completed(futures):
+            c = future.result()
+            sizes = [sum(s[i] for s in c.sizes.values()) for i in range(3)]
+            print('{:<{}} {:>7} {:6.1f}s {:>4}/{:<4} {:>7} {:>6} {:>6}'.format(
+                c.name, width, c.status, c.seconds, c.hits, c.objects,
+                *(sizes if c.sizes else ['', '', ''])), flush=True)
+            if c.status == 'failed' and args.verbose:
+                print(c.log)
+    elapsed = time.monotonic() - start
+    if temporary and not args.keep:
+        shutil.rmtree(args.build_dir, ignore_errors=True)
+
+    results = list(rows(combinations))
+    if args.csv:
+        with open(args.csv, 'w', newline='') as f:
+            writer = csv.DictWriter(f, FIELDS)
+            writer.writeheader()
+            writer.writerows(results)
+
+    failed = [c.name for c in combinations if c.status == 'failed']
+    grown = []
+    if args.baseline:
+        baseline = read_baseline(args.baseline)
+        for row in results:
+            old = baseline.get((row['combination'], row['binary']))
+            if old is None or row['text'] == '':
+                continue
+            growth = [row[f] - int(old[f]) for f in ('text', 'data', 'bss')]
+            if sum(growth) > args.threshold:
+                grown.append('{} {}: text {:+d}, data {:+d}, bss {:+d}'.format(
+                    row['combination'], row['binary'], *growth))
+
+    hits = sum(c.hits for c in combinations)
+    objects = sum(c.objects for c in combinations)
+    print('{} combinations in {:.1f}s ({:.1f}s of builds), {} failed,'
+          ' {} skipped, {} of {} objects from the cache'.format(
+              len(combinations), elapsed,
+              sum(c.seconds for c in combinations), len(failed),
+              sum(c.status == 'skipped' for c in combinations), hits,
+              objects))
+    for name in failed:
+        print('Failed: ' + name)
+    for line in grown:
+        print('Grown: ' + line)
+    sys.exit(1 if failed or grown else 0)
+
+
+if __name__ == '__main__':
+    main()
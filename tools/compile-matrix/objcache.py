@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+"""Content-addressed cache for object files, run in place of ccache.
+
+The build runs $(CCACHE) $(CC) ... -c source -o object, so the cache is
+used with:
+
+  make CCACHE=/path/to/objcache.py OBJCACHE_DIR=/path/to/cache
+
+An object is looked up by a hash of the preprocessed source, the
+compiler, and the flags other than those for the preprocessor, such as
+-D and -I, whose effect is already in the preprocessed source. Two
+builds with different defines therefore share the objects of all files
+that the defines do not change. The preprocessor run also writes the
+dependency file that the build asks for.
+
+If OBJCACHE_LOG is set, a line with "hit" or "miss" and the object is
+appended to that file for each compilation.
+"""
+
+import hashlib
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+# Flags that only affect the preprocessor, followed by an argument
+PREPROCESSOR_ARG_FLAGS = {'-D', '-U', '-I', '-include', '-imacros',
+                          '-isystem', '-iquote', '-idirafter', '-MT', '-MQ',
+                          '-MF'}
+PREPROCESSOR_FLAGS = {'-M', '-MM', '-MD', '-MMD', '-MP', '-MG'}
+
+
+def parse(args):
+    """Split the flags of a compilation into those for the preprocessor
+    run and those for the key, or return None if it is not cacheable."""
+    if '-c' not in args or '-o' not in args:
+        return None
+    output = None
+    preprocess = []
+    key = []
+    i = 0
+    while i < len(args):
+        arg = args[i]
+        if arg == '-o' and i + 1 < len(args):
+            output = args[i + 1]
+            i += 2
+            continue
+        if arg in PREPROCESSOR_ARG_FLAGS and i + 1 < len(args):
+            preprocess += args[i:i + 2]
+            i += 2
+            continue
+        if arg in ('-E', '-S', '-'):
+            return None
+        if arg != '-c':
+            preprocess.append(arg)
+            if arg not in PREPROCESSOR_FLAGS and arg[:2] not in (
+                    '-D', '-U', '-I') and not arg.startswith('-MF'):
+                key.append(arg)
+        i += 1
+    if output is None:
+        return None
+    return output, preprocess, key
+
+
+def compiler_identity(cc):
+    path = shutil.which(cc)
+    if path is None:
+        return cc
+    st = os.stat(path)
+    return '{}:{}:{}'.format(os.path.realpath(path), st.st_size, st.st_mtime)
+
+
+def log(result, output):
+    name = os.environ.get('OBJCACHE_LOG')
+    if name:
+        with open(name, 'a') as f:
+            f.write('{} {}\n'.format(result, output))
+
+
+def store(path, data):
+    directory = os.path.dirname(path)
+    os.makedirs(directory, exist_ok=True)
+    fd, tmp = tempfile.mkstemp(dir=directory)
+    with os.fdopen(fd, 'wb') as f:
+        f.write(data)
+    os.replace(tmp, path)
+
+
+def main():
+    command = sys.argv[1:]
+    cache = os.environ.get('OBJCACHE_DIR')
+    parsed = parse(command[1:]) if cache and command else None
+    if parsed is None:
+        os.execvp(command[0], command)
+    output, preprocess, key = parsed
+
+    result = subprocess.run(command[:1] + preprocess + ['-E'],
+                            stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+    if result.returncode != 0:
+        # Let the compiler report the error.
+        os.execvp(command[0], command)
+    h = hashlib.sha256()
+    h.update(compiler_identity(command[0]).encode())
+    h.update('\0'.join(key).encode() + b'\0')
+    h.update(result.stdout)
+    digest = h.hexdigest()
+    path = os.path.join(cache, digest[:2], digest[2:])
+
+    try:
+        with open(path + '.o', 'rb') as f:
+            obj = f.read()
+        with open(path + '.stderr', 'rb') as f:
+            sys.stderr.buffer.write(f.read())
+        store(output, obj)
+        log('hit', output)
+        return 0
+    except FileNotFoundError:
+        pass
+
+    result = subprocess.run(command, stderr=subprocess.PIPE)
+    sys.stderr.buffer.write(result.stderr)
+    if result.returncode == 0:
+        with open(output, 'rb') as f:
+            obj = f.read()
+        # The object last, so that a hit always finds the messages
+        store(path + '.stderr', result.stderr)
+        store(path + '.o', obj)
+    log('miss', output)
+    return result.returncode
+
+
+if __name__ == '__main__':
+    sys.exit(main())
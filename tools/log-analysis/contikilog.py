@@ -0,0 +1,535 @@
+"""Read Contiki-NG logs and extract metrics from them.
+
+The logs are those of Cooja simulations, testbeds or native nodes, in
+which each line may carry a "[LEVEL: MODULE] " prefix from os/sys/log.
+The lines of a log are read as records with the time in seconds, the
+node, the level, the module and the message. The time and the node are
+None for the output of a single node without them. The format of a log
+is detected from its first lines:
+
+  123456\tID:2\t[INFO: App       ] ...      Cooja log listener, in ms
+  01:23.456\tID:2\t[INFO: App       ] ...   the same, formatted
+  123456000 2 [INFO: App       ] ...        Cooja script log, in us
+  1712345678.123;m3-2;[INFO: App       ] ... testbed, in s
+  [INFO: App       ] ...                    a single node
+
+The records are given to extractors, each of which collects the rows of
+one or more tables. A log is read in large chunks, which are searched
+with one regular expression for the lines of the modules that the
+extractors need, so that the other lines are skipped outside of Python.
+
+A large log can be split with split_log() into parts that are read in
+parallel. The extractors of the parts are then combined in order with
+merge(), which also completes the packets and the energest periods that
+span two parts.
+"""
+
+import collections
+import functools
+import gzip
+import operator
+import os
+import re
+import sys
+
+Record = collections.namedtuple('Record', 'time node level module message')
+
+# The time and node part of each format, and its time units per second
+FORMATS = collections.OrderedDict([
+    ('cooja', (r'(\d+)\tID:(\d+)\t', 1000)),
+    ('cooja-seconds', (r'(\d+\.\d+)\tID:(\d+)\t', 1)),
+    ('cooja-formatted', (r'((?:\d+:)?\d+:\d+\.\d+)\tID:(\d+)\t', None)),
+    ('cooja-script', (r'(\d+) (\d+) ', 1000000)),
+    ('testbed', (r'(\d+(?:\.\d+)?);[^;\n]*?(\d+);', 1)),
+    ('node', (r'()()', None)),
+])
+TIME_UNITS = {'us': 1000000, 'ms': 1000, 's': 1}
+COLOR = re.compile(r'\x1b\[[0-9;]*m')
+DETECT_LINES = 200
+CHUNK = 1 << 23
+
+
+def open_log(name):
+    """Open a log for reading bytes. It may be compressed with gzip, or be
+    "-" for stdin."""
+    if name == '-':
+        return sys.stdin.buffer
+    if name.endswith('.gz'):
+        return gzip.open(name, 'rb')
+    return open(name, 'rb')
+
+
+def formatted_time(text):
+    seconds = 0.0
+    for part in text.split(':'):
+        seconds = seconds * 60 + float(part)
+    return seconds
+
+
+def detect_format(text):
+    """The format that matches most of the first lines of a log, and the
+    time of its first line."""
+    head = text.splitlines()[:DETECT_LINES]
+    fmt, best = 'node', 0
+    for name, (prefix, _) in FORMATS.items():
+        pattern = re.compile(prefix)
+        count = sum(1 for line in head if pattern.match(line))
+        if name != 'node' and count > best:
+            fmt, best = name, count
+    m = re.search('^' + FORMATS[fmt][0], text, re.M)
+    return fmt, m.group(1) if m else None
+
+
+def split_log(path, parts):
+    """Split a log file into at most the given number of parts of whole
+    lines, as pairs of byte offsets."""
+    size = os.path.getsize(path)
+    offsets = [0]
+    with open(path, 'rb') as f:
+        for i in range(1, parts):
+            f.seek(max(size * i // parts, offsets[-1]))
+            f.readline()
+            offsets.append(min(f.tell(), size))
+    offsets.append(size)
+    return [(a, b) for a, b in zip(offsets, offsets[1:]) if b > a]
+
+
+class LogReader:
+    """Read a log in large chunks of whole lines, which are searched with
+    regular expressions, so that most of the work is done outside of
+    Python.
+
+    A reader of a part of a log is given the file at the start of the
+    part, the offset of its end, and the format and first time that were
+    detected at the start of the log.
+    """
+
+    def __init__(self, f, time_unit=None, fmt=None, first=None, end=None):
+        self.f = f
+        self.remaining = None if end is None else end - f.tell()
+        self.rest = self.read()
+        if fmt is None:
+            fmt, first = detect_format(self.rest)
+        self.format = fmt
+        self.prefix, self.scale = FORMATS[fmt]
+        self.first = first
+        if time_unit is not None and fmt != 'cooja-formatted':
+            self.scale = TIME_UNITS[time_unit]
+        # Testbed times are relative to the start of the log.
+        self.start = float(first) if fmt == 'testbed' and first else None
+        # The lines with their time, node, level and padded module. Each
+        # line is matched with the newline before it.
+        self.line_pattern = re.compile(
+            r'\n' + self.prefix + r'(?:\[(\w+) *: ([^\]\n]*)\] )?')
+
+    def read(self):
+        size = CHUNK
+        if self.remaining is not None:
+            size = min(size, self.remaining)
+            self.remaining -= size
+        return self.f.read(size).decode(errors='replace')
+
+    def time(self, text):
+        """The time in seconds of the time of a line."""
+        if not text:
+            return None
+        if self.scale is None:
+            return formatted_time(text)
+        if self.start is not None:
+            return round(float(text) - self.start, 6)
+        return int(text) / self.scale if text.isdigit() else \
+            float(text) / self.scale
+
+    def record_pattern(self, modules):
+        """A pattern of the lines of the given modules, or of all lines."""
+        if modules is None:
+            module = r'(?:\[(\w+) *: ([^\]\n]*?) *\] )?'
+        else:
+            module = r'\[(\w+) *: (' + '|'.join(
+                re.escape(m) for m in sorted(modules)) + r') *\] '
+        return re.compile(r'\n' + self.prefix + module + r'([^\r\n]*)')
+
+    def chunks(self):
+        """Yield the log in chunks of whole lines, each of which starts
+        with a newline."""
+        while self.rest:
+            data = self.read()
+            text = self.rest + data
+            end = text.rfind('\n') + 1 if data else len(text)
+            self.rest = text[end:]
+            chunk = '\n' + text[:end]
+            if '\x1b' in chunk:
+                chunk = COLOR.sub('', chunk)
+            yield chunk
+
+    def records(self, chunk, pattern):
+        """Yield the records of the lines in a chunk that match a pattern
+        from record_pattern()."""
+        time = self.time
+        for t, node, level, module, message in pattern.findall(chunk):
+            yield Record(time(t), int(node) if node else None, level or None,
+                         module or None, message)
+
+
+def read_records(f, time_unit=None, modules=None):
+    """Yield the records of the lines of a log file, or of those of the
+    given modules."""
+    reader = LogReader(f, time_unit)
+    pattern = reader.record_pattern(modules)
+    for chunk in reader.chunks():
+        yield from reader.records(chunk, pattern)
+
+
+ADDRESS_NODE = re.compile(r'-(\d+)$')
+
+
+@functools.lru_cache(maxsize=4096)
+def node_id(address):
+    """The node ID of an address as printed by the log module, such as
+    fd00::202:2:2:2, 0002.0002.0002.0002 or 6G-2, or None for NULL."""
+    if address is None or 'NULL' in address:
+        return None
+    address = address.strip('(),')
+    m = ADDRESS_NODE.search(address)
+    if m:
+        return int(m.group(1))
+    for separator in (':', '.'):
+        if separator in address:
+            return int(address.rsplit(separator, 1)[1] or '0', 16)
+    return int(address)
+
+
+def percentile(values, p):
+    """The p-th percentile of sorted values, interpolated linearly."""
+    if not values:
+        return None
+    k = (len(values) - 1) * p / 100
+    low = int(k)
+    high = min(low + 1, len(values) - 1)
+    return round(values[low] + (values[high] - values[low]) * (k - low), 6)
+
+
+def node_order(node):
+    return -1 if node is None else node
+
+
+class Extractor:
+    """Collects tables from the records of some modules."""
+
+    # The modules of the records to feed, or None for all
+    modules = None
+
+    def feed(self, record):
+        raise NotImplementedError
+
+    def merge(self, later):
+        """Add what the extractor of the next part of a log collected."""
+        raise NotImplementedError
+
+    def tables(self):
+        """A dict from table names to pairs of columns and rows."""
+        raise NotImplementedError
+
+
+class Levels(Extractor):
+    """Log lines per node, and per node, module and level.
+
+    The lines are counted per chunk with scan(), and only the records of
+    the Main module are fed, to count the starts of the nodes.
+    """
+
+    modules = {'Main'}
+
+    def __init__(self):
+        self.counts = collections.Counter()
+        self.first = {}
+        self.last = {}
+        self.starts = collections.Counter()
+
+    def scan(self, reader, chunk):
+        lines = reader.line_pattern.findall(chunk)
+        nodes = list(map(operator.itemgetter(1), lines))
+        times = list(map(operator.itemgetter(0), lines))
+        self.counts.update(map(operator.itemgetter(1, 2, 3), lines))
+        for node, t in dict(zip(nodes, times)).items():
+            self.last[node] = reader.time(t)
+        # The first line of a node is the last one seen in reverse.
+        for node, t in dict(zip(reversed(nodes), reversed(times))).items():
+            if node not in self.first:
+                self.first[node] = reader.time(t)
+
+    def feed(self, record):
+        if record.message.startswith('Starting Contiki-NG'):
+            self.starts[record.node] += 1
+
+    def merge(self, later):
+        self.counts.update(later.counts)
+        for node, t in later.first.items():
+            self.first.setdefault(node, t)
+        self.last.update(later.last)
+        self.starts.update(later.starts)
+
+    def tables(self):
+        def node(text):
+            return int(text) if text else None
+        lines = collections.Counter()
+        modules = collections.Counter()
+        for (n, level, module), count in self.counts.items():
+            lines[n] += count
+            modules[node(n), module.rstrip() or None, level or None] += count
+        return {
+            'nodes': (['node', 'lines', 'first', 'last', 'starts'], [
+                [node(n), lines[n], self.first[n], self.last[n],
+                 self.starts[node(n)]]
+                for n in sorted(lines, key=lambda n: node_order(node(n)))]),
+            'modules': (['node', 'module', 'level', 'lines'], [
+                list(k) + [v] for k, v in sorted(
+                    modules.items(),
+                    key=lambda i: (node_order(i[0][0]), str(i[0][1:])))]),
+        }
+
+
+class Energest(Extractor):
+    """The periods reported by os/services/simple-energest."""
+
+    modules = {'Energest'}
+    COLUMNS = ['node', 'time', 'period', 'seconds', 'total', 'cpu', 'lpm',
+               'deep_lpm', 'radio_tx', 'radio_rx', 'duty_cycle']
+    NAMES = {'Total time': 'total', 'CPU': 'cpu', 'LPM': 'lpm',
+             'Deep LPM': 'deep_lpm', 'Radio Tx': 'radio_tx',
+             'Radio Rx': 'radio_rx', 'Radio total': 'radio'}
+    SUMMARY = re.compile(r'--- Period summary #(\d+) \((\d+) seconds\)')
+    VALUE = re.compile(r'(.*?)\s*:\s*(\d+)')
+
+    def __init__(self):
+        self.rows = []
+        self.current = {}
+        # The values of the nodes before their first summary, which end a
+        # period that began in the previous part of a log
+        self.leading = {}
+        self.seen = set()
+
+    def feed(self, record):
+        m = self.SUMMARY.match(record.message)
+        if m:
+            self.seen.add(record.node)
+            self.current[record.node] = dict(
+                node=record.node, time=record.time, period=int(m.group(1)),
+                seconds=int(m.group(2)))
+            return
+        m = self.VALUE.match(record.message)
+        if m is None or m.group(1) not in self.NAMES:
+            return
+        row = self.current.get(record.node)
+        if row is None:
+            if record.node in self.seen:
+                return
+            row = self.leading.setdefault(record.node, {})
+        row[self.NAMES[m.group(1)]] = int(m.group(2))
+        if m.group(1) == 'Radio total' and record.node in self.current:
+            self.complete(self.current.pop(record.node))
+
+    def complete(self, row):
+        if row.get('total') and 'radio' in row:
+            row['duty_cycle'] = 100.0 * row['radio'] / row['total']
+        self.rows.append([row.get(c) for c in self.COLUMNS])
+
+    def merge(self, later):
+        for node, values in later.leading.items():
+            row = self.current.pop(node, None)
+            if row is not None:
+                row.update(values)
+                if 'radio' in values:
+                    self.complete(row)
+                elif node not in later.seen:
+                    self.current[node] = row
+        self.rows.extend(later.rows)
+        self.current.update(later.current)
+        self.seen |= later.seen
+
+    def tables(self):
+        return {'energest': (self.COLUMNS, self.rows)}
+
+
+class Packets(Extractor):
+    """Packets matched from the log lines of their sending and receiving.
+
+    A packet is identified by its source node and the "id" group of the
+    patterns. A sending pattern may name the destination in a "dst"
+    group. A receiving pattern names the source in a "src" group, for
+    one-way packets, or the node that a request was sent to in a "peer"
+    group, for round trips that end at the source. The packets sent in
+    the last settle seconds of a log are left out, as they may still be
+    in flight. Only the lines of the given modules are matched, by
+    default those of "App".
+    """
+
+    SEND = [r'Sending request (?P<id>\d+) to (?P<dst>\S+)',
+            r'app generate packet seqnum=(?P<id>\d+)']
+    RECEIVE = [r'Received response (?P<id>\d+) from (?P<peer>\S+)',
+               r'app receive packet seqnum=(?P<id>\d+) from=(?P<src>\S+)']
+    COLUMNS = ['src', 'id', 'dst', 'sent', 'received', 'latency']
+
+    def __init__(self, send=None, receive=None, modules=None, settle=0):
+        self.send = [re.compile(p) for p in send or self.SEND]
+        self.receive = [re.compile(p) for p in receive or self.RECEIVE]
+        self.modules = set(modules or ['App'])
+        self.settle = settle
+        self.packets = {}
+        # The receptions of packets that were not sent in this part
+        self.orphans = []
+        self.last = 0
+
+    def feed(self, record):
+        message = record.message
+        if record.time is not None:
+            self.last = record.time
+        for pattern in self.send:
+            m = pattern.match(message)
+            if m:
+                key = record.node, int(m.group('id'))
+                if key not in self.packets:
+                    dst = m.groupdict().get('dst')
+                    self.packets[key] = [record.node, key[1], node_id(dst),
+                                         record.time, None, None]
+                return
+        for pattern in self.receive:
+            m = pattern.match(message)
+            if m:
+                src = m.groupdict().get('src')
+                key = (node_id(src) if src else record.node,
+                       int(m.group('id')))
+                if not self.received(key, record.time):
+                    self.orphans.append((key, record.time))
+                return
+
+    def received(self, key, time):
+        packet = self.packets.get(key)
+        if packet is None:
+            return False
+        if packet[4] is None:
+            packet[4] = time
+            if time is not None and packet[3] is not None:
+                packet[5] = round(time - packet[3], 6)
+        return True
+
+    def merge(self, later):
+        for key, time in later.orphans:
+            self.received(key, time)
+        for key, packet in later.packets.items():
+            self.packets.setdefault(key, packet)
+        self.last = max(self.last, later.last)
+
+    def tables(self):
+        packets = [p for p in self.packets.values()
+                   if p[3] is None or p[3] <= self.last - self.settle]
+        per_node = collections.defaultdict(list)
+        for p in packets:
+            per_node[p[0]].append(p)
+        pdr = []
+        for node in sorted(per_node, key=node_order):
+            sent = per_node[node]
+            latencies = sorted(p[5] for p in sent if p[5] is not None)
+            received = sum(1 for p in sent if p[4] is not None)
+            pdr.append([node, len(sent), received, 100.0 * received / len(sent),
+                        sum(latencies) / len(latencies) if latencies else None,
+                        percentile(latencies, 50), percentile(latencies, 95),
+                        latencies[-1] if latencies else None])
+        return {
+            'packets': (self.COLUMNS, packets),
+            'pdr': (['node', 'sent', 'received', 'pdr', 'latency_mean',
+                     'latency_p50', 'latency_p95', 'latency_max'], pdr),
+        }
+
+
+class Convergence(Extractor):
+    """The times at which nodes joined TSCH and RPL, and at which the
+    PraSLE leader election converged."""
+
+    modules = {'TSCH', 'RPL', 'PraSLE'}
+    COLUMNS = ['node', 'tsch_join', 'tsch_leaves', 'rpl_join',
+               'parent_switches', 'parent', 'election_time', 'election_round',
+               'leader', 'election_ms']
+    ELECTION = ('election_time', 'election_round', 'leader', 'election_ms')
+    PARENT = re.compile(r'parent switch: (.*) -> (.*)$')
+    CONVERGED = re.compile(r'CONVERGED at round (\d+): Leader = (\d+)')
+    CONVERGENCE_TIME = re.compile(r'Convergence time: (\d+) ms')
+
+    def __init__(self):
+        self.nodes = {}
+
+    def node(self, node):
+        row = self.nodes.get(node)
+        if row is None:
+            row = self.nodes[node] = dict.fromkeys(self.COLUMNS)
+            row.update(node=node, tsch_leaves=0, parent_switches=0)
+        return row
+
+    def feed(self, record):
+        message = record.message
+        node = self.node(record.node)
+        if record.module == 'TSCH':
+            if message.startswith('association done'):
+                if node['tsch_join'] is None:
+                    node['tsch_join'] = record.time
+            elif message.startswith('leaving the network, stats'):
+                # Logged once per leave, after any message that gives
+                # the reason for leaving.
+                node['tsch_leaves'] += 1
+        elif record.module == 'RPL':
+            m = self.PARENT.match(message)
+            if m:
+                node['parent_switches'] += 1
+                node['parent'] = node_id(m.group(2))
+                if node['parent'] is not None and node['rpl_join'] is None:
+                    node['rpl_join'] = record.time
+        else:
+            m = self.CONVERGED.match(message)
+            if m:
+                node['election_time'] = record.time
+                node['election_round'] = int(m.group(1))
+                node['leader'] = int(m.group(2))
+                return
+            m = self.CONVERGENCE_TIME.match(message)
+            if m:
+                node['election_ms'] = int(m.group(1))
+
+    def merge(self, later):
+        for n, values in later.nodes.items():
+            node = self.node(n)
+            for column in ('tsch_join', 'rpl_join'):
+                if node[column] is None:
+                    node[column] = values[column]
+            node['tsch_leaves'] += values['tsch_leaves']
+            if values['parent_switches']:
+                node['parent_switches'] += values['parent_switches']
+                node['parent'] = values['parent']
+            for column in self.ELECTION:
+                if values[column] is not None:
+                    node[column] = values[column]
+
+    def tables(self):
+        return {'convergence': (self.COLUMNS, [
+            [self.nodes[n][c] for c in self.COLUMNS]
+            for n in sorted(self.nodes, key=node_order)])}
+
+
+def extract(reader, extractors):
+    """Feed each extractor the records of its modules from a LogReader.
+
+    Extractors with a scan() method are also given each chunk of the log.
+    """
+    any_module = [e for e in extractors if e.modules is None]
+    by_module = {}
+    for e in extractors:
+        for module in e.modules or ():
+            by_module.setdefault(module, list(any_module)).append(e)
+    pattern = reader.record_pattern(None if any_module else by_module)
+    scanners = [e for e in extractors if hasattr(e, 'scan')]
+    for chunk in reader.chunks():
+        for e in scanners:
+            e.scan(reader, chunk)
+        for record in reader.records(chunk, pattern):
+            for e in by_module.get(record.module, any_module):
+                e.feed(record)
+    return extractors
@@ -0,0 +1,267 @@
+#!/usr/bin/env python3
+"""Turn Contiki-NG logs into tables of metrics.
+
+The records of each log are given to the extractors of contikilog.py,
+which collect these tables:
+
+  nodes        log lines, first and last time, and starts per node
+  modules      log lines per node, module and level
+  energest     the periods of os/services/simple-energest
+  packets      application packets with their send and receive times
+  pdr          packet delivery ratio and latency percentiles per node
+  convergence  TSCH and RPL join times, and PraSLE election results
+
+The tables are written as CSV files, or as Parquet files if pyarrow is
+installed, to the output directory. Each row starts with the name of its
+log, so that the tables of many runs can be analysed together. Logs may
+be compressed with gzip. With -j, logs are read in parallel, and a large
+log that is not compressed is split into parts that are read in
+parallel, so that a log of gigabytes is read in seconds on a machine
+with enough cores.
+
+  log-ingest.py -o tables -j 8 runs/*.testlog
+  log-ingest.py -o tables --format parquet --lines COOJA.testlog
+
+The packets are found with the patterns of the two benchmark examples,
+which --send and --receive replace with regular expressions that have
+the groups described in contikilog.Packets:
+
+  log-ingest.py --send 'CoAP request (?P<id>\\d+)' \\
+      --receive 'CoAP response (?P<id>\\d+) from (?P<peer>\\S+)' LOG
+
+With --lines, all records are also written to a lines table per log,
+which makes reading several times slower, as each line is then handled
+in Python rather than only by the regular expressions, and the log is
+not split.
+"""
+
+import argparse
+import csv
+import multiprocessing
+import os
+import sys
+
+import contikilog
+
+LINE_COLUMNS = ['run', 'time', 'node', 'level', 'module', 'message']
+BATCH = 65536
+# Bytes of a log per part when it is split between jobs
+SPLIT = 1 << 25
+
+
+class TableWriter:
+    """Write the rows of a table in batches, as CSV or Parquet."""
+
+    def __init__(self, path, columns, fmt):
+        self.columns = columns
+        self.fmt = fmt
+        self.writer = None
+        if fmt == 'csv':
+            self.file = open(path + '.csv', 'w', newline='')
+            self.writer = csv.writer(self.file)
+            self.writer.writerow(columns)
+        else:
+            self.path = path + '.parquet'
+            self.batch = []
+
+    def write(self, rows):
+        if self.fmt == 'csv':
+            self.writer.writerows(rows)
+            return
+        self.batch.extend(rows)
+        if len(self.batch) >= BATCH:
+            self.flush()
+
+    def flush(self):
+        import pyarrow
+        import pyarrow.parquet
+        table = pyarrow.Table.from_pydict(
+            {c: [row[i] for row in self.batch]
+             for i, c in enumerate(self.columns)})
+        if self.writer is None:
+            self.writer = pyarrow.parquet.ParquetWriter(self.path,
+                                                        table.schema)
+        self.writer.write_table(table.cast(self.writer.schema))
+        self.batch = []
+
+    def close(self):
+        if self.fmt == 'csv':
+            self.file.close()
+            return
+        if self.batch or self.writer is None:
+            self.flush()
+        self.writer.close()
+
+
+def extractors(args):
+    return [contikilog.Levels(), contikilog.Energest(),
+            contikilog.Packets(args.send, args.receive, args.packet_modules,
+                               args.settle),
+            contikilog.Convergence()]
+
+
+def run_name(path):
+    name = os.path.basename(path)
+    return name[:-3] if name.endswith('.gz') else name
+
+
+class Lines(contikilog.Extractor):
+    """Write all records to a table."""
+
+    def __init__(self, path, fmt, run):
+        self.writer = TableWriter(path, LINE_COLUMNS, fmt)
+        self.run = run
+        self.batch = []
+
+    def feed(self, record):
+        self.batch.append((self.run,) + tuple(record))
+        if len(self.batch) == BATCH:
+            self.writer.write(self.batch)
+            self.batch = []
+
+    def close(self):
+        self.writer.write(self.batch)
+        self.writer.close()
+
+
+def ingest(task):
+    """Extract the tables of one log, or of a part of it."""
+    path, part, args = task
+    selected = extractors(args)
+    lines = []
+    if args.lines:
+        run = run_name(path)
+        lines.append(Lines(os.path.join(args.output, 'lines.' + run),
+                           args.format, run))
+    with contikilog.open_log(path) as f:
+        if part is None:
+            reader = contikilog.LogReader(f, args.time_unit)
+        else:
+            (start, end), fmt, first = part
+            f.seek(start)
+            reader = contikilog.LogReader(f, args.time_unit, fmt, first, end)
+        contikilog.extract(reader, selected + lines)
+    for e in lines:
+        e.close()
+    return selected
+
+
+def tasks(path, args):
+    """The tasks of a log, which is split into parts if it is large and
+    there are more jobs than logs."""
+    parts = min(args.jobs // len(args.logs), os.path.getsize(path) // SPLIT) \
+        if path != '-' and not path.endswith('.gz') and not args.lines else 0
+    if parts < 2:
+        return [(path, None, args)]
+    with open(path, 'rb') as f:
+        fmt, first = contikilog.detect_format(
+            f.read(contikilog.CHUNK).decode(errors='replace'))
+    return [(path, (offsets, fmt, first), args)
+            for offsets in contikilog.split_log(path, parts)]
+
+
+def summary(tables):
+    """Print the network-wide metrics of the tables."""
+    def column(table, name):
+        columns, rows = tables.get(table, ([], []))
+        if name not in columns:
+            return []
+        i = columns.index(name)
+        return sorted(row[i] for row in rows if row[i] is not None)
+
+    lines = column('nodes', 'lines')
+    print('{} nodes, {} lines'.format(len(lines), sum(lines)))
+    pdr = tables.get('pdr')
+    if pdr and pdr[1]:
+        sent = sum(column('pdr', 'sent'))
+        received = sum(column('pdr', 'received'))
+        latency = column('packets', 'latency')
+        print('PDR {:.2f}% ({} of {} packets)'.format(
+            100.0 * received / sent if sent else 0, received, sent), end='')
+        if latency:
+            print(', latency p50 {:.3f} s, p95 {:.3f} s, max {:.3f} s'.format(
+                contikilog.percentile(latency, 50),
+                contikilog.percentile(latency, 95), latency[-1]), end='')
+        print()
+    duty_cycle = column('energest', 'duty_cycle')
+    if duty_cycle:
+        print('Radio duty cycle p50 {:.2f}%, p95 {:.2f}%, max {:.2f}%'.format(
+            contikilog.percentile(duty_cycle, 50),
+            contikilog.percentile(duty_cycle, 95), duty_cycle[-1]))
+    for name, label in (('tsch_join', 'TSCH join'), ('rpl_join', 'RPL join'),
+                        ('election_time', 'Election convergence')):
+        times = column('convergence', name)
+        if times:
+            print('{} of {} nodes: p50 {:.1f} s, last {:.1f} s'.format(
+                label, len(times), contikilog.percentile(times, 50),
+                times[-1]))
+    leaders = set(column('convergence', 'leader'))
+    if leaders:
+        print('Elected leaders: {}'.format(
+            ', '.join(str(n) for n in sorted(leaders))))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('logs', nargs='+')
+    parser.add_argument('-o', '--output', default='.',
+                        help='directory of the tables')
+    parser.add_argument('--format', choices=['csv', 'parquet'],
+                        default='csv')
+    parser.add_argument('-j', '--jobs', type=int, default=1,
+                        help='processes that read the logs')
+    parser.add_argument('--time-unit', choices=sorted(contikilog.TIME_UNITS),
+                        help='unit of the times in the logs (default: that'
+                        ' of the detected format)')
+    parser.add_argument('--lines', action='store_true',
+                        help='also write all records, one table per log')
+    parser.add_argument('--send', action='append',
+                        help='pattern of a sent packet')
+    parser.add_argument('--receive', action='append',
+                        help='pattern of a received packet')
+    parser.add_argument('--packet-modules', nargs='+',
+                        help='modules of the packet log lines'
+                        ' (default: App)')
+    parser.add_argument('--settle', type=float, default=0,
+                        help='seconds before the end of a log in which'
+                        ' sent packets are not counted')
+    parser.add_argument('-q', '--quiet', action='store_true',
+                        help='do not print a summary')
+    args = parser.parse_args()
+    if args.format == 'parquet':
+        try:
+            import pyarrow.parquet  # noqa: F401
+        except ImportError:
+            parser.error('--format parquet needs pyarrow')
+    os.makedirs(args.output, exist_ok=True)
+
+    logs = [(path, tasks(path, args)) for path in args.logs]
+    all_tasks = [task for _, log_tasks in logs for task in log_tasks]
+    if args.jobs > 1 and len(all_tasks) > 1:
+        with multiprocessing.Pool(min(args.jobs, len(all_tasks))) as pool:
+            results = iter(pool.map(ingest, all_tasks))
+    else:
+        results = map(ingest, all_tasks)
+
+    tables = {}
+    for path, log_tasks in logs:
+        run = run_name(path)
+        selected = next(results)
+        for _ in log_tasks[1:]:
+            for e, later in zip(selected, next(results)):
+                e.merge(later)
+        for e in selected:
+            for name, (columns, rows) in e.tables().items():
+                table = tables.setdefault(name, (['run'] + columns, []))
+                table[1].extend([run] + list(row) for row in rows)
+    for name, (columns, rows) in sorted(tables.items()):
+        writer = TableWriter(os.path.join(args.output, name), columns,
+                             args.format)
+        writer.write(rows)
+        writer.close()
+    if not args.quiet:
+        summary(tables)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,522 @@
+#!/usr/bin/env python3
+"""Write static HTML dashboards of the tables of log-ingest.py.
+
+The report correlates the periods of os/services/simple-energest with
+the events of the application: the packets and their latency, the TSCH
+and RPL joins, and the PraSLE election. For each run, a page shows:
+
+  - a timeline per node of the radio duty cycle of each energest
+    period, with markers at the TSCH join, the RPL join and the
+    convergence of the election of the node,
+  - the latency of each packet over time, with the lost packets,
+  - a topology heatmap of the mean duty cycle of the nodes, with the
+    links to their RPL parents,
+  - a table of the metrics of each node.
+
+The index page has the network-wide percentiles of all runs, a histogram
+of the mean duty cycle of the nodes, and a table of the runs, with the
+runs that have the hottest node first, so that the energy hotspots of
+hundreds of runs are found at a glance. The duty cycle colours are on
+the same scale on all pages.
+
+  log-ingest.py -o tables runs/*.testlog
+  log-report.py -o report tables
+
+The nodes are placed at their positions in a Cooja simulation given with
+--csc, or else in rows by their depth in the RPL tree. For CoAP latency,
+give log-ingest.py --send and --receive patterns of the CoAP requests
+and responses of the application.
+"""
+
+import argparse
+import collections
+import csv
+import html
+import math
+import os
+import re
+import sys
+import xml.etree.ElementTree
+
+import contikilog
+
+TABLES = ['nodes', 'energest', 'packets', 'pdr', 'convergence']
+STYLE = '''
+body { font-family: sans-serif; margin: 1em 2em; }
+table { border-collapse: collapse; font-size: 90%; }
+th, td { border: 1px solid #ccc; padding: 2px 6px; text-align: right; }
+th { background: #eee; }
+td.name { text-align: left; }
+svg { font-size: 10px; }
+'''
+WIDTH = 900
+MARGIN = 40
+# Packets drawn on a latency plot, of which larger runs draw a sample
+MAX_POINTS = 5000
+# Marker colours of the events on the timelines
+EVENTS = [('tsch_join', 'TSCH join', '#000'),
+          ('rpl_join', 'RPL join', '#06c'),
+          ('election_time', 'election converged', '#a0a')]
+
+
+def value(text):
+    if text == '':
+        return None
+    for kind in (int, float):
+        try:
+            return kind(text)
+        except ValueError:
+            pass
+    return text
+
+
+def read_table(directory, name):
+    """The rows of a table as dicts, read from CSV or Parquet."""
+    path = os.path.join(directory, name)
+    if os.path.exists(path + '.csv'):
+        with open(path + '.csv', newline='') as f:
+            return [{k: v if k == 'run' else value(v) for k, v in row.items()}
+                    for row in csv.DictReader(f)]
+    if os.path.exists(path + '.parquet'):
+        import pyarrow.parquet
+        return pyarrow.parquet.read_table(path + '.parquet').to_pylist()
+    return []
+
+
+def read_positions(path):
+    """The positions of the motes of a Cooja simulation."""
+    positions = {}
+    for mote in xml.etree.ElementTree.parse(path).iter('mote'):
+        node = x = y = None
+        for config in mote.iter('interface_config'):
+            if config.find('id') is not None:
+                node = int(config.find('id').text)
+            if config.find('x') is not None:
+                x = float(config.find('x').text)
+                y = float(config.find('y').text)
+        if node is not None and x is not None:
+            positions[node] = (x, y)
+    return positions
+
+
+def tree_positions(parents):
+    """Positions of the nodes in rows by their depth in the RPL tree."""
+    def depth(node):
+        hops = 0
+        while parents.get(node) is not None and hops < len(parents):
+            node = parents[node]
+            hops += 1
+        return hops
+    rows = collections.defaultdict(list)
+    for node in sorted(parents):
+        rows[depth(node)].append(node)
+    return {node: (i - (len(nodes) - 1) / 2, d)
+            for d, nodes in rows.items() for i, node in enumerate(nodes)}
+
+
+def color(v, high):
+    """A colour from green at zero to red at high."""
+    if v is None:
+        return '#ddd'
+    level = min(max(v / high, 0), 1) if high else 0
+    return 'hsl({:.0f},80%,50%)'.format(120 * (1 - level))
+
+
+def fmt(v, digits=None):
+    if v is None:
+        return ''
+    if isinstance(v, float):
+        if digits is None:
+            return '{:.4g}'.format(v)
+        return '{:.{}f}'.format(v, digits)
+    return html.escape(str(v))
+
+
+def mean(values):
+    values = [v for v in values if v is not None]
+    return sum(values) / len(values) if values else None
+
+
+def percentiles(values, points=(50, 95, 99)):
+    values = sorted(v for v in values if v is not None)
+    return [contikilog.percentile(values, p) for p in points] + \
+        [values[-1] if values else None]
+
+
+def ticks(end):
+    """Round tick values from zero to end."""
+    if not end:
+        return [0]
+    step = 10 ** math.floor(math.log10(end / 8))
+    for factor in (1, 2, 5, 10):
+        if end / (step * factor) <= 10:
+            step *= factor
+            break
+    return [i * step for i in range(int(end / step) + 1)]
+
+
+def time_axis(end, top, scale):
+    parts = []
+    for t in ticks(end):
+        x = MARGIN + t * scale
+        parts.append('<line x1="{0:.1f}" x2="{0:.1f}" y1="{1}" y2="{2}"'
+                     ' stroke="#999"/><text x="{0:.1f}" y="{3}"'
+                     ' text-anchor="middle">{4:g}</text>'.format(
+                         x, top, top + 4, top + 14, t))
+    parts.append('<text x="{}" y="{}" text-anchor="end">s</text>'.format(
+        MARGIN + WIDTH, top + 26))
+    return ''.join(parts)
+
+
+def legend(high, label):
+    stops = ''.join('<stop offset="{}%" stop-color="{}"/>'.format(
+        p, color(high * p / 100, high)) for p in range(0, 101, 25))
+    return ('<svg width="320" height="32"><defs><linearGradient id="scale">'
+            '{}</linearGradient></defs><rect x="0" y="0" width="200"'
+            ' height="12" fill="url(#scale)"/><text x="0" y="26">0</text>'
+            '<text x="200" y="26" text-anchor="middle">{:.2f}</text>'
+            '<text x="220" y="10">{}</text></svg>'.format(
+                stops, high, html.escape(label)))
+
+
+def timeline(nodes, energest, convergence, end, high):
+    """A row per node of the duty cycle of its energest periods."""
+    height = max(4, min(14, 600 // max(len(nodes), 1)))
+    scale = WIDTH / end if end else 0
+    top = len(nodes) * height
+    parts = ['<svg width="{}" height="{}">'.format(MARGIN + WIDTH + 10,
+                                                    top + 30)]
+    for i, node in enumerate(nodes):
+        y = i * height
+        if height >= 8 or i % 5 == 0:
+            parts.append('<text x="{}" y="{}" text-anchor="end">{}</text>'
+                         .format(MARGIN - 4, y + height - 1, node))
+        for row in energest.get(node, []):
+            if row['time'] is None or row['seconds'] is None:
+                continue
+            start = max(row['time'] - row['seconds'], 0)
+            parts.append(
+                '<rect x="{:.1f}" y="{}" width="{:.1f}" height="{}"'
+                ' fill="{}"><title>node {} period {}: duty cycle {}%, CPU'
+                ' {}%</title></rect>'.format(
+                    MARGIN + start * scale, y,
+                    max((row['time'] - start) * scale, 1), height - 1,
+                    color(row['duty_cycle'], high), node, row['period'],
+                    fmt(row['duty_cycle']), fmt(row['cpu_ratio'])))
+        events = convergence.get(node, {})
+        for column, label, stroke in EVENTS:
+            t = events.get(column)
+            if t is not None:
+                parts.append(
+                    '<line x1="{0:.1f}" x2="{0:.1f}" y1="{1}" y2="{2}"'
+                    ' stroke="{3}" stroke-width="2"><title>node {4}: {5} at'
+                    ' {6:.1f} s</title></line>'.format(
+                        MARGIN + t * scale, y, y + height - 1, stroke, node,
+                        label, t))
+    parts.append(time_axis(end, top, scale))
+    parts.append('</svg>')
+    return ''.join(parts)
+
+
+def latency_plot(packets, end):
+    """The latency of the packets over time, with the lost packets in
+    red at the top."""
+    height = 200
+    latencies = [p['latency'] for p in packets if p['latency'] is not None]
+    high = percentiles(latencies, (99,))[0] or 1
+    scale = WIDTH / end if end else 0
+    parts = ['<svg width="{}" height="{}">'.format(MARGIN + WIDTH + 10,
+                                                    height + 30)]
+    for v in ticks(high):
+        y = height - v / high * (height - 10)
+        parts.append('<text x="{}" y="{:.1f}" text-anchor="end">{:g}</text>'
+                     '<line x1="{}" x2="{}" y1="{:.1f}" y2="{:.1f}"'
+                     ' stroke="#eee"/>'.format(MARGIN - 4, y + 3, v, MARGIN,
+                                               MARGIN + WIDTH, y, y))
+    for p in packets[::len(packets) // MAX_POINTS + 1]:
+        if p['sent'] is None:
+            continue
+        x = MARGIN + p['sent'] * scale
+        if p['received'] is None:
+            parts.append('<rect x="{:.1f}" y="0" width="2" height="6"'
+                         ' fill="red"><title>{} #{} lost</title></rect>'
+                         .format(x, p['src'], p['id']))
+        elif p['latency'] is not None:
+            y = height - min(p['latency'] / high, 1) * (height - 10)
+            parts.append('<circle cx="{:.1f}" cy="{:.1f}" r="1.5"'
+                         ' fill="#06c"><title>{} #{}: {:.3f} s</title>'
+                         '</circle>'.format(x, y, p['src'], p['id'],
+                                            p['latency']))
+    parts.append(time_axis(end, height, scale))
+    parts.append('</svg>')
+    return ''.join(parts)
+
+
+def topology(nodes, positions, parents, duty, high):
+    """The nodes at their positions, coloured by their duty cycle, with
+    the links to their RPL parents."""
+    placed = {n: positions[n] for n in nodes if n in positions}
+    if not placed:
+        return ''
+    xs = [p[0] for p in placed.values()]
+    ys = [p[1] for p in placed.values()]
+    size = 500
+    span = max(max(xs) - min(xs), max(ys) - min(ys)) or 1
+
+    def point(node):
+        x, y = placed[node]
+        return (20 + (x - min(xs)) / span * (size - 40),
+                20 + (y - min(ys)) / span * (size - 40))
+    width, height = point(max(placed, key=lambda n: placed[n][0]))[0] + 20, \
+        point(max(placed, key=lambda n: placed[n][1]))[1] + 20
+    radius = max(4, min(10, 150 / math.sqrt(len(placed))))
+    parts = ['<svg width="{:.0f}" height="{:.0f}">'.format(
+        max(width, 100), max(height, 100))]
+    for node in placed:
+        parent = parents.get(node)
+        if parent in placed:
+            (x1, y1), (x2, y2) = point(node), point(parent)
+            parts.append('<line x1="{:.1f}" y1="{:.1f}" x2="{:.1f}"'
+                         ' y2="{:.1f}" stroke="#888"/>'.format(x1, y1, x2, y2))
+    for node in placed:
+        x, y = point(node)
+        parts.append(
+            '<circle cx="{:.1f}" cy="{:.1f}" r="{:.1f}" fill="{}"'
+            ' stroke="#333"><title>node {}: duty cycle {}%</title></circle>'
+            '<text x="{:.1f}" y="{:.1f}" text-anchor="middle">{}</text>'
+            .format(x, y, radius, color(duty.get(node), high), node,
+                    fmt(duty.get(node)), x, y + 3, node))
+    parts.append('</svg>')
+    return ''.join(parts)
+
+
+def histogram(values, high, bins=20):
+    counts = [0] * bins
+    for v in values:
+        counts[min(int(v / high * bins), bins - 1) if high else 0] += 1
+    top = max(counts) or 1
+    bar = WIDTH // bins
+    parts = ['<svg width="{}" height="150">'.format(MARGIN + WIDTH + 10)]
+    for i, count in enumerate(counts):
+        h = count / top * 110
+        parts.append('<rect x="{}" y="{:.1f}" width="{}" height="{:.1f}"'
+                     ' fill="{}"><title>{}: {} nodes</title></rect>'.format(
+                         MARGIN + i * bar, 120 - h, bar - 1, h,
+                         color((i + 0.5) * high / bins, high),
+                         fmt(i * high / bins), count))
+        if i % 4 == 0:
+            parts.append('<text x="{}" y="134">{}%</text>'.format(
+                MARGIN + i * bar, fmt(i * high / bins, 1)))
+    parts.append('</svg>')
+    return ''.join(parts)
+
+
+def html_table(columns, rows, colors=None):
+    """A table of rows of values, where colors maps a column to the
+    function of the background colour of its cells."""
+    colors = colors or {}
+    parts = ['<table><tr>']
+    parts += ['<th>{}</th>'.format(html.escape(c)) for c in columns]
+    parts.append('</tr>')
+    for row in rows:
+        parts.append('<tr>')
+        for column, v in zip(columns, row):
+            if column in colors:
+                parts.append('<td style="background:{}">{}</td>'.format(
+                    colors[column](v), v if isinstance(v, str) and
+                    v.startswith('<a ') else fmt(v)))
+            elif isinstance(v, str) and v.startswith('<a '):
+                parts.append('<td class="name">{}</td>'.format(v))
+            else:
+                parts.append('<td>{}</td>'.format(fmt(v)))
+        parts.append('</tr>')
+    parts.append('</table>')
+    return ''.join(parts)
+
+
+def page(title, body):
+    return ('<!DOCTYPE html>\n<html><head><meta charset="utf-8"><title>{0}'
+            '</title><style>{1}</style></head><body><h1>{0}</h1>\n{2}\n'
+            '</body></html>\n'.format(html.escape(title), STYLE,
+                                      '\n'.join(body)))
+
+
+class Run:
+    """The tables of one run."""
+
+    def __init__(self, name):
+        self.name = name
+        self.rows = {table: [] for table in TABLES}
+
+    def analyse(self):
+        self.energest = collections.defaultdict(list)
+        for row in self.rows['energest']:
+            total = row['total']
+            row['cpu_ratio'] = 100.0 * row['cpu'] / total \
+                if total and row['cpu'] is not None else None
+            self.energest[row['node']].append(row)
+        self.convergence = {row['node']: row
+                            for row in self.rows['convergence']}
+        self.pdr = {row['node']: row for row in self.rows['pdr']}
+        self.parents = {n: row['parent']
+                        for n, row in self.convergence.items()}
+        self.nodes = sorted({row['node'] for table in TABLES
+                             for row in self.rows[table]
+                             if row.get('node') is not None} |
+                            {row['src'] for row in self.rows['packets']
+                             if row['src'] is not None})
+        self.duty = {n: mean(r['duty_cycle'] for r in rows)
+                     for n, rows in self.energest.items()}
+        self.cpu = {n: mean(r['cpu_ratio'] for r in rows)
+                    for n, rows in self.energest.items()}
+        times = [row['last'] for row in self.rows['nodes']] + \
+            [row['time'] for row in self.rows['energest']] + \
+            [row['sent'] for row in self.rows['packets']]
+        self.end = max([t for t in times if t is not None] or [0])
+        self.latencies = [row['latency'] for row in self.rows['packets']]
+        sent = len(self.rows['packets'])
+        received = sum(1 for row in self.rows['packets']
+                       if row['received'] is not None)
+        self.delivery = 100.0 * received / sent if sent else None
+        elections = [row['election_time'] for row in
+                     self.rows['convergence']]
+        elections = [t for t in elections if t is not None]
+        self.election = max(elections) if elections else None
+        self.leaders = sorted({row['leader'] for row in
+                               self.rows['convergence']
+                               if row['leader'] is not None})
+        self.hottest = max(self.duty, key=lambda n: self.duty[n] or 0) \
+            if self.duty else None
+
+    @property
+    def file(self):
+        return 'run-' + re.sub(r'[^\w.-]', '_', self.name) + '.html'
+
+
+def run_page(run, positions, high):
+    body = ['<p><a href="index.html">All runs</a></p>']
+    body.append('<h2>Radio duty cycle per energest period</h2>')
+    body.append(legend(high, 'duty cycle, %'))
+    body.append('<p>' + ', '.join(
+        '<span style="color:{}">|</span> {}'.format(c, label)
+        for _, label, c in EVENTS) + '</p>')
+    body.append(timeline(run.nodes, run.energest, run.convergence, run.end,
+                         high))
+    if run.rows['packets']:
+        body.append('<h2>Packet latency (s)</h2>')
+        body.append('<p>PDR {}%, latency p50 {} s, p95 {} s, p99 {} s,'
+                    ' max {} s</p>'.format(fmt(run.delivery), *[
+                        fmt(v, 3) for v in percentiles(run.latencies)]))
+        body.append(latency_plot(run.rows['packets'], run.end))
+    layout = positions or tree_positions(
+        {n: run.parents.get(n) for n in run.nodes})
+    body.append('<h2>Topology: mean duty cycle</h2>')
+    body.append(topology(run.nodes, layout, run.parents, run.duty, high))
+    body.append('<h2>Nodes</h2>')
+    columns = ['node', 'duty cycle %', 'max duty cycle %', 'CPU %', 'sent',
+               'PDR %', 'latency p50', 'latency p95', 'TSCH join',
+               'RPL join', 'parent', 'switches', 'election', 'leader']
+    rows = []
+    for n in run.nodes:
+        c = run.convergence.get(n, {})
+        p = run.pdr.get(n, {})
+        rows.append([n, run.duty.get(n), max(
+            [r['duty_cycle'] for r in run.energest.get(n, [])
+             if r['duty_cycle'] is not None] or [None],
+            key=lambda v: -1 if v is None else v),
+            run.cpu.get(n), p.get('sent'), p.get('pdr'),
+            p.get('latency_p50'), p.get('latency_p95'), c.get('tsch_join'),
+            c.get('rpl_join'), c.get('parent'), c.get('parent_switches'),
+            c.get('election_time'), c.get('leader')])
+    duty_color = {'duty cycle %': lambda v: color(v, high),
+                  'max duty cycle %': lambda v: color(v, high)}
+    body.append(html_table(columns, rows, duty_color))
+    return page(run.name, body)
+
+
+def index_page(runs, high):
+    body = ['<h2>Network-wide percentiles</h2>']
+    duty = [v for run in runs for v in run.duty.values() if v is not None]
+    rows = [
+        ['node mean duty cycle %'] + percentiles(duty),
+        ['energest period duty cycle %'] + percentiles(
+            r['duty_cycle'] for run in runs for r in run.rows['energest']),
+        ['packet latency s'] + percentiles(
+            v for run in runs for v in run.latencies),
+        ['node PDR %'] + percentiles(
+            r['pdr'] for run in runs for r in run.rows['pdr']),
+        ['TSCH join s'] + percentiles(
+            r['tsch_join'] for run in runs for r in run.rows['convergence']),
+        ['RPL join s'] + percentiles(
+            r['rpl_join'] for run in runs for r in run.rows['convergence']),
+        ['run election convergence s'] + percentiles(
+            run.election for run in runs),
+    ]
+    body.append(html_table(['metric', 'p50', 'p95', 'p99', 'max'], rows))
+    if duty:
+        body.append('<h2>Mean duty cycle of the nodes</h2>')
+        body.append(histogram(duty, high))
+    body.append('<h2>Runs, hottest first</h2>')
+    columns = ['run', 'nodes', 'PDR %', 'latency p50', 'latency p95',
+               'duty cycle p50', 'duty cycle max', 'hottest node',
+               'election s', 'leaders']
+    rows = []
+    for run in sorted(runs, key=lambda r: -(r.duty.get(r.hottest) or 0)):
+        p50, _, _, highest = percentiles(run.duty.values())
+        latency = percentiles(run.latencies)
+        rows.append(['<a href="{}">{}</a>'.format(
+            html.escape(run.file), html.escape(run.name)), len(run.nodes),
+            run.delivery, latency[0], latency[1], p50, highest, run.hottest,
+            run.election, ' '.join(str(n) for n in run.leaders)])
+    body.append(html_table(columns, rows, {
+        'duty cycle p50': lambda v: color(v, high),
+        'duty cycle max': lambda v: color(v, high)}))
+    body.append(legend(high, 'duty cycle, %'))
+    return page('Contiki-NG runs', body)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('tables', help='directory of the log-ingest.py'
+                        ' tables')
+    parser.add_argument('-o', '--output', default='report',
+                        help='directory of the report')
+    parser.add_argument('--csc', help='Cooja simulation with the positions'
+                        ' of the nodes')
+    parser.add_argument('--runs', nargs='+',
+                        help='only report these runs')
+    parser.add_argument('--high', type=float,
+                        help='duty cycle %% of the hottest colour (default:'
+                        ' the 99th percentile of the periods)')
+    args = parser.parse_args()
+
+    runs = collections.OrderedDict()
+    for table in TABLES:
+        for row in read_table(args.tables, table):
+            run = row['run']
+            if args.runs and run not in args.runs:
+                continue
+            if run not in runs:
+                runs[run] = Run(run)
+            runs[run].rows[table].append(row)
+    if not runs:
+        sys.exit('{}: no tables of log-ingest.py'.format(args.tables))
+    for run in runs.values():
+        run.analyse()
+    positions = read_positions(args.csc) if args.csc else {}
+    high = args.high or percentiles(
+        (r['duty_cycle'] for run in runs.values()
+         for r in run.rows['energest']), (99,))[0] or 1
+
+    os.makedirs(args.output, exist_ok=True)
+    for run in runs.values():
+        with open(os.path.join(args.output, run.file), 'w') as f:
+            f.write(run_page(run, positions, high))
+    with open(os.path.join(args.output, 'index.html'), 'w') as f:
+        f.write(index_page(list(runs.values()), high))
+    print('{} runs: {}'.format(len(runs), os.path.join(args.output,
+                                                       'index.html')))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+"""Decode and compare memory snapshots printed by the mem-snapshot
+shell command.
+
+The snapshot is read from a log of the shell output, in which each
+part of the snapshot is printed on a line starting with "memsnap".
+If a log contains several snapshots, the last one is used.
+
+  mem-snapshot.py show LOG
+  mem-snapshot.py diff OLD-LOG NEW-LOG
+"""
+
+import argparse
+import collections
+import struct
+import sys
+
+END, HEAP, ZONE, CHUNK, MEMB = range(5)
+
+Snapshot = collections.namedtuple(
+    'Snapshot', 'time clock_second heap zones chunks membs')
+
+
+def read_snapshot(path):
+    snapshots = []
+    data = None
+    with open(path, errors='replace') as f:
+        for line in f:
+            fields = line.split()
+            if 'memsnap' not in fields:
+                continue
+            text = fields[fields.index('memsnap') + 1]
+            part = bytes.fromhex(text)
+            if part.startswith(b'MEMS'):
+                data = bytearray()
+            if data is not None:
+                data += part
+                if part == bytes([END, 0]):
+                    snapshots.append(bytes(data))
+                    data = None
+    if not snapshots:
+        sys.exit('{}: no complete snapshot found'.format(path))
+    return parse_snapshot(snapshots[-1])
+
+
+def parse_snapshot(data):
+    if data[4] != 1:
+        sys.exit('unsupported snapshot version {}'.format(data[4]))
+    time, clock_second = struct.unpack_from('<IH', data, 5)
+    heap = None
+    zones = {}
+    chunks = []
+    membs = {}
+    offset = 11
+    while offset + 2 <= len(data):
+        rtype, length = data[offset], data[offset + 1]
+        payload = data[offset + 2:offset + 2 + length]
+        offset += 2 + length
+        if rtype == END:
+            break
+        elif rtype == HEAP:
+            heap = dict(zip(('allocated', 'overhead', 'available',
+                             'footprint', 'max_footprint', 'chunks'),
+                            struct.unpack_from('<6I', payload)))
+        elif rtype == ZONE:
+            zone_id, size, allocated, max_allocated, failures = \
+                struct.unpack_from('<B4I', payload)
+            zones[payload[17:].decode(errors='replace')] = dict(
+                id=zone_id, size=size, allocated=allocated,
+                max_allocated=max_allocated, failures=failures)
+        elif rtype == CHUNK:
+            zone_id, size, line, age = struct.unpack_from('<B3I', payload)
+            chunks.append(dict(zone=zone_id, size=size, age=age,
+                               site='{}:{}'.format(
+                                   payload[13:].decode(errors='replace'),
+                                   line)))
+        elif rtype == MEMB:
+            size, num, used, max_used, failures = \
+                struct.unpack_from('<5H', payload)
+            membs[payload[10:].decode(errors='replace')] = dict(
+                size=size, num=num, used=used, max_used=max_used,
+                failures=failures)
+    return Snapshot(time, clock_second, heap, zones, chunks, membs)
+
+
+def sites(snapshot):
+    """Sum the allocated chunks by allocation site."""
+    result = collections.defaultdict(lambda: [0, 0, 0])
+    for chunk in snapshot.chunks:
+        entry = result[chunk['site']]
+        entry[0] += 1
+        entry[1] += chunk['size']
+        entry[2] = max(entry[2], chunk['age'])
+    return result
+
+
+def show(snapshot):
+    print('Time: {:.2f} s'.format(snapshot.time / snapshot.clock_second))
+    if snapshot.heap:
+        print('Heap: {allocated} bytes in {chunks} chunks, footprint '
+              '{footprint} (max {max_footprint})'.format(**snapshot.heap))
+    for name, zone in snapshot.zones.items():
+        print('Zone {}: {allocated}/{size} bytes (max {max_allocated}), '
+              '{failures} failures'.format(name, **zone))
+    by_site = sites(snapshot)
+    if by_site:
+        print('{:40} {:>7} {:>9} {:>9}'.format('Site', 'Chunks', 'Bytes',
+                                              'Oldest/s'))
+        for site, (count, size, age) in sorted(by_site.items(),
+                                               key=lambda x: -x[1][1]):
+            print('{:40} {:7} {:9} {:9.1f}'.format(
+                site, count, size, age / snapshot.clock_second))
+    for name, memb in snapshot.membs.items():
+        print('Memb {}: {used}/{num} blocks of {size} bytes (max {max_used}), '
+              '{failures} failures'.format(name, **memb))
+
+
+def diff(old, new):
+    print('Elapsed: {:.2f} s'.format(
+        (new.time - old.time) / new.clock_second))
+    if old.heap and new.heap:
+        for key in ('allocated', 'chunks', 'footprint'):
+            print('Heap {}: {} -> {} ({:+d})'.format(
+                key, old.heap[key], new.heap[key],
+                new.heap[key] - old.heap[key]))
+    for name, zone in new.zones.items():
+        prev = old.zones.get(name, dict(allocated=0, failures=0))
+        print('Zone {}: {:+d} bytes, {:+d} failures'.format(
+            name, zone['allocated'] - prev['allocated'],
+            zone['failures'] - prev['failures']))
+    old_sites = sites(old)
+    new_sites = sites(new)
+    changes = []
+    for site in set(old_sites) | set(new_sites):
+        o = old_sites.get(site, [0, 0, 0])
+        n = new_sites.get(site, [0, 0, 0])
+        if o[:2] != n[:2]:
+            changes.append((n[1] - o[1], n[0] - o[0], site))
+    if changes:
+        print('{:40} {:>7} {:>9}'.format('Site', 'Chunks', 'Bytes'))
+        for size, count, site in sorted(changes, reverse=True):
+            print('{:40} {:+7d} {:+9d}'.format(site, count, size))
+    for name, memb in new.membs.items():
+        prev = old.membs.get(name, dict(used=0, failures=0))
+        if memb['used'] != prev['used'] or \
+           memb['failures'] != prev['failures']:
+            print('Memb {}: {:+d} blocks, {:+d} failures'.format(
+                name, memb['used'] - prev['used'],
+                memb['failures'] - prev['failures']))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    sub = parser.add_subparsers(dest='command', required=True)
+    sub.add_parser('show').add_argument('log')
+    diff_parser = sub.add_parser('diff')
+    diff_parser.add_argument('old')
+    diff_parser.add_argument('new')
+    args = parser.parse_args()
+
+    if args.command == 'show':
+        show(read_snapshot(args.log))
+    else:
+        diff(read_snapshot(args.old), read_snapshot(args.new))
+
+
+if __name__ == '__main__':
+    main()
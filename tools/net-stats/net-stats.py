@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""Decode the network stack statistics printed by the "stats cbor"
+shell command.
+
+Each group of counters is printed on a line starting with "netstats",
+followed by the group encoded as hex CBOR. The lines are read from
+logs of the shell output, or from standard input, and written as CSV
+with one row per counter:
+
+  net-stats.py LOG... > stats.csv
+  net-stats.py --rates LOG...
+
+The columns are the file, the line number, the group, the milliseconds
+since the previous reading, the counter, its value, and its change
+since the previous reading, which is empty for a gauge. With --rates,
+the change is given per second instead.
+"""
+
+import argparse
+import csv
+import sys
+
+
+class CborError(Exception):
+    pass
+
+
+def decode(data, offset=0):
+    """Decode the CBOR item at offset, returning it and the next offset.
+
+    Only the types written by net_stats_to_cbor() are supported.
+    """
+    if offset >= len(data):
+        raise CborError('truncated')
+    major, info = data[offset] >> 5, data[offset] & 0x1f
+    offset += 1
+    if info < 24:
+        value = info
+    elif info in (24, 25, 26, 27):
+        size = 1 << (info - 24)
+        if offset + size > len(data):
+            raise CborError('truncated')
+        value = int.from_bytes(data[offset:offset + size], 'big')
+        offset += size
+    else:
+        raise CborError('unsupported length {}'.format(info))
+    if major == 0:
+        return value, offset
+    if major == 3:
+        if offset + value > len(data):
+            raise CborError('truncated')
+        return data[offset:offset + value].decode(), offset + value
+    if major == 5:
+        result = {}
+        for _ in range(value):
+            key, offset = decode(data, offset)
+            result[key], offset = decode(data, offset)
+        return result, offset
+    raise CborError('unsupported type {}'.format(major))
+
+
+def read_groups(name, f):
+    for number, line in enumerate(f, 1):
+        fields = line.split()
+        if 'netstats' not in fields[:-1]:
+            continue
+        text = fields[fields.index('netstats') + 1]
+        try:
+            group, _ = decode(bytes.fromhex(text))
+        except (ValueError, CborError) as e:
+            print('{}:{}: {}'.format(name, number, e), file=sys.stderr)
+            continue
+        yield number, group
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('logs', nargs='*', default=['-'])
+    parser.add_argument('--rates', action='store_true',
+                        help='show changes per second')
+    args = parser.parse_args()
+
+    writer = csv.writer(sys.stdout)
+    writer.writerow(['file', 'line', 'group', 'ms', 'counter', 'value',
+                     'rate' if args.rates else 'delta'])
+    for name in args.logs:
+        f = sys.stdin if name == '-' else open(name, errors='replace')
+        with f:
+            for number, group in read_groups(name, f):
+                ms = group['ms']
+                for counter, value in group['values'].items():
+                    delta = group['deltas'].get(counter)
+                    if delta is not None and args.rates:
+                        delta = '{:.2f}'.format(delta * 1000 / ms) if ms else ''
+                    writer.writerow([name, number, group['group'], ms,
+                                     counter, value,
+                                     '' if delta is None else delta])
+
+
+if __name__ == '__main__':
+    main()
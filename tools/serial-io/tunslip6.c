@@ -59,6 +59,7 @@
 #include <err.h>
 
 #include "tools-utils.h"
+#include "lib/slip-codec.h"
 
 #ifndef BAUDRATE
 #define BAUDRATE B115200
@@ -174,195 +175,186 @@ is_sensible_string(const unsigned char *s, int len)
 }
 
 /*
- * Read from serial, when we have a packet write it to tun. No output
- * buffering, input buffered by stdio.
+ * Handle a frame received from serial: a request from the radio, a debug
+ * line, or a packet that is written to tun.
  */
-void
-serial_to_tun(FILE *inslip, int outfd)
+static void
+frame_input(unsigned char *inbuf, int len, int outfd)
 {
-  static union {
-    unsigned char inbuf[2000];
-  } uip;
-  static int inbufptr = 0;
-  int ret,i;
-  unsigned char c;
-
-#ifdef linux
-  ret = fread(&c, 1, 1, inslip);
-  if(ret == -1 || ret == 0) err(1, "serial_to_tun: read");
-  goto after_fread;
-#endif
+  int i;
 
- read_more:
-  if(inbufptr >= sizeof(uip.inbuf)) {
-     if(timestamp) stamptime();
-     fprintf(stderr, "*** dropping large %d byte packet\n",inbufptr);
-	 inbufptr = 0;
-  }
-  ret = fread(&c, 1, 1, inslip);
-#ifdef linux
- after_fread:
-#endif
-  if(ret == -1) {
-    err(1, "serial_to_tun: read");
-  }
-  if(ret == 0) {
-    clearerr(inslip);
-    return;
-  }
-  PROGRESS(".");
-  switch(c) {
-  case SLIP_END:
-    if(inbufptr > 0) {
-      if(uip.inbuf[0] == '!') {
-	if(uip.inbuf[1] == 'M') {
-	  /* Read gateway MAC address and autoconfigure tap0 interface */
-	  char macs[24];
-	  int i, pos;
-	  for(i = 0, pos = 0; i < 16; i++) {
-	    macs[pos++] = uip.inbuf[2 + i];
-	    if((i & 1) == 1 && i < 14) {
-	      macs[pos++] = ':';
-	    }
-	  }
-          if(timestamp) stamptime();
-	  macs[pos] = '\0';
-//	  printf("*** Gateway's MAC address: %s\n", macs);
-	  fprintf(stderr,"*** Gateway's MAC address: %s\n", macs);
-          if (timestamp) stamptime();
-	  ssystem("ifconfig %s down", tundev);
-          if (timestamp) stamptime();
-	  ssystem("ifconfig %s hw ether %s", tundev, &macs[6]);
-          if (timestamp) stamptime();
-	  ssystem("ifconfig %s up", tundev);
-	}
-      } else if(uip.inbuf[0] == '?') {
-	if(uip.inbuf[1] == 'P') {
-          /* Prefix info requested */
-          struct in6_addr addr;
-	  int i;
-	  char *s = strchr(ipaddr, '/');
-	  if(s != NULL) {
-	    *s = '\0';
-	  }
-          inet_pton(AF_INET6, ipaddr, &addr);
-          if(timestamp) stamptime();
-          fprintf(stderr,"*** Address:%s => %02x%02x:%02x%02x:%02x%02x:%02x%02x\n",
-		 ipaddr,
-		 addr.s6_addr[0], addr.s6_addr[1],
-		 addr.s6_addr[2], addr.s6_addr[3],
-		 addr.s6_addr[4], addr.s6_addr[5],
-		 addr.s6_addr[6], addr.s6_addr[7]);
-	  slip_send('!');
-	  slip_send('P');
-	  for(i = 0; i < 8; i++) {
-	    /* need to call the slip_send_char for stuffing */
-	    slip_send_char(addr.s6_addr[i]);
-	  }
-	  slip_send(SLIP_END);
+  if(inbuf[0] == '!') {
+    if(inbuf[1] == 'M') {
+      /* Read gateway MAC address and autoconfigure tap0 interface */
+      char macs[24];
+      int i, pos;
+      for(i = 0, pos = 0; i < 16; i++) {
+        macs[pos++] = inbuf[2 + i];
+        if((i & 1) == 1 && i < 14) {
+          macs[pos++] = ':';
         }
+      }
+      if(timestamp) stamptime();
+      macs[pos] = '\0';
+//    printf("*** Gateway's MAC address: %s\n", macs);
+      fprintf(stderr,"*** Gateway's MAC address: %s\n", macs);
+      if (timestamp) stamptime();
+      ssystem("ifconfig %s down", tundev);
+      if (timestamp) stamptime();
+      ssystem("ifconfig %s hw ether %s", tundev, &macs[6]);
+      if (timestamp) stamptime();
+      ssystem("ifconfig %s up", tundev);
+    }
+  } else if(inbuf[0] == '?') {
+    if(inbuf[1] == 'P') {
+      /* Prefix info requested */
+      struct in6_addr addr;
+      int i;
+      char *s = strchr(ipaddr, '/');
+      if(s != NULL) {
+        *s = '\0';
+      }
+      inet_pton(AF_INET6, ipaddr, &addr);
+      if(timestamp) stamptime();
+      fprintf(stderr,"*** Address:%s => %02x%02x:%02x%02x:%02x%02x:%02x%02x\n",
+              ipaddr,
+              addr.s6_addr[0], addr.s6_addr[1],
+              addr.s6_addr[2], addr.s6_addr[3],
+              addr.s6_addr[4], addr.s6_addr[5],
+              addr.s6_addr[6], addr.s6_addr[7]);
+      slip_send('!');
+      slip_send('P');
+      for(i = 0; i < 8; i++) {
+        /* need to call the slip_send_char for stuffing */
+        slip_send_char(addr.s6_addr[i]);
+      }
+      slip_send(SLIP_END);
+    }
 #define DEBUG_LINE_MARKER '\r'
-      } else if(uip.inbuf[0] == DEBUG_LINE_MARKER) {
-	fwrite(uip.inbuf + 1, inbufptr - 1, 1, stdout);
-      } else if(is_sensible_string(uip.inbuf, inbufptr)) {
-        if(verbose==1) {   /* strings already echoed below for verbose>1 */
-          if (timestamp) stamptime();
-          fwrite(uip.inbuf, inbufptr, 1, stdout);
-        }
-      } else {
-        if(verbose>2) {
-          if (timestamp) stamptime();
-          printf("Packet from SLIP of length %d - write TUN\n", inbufptr);
-          if (verbose>4) {
+  } else if(inbuf[0] == DEBUG_LINE_MARKER) {
+    fwrite(inbuf + 1, len - 1, 1, stdout);
+  } else if(is_sensible_string(inbuf, len)) {
+    if(verbose==1) {   /* strings already echoed below for verbose>1 */
+      if (timestamp) stamptime();
+      fwrite(inbuf, len, 1, stdout);
+    }
+  } else {
+    if(verbose>2) {
+      if (timestamp) stamptime();
+      printf("Packet from SLIP of length %d - write TUN\n", len);
+      if (verbose>4) {
 #if WIRESHARK_IMPORT_FORMAT
-            printf("0000");
-	        for(i = 0; i < inbufptr; i++) printf(" %02x",uip.inbuf[i]);
+        printf("0000");
+        for(i = 0; i < len; i++) printf(" %02x",inbuf[i]);
 #else
-            printf("         ");
-            for(i = 0; i < inbufptr; i++) {
-              printf("%02x", uip.inbuf[i]);
-              if((i & 3) == 3) printf(" ");
-              if((i & 15) == 15) printf("\n         ");
-            }
-#endif
-            printf("\n");
-          }
+        printf("         ");
+        for(i = 0; i < len; i++) {
+          printf("%02x", inbuf[i]);
+          if((i & 3) == 3) printf(" ");
+          if((i & 15) == 15) printf("\n         ");
         }
+#endif
+        printf("\n");
+      }
+    }
 
 #ifdef __APPLE__
-        /* Fake IFF_NO_PI on macOS by sending a 4 byte header containing AF_INET6 */
-        u_int32_t type = htonl(AF_INET6);
-        struct iovec iv[2];
+    /* Fake IFF_NO_PI on macOS by sending a 4 byte header containing AF_INET6 */
+    u_int32_t type = htonl(AF_INET6);
+    struct iovec iv[2];
 
-        iv[0].iov_base = &type;
-        iv[0].iov_len = sizeof(type);
-        iv[1].iov_base = uip.inbuf;
-        iv[1].iov_len = inbufptr;
+    iv[0].iov_base = &type;
+    iv[0].iov_len = sizeof(type);
+    iv[1].iov_base = inbuf;
+    iv[1].iov_len = len;
 
-        if(writev(outfd, iv, 2) != (sizeof(type) + inbufptr)) {
-          err(1, "serial_to_tun: writev");
-        }
+    if(writev(outfd, iv, 2) != (sizeof(type) + len)) {
+      err(1, "serial_to_tun: writev");
+    }
 #else
-        if(write(outfd, uip.inbuf, inbufptr) != inbufptr) {
-          err(1, "serial_to_tun: write");
-        }
+    if(write(outfd, inbuf, len) != len) {
+      err(1, "serial_to_tun: write");
+    }
 #endif
 
-      }
-      inbufptr = 0;
-    }
-    break;
+  }
+}
+/*
+ * Read from serial, when we have a packet write it to tun. No output
+ * buffering; input is read in bulk and decoded by the SLIP codec.
+ */
+void
+serial_to_tun(int infd, int outfd)
+{
+  static unsigned char inbuf[2000];
+  static unsigned char chunk[4096];
+  static slip_decoder_t decoder;
+  static int initialized;
+  int ret, i;
+
+  if(!initialized) {
+    /* Lines are echoed as they are received for verbose=2,3,5+ */
+    slip_decoder_init(&decoder, inbuf, sizeof(inbuf),
+                      (verbose == 2 || verbose == 3 || verbose > 4) ?
+                      SLIP_CODEC_LINES : 0);
+    initialized = 1;
+  }
 
-  case SLIP_ESC:
-    if(fread(&c, 1, 1, inslip) != 1) {
-      clearerr(inslip);
-      /* Put ESC back and give up! */
-      ungetc(SLIP_ESC, inslip);
+  ret = read(infd, chunk, sizeof(chunk));
+  if(ret == -1) {
+    if(errno == EAGAIN || errno == EINTR) {
       return;
     }
+    err(1, "serial_to_tun: read");
+  }
+  if(ret == 0) {
+#ifdef linux
+    /* select() reported input, so the device is gone */
+    err(1, "serial_to_tun: read");
+#endif
+    return;
+  }
+  PROGRESS(".");
 
-    switch(c) {
-    case SLIP_ESC_END:
-      c = SLIP_END;
-      break;
-    case SLIP_ESC_ESC:
-      c = SLIP_ESC;
-      break;
-    case SLIP_ESC_XON:
-      c = XON;
-      break;
-    case SLIP_ESC_XOFF:
-      c = XOFF;
-      break;
-    }
-    /* FALLTHROUGH */
-  default:
-    uip.inbuf[inbufptr++] = c;
-
-    /* Echo lines as they are received for verbose=2,3,5+ */
-    /* Echo all printable characters for verbose==4 */
-    if((verbose==2) || (verbose==3) || (verbose>4)) {
-      if(c=='\n') {
-        if(is_sensible_string(uip.inbuf, inbufptr)) {
-          if (timestamp) stamptime();
-          fwrite(uip.inbuf, inbufptr, 1, stdout);
-          inbufptr=0;
-        }
-      }
-    } else if(verbose==4) {
+  /* Echo all printable characters for verbose==4 */
+  if(verbose == 4) {
+    for(i = 0; i < ret; i++) {
+      unsigned char c = chunk[i];
       if(c == 0 || c == '\r' || c == '\n' || c == '\t' || (c >= ' ' && c <= '~')) {
-	fwrite(&c, 1, 1, stdout);
-        if(c=='\n') if(timestamp) stamptime();
+        fwrite(&c, 1, 1, stdout);
+        if(c == '\n' && timestamp) stamptime();
       }
     }
-
-    break;
   }
 
-  goto read_more;
+  slip_decoder_input(&decoder, chunk, ret);
+  for(;;) {
+    switch(slip_decoder_next(&decoder)) {
+    case SLIP_DECODER_FRAME:
+      frame_input(inbuf, decoder.len, outfd);
+      break;
+    case SLIP_DECODER_LINE:
+      if(is_sensible_string(inbuf, decoder.len)) {
+        if (timestamp) stamptime();
+        fwrite(inbuf, decoder.len, 1, stdout);
+        slip_decoder_reset(&decoder);
+      }
+      break;
+    case SLIP_DECODER_OVERFLOW:
+      if(timestamp) stamptime();
+      fprintf(stderr, "*** dropping large %d byte packet\n", (int)decoder.len);
+      break;
+    default:
+      return;
+    }
+  }
 }
 
-unsigned char slip_buf[2000];
+/*
+ * Room for several packets, so that packets that arrive from tun
+ * together are written to serial in a single write().
+ */
+unsigned char slip_buf[8 * 2000];
 unsigned int slip_end, slip_begin;
 
 void
@@ -415,6 +407,13 @@ slip_empty()
   return slip_end == 0;
 }
 
+/* Whether another packet from tun fits, with room to spare for requests. */
+int
+slip_room()
+{
+  return sizeof(slip_buf) - slip_end >= SLIP_CODEC_ENCODED_SIZE_MAX(2000) + 32;
+}
+
 void
 slip_flushbuf(int fd)
 {
@@ -468,38 +467,11 @@ write_to_serial(void *inbuf, int len)
    */
   /* slip_send(SLIP_END); */
 
-  for(i = 0; i < len; i++) {
-    switch(p[i]) {
-    case SLIP_END:
-      slip_send(SLIP_ESC);
-      slip_send(SLIP_ESC_END);
-      break;
-    case SLIP_ESC:
-      slip_send(SLIP_ESC);
-      slip_send(SLIP_ESC_ESC);
-      break;
-    case XON:
-      if(flowcontrol_xonxoff) {
-        slip_send(SLIP_ESC);
-        slip_send(SLIP_ESC_XON);
-      } else {
-        slip_send(p[i]);
-      }
-      break;
-    case XOFF:
-      if(flowcontrol_xonxoff) {
-        slip_send(SLIP_ESC);
-        slip_send(SLIP_ESC_XOFF);
-      } else {
-        slip_send(p[i]);
-      }
-      break;
-    default:
-      slip_send(p[i]);
-      break;
-    }
+  if(sizeof(slip_buf) - slip_end < (size_t)SLIP_CODEC_ENCODED_SIZE_MAX(len)) {
+    err(1, "slip_send overflow");
   }
-  slip_send(SLIP_END);
+  slip_end += slip_codec_encode(slip_buf + slip_end, p, len,
+                                flowcontrol_xonxoff ? SLIP_CODEC_XONXOFF : 0);
   PROGRESS("t");
 }
 
@@ -531,6 +503,17 @@ tun_to_serial(int infd)
   return size;
 }
 
+int
+tun_readable(int fd)
+{
+  struct timeval tv = { 0, 0 };
+  fd_set rset;
+
+  FD_ZERO(&rset);
+  FD_SET(fd, &rset);
+  return select(fd + 1, &rset, NULL, NULL, &tv) > 0;
+}
+
 void
 stty_telos(int fd)
 {
@@ -849,7 +832,6 @@ main(int argc, char **argv)
   int tunfd, maxfd;
   int ret;
   fd_set rset, wset;
-  FILE *inslip;
   const char *siodev = NULL;
   const char *host = NULL;
   const char *port = NULL;
@@ -1091,8 +1073,6 @@ exit(1);
     stty_telos(slipfd);
   }
   slip_send(SLIP_END);
-  inslip = fdopen(slipfd, "r");
-  if(inslip == NULL) err(1, "main: fdopen");
 
   tunfd = tun_alloc(tundev, tap);
   if(tunfd == -1) err(1, "main: open /dev/tun");
@@ -1129,8 +1109,8 @@ exit(1);
     FD_SET(slipfd, &rset);	/* Read from slip ASAP! */
     if(slipfd > maxfd) maxfd = slipfd;
 
-    /* We only have one packet at a time queued for slip output. */
-    if(slip_empty()) {
+    /* Without a delay, packets from tun are queued while they fit. */
+    if(basedelay ? slip_empty() : slip_room()) {
       FD_SET(tunfd, &rset);
       if(tunfd > maxfd) maxfd = tunfd;
     }
@@ -1140,7 +1120,7 @@ exit(1);
       err(1, "select");
     } else if(ret > 0) {
       if(FD_ISSET(slipfd, &rset)) {
-        serial_to_tun(inslip, tunfd);
+        serial_to_tun(slipfd, tunfd);
       }
 
       if(FD_ISSET(slipfd, &wset)) {
@@ -1159,8 +1139,12 @@ exit(1);
        if(dmsec>delaymsec) delaymsec=0;
       }
       if(delaymsec==0) {
-        if(slip_empty() && FD_ISSET(tunfd, &rset)) {
+        if((basedelay ? slip_empty() : slip_room()) && FD_ISSET(tunfd, &rset)) {
           tun_to_serial(tunfd);
+          /* Batch the packets that are already waiting, unless paced. */
+          while(!basedelay && slip_room() && tun_readable(tunfd)) {
+            tun_to_serial(tunfd);
+          }
           slip_flushbuf(slipfd);
           if(ipa_enable) sigalarm_reset();
           if(basedelay) {
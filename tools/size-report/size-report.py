@@ -0,0 +1,243 @@
+#!/usr/bin/env python3
+"""Report the text, data and bss size of a firmware per module.
+
+The sizes are taken from the map file written by the linker, which
+lists the size of each input section, and the object file it is from.
+An object is attributed to the directory of its source file, which is
+found through the dependency file of the object, so that for example
+os/net/mac/csma is one module. With --depth, directories are merged,
+so that --depth 3 makes os/net/mac one module. Input sections of
+libraries are attributed to the library, and sections that the linker
+creates are attributed to "(other)".
+
+The sections are counted as text, data or bss the way the size tool
+does: read-only sections as text, other loaded sections as data, and
+the rest as bss. The total of each column therefore matches the size
+tool.
+
+  size-report.py --objdir build/native/obj build/native/hello-world.native
+
+With --baseline, the sizes are compared to those of an earlier report
+that was saved with --save, and the modules that grew by more than
+--threshold bytes are reported, which makes the exit status 1.
+
+The report is run for each binary of a project with "make size-report",
+and the baseline is saved with "make size-baseline".
+"""
+
+import argparse
+import collections
+import csv
+import glob
+import os
+import re
+import subprocess
+import sys
+
+COLUMNS = ['text', 'data', 'bss']
+OTHER = '(other)'
+
+
+def section_kinds(objdump, binary):
+    """The size and the column of each allocated section of the binary."""
+    output = subprocess.run([objdump, '-h', binary], check=True,
+                            stdout=subprocess.PIPE,
+                            universal_newlines=True).stdout
+    sections = {}
+    lines = output.splitlines()
+    for line, flags in zip(lines, lines[1:]):
+        fields = line.split()
+        if len(fields) < 7 or not fields[0].isdigit():
+            continue
+        flags = flags.replace(',', ' ').split()
+        if 'ALLOC' not in flags:
+            continue
+        if 'CODE' in flags or 'READONLY' in flags:
+            kind = 'text'
+        elif 'LOAD' in flags:
+            kind = 'data'
+        else:
+            kind = 'bss'
+        sections[fields[1]] = (int(fields[2], 16), kind)
+    return sections
+
+
+def input_sections(path):
+    """Yield the output section, the size and the file of each input
+    section in a linker map."""
+    with open(path) as f:
+        lines = iter(f.read().splitlines())
+    for line in lines:
+        if line.startswith('Linker script and memory map'):
+            break
+    output = None
+    pending = None
+    for line in lines:
+        fields = line.split()
+        if not fields:
+            continue
+        if not line[0].isspace():
+            output = fields[0]
+            continue
+        if pending is not None:
+            name, pending = pending, None
+            if len(fields) >= 3 and fields[1].startswith('0x'):
+                yield output, int(fields[1], 16), ' '.join(fields[2:])
+                continue
+        if fields[0].startswith('0x') or '(' in fields[0] and \
+                not fields[0].startswith('COMMON'):
+            continue
+        if fields[0] == '*fill*':
+            if len(fields) >= 3:
+                yield output, int(fields[2], 16), OTHER
+        elif len(fields) >= 4 and fields[1].startswith('0x'):
+            yield output, int(fields[2], 16), ' '.join(fields[3:])
+        elif len(fields) == 1:
+            pending = fields[0]
+
+
+class Modules:
+    """Map the files of a map to modules."""
+
+    def __init__(self, objdir, contiki, depth):
+        self.objdir = os.path.realpath(objdir) if objdir else None
+        self.contiki = os.path.realpath(contiki)
+        self.depth = depth
+        self.cache = {}
+
+    def source(self, obj):
+        stem = os.path.splitext(os.path.basename(obj))[0]
+        for dep in glob.glob(os.path.join(self.objdir, '.deps',
+                                          glob.escape(stem) + '.*.d')):
+            with open(dep) as f:
+                text = f.read().replace('\\\n', ' ')
+            fields = text.split(':', 1)[1].split() if ':' in text else []
+            if fields:
+                return os.path.realpath(fields[0])
+        return None
+
+    def module(self, name):
+        if name not in self.cache:
+            self.cache[name] = self.lookup(name)
+        return self.cache[name]
+
+    def lookup(self, name):
+        if name == OTHER:
+            return OTHER
+        match = re.match(r'^(.*\.a)\((.*)\)$', name)
+        if match:
+            return os.path.basename(match.group(1))
+        if self.objdir is None or \
+                os.path.dirname(os.path.realpath(name)) != self.objdir:
+            return OTHER
+        source = self.source(name)
+        if source is None:
+            return OTHER
+        directory = os.path.dirname(source)
+        if directory == self.contiki or \
+                not directory.startswith(self.contiki + os.sep):
+            return '(project)'
+        parts = os.path.relpath(directory, self.contiki).split(os.sep)
+        return '/'.join(parts[:self.depth] if self.depth else parts)
+
+
+def report(args):
+    if not os.path.exists(args.map):
+        sys.exit('{}: no map file; the platform does not write one'.format(
+            args.map))
+    sections = section_kinds(args.objdump, args.binary)
+    modules = Modules(args.objdir, args.contiki, args.depth)
+    sizes = collections.defaultdict(lambda: dict.fromkeys(COLUMNS, 0))
+    attributed = collections.Counter()
+    for output, size, name in input_sections(args.map):
+        if output not in sections or not size:
+            continue
+        sizes[modules.module(name)][sections[output][1]] += size
+        attributed[output] += size
+    for output, (size, kind) in sections.items():
+        if size > attributed[output]:
+            sizes[OTHER][kind] += size - attributed[output]
+    return sizes
+
+
+def read_sizes(path):
+    with open(path) as f:
+        return {row['module']: {c: int(row[c]) for c in COLUMNS}
+                for row in csv.DictReader(f)}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('binary')
+    parser.add_argument('--map', help='linker map (default: the binary'
+                        ' with the extension .map)')
+    parser.add_argument('--objdir', help='object directory of the build')
+    parser.add_argument('--contiki', default=os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), '..', '..'))
+    parser.add_argument('--objdump', help='objdump of the toolchain'
+                        ' (default: derived from --size)')
+    parser.add_argument('--size', default='size',
+                        help='size tool of the toolchain')
+    parser.add_argument('--depth', type=int, default=0,
+                        help='directory levels of a module (default: all)')
+    parser.add_argument('--baseline', help='report to compare to')
+    parser.add_argument('--threshold', type=int, default=0,
+                        help='bytes a module may grow by')
+    parser.add_argument('--save', help='write the report to a file')
+    args = parser.parse_args()
+    if args.map is None:
+        args.map = os.path.splitext(args.binary)[0] + '.map'
+    if args.objdump is None:
+        args.objdump = re.sub(r'size$', 'objdump', args.size)
+
+    sizes = report(args)
+    baseline = {}
+    if args.baseline and os.path.exists(args.baseline):
+        baseline = read_sizes(args.baseline)
+
+    grown = []
+    width = max([len(m) for m in sizes] + [len('total')])
+    print('{:<{}} {:>8} {:>8} {:>8}'.format('module', width, *COLUMNS))
+    totals = dict.fromkeys(COLUMNS, 0)
+    old_totals = dict.fromkeys(COLUMNS, 0)
+    rows = sorted(set(sizes) | set(baseline),
+                  key=lambda m: -sum(sizes.get(m, baseline.get(m)).values()))
+    for module in rows + ['total']:
+        if module == 'total':
+            new, old = totals, old_totals if baseline else None
+        else:
+            new = sizes.get(module, dict.fromkeys(COLUMNS, 0))
+            old = baseline.get(module, dict.fromkeys(COLUMNS, 0)) \
+                if baseline else None
+            for c in COLUMNS:
+                totals[c] += new[c]
+                old_totals[c] += old[c] if old else 0
+        line = '{:<{}}'.format(module, width)
+        for c in COLUMNS:
+            line += ' {:>8}'.format(new[c])
+        if old is not None:
+            growth = [new[c] - old[c] for c in COLUMNS]
+            if any(growth):
+                line += '  ' + ' '.join('{}{:+d}'.format(c[0], g)
+                                        for c, g in zip(COLUMNS, growth)
+                                        if g)
+            if module != 'total' and sum(growth) > args.threshold:
+                line += '  GROWN'
+                grown.append(module)
+        print(line)
+
+    if args.save:
+        with open(args.save, 'w', newline='') as f:
+            writer = csv.writer(f)
+            writer.writerow(['module'] + COLUMNS)
+            for module in sorted(sizes):
+                writer.writerow([module] + [sizes[module][c]
+                                            for c in COLUMNS])
+    if grown:
+        print('{} module(s) grew by more than {} bytes: {}'.format(
+            len(grown), args.threshold, ', '.join(grown)))
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
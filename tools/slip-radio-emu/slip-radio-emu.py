@@ -0,0 +1,274 @@
+#!/usr/bin/env python3
+"""Emulate slip-radios on pseudo-terminals, for testing the native
+border router without hardware.
+
+Each radio is a pseudo-terminal whose device name is printed on
+startup, and which is given to the border router with -s. A radio
+answers ?M with its MAC address and reports each packet sent with !S as
+transmitted. Each radio has a number of emulated neighbors, which
+periodically send an ICMPv6 echo request to ff02::1. The border router
+answers with unicast echo replies, which are counted per radio. A reply
+that is sent on a radio other than the one of its neighbor is counted
+as misdirected, and is reported as not acknowledged.
+
+  slip-radio-emu.py -n 2 --neighbors 3 --duration 20
+
+With --queue, a radio transmits its packets one at a time at the air
+bit rate, holding at most the given number of packets, and rejects
+packets that arrive when the queue is full. With --credits, it also
+reports the free queue slots with !F and in each !R report, as the
+slip-radio does, so that the border router can send at line rate. The
+sustained throughput is reported per radio:
+
+  slip-radio-emu.py -n 1 --neighbors 10 --interval 0.02 --payload 40 \\
+      --queue 4 --credits --duration 20
+"""
+
+import argparse
+import collections
+import os
+import pty
+import select
+import struct
+import sys
+import time
+import tty
+
+END, ESC, ESC_END, ESC_ESC = 0o300, 0o333, 0o334, 0o335
+MAC_TX_OK, MAC_TX_NOACK, MAC_TX_ERR = 0, 2, 4
+# PHY preamble, start of frame, and length, plus the frame check sequence
+PHY_OVERHEAD = 6 + 2
+PAN_ID = 0xabcd
+
+
+def slip_encode(data):
+    return data.replace(bytes([ESC]), bytes([ESC, ESC_ESC])).replace(
+        bytes([END]), bytes([ESC, ESC_END])) + bytes([END])
+
+
+class SlipDecoder:
+    def __init__(self):
+        self.frame = bytearray()
+        self.escaped = False
+
+    def feed(self, data):
+        frames = []
+        for c in data:
+            if self.escaped:
+                self.escaped = False
+                self.frame.append({ESC_END: END, ESC_ESC: ESC}.get(c, c))
+            elif c == ESC:
+                self.escaped = True
+            elif c == END:
+                if self.frame:
+                    frames.append(bytes(self.frame))
+                self.frame = bytearray()
+            else:
+                self.frame.append(c)
+        return frames
+
+
+def checksum(data):
+    if len(data) & 1:
+        data += b'\0'
+    total = sum(struct.unpack('!%dH' % (len(data) // 2), data))
+    while total > 0xffff:
+        total = (total & 0xffff) + (total >> 16)
+    return ~total & 0xffff
+
+
+def link_local(mac):
+    return bytes.fromhex('fe80000000000000') + bytes([mac[0] ^ 2]) + mac[1:]
+
+
+def echo_request(mac, seq, payload):
+    """An 802.15.4 broadcast frame with an uncompressed IPv6 packet."""
+    src = link_local(mac)
+    dst = bytes.fromhex('ff020000000000000000000000000001')
+    icmp = struct.pack('!BBHHH', 128, 0, 0, 0x4242, seq & 0xffff)
+    icmp += (b'emu' * payload)[:payload]
+    pseudo = src + dst + struct.pack('!IxxxB', len(icmp), 58)
+    icmp = icmp[:2] + struct.pack('!H', checksum(pseudo + icmp)) + icmp[4:]
+    ip = struct.pack('!IHBB', 0x60000000, len(icmp), 58, 255) + src + dst
+    # data frame, PAN ID compression, short destination, long source
+    header = struct.pack('<HBHH', 0xc841, seq & 0xff, PAN_ID, 0xffff)
+    return header + mac[::-1] + b'\x41' + ip + icmp
+
+
+def frame_destination(frame):
+    """The long destination address of an 802.15.4 frame, or None."""
+    if len(frame) < 3:
+        return None
+    fcf = frame[0] | frame[1] << 8
+    if (fcf >> 10) & 3 != 3:
+        return None
+    return bytes(frame[5:13][::-1])
+
+
+class Radio:
+    def __init__(self, index, neighbors, args):
+        self.index = index
+        self.master, slave = pty.openpty()
+        tty.setraw(slave)
+        os.set_blocking(self.master, False)
+        self.device = os.ttyname(slave)
+        self.mac = bytes([0, 0x12, 0x4b, 0, 0, 0, 0, index + 1])
+        self.neighbors = [bytes([2, 0, 0, 0, 0, 0, index + 1, n + 1])
+                          for n in range(neighbors)]
+        self.decoder = SlipDecoder()
+        self.broadcasts = 0
+        self.unicasts = 0
+        self.misdirected = 0
+        self.seq = 0
+        self.payload = args.payload
+        self.queue_size = args.queue
+        self.bitrate = args.bitrate
+        self.credits = args.credits
+        self.queue = collections.deque()
+        self.tx_end = None
+        self.received = 0
+        self.transmitted = 0
+        self.transmitted_bytes = 0
+        self.overflows = 0
+
+    def send(self, data):
+        try:
+            os.write(self.master, slip_encode(data))
+        except (BlockingIOError, OSError):
+            pass  # the border router is not reading
+
+    def hello(self):
+        for mac in self.neighbors:
+            self.seq += 1
+            self.send(echo_request(mac, self.seq, self.payload))
+
+    def credit_report(self):
+        return bytes([self.queue_size - len(self.queue), self.received & 0xff])
+
+    def report(self, sid, status):
+        report = b'!R' + bytes([sid, status, 1])
+        if self.credits:
+            report += self.credit_report()
+        self.send(report)
+
+    def transmit(self, sid, status, length):
+        if not self.queue_size:
+            self.report(sid, status)
+            return
+        if len(self.queue) == self.queue_size:
+            self.overflows += 1
+            self.report(sid, MAC_TX_ERR)
+            return
+        self.queue.append((sid, status, length))
+        if self.tx_end is None:
+            self.tx_end = time.monotonic() + self.airtime(length)
+
+    def airtime(self, length):
+        return (length + PHY_OVERHEAD) * 8 / self.bitrate
+
+    def poll(self, now):
+        """Complete the transmissions that have ended by now."""
+        while self.tx_end is not None and self.tx_end <= now:
+            sid, status, length = self.queue.popleft()
+            self.transmitted += 1
+            self.transmitted_bytes += length
+            if self.queue:
+                self.tx_end += self.airtime(self.queue[0][2])
+            else:
+                self.tx_end = None
+            self.report(sid, status)
+
+    def input(self, all_neighbors):
+        try:
+            data = os.read(self.master, 4096)
+        except OSError:
+            return
+        for frame in self.decoder.feed(data):
+            if frame[:2] == b'?M':
+                self.send(b'!M' + self.mac)
+            elif frame[:2] == b'?F' and self.credits:
+                self.send(b'!F' + self.credit_report())
+            elif frame[:1] == b'?':
+                self.send(b'EUnknown command')
+            elif frame[:2] == b'!S' and len(frame) > 3:
+                self.received += 1
+                sid = frame[2]
+                payload = frame[4 + 3 * frame[3]:]
+                status = MAC_TX_OK
+                dest = frame_destination(payload)
+                if dest is None:
+                    self.broadcasts += 1
+                elif dest in self.neighbors:
+                    self.unicasts += 1
+                else:
+                    if dest in all_neighbors:
+                        self.misdirected += 1
+                    status = MAC_TX_NOACK
+                self.transmit(sid, status, len(payload))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('-n', '--radios', type=int, default=2)
+    parser.add_argument('--neighbors', type=int, default=2,
+                        help='emulated neighbors per radio')
+    parser.add_argument('--interval', type=float, default=1.0,
+                        help='seconds between echo requests of a neighbor')
+    parser.add_argument('--duration', type=float, default=0,
+                        help='seconds to run (default: until interrupted)')
+    parser.add_argument('--payload', type=int, default=12,
+                        help='bytes of echo request data')
+    parser.add_argument('--queue', type=int, default=0,
+                        help='packets held by a radio while transmitting'
+                        ' (default: transmit instantly)')
+    parser.add_argument('--bitrate', type=int, default=250000,
+                        help='air bit rate of a radio with a queue')
+    parser.add_argument('--credits', action='store_true',
+                        help='report free queue slots to the border router')
+    args = parser.parse_args()
+    if args.credits and not 0 < args.queue < 256:
+        parser.error('--credits requires a --queue of 1 to 255 packets')
+
+    radios = [Radio(i, args.neighbors, args) for i in range(args.radios)]
+    all_neighbors = {mac for radio in radios for mac in radio.neighbors}
+    for radio in radios:
+        print('radio {}: {}'.format(radio.index, radio.device), flush=True)
+
+    start = time.monotonic()
+    next_hello = start + args.interval
+    by_fd = {radio.master: radio for radio in radios}
+    try:
+        while not args.duration or time.monotonic() - start < args.duration:
+            next_event = min([next_hello] + [radio.tx_end for radio in radios
+                                             if radio.tx_end is not None])
+            timeout = max(0, next_event - time.monotonic())
+            readable, _, _ = select.select(list(by_fd), [], [], timeout)
+            for fd in readable:
+                by_fd[fd].input(all_neighbors)
+            now = time.monotonic()
+            for radio in radios:
+                radio.poll(now)
+            if now >= next_hello:
+                next_hello += args.interval
+                for radio in radios:
+                    radio.hello()
+    except KeyboardInterrupt:
+        pass
+
+    elapsed = time.monotonic() - start
+    misdirected = 0
+    for radio in radios:
+        print('radio {}: {} broadcasts, {} unicasts, {} misdirected'.format(
+            radio.index, radio.broadcasts, radio.unicasts, radio.misdirected))
+        if radio.queue_size:
+            print('radio {}: {} transmitted, {:.1f} packets/s, {:.0f} bytes/s,'
+                  ' {} overflows'.format(
+                      radio.index, radio.transmitted,
+                      radio.transmitted / elapsed,
+                      radio.transmitted_bytes / elapsed, radio.overflows))
+        misdirected += radio.misdirected
+    sys.exit(1 if misdirected else 0)
+
+
+if __name__ == '__main__':
+    main()